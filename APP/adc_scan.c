@@ -0,0 +1,397 @@
+/**
+  ******************************************************************************
+  * @file           : adc_scan.c
+  * @brief          : ADC1多通道扫描采样服务实现
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-13
+  ******************************************************************************
+  */
+
+#include "adc_scan.h"
+#include "adc.h"
+#include "tim.h"
+#include <string.h>
+
+/* ==================== 常量 ==================== */
+
+// 出厂校准值（VDDA = 3.3V时的ADC码），主机测试可在编译时替换
+#ifndef ADC_SCAN_VREFINT_CAL
+#define ADC_SCAN_VREFINT_CAL    (*(const uint16_t *)0x1FFF7A2AU)
+#endif
+#ifndef ADC_SCAN_TS_CAL1
+#define ADC_SCAN_TS_CAL1        (*(const uint16_t *)0x1FFF7A2CU)    // 30℃
+#endif
+#ifndef ADC_SCAN_TS_CAL2
+#define ADC_SCAN_TS_CAL2        (*(const uint16_t *)0x1FFF7A2EU)    // 110℃
+#endif
+#define ADC_SCAN_CAL_VDDA       3.3f
+#define ADC_SCAN_TS_CAL1_TEMP   30.0f
+#define ADC_SCAN_TS_CAL2_TEMP   110.0f
+
+/* ==================== 数据结构 ==================== */
+
+/**
+ * @brief 扫描通道
+ */
+typedef struct {
+    uint32_t channel;           // ADC通道
+    uint32_t sampling_time;     // 采样时间
+    uint8_t shift;              // 抽取倍数2^shift
+    float gain;                 // 校准增益
+    float offset;               // 校准偏移(V)
+    uint32_t sum;               // 当前累加和（DMA中断中更新）
+    uint16_t samples;           // 当前累加的采样数
+    volatile uint16_t code;     // 最新平均值（ADC码 << ADC_SCAN_FRAC_BITS）
+    volatile uint32_t count;    // 已产生的平均值个数
+} ADC_SCAN_Channel_t;
+
+/* ==================== 全局变量 ==================== */
+
+static ADC_SCAN_Channel_t adc_scan_channels[ADC_SCAN_MAX_CHANNELS];
+static uint8_t adc_scan_channel_count = 0;
+static bool adc_scan_started = false;
+
+// DMA循环缓冲：每次扫描依次写入各通道一个采样
+static uint16_t adc_scan_buffer[ADC_SCAN_MAX_CHANNELS * ADC_SCAN_FRAMES * 2];
+
+// 模拟看门狗
+static int8_t adc_scan_awd_index = -1;
+static ADC_SCAN_Watchdog_Handler_t adc_scan_awd_handler = NULL;
+static uint16_t adc_scan_awd_low = 0;
+static uint16_t adc_scan_awd_high = ADC_SCAN_CODE_MAX;
+
+/* ==================== 内部函数 ==================== */
+
+/**
+ * @brief 处理半个DMA缓冲（DMA中断中调用）
+ * @param samples: 半区起始地址
+ */
+static void ADC_SCAN_Decimate(const uint16_t *samples)
+{
+    uint32_t frame;
+    uint8_t i;
+
+    for (frame = 0; frame < ADC_SCAN_FRAMES; frame++) {
+        for (i = 0; i < adc_scan_channel_count; i++) {
+            ADC_SCAN_Channel_t *ch = &adc_scan_channels[i];
+
+            ch->sum += *samples++;
+            if (++ch->samples >= (1U << ch->shift)) {
+                // 平均值 << FRAC_BITS = sum >> (shift - FRAC_BITS)，最大65520
+                if (ch->shift >= ADC_SCAN_FRAC_BITS) {
+                    ch->code = (uint16_t)(ch->sum >> (ch->shift - ADC_SCAN_FRAC_BITS));
+                } else {
+                    ch->code = (uint16_t)(ch->sum << (ADC_SCAN_FRAC_BITS - ch->shift));
+                }
+                ch->count++;
+                ch->sum = 0;
+                ch->samples = 0;
+            }
+        }
+    }
+}
+
+/**
+ * @brief 按当前设置配置模拟看门狗（单通道、规则组、中断使能）
+ * @retval 0: 成功, 1: 失败
+ */
+static uint8_t ADC_SCAN_Apply_Watchdog(void)
+{
+    ADC_AnalogWDGConfTypeDef awd = {0};
+
+    awd.WatchdogMode = ADC_ANALOGWATCHDOG_SINGLE_REG;
+    awd.Channel = adc_scan_channels[adc_scan_awd_index].channel;
+    awd.HighThreshold = adc_scan_awd_high;
+    awd.LowThreshold = adc_scan_awd_low;
+    awd.ITMode = ENABLE;
+
+    return (HAL_ADC_AnalogWDGConfig(&hadc1, &awd) == HAL_OK) ? 0 : 1;
+}
+
+/**
+ * @brief 启动DMA，从缓冲起始处重新开始抽取
+ * @retval 0: 成功, 1: 失败
+ */
+static uint8_t ADC_SCAN_Start_DMA(void)
+{
+    uint8_t i;
+
+    // DMA从缓冲起始处写入，丢弃未满一次抽取的累加
+    for (i = 0; i < adc_scan_channel_count; i++) {
+        adc_scan_channels[i].sum = 0;
+        adc_scan_channels[i].samples = 0;
+    }
+
+    return (HAL_ADC_Start_DMA(&hadc1, (uint32_t *)adc_scan_buffer,
+                              (uint32_t)adc_scan_channel_count * ADC_SCAN_FRAMES * 2) == HAL_OK) ? 0 : 1;
+}
+
+/* ==================== 函数实现 ==================== */
+
+/**
+ * @brief 初始化（清空通道列表，登记VREFINT和温度传感器）
+ */
+void ADC_SCAN_Init(void)
+{
+    memset(adc_scan_channels, 0, sizeof(adc_scan_channels));
+    adc_scan_channel_count = 0;
+    adc_scan_started = false;
+    adc_scan_awd_index = -1;
+    adc_scan_awd_handler = NULL;
+    adc_scan_awd_low = 0;
+    adc_scan_awd_high = ADC_SCAN_CODE_MAX;
+
+    // 内部通道要求采样时间≥10us：ADC时钟21MHz时480周期约22.8us
+    ADC_SCAN_Add_Channel(ADC_CHANNEL_VREFINT, ADC_SAMPLETIME_480CYCLES, ADC_SCAN_INTERNAL_SHIFT);
+    ADC_SCAN_Add_Channel(ADC_CHANNEL_TEMPSENSOR, ADC_SAMPLETIME_480CYCLES, ADC_SCAN_INTERNAL_SHIFT);
+}
+
+/**
+ * @brief 登记扫描通道（需在ADC_SCAN_Start之前调用）
+ * @param channel: ADC通道（ADC_CHANNEL_x）
+ * @param sampling_time: 采样时间（ADC_SAMPLETIME_xCYCLES）
+ * @param oversample_shift: 每个输出平均2^shift次采样（0~ADC_SCAN_MAX_SHIFT）
+ * @retval 通道编号，失败返回-1（通道已满、参数无效或已启动）
+ */
+int8_t ADC_SCAN_Add_Channel(uint32_t channel, uint32_t sampling_time, uint8_t oversample_shift)
+{
+    ADC_SCAN_Channel_t *ch;
+
+    if (adc_scan_started || adc_scan_channel_count >= ADC_SCAN_MAX_CHANNELS ||
+        oversample_shift > ADC_SCAN_MAX_SHIFT) {
+        return -1;
+    }
+
+    ch = &adc_scan_channels[adc_scan_channel_count];
+    ch->channel = channel;
+    ch->sampling_time = sampling_time;
+    ch->shift = oversample_shift;
+    ch->gain = 1.0f;
+    ch->offset = 0.0f;
+
+    return (int8_t)adc_scan_channel_count++;
+}
+
+/**
+ * @brief 设置通道线性校准（默认增益1、偏移0）
+ * @param index: 通道编号
+ * @param gain: 增益（如分压比）
+ * @param offset: 偏移(V)
+ */
+void ADC_SCAN_Set_Calibration(int8_t index, float gain, float offset)
+{
+    if (index < 0 || index >= adc_scan_channel_count) {
+        return;
+    }
+
+    adc_scan_channels[index].gain = gain;
+    adc_scan_channels[index].offset = offset;
+}
+
+/**
+ * @brief 按登记顺序配置扫描序列，启动DMA和TIM3触发
+ * @retval 0: 成功, 1: 失败
+ */
+uint8_t ADC_SCAN_Start(void)
+{
+    ADC_ChannelConfTypeDef sConfig = {0};
+    uint8_t i;
+
+    if (adc_scan_started || adc_scan_channel_count == 0) {
+        return 1;
+    }
+
+    // 触发源和DMA已在MX_ADC1_Init中配置，此处改为扫描模式，整个序列结束才置EOC
+    hadc1.Init.ScanConvMode = ENABLE;
+    hadc1.Init.NbrOfConversion = adc_scan_channel_count;
+    hadc1.Init.EOCSelection = ADC_EOC_SEQ_CONV;
+    if (HAL_ADC_Init(&hadc1) != HAL_OK) {
+        return 1;
+    }
+
+    for (i = 0; i < adc_scan_channel_count; i++) {
+        sConfig.Channel = adc_scan_channels[i].channel;
+        sConfig.Rank = i + 1;
+        sConfig.SamplingTime = adc_scan_channels[i].sampling_time;
+        if (HAL_ADC_ConfigChannel(&hadc1, &sConfig) != HAL_OK) {
+            return 1;
+        }
+    }
+
+    if (adc_scan_awd_index >= 0 && ADC_SCAN_Apply_Watchdog() != 0) {
+        return 1;
+    }
+
+    // ADC中断（模拟看门狗、溢出）
+    HAL_NVIC_SetPriority(ADC_IRQn, 0, 0);
+    HAL_NVIC_EnableIRQ(ADC_IRQn);
+
+    if (ADC_SCAN_Start_DMA() != 0) {
+        return 1;
+    }
+    HAL_TIM_Base_Start(&htim3);
+
+    adc_scan_started = true;
+    return 0;
+}
+
+/**
+ * @brief 对指定通道启用模拟看门狗（初始窗口0~满量程，不会触发）
+ * @param index: 通道编号
+ * @param handler: 越界回调，在ADC中断中调用
+ * @retval 0: 成功, 1: 失败
+ */
+uint8_t ADC_SCAN_Set_Watchdog(int8_t index, ADC_SCAN_Watchdog_Handler_t handler)
+{
+    if (index < 0 || index >= adc_scan_channel_count || handler == NULL) {
+        return 1;
+    }
+
+    adc_scan_awd_index = index;
+    adc_scan_awd_handler = handler;
+
+    // 未启动时在ADC_SCAN_Start中配置
+    return adc_scan_started ? ADC_SCAN_Apply_Watchdog() : 0;
+}
+
+/**
+ * @brief 设置模拟看门狗窗口（可在越界回调中调用）
+ * @param low: 低阈值（ADC码），转换结果小于该值时触发
+ * @param high: 高阈值（ADC码），转换结果大于该值时触发
+ */
+void ADC_SCAN_Set_Watchdog_Window(uint16_t low, uint16_t high)
+{
+    adc_scan_awd_low = low;
+    adc_scan_awd_high = high;
+
+    // 直接写阈值寄存器：不经过HAL加锁，中断中也可调用
+    hadc1.Instance->HTR = high;
+    hadc1.Instance->LTR = low;
+}
+
+/**
+ * @brief 读取通道最新平均值
+ * @param index: 通道编号
+ * @param code: 输出，ADC码 << ADC_SCAN_FRAC_BITS
+ * @retval true: 有效, false: 通道无效或尚无平均值
+ */
+bool ADC_SCAN_Read(int8_t index, uint16_t *code)
+{
+    if (index < 0 || index >= adc_scan_channel_count ||
+        adc_scan_channels[index].count == 0) {
+        return false;
+    }
+
+    *code = adc_scan_channels[index].code;
+    return true;
+}
+
+/**
+ * @brief 获取通道已产生的平均值个数（用于判断是否有新数据）
+ * @param index: 通道编号
+ * @retval 平均值个数
+ */
+uint32_t ADC_SCAN_Get_Count(int8_t index)
+{
+    if (index < 0 || index >= adc_scan_channel_count) {
+        return 0;
+    }
+
+    return adc_scan_channels[index].count;
+}
+
+/**
+ * @brief 获取实测VDDA
+ * @retval VDDA(V)
+ */
+float ADC_SCAN_Get_VDDA(void)
+{
+    uint16_t code;
+
+    // VDDA = 3.3V x VREFINT_CAL / VREFINT实测码
+    if (!ADC_SCAN_Read(ADC_SCAN_VREFINT, &code) || code == 0) {
+        return ADC_SCAN_VDDA_DEFAULT;
+    }
+
+    return ADC_SCAN_CAL_VDDA * (float)((uint32_t)ADC_SCAN_VREFINT_CAL << ADC_SCAN_FRAC_BITS) / (float)code;
+}
+
+/**
+ * @brief 获取通道电压（按实测VDDA换算并经过通道校准）
+ * @param index: 通道编号
+ * @retval 电压(V)，尚无数据时返回0
+ */
+float ADC_SCAN_Get_Voltage(int8_t index)
+{
+    uint16_t code;
+    float v;
+
+    if (!ADC_SCAN_Read(index, &code)) {
+        return 0.0f;
+    }
+
+    v = (float)code * ADC_SCAN_Get_VDDA() *
+        (1.0f / ((float)ADC_SCAN_CODE_MAX * (float)(1U << ADC_SCAN_FRAC_BITS)));
+
+    return v * adc_scan_channels[index].gain + adc_scan_channels[index].offset;
+}
+
+/**
+ * @brief 获取芯片内部温度（出厂两点校准）
+ * @retval 温度(℃)
+ */
+float ADC_SCAN_Get_Temperature(void)
+{
+    // 校准值在VDDA = 3.3V下测得，先把实测电压换算成3.3V参考下的ADC码
+    float code = ADC_SCAN_Get_Voltage(ADC_SCAN_TEMPSENSOR) * ((float)ADC_SCAN_CODE_MAX / ADC_SCAN_CAL_VDDA);
+    float cal1 = (float)ADC_SCAN_TS_CAL1;
+    float cal2 = (float)ADC_SCAN_TS_CAL2;
+
+    return ADC_SCAN_TS_CAL1_TEMP +
+           (code - cal1) * (ADC_SCAN_TS_CAL2_TEMP - ADC_SCAN_TS_CAL1_TEMP) / (cal2 - cal1);
+}
+
+/**
+ * @brief ADC DMA半满回调：处理缓冲前半区
+ * @param hadc: ADC句柄指针
+ */
+void ADC_SCAN_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc)
+{
+    if (hadc->Instance == ADC1) {
+        ADC_SCAN_Decimate(&adc_scan_buffer[0]);
+    }
+}
+
+/**
+ * @brief ADC DMA全满回调：处理缓冲后半区
+ * @param hadc: ADC句柄指针
+ */
+void ADC_SCAN_ConvCpltCallback(ADC_HandleTypeDef *hadc)
+{
+    if (hadc->Instance == ADC1) {
+        ADC_SCAN_Decimate(&adc_scan_buffer[(uint32_t)adc_scan_channel_count * ADC_SCAN_FRAMES]);
+    }
+}
+
+/**
+ * @brief ADC模拟看门狗回调
+ * @param hadc: ADC句柄指针
+ */
+void ADC_SCAN_LevelOutOfWindowCallback(ADC_HandleTypeDef *hadc)
+{
+    if (hadc->Instance == ADC1 && adc_scan_awd_handler != NULL) {
+        adc_scan_awd_handler();
+    }
+}
+
+/**
+ * @brief ADC错误回调：溢出或DMA错误后DMA请求已停止，重新启动
+ * @param hadc: ADC句柄指针
+ */
+void ADC_SCAN_ErrorCallback(ADC_HandleTypeDef *hadc)
+{
+    if (hadc->Instance == ADC1 && adc_scan_started) {
+        HAL_ADC_Stop_DMA(&hadc1);
+        ADC_SCAN_Start_DMA();
+    }
+}
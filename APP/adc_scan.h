@@ -0,0 +1,161 @@
+/**
+  ******************************************************************************
+  * @file           : adc_scan.h
+  * @brief          : ADC1多通道扫描采样服务头文件
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-13
+  ******************************************************************************
+  * @attention
+  *
+  * ADC1由TIM3 TRGO每1ms触发一次扫描序列，DMA循环搬运到双半区缓冲：
+  * - 通道列表可配置：ADC_SCAN_Init()固定登记VREFINT和内部温度传感器，
+  *   各模块用ADC_SCAN_Add_Channel()登记自己的通道，最后ADC_SCAN_Start()
+  *   按登记顺序配置扫描序列并启动
+  * - 每个通道独立抽取：累计2^oversample_shift次采样输出一个平均值，
+  *   保留ADC_SCAN_FRAC_BITS位小数，半满/全满中断中完成，读取时不阻塞
+  * - VDDA由VREFINT出厂校准值换算，通道电压按实测VDDA计算（比例测量），
+  *   不再假定参考电压为3.3V
+  * - 每个通道可设置线性校准：电压 = 增益 x 测量电压 + 偏移
+  * - 可对一个通道启用模拟看门狗：单次转换超出窗口即进入ADC中断，
+  *   回调中用ADC_SCAN_Set_Watchdog_Window移动窗口（如改为检测回落）
+  * - 溢出（OVR）或DMA错误时在错误回调中重启DMA
+  *
+  * 使用示例：
+  *   ADC_SCAN_Init();
+  *   idx = ADC_SCAN_Add_Channel(ADC_CHANNEL_1, ADC_SAMPLETIME_480CYCLES, 6);
+  *   ADC_SCAN_Start();
+  *   v = ADC_SCAN_Get_Voltage(idx);
+  *
+  ******************************************************************************
+  */
+
+#ifndef __ADC_SCAN_H
+#define __ADC_SCAN_H
+
+#include "main.h"
+#include <stdbool.h>
+
+/* ==================== 配置参数 ==================== */
+
+#define ADC_SCAN_MAX_CHANNELS       8       // 扫描序列最大通道数
+#define ADC_SCAN_FRAMES             16      // 每半区的扫描次数（1kHz触发时每16ms处理一次）
+#define ADC_SCAN_MAX_SHIFT          10      // 抽取倍数上限2^10，累加和不超过32位
+#define ADC_SCAN_FRAC_BITS          4       // 平均值保留的小数位数
+#define ADC_SCAN_CODE_MAX           4095    // 12位ADC满量程
+#define ADC_SCAN_VDDA_DEFAULT       3.3f    // VREFINT尚无平均值时使用的VDDA(V)
+
+#define ADC_SCAN_VREFINT            0       // 固定登记的通道编号：内部参考电压
+#define ADC_SCAN_TEMPSENSOR         1       // 固定登记的通道编号：内部温度传感器
+#define ADC_SCAN_INTERNAL_SHIFT     8       // 内部通道抽取倍数（256次，约4Hz）
+
+/* ==================== 数据结构 ==================== */
+
+/**
+ * @brief 模拟看门狗越界回调（ADC中断中调用）
+ */
+typedef void (*ADC_SCAN_Watchdog_Handler_t)(void);
+
+/* ==================== 函数声明 ==================== */
+
+/**
+ * @brief 初始化（清空通道列表，登记VREFINT和温度传感器）
+ */
+void ADC_SCAN_Init(void);
+
+/**
+ * @brief 登记扫描通道（需在ADC_SCAN_Start之前调用）
+ * @param channel: ADC通道（ADC_CHANNEL_x）
+ * @param sampling_time: 采样时间（ADC_SAMPLETIME_xCYCLES）
+ * @param oversample_shift: 每个输出平均2^shift次采样（0~ADC_SCAN_MAX_SHIFT）
+ * @retval 通道编号，失败返回-1（通道已满、参数无效或已启动）
+ */
+int8_t ADC_SCAN_Add_Channel(uint32_t channel, uint32_t sampling_time, uint8_t oversample_shift);
+
+/**
+ * @brief 设置通道线性校准（默认增益1、偏移0）
+ * @param index: 通道编号
+ * @param gain: 增益（如分压比）
+ * @param offset: 偏移(V)
+ */
+void ADC_SCAN_Set_Calibration(int8_t index, float gain, float offset);
+
+/**
+ * @brief 按登记顺序配置扫描序列，启动DMA和TIM3触发
+ * @retval 0: 成功, 1: 失败
+ */
+uint8_t ADC_SCAN_Start(void);
+
+/**
+ * @brief 对指定通道启用模拟看门狗（初始窗口0~满量程，不会触发）
+ * @param index: 通道编号
+ * @param handler: 越界回调，在ADC中断中调用
+ * @retval 0: 成功, 1: 失败
+ */
+uint8_t ADC_SCAN_Set_Watchdog(int8_t index, ADC_SCAN_Watchdog_Handler_t handler);
+
+/**
+ * @brief 设置模拟看门狗窗口（可在越界回调中调用）
+ * @param low: 低阈值（ADC码），转换结果小于该值时触发
+ * @param high: 高阈值（ADC码），转换结果大于该值时触发
+ */
+void ADC_SCAN_Set_Watchdog_Window(uint16_t low, uint16_t high);
+
+/**
+ * @brief 读取通道最新平均值
+ * @param index: 通道编号
+ * @param code: 输出，ADC码 << ADC_SCAN_FRAC_BITS
+ * @retval true: 有效, false: 通道无效或尚无平均值
+ */
+bool ADC_SCAN_Read(int8_t index, uint16_t *code);
+
+/**
+ * @brief 获取通道已产生的平均值个数（用于判断是否有新数据）
+ * @param index: 通道编号
+ * @retval 平均值个数
+ */
+uint32_t ADC_SCAN_Get_Count(int8_t index);
+
+/**
+ * @brief 获取实测VDDA
+ * @retval VDDA(V)
+ */
+float ADC_SCAN_Get_VDDA(void);
+
+/**
+ * @brief 获取通道电压（按实测VDDA换算并经过通道校准）
+ * @param index: 通道编号
+ * @retval 电压(V)，尚无数据时返回0
+ */
+float ADC_SCAN_Get_Voltage(int8_t index);
+
+/**
+ * @brief 获取芯片内部温度（出厂两点校准）
+ * @retval 温度(℃)
+ */
+float ADC_SCAN_Get_Temperature(void);
+
+/**
+ * @brief ADC DMA半满回调（在HAL_ADC_ConvHalfCpltCallback中调用）
+ * @param hadc: ADC句柄指针
+ */
+void ADC_SCAN_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc);
+
+/**
+ * @brief ADC DMA全满回调（在HAL_ADC_ConvCpltCallback中调用）
+ * @param hadc: ADC句柄指针
+ */
+void ADC_SCAN_ConvCpltCallback(ADC_HandleTypeDef *hadc);
+
+/**
+ * @brief ADC模拟看门狗回调（在HAL_ADC_LevelOutOfWindowCallback中调用）
+ * @param hadc: ADC句柄指针
+ */
+void ADC_SCAN_LevelOutOfWindowCallback(ADC_HandleTypeDef *hadc);
+
+/**
+ * @brief ADC错误回调（在HAL_ADC_ErrorCallback中调用），重启DMA
+ * @param hadc: ADC句柄指针
+ */
+void ADC_SCAN_ErrorCallback(ADC_HandleTypeDef *hadc);
+
+#endif /* __ADC_SCAN_H */
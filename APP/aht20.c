@@ -218,24 +218,46 @@ uint8_t AHT20_ReadData(I2C_HandleTypeDef *hi2c, AHT20_Data_t *data) {
 
 /**
  * @brief  Task function for scheduler
+ * @note   Non-blocking: each run reads the measurement triggered by the
+ *         previous run (>= AHT20_MEASUREMENT_DELAY ago), then triggers the
+ *         next one. The first run only triggers. No HAL_Delay on the task path.
  */
 void aht20_task(void) {
-    uint8_t result = AHT20_ReadData(&hi2c1, &aht20_data);
+    static uint8_t pending = 0;         // A measurement has been triggered
+    static uint32_t trigger_tick = 0;   // HAL tick when it was triggered
+    AHT20_RawData_t raw_data;
+    uint8_t result;
 
-    if(result != 0) {
-        // printf("AHT20: Read error (code=%d)\r\n", result);
-        aht20_data.is_valid = 0;
-        return;
+    if(pending) {
+        // Called early (e.g. scheduler catch-up): leave the conversion running
+        if((HAL_GetTick() - trigger_tick) < AHT20_MEASUREMENT_DELAY) {
+            return;
+        }
+
+        pending = 0;
+        result = AHT20_ReadRawData(&hi2c1, &raw_data);
+
+        if(result != 0) {
+            // printf("AHT20: Read error (code=%d)\r\n", result);
+            aht20_data.is_valid = 0;
+        } else {
+            // Sets is_valid = 0 if out of range
+            AHT20_ProcessData(&raw_data, &aht20_data);
+
+            // Optional: Print debug information
+            // printf("AHT20: Temperature=%.1f°C, Humidity=%.1f%%\r\n",
+            //        aht20_data.temperature, aht20_data.humidity);
+        }
     }
 
-    if(!aht20_data.is_valid) {
-        // printf("AHT20: Data out of range\r\n");
+    // Start the next conversion; its result is read on the next run
+    if(AHT20_TriggerMeasurement(&hi2c1) != 0) {
+        aht20_data.is_valid = 0;
         return;
     }
 
-    // Optional: Print debug information
-    // printf("AHT20: Temperature=%.1f°C, Humidity=%.1f%%\r\n",
-    //        aht20_data.temperature, aht20_data.humidity);
+    pending = 1;
+    trigger_tick = HAL_GetTick();
 }
 
 /**
@@ -14,7 +14,7 @@
 #ifndef __AHT20_H
 #define __AHT20_H
 
-#include "stm32f1xx_hal.h"
+#include "main.h"
 
 /* ==================== AHT20 I2C Address ==================== */
 #define AHT20_ADDRESS           (0x38 << 1)  // 7-bit address 0x38, left shift for HAL
@@ -132,7 +132,9 @@ void AHT20_ProcessData(AHT20_RawData_t *raw_data, AHT20_Data_t *data);
 uint8_t AHT20_ReadData(I2C_HandleTypeDef *hi2c, AHT20_Data_t *data);
 
 /**
- * @brief  Task function for scheduler (call every 1000ms)
+ * @brief  Task function for scheduler (call every 2000ms, period must be
+ *         >= AHT20_MEASUREMENT_DELAY)
+ * @note   Split into trigger/read across two runs, never blocks
  * @param  None
  * @retval None
  */
@@ -9,32 +9,277 @@
 
 #include "atgm336h.h"
 #include "usart.h"
+#include "scheduler.h"
+#include "geofence.h"
+#include "track.h"
+#include "dead_reckoning.h"
 #include <stdio.h>
 #include <string.h>
-#include <stdlib.h>
 
 /* ==================== 全局变量 ==================== */
 
 static GPS_Data_t gps_data = {0};
-static char gps_rx_buffer[GPS_UART_BUFFER_SIZE] = {0};
-static char gps_sentence[GPS_SENTENCE_MAX_LEN] = {0};
-static uint16_t gps_rx_index = 0;
-static bool sentence_ready = false;
+static uint8_t gps_rx_buffer[GPS_UART_BUFFER_SIZE] = {0};   // DMA循环接收缓冲区
+static uint16_t gps_rx_pos = 0;                             // 已处理到的DMA缓冲区位置
+static char gps_slots[GPS_SENTENCE_SLOTS][GPS_SENTENCE_MAX_LEN];  // 完整语句槽位池
+static volatile uint8_t gps_slot_head = 0;                  // 生产者（中断）写入计数，只由中断修改
+static volatile uint8_t gps_slot_tail = 0;                  // 消费者（任务）读取计数，只由任务修改
+static uint16_t gps_rx_index = 0;                           // 当前槽位已写入长度
+static bool gps_assembling = false;                         // 是否正在组装语句（占用head槽位）
+static GPS_RX_Stats_t gps_rx_stats = {0};
+static NMEA_Parser_t gps_parser;                            // NMEA流式解析器
+static uint32_t gps_task_fix_seq = 0;                       // gps_task已处理的定位序号
+static char gps_task_fix_status = 0;                        // gps_task上次看到的定位状态
 
 /* ==================== 函数实现 ==================== */
 
+/**
+ * @brief 启动UART2循环DMA接收
+ */
+static void GPS_UART_Start_DMA(void)
+{
+    gps_rx_pos = 0;
+    HAL_UARTEx_ReceiveToIdle_DMA(&huart2, gps_rx_buffer, GPS_UART_BUFFER_SIZE);
+}
+
+/**
+ * @brief 按字节组装NMEA语句（中断上下文，单生产者）
+ * @note 语句直接写入head所指的空闲槽位，收到换行后才推进head发布给任务；
+ *       槽位池满时整条语句丢弃，绝不改写任务正在解析的槽位
+ * @param buf: 接收数据
+ * @param len: 字节数
+ */
+static void GPS_Process_Bytes(const uint8_t *buf, uint16_t len)
+{
+    uint16_t i;
+    uint8_t head = gps_slot_head;
+
+    for (i = 0; i < len; i++) {
+        char received = (char)buf[i];
+        char *slot = gps_slots[head & (GPS_SENTENCE_SLOTS - 1)];
+
+        // 检测到$符号，开始新语句（未结束的上一句直接覆盖，计为截断）
+        if (received == '$') {
+            if (gps_assembling) {
+                gps_rx_stats.dropped_partial++;
+            }
+            if ((uint8_t)(head - gps_slot_tail) >= GPS_SENTENCE_SLOTS) {
+                // 槽位全部待解析：丢弃本句
+                gps_rx_stats.dropped_full++;
+                gps_assembling = false;
+                continue;
+            }
+            gps_assembling = true;
+            gps_rx_index = 0;
+            slot[gps_rx_index++] = received;
+        }
+        else if (!gps_assembling) {
+            // 语句外的字节（或已丢弃的语句）忽略
+        }
+        // 检测到换行符，语句结束：先写完数据再发布槽位
+        else if (received == '\n') {
+            slot[gps_rx_index] = '\0';
+            gps_assembling = false;
+            __DMB();
+            gps_slot_head = ++head;
+            gps_rx_stats.sentences++;
+            scheduler_notify(gps_task);
+        }
+        // 正常字符
+        else if (gps_rx_index < GPS_SENTENCE_MAX_LEN - 1) {
+            slot[gps_rx_index++] = received;
+        }
+    }
+
+    gps_rx_stats.bytes += len;
+}
+
+/**
+ * @brief 取出所有已发布的语句并解析（单消费者）
+ * @retval true: 有语句解析成功，定位数据已更新
+ */
+static bool GPS_Drain_Sentences(void)
+{
+    uint8_t tail = gps_slot_tail;
+    bool updated = false;
+
+    while (tail != gps_slot_head) {
+        __DMB();
+        if (GPS_Parse_NMEA(gps_slots[tail & (GPS_SENTENCE_SLOTS - 1)], &gps_data) == 0) {
+            updated = true;
+        }
+        // 解析完成后才归还槽位
+        __DMB();
+        gps_slot_tail = ++tail;
+    }
+
+    return updated;
+}
+
+/**
+ * @brief 修改USART2波特率并重新启动DMA接收
+ * @param baudrate: 波特率
+ */
+static void GPS_UART_Set_Baudrate(uint32_t baudrate)
+{
+    HAL_UART_DMAStop(&huart2);
+    gps_assembling = false;     // 旧波特率下的半句丢弃
+    gps_slot_tail = gps_slot_head;  // 旧波特率下排队的语句不计入新链路的确认
+
+    huart2.Init.BaudRate = baudrate;
+    HAL_UART_Init(&huart2);     // 句柄已初始化，不会重复调用MspInit，DMA链接保持不变
+
+    GPS_UART_Start_DMA();
+}
+
+/**
+ * @brief 发送PCAS指令，自动补充'$'、校验和与结束符
+ * @param body: '$'与'*'之间的内容，如"PCAS02,1000"
+ */
+static void GPS_Send_Command(const char *body)
+{
+    char cmd[GPS_SENTENCE_MAX_LEN];
+    uint8_t checksum = 0;
+    const char *p;
+    int len;
+
+    for (p = body; *p != '\0'; p++) {
+        checksum ^= (uint8_t)*p;
+    }
+
+    len = snprintf(cmd, sizeof(cmd), "$%s*%02X\r\n", body, checksum);
+
+    // 阻塞发送，返回时最后一个字节已移出（TC置位），可以立即切换波特率
+    HAL_UART_Transmit(&huart2, (uint8_t *)cmd, (uint16_t)len, 100);
+    HAL_Delay(GPS_CMD_DELAY);
+}
+
+/**
+ * @brief 等待指定数量的校验通过语句，确认当前波特率下链路正常
+ * @param count: 语句数
+ * @param timeout: 超时时间（ms）
+ * @retval true: 收到足够的语句
+ */
+static bool GPS_Wait_Sentences(uint32_t count, uint32_t timeout)
+{
+    uint32_t start = HAL_GetTick();
+    uint32_t base = gps_parser.sentence_count;
+
+    while (HAL_GetTick() - start < timeout) {
+        GPS_Drain_Sentences();
+        if (gps_parser.sentence_count - base >= count) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief 波特率转换为PCAS01参数
+ * @param baudrate: 波特率
+ * @retval 0~5，不支持返回-1
+ */
+static int8_t GPS_Baudrate_Code(uint32_t baudrate)
+{
+    static const uint32_t baudrates[] = {4800, 9600, 19200, 38400, 57600, 115200};
+    int8_t i;
+
+    for (i = 0; i < (int8_t)(sizeof(baudrates) / sizeof(baudrates[0])); i++) {
+        if (baudrates[i] == baudrate) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
 /**
  * @brief 初始化GPS模块
  */
 void GPS_Init(void)
 {
-    // 启动UART2中断接收
-    HAL_UART_Receive_IT(&huart2, (uint8_t *)gps_rx_buffer, 1);
+    static const GPS_Config_t config = {
+        .baudrate = GPS_CONFIG_BAUDRATE,
+        .rate = GPS_CONFIG_RATE,
+        .sentence_mask = GPS_CONFIG_SENTENCES
+    };
+
+    NMEA_Parser_Init(&gps_parser);
+
+    // 启动UART2循环DMA接收（空闲线检测 + 半满/全满事件）
+    GPS_UART_Start_DMA();
+
+    // 提高波特率、只保留需要的语句；失败时模块仍按原配置输出
+    GPS_Configure(&config);
 
     printf("GPS: Init Success\r\n");
     printf("GPS: Waiting for fix (may take 1-3 minutes outdoors)...\r\n");
 }
 
+/**
+ * @brief 配置模块波特率、定位频率和输出语句，并将USART2切换到新波特率
+ * @param config: 配置
+ * @retval 0: 成功, 1: 失败（链路不通或切换未生效）
+ */
+uint8_t GPS_Configure(const GPS_Config_t *config)
+{
+    char body[48];
+    uint16_t m = config->sentence_mask;
+    int8_t code = GPS_Baudrate_Code(config->baudrate);
+    uint32_t prev_baudrate;
+
+    if (code < 0 || m == 0 ||
+        (config->rate != GPS_RATE_1HZ && config->rate != GPS_RATE_5HZ && config->rate != GPS_RATE_10HZ)) {
+        printf("GPS: Invalid config\r\n");
+        return 1;
+    }
+
+    // 1. 确认当前链路；MCU单独复位时模块可能已处于目标波特率
+    if (!GPS_Wait_Sentences(1, GPS_VERIFY_TIMEOUT)) {
+        prev_baudrate = huart2.Init.BaudRate;
+        GPS_UART_Set_Baudrate(config->baudrate);
+        if (!GPS_Wait_Sentences(1, GPS_VERIFY_TIMEOUT)) {
+            GPS_UART_Set_Baudrate(prev_baudrate);
+            printf("GPS: No NMEA output at %lu or %lu baud\r\n",
+                   (unsigned long)prev_baudrate, (unsigned long)config->baudrate);
+            return 1;
+        }
+    }
+    prev_baudrate = huart2.Init.BaudRate;
+
+    // 2. 先在当前波特率下关闭不用的语句并设置频率，减少切换期间的数据量
+    // PCAS03字段：GGA,GLL,GSA,GSV,RMC,VTG,ZDA,ANT,DHV,LPS,,,UTC,GST（值为每几次定位输出一次，0关闭）
+    snprintf(body, sizeof(body), "PCAS03,%u,%u,%u,%u,%u,%u,%u,0,0,0,,,0,0",
+             (m & GPS_MSG_GGA) ? 1U : 0U, (m & GPS_MSG_GLL) ? 1U : 0U,
+             (m & GPS_MSG_GSA) ? 1U : 0U, (m & GPS_MSG_GSV) ? 1U : 0U,
+             (m & GPS_MSG_RMC) ? 1U : 0U, (m & GPS_MSG_VTG) ? 1U : 0U,
+             (m & GPS_MSG_ZDA) ? 1U : 0U);
+    GPS_Send_Command(body);
+
+    // PCAS02：定位间隔（ms）
+    snprintf(body, sizeof(body), "PCAS02,%u", 1000U / (unsigned)config->rate);
+    GPS_Send_Command(body);
+
+    // 3. 切换波特率：模块收到PCAS01后立即改用新波特率，USART2随后跟随
+    if (config->baudrate != prev_baudrate) {
+        snprintf(body, sizeof(body), "PCAS01,%d", code);
+        GPS_Send_Command(body);
+        GPS_UART_Set_Baudrate(config->baudrate);
+    }
+
+    // 4. 以新波特率收到校验通过的语句才算生效，否则恢复原波特率
+    if (!GPS_Wait_Sentences(GPS_VERIFY_SENTENCES, GPS_VERIFY_TIMEOUT)) {
+        GPS_UART_Set_Baudrate(prev_baudrate);
+        printf("GPS: Config not applied, staying at %lu baud\r\n", (unsigned long)prev_baudrate);
+        return 1;
+    }
+
+    printf("GPS: %lu baud, %u Hz, sentences 0x%02X\r\n",
+           (unsigned long)config->baudrate, (unsigned)config->rate, (unsigned)m);
+    return 0;
+}
+
 /**
  * @brief NMEA坐标转换为十进制度数
  * @param nmea_coord: NMEA坐标（ddmm.mmmm或dddmm.mmmm格式）
@@ -62,128 +307,345 @@ float GPS_NMEA_To_Decimal(float nmea_coord)
 }
 
 /**
- * @brief 解析$GNRMC语句
- * @param sentence: NMEA语句字符串
+ * @brief NMEA坐标字段直接换算为1e-7度定点值（整数运算，不经过float）
+ * @param field: 坐标字段（ddmm.mmmmm或dddmm.mmmmm）
+ * @retval 1e-7度（不含方向符号）
+ */
+int32_t GPS_NMEA_To_E7(const NMEA_Field_t *field)
+{
+    // 统一换算为5位小数的分：dddmm.mmmmm -> dddmmmmmmm（经度最大1800000000，不溢出）
+    int32_t v = NMEA_Field_To_Fixed(field, 5);
+    int32_t degrees = v / 10000000;
+    int32_t minutes_e5 = v % 10000000;
+
+    // 分(1e-5) -> 度(1e-7)：乘100再除60，即乘5除3，四舍五入
+    return degrees * GPS_E7_SCALE + (minutes_e5 * 5 + 1) / 3;
+}
+
+/**
+ * @brief 1e-7度定点坐标转换为double度数
+ * @param e7: 1e-7度
+ * @retval 度
+ */
+double GPS_E7_To_Degrees(int32_t e7)
+{
+    return (double)e7 / (double)GPS_E7_SCALE;
+}
+
+/**
+ * @brief 度数转换为1e-7度定点坐标（四舍五入）
+ * @param degrees: 度
+ * @retval 1e-7度
+ */
+int32_t GPS_Degrees_To_E7(double degrees)
+{
+    double e7 = degrees * (double)GPS_E7_SCALE;
+
+    return (int32_t)(e7 >= 0.0 ? e7 + 0.5 : e7 - 0.5);
+}
+
+/**
+ * @brief 将1e-7度定点坐标格式化为十进制字符串，不使用浮点
+ * @param e7: 1e-7度
+ * @param buf: 输出缓冲区（至少14字节）
+ * @param size: 缓冲区大小
+ * @retval 写入的字符数
+ */
+int GPS_E7_Format(int32_t e7, char *buf, uint32_t size)
+{
+    uint32_t mag = (e7 < 0) ? (uint32_t)(-(int64_t)e7) : (uint32_t)e7;
+
+    return snprintf(buf, size, "%s%lu.%07lu", (e7 < 0) ? "-" : "",
+                    (unsigned long)(mag / GPS_E7_SCALE),
+                    (unsigned long)(mag % GPS_E7_SCALE));
+}
+
+/**
+ * @brief 解析RMC语句（推荐最小定位信息）
+ * @param s: 已校验的语句
  * @param data: GPS数据结构指针
  * @retval 0: 成功, 1: 失败
  */
-uint8_t GPS_Parse_GNRMC(char *sentence, GPS_Data_t *data)
+uint8_t GPS_Parse_RMC(const NMEA_Sentence_t *s, GPS_Data_t *data)
 {
-    char *token;
-    int field = 0;
-    char time_str[16] = {0};
-    char lat_str[16] = {0};
-    char lon_str[16] = {0};
-    char status_str[2] = {0};
-
     // $GNRMC,073040.00,A,3954.52200,N,11628.85100,E,0.012,,101125,,,A*7E
-    // 字段：0=RMC, 1=时间, 2=状态, 3=纬度, 4=纬度方向, 5=经度, 6=经度方向...
-
-    token = strtok(sentence, ",");
-
-    while (token != NULL) {
-        switch (field) {
-            case 1:  // 时间 (hhmmss.ss)
-                strncpy(time_str, token, sizeof(time_str) - 1);
-                if (strlen(time_str) >= 6) {
-                    data->hour = (time_str[0] - '0') * 10 + (time_str[1] - '0');
-                    data->minute = (time_str[2] - '0') * 10 + (time_str[3] - '0');
-                    data->second = (time_str[4] - '0') * 10 + (time_str[5] - '0');
-                }
-                break;
-
-            case 2:  // 状态 (A=有效, V=无效)
-                strncpy(status_str, token, sizeof(status_str) - 1);
-                data->fix_status = status_str[0];
-                data->fix_valid = (status_str[0] == 'A');
-                break;
-
-            case 3:  // 纬度 (ddmm.mmmm)
-                if (strlen(token) > 0) {
-                    strncpy(lat_str, token, sizeof(lat_str) - 1);
-                    float nmea_lat = atof(lat_str);
-                    data->latitude = GPS_NMEA_To_Decimal(nmea_lat);
-                }
-                break;
-
-            case 4:  // 纬度方向 (N/S)
-                data->lat_dir = token[0];
-                break;
-
-            case 5:  // 经度 (dddmm.mmmm)
-                if (strlen(token) > 0) {
-                    strncpy(lon_str, token, sizeof(lon_str) - 1);
-                    float nmea_lon = atof(lon_str);
-                    data->longitude = GPS_NMEA_To_Decimal(nmea_lon);
-                }
-                break;
-
-            case 6:  // 经度方向 (E/W)
-                data->lon_dir = token[0];
-                break;
-        }
+    // 字段：0=时间, 1=状态, 2=纬度, 3=纬度方向, 4=经度, 5=经度方向...
+    if (s->field_count < 6) {
+        return 1;
+    }
+
+    // 时间 (hhmmss.ss)
+    if (NMEA_Field_Is_Number(&s->field[0])) {
+        int32_t t = NMEA_Field_To_Fixed(&s->field[0], 0);
+        data->hour = (uint8_t)(t / 10000);
+        data->minute = (uint8_t)(t / 100 % 100);
+        data->second = (uint8_t)(t % 100);
+    }
+
+    // 状态 (A=有效, V=无效)
+    if (s->field[1].len > 0) {
+        data->fix_status = s->field[1].first;
+        data->fix_valid = (s->field[1].first == 'A');
+    }
+
+    // 纬度 (ddmm.mmmm) 及方向 (N/S)
+    if (NMEA_Field_Is_Number(&s->field[2]) && s->field[3].len > 0) {
+        int32_t e7 = GPS_NMEA_To_E7(&s->field[2]);
+
+        data->lat_dir = s->field[3].first;
+        data->lat_e7 = (data->lat_dir == 'S') ? -e7 : e7;
+        data->latitude = (float)e7 / (float)GPS_E7_SCALE;
+    }
 
-        token = strtok(NULL, ",");
-        field++;
+    // 经度 (dddmm.mmmm) 及方向 (E/W)
+    if (NMEA_Field_Is_Number(&s->field[4]) && s->field[5].len > 0) {
+        int32_t e7 = GPS_NMEA_To_E7(&s->field[4]);
+
+        data->lon_dir = s->field[5].first;
+        data->lon_e7 = (data->lon_dir == 'W') ? -e7 : e7;
+        data->longitude = (float)e7 / (float)GPS_E7_SCALE;
+    }
+
+    if (data->fix_valid && NMEA_Field_Is_Number(&s->field[2]) && NMEA_Field_Is_Number(&s->field[4])) {
+        data->fix_seq++;
     }
 
     return 0;
 }
 
 /**
- * @brief 解析$GNGGA语句
- * @param sentence: NMEA语句字符串
+ * @brief 解析GGA语句（定位数据）
+ * @param s: 已校验的语句
  * @param data: GPS数据结构指针
  * @retval 0: 成功, 1: 失败
  */
-uint8_t GPS_Parse_GNGGA(char *sentence, GPS_Data_t *data)
+uint8_t GPS_Parse_GGA(const NMEA_Sentence_t *s, GPS_Data_t *data)
 {
-    char *token;
-    int field = 0;
-
     // $GNGGA,073040.00,3954.52200,N,11628.85100,E,1,12,0.99,48.0,M,-5.0,M,,*7A
-    // 字段：0=GGA, 1=时间, 2=纬度, 3=纬度方向, 4=经度, 5=经度方向,
-    //       6=定位质量, 7=卫星数, 8=HDOP, 9=海拔...
+    // 字段：0=时间, 1=纬度, 2=纬度方向, 3=经度, 4=经度方向,
+    //       5=定位质量, 6=卫星数, 7=HDOP, 8=海拔...
+    if (s->field_count < 9) {
+        return 1;
+    }
+
+    // 卫星数
+    if (NMEA_Field_Is_Number(&s->field[6])) {
+        data->satellites = (uint8_t)NMEA_Field_To_Fixed(&s->field[6], 0);
+    }
+
+    // HDOP（水平精度因子）
+    if (NMEA_Field_Is_Number(&s->field[7])) {
+        data->hdop = NMEA_Field_To_Float(&s->field[7]);
+    }
+
+    // 海拔高度（米）
+    if (NMEA_Field_Is_Number(&s->field[8])) {
+        data->altitude = NMEA_Field_To_Float(&s->field[8]);
+    }
+
+    return 0;
+}
 
-    token = strtok(sentence, ",");
+/**
+ * @brief 解析GSA语句（精度因子与定位模式）
+ * @param s: 已校验的语句
+ * @param data: GPS数据结构指针
+ * @retval 0: 成功, 1: 失败
+ */
+uint8_t GPS_Parse_GSA(const NMEA_Sentence_t *s, GPS_Data_t *data)
+{
+    // $GNGSA,A,3,10,12,18,23,25,32,,,,,,,1.52,0.99,1.15,1*0B
+    // 字段：0=模式(M/A), 1=定位模式(1/2/3), 2~13=使用的卫星号, 14=PDOP, 15=HDOP, 16=VDOP
+    if (s->field_count < 17) {
+        return 1;
+    }
 
-    while (token != NULL) {
-        switch (field) {
-            case 7:  // 卫星数
-                data->satellites = (uint8_t)atoi(token);
-                break;
+    if (NMEA_Field_Is_Number(&s->field[1])) {
+        data->fix_mode = (uint8_t)NMEA_Field_To_Fixed(&s->field[1], 0);
+    }
 
-            case 8:  // HDOP（水平精度因子）
-                data->hdop = atof(token);
-                break;
+    if (NMEA_Field_Is_Number(&s->field[14])) {
+        data->pdop = NMEA_Field_To_Float(&s->field[14]);
+    }
+
+    if (NMEA_Field_Is_Number(&s->field[15])) {
+        data->hdop = NMEA_Field_To_Float(&s->field[15]);
+    }
+
+    if (NMEA_Field_Is_Number(&s->field[16])) {
+        data->vdop = NMEA_Field_To_Float(&s->field[16]);
+    }
+
+    return 0;
+}
 
-            case 9:  // 海拔高度（米）
-                data->altitude = atof(token);
-                break;
+/**
+ * @brief 发送方编码转换为卫星系统
+ * @param talker: NMEA_TALKER编码
+ * @retval 卫星系统
+ */
+static GPS_System_t GPS_Talker_System(uint16_t talker)
+{
+    switch (talker) {
+        case NMEA_TALKER('G', 'P'): return GPS_SYSTEM_GPS;
+        case NMEA_TALKER('B', 'D'):
+        case NMEA_TALKER('G', 'B'): return GPS_SYSTEM_BDS;
+        case NMEA_TALKER('G', 'L'): return GPS_SYSTEM_GLONASS;
+        case NMEA_TALKER('G', 'A'): return GPS_SYSTEM_GALILEO;
+        default:                    return GPS_SYSTEM_UNKNOWN;
+    }
+}
+
+/**
+ * @brief 解析GSV语句（可见卫星信噪比）
+ * @note 每个系统的GSV分多条输出，收到该系统第1条时先移除表中该系统的旧记录
+ * @param s: 已校验的语句
+ * @param data: GPS数据结构指针
+ * @retval 0: 成功, 1: 失败
+ */
+uint8_t GPS_Parse_GSV(const NMEA_Sentence_t *s, GPS_Data_t *data)
+{
+    // $GPGSV,3,1,10,10,55,314,42,12,20,047,38,18,67,023,45,23,30,210,33*7C
+    // 字段：0=总条数, 1=本条序号, 2=可见卫星数, 之后每4个字段一颗卫星：卫星号,仰角,方位角,信噪比
+    GPS_System_t system = GPS_Talker_System(s->talker);
+    uint8_t i;
+    uint8_t n;
+
+    if (s->field_count < 3 || !NMEA_Field_Is_Number(&s->field[1])) {
+        return 1;
+    }
+
+    if (NMEA_Field_To_Fixed(&s->field[1], 0) == 1) {
+        // 新一轮：原地压缩掉该系统的旧记录
+        for (i = 0, n = 0; i < data->sat_count; i++) {
+            if (data->sats[i].system != system) {
+                data->sats[n++] = data->sats[i];
+            }
         }
+        data->sat_count = n;
+    }
+
+    for (i = 3; i + 3 < s->field_count && i + 3 < NMEA_MAX_FIELDS; i += 4) {
+        GPS_Satellite_t *sat;
 
-        token = strtok(NULL, ",");
-        field++;
+        if (!NMEA_Field_Is_Number(&s->field[i])) {
+            continue;
+        }
+        if (data->sat_count >= GPS_MAX_SATELLITES) {
+            break;
+        }
+
+        sat = &data->sats[data->sat_count++];
+        sat->prn = (uint8_t)NMEA_Field_To_Fixed(&s->field[i], 0);
+        sat->system = (uint8_t)system;
+        sat->elevation = (int8_t)NMEA_Field_To_Fixed(&s->field[i + 1], 0);
+        sat->azimuth = (uint16_t)NMEA_Field_To_Fixed(&s->field[i + 2], 0);
+        sat->snr = (uint8_t)NMEA_Field_To_Fixed(&s->field[i + 3], 0);  // 未跟踪时为空，记为0
     }
 
     return 0;
 }
 
+/**
+ * @brief 解析VTG语句（地面航向与速度）
+ * @param s: 已校验的语句
+ * @param data: GPS数据结构指针
+ * @retval 0: 成功, 1: 失败
+ */
+uint8_t GPS_Parse_VTG(const NMEA_Sentence_t *s, GPS_Data_t *data)
+{
+    // $GNVTG,156.30,T,,M,0.012,N,0.022,K,A*2F
+    // 字段：0=真北航向, 1=T, 2=磁北航向, 3=M, 4=速度(节), 5=N, 6=速度(km/h), 7=K
+    if (s->field_count < 8) {
+        return 1;
+    }
+
+    if (NMEA_Field_Is_Number(&s->field[0])) {
+        data->course = NMEA_Field_To_Float(&s->field[0]);
+    }
+
+    if (NMEA_Field_Is_Number(&s->field[6])) {
+        data->speed_kmh = NMEA_Field_To_Float(&s->field[6]);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief 解析ZDA语句（UTC日期与时间）
+ * @param s: 已校验的语句
+ * @param data: GPS数据结构指针
+ * @retval 0: 成功, 1: 失败
+ */
+uint8_t GPS_Parse_ZDA(const NMEA_Sentence_t *s, GPS_Data_t *data)
+{
+    // $GNZDA,073040.00,10,11,2025,00,00*71
+    // 字段：0=时间, 1=日, 2=月, 3=年, 4=时区小时, 5=时区分钟
+    if (s->field_count < 4 || !NMEA_Field_Is_Number(&s->field[3])) {
+        return 1;
+    }
+
+    data->day = (uint8_t)NMEA_Field_To_Fixed(&s->field[1], 0);
+    data->month = (uint8_t)NMEA_Field_To_Fixed(&s->field[2], 0);
+    data->year = (uint16_t)NMEA_Field_To_Fixed(&s->field[3], 0);
+
+    return 0;
+}
+
+/**
+ * @brief 语句解析表：按3字符语句类型分发，与发送方（GN/GP/BD...）无关
+ * @note 新增语句只需实现解析函数并在此登记
+ */
+static const GPS_Sentence_Handler_t gps_handlers[] = {
+    { NMEA_TYPE('R', 'M', 'C'), GPS_Parse_RMC },
+    { NMEA_TYPE('G', 'G', 'A'), GPS_Parse_GGA },
+    { NMEA_TYPE('G', 'S', 'A'), GPS_Parse_GSA },
+    { NMEA_TYPE('G', 'S', 'V'), GPS_Parse_GSV },
+    { NMEA_TYPE('V', 'T', 'G'), GPS_Parse_VTG },
+    { NMEA_TYPE('Z', 'D', 'A'), GPS_Parse_ZDA },
+};
+
+#define GPS_HANDLER_COUNT   (sizeof(gps_handlers) / sizeof(gps_handlers[0]))
+
+/**
+ * @brief 按语句类型查表分发已校验的语句
+ * @param s: 已校验的语句
+ * @param data: GPS数据结构指针
+ * @retval 0: 成功, 1: 失败（不支持的语句类型或字段不足）
+ */
+uint8_t GPS_Dispatch_Sentence(const NMEA_Sentence_t *s, GPS_Data_t *data)
+{
+    uint8_t i;
+
+    for (i = 0; i < GPS_HANDLER_COUNT; i++) {
+        if (gps_handlers[i].type == s->type) {
+            return gps_handlers[i].parse(s, data);
+        }
+    }
+
+    return 1;  // 不支持的语句类型
+}
+
 /**
  * @brief 解析NMEA语句
  * @param sentence: NMEA语句字符串
  * @param data: GPS数据结构指针
- * @retval 0: 成功, 1: 失败
+ * @retval 0: 成功, 1: 失败（校验错误或不支持的语句类型）
  */
 uint8_t GPS_Parse_NMEA(char *sentence, GPS_Data_t *data)
 {
-    if (strstr(sentence, "$GNRMC") != NULL) {
-        return GPS_Parse_GNRMC(sentence, data);
-    } else if (strstr(sentence, "$GNGGA") != NULL) {
-        return GPS_Parse_GNGGA(sentence, data);
+    const NMEA_Sentence_t *s = NULL;
+
+    // 逐字节送入状态机，校验通过后查表分发
+    while (*sentence != '\0' && s == NULL) {
+        s = NMEA_Parser_Feed(&gps_parser, *sentence++);
     }
 
-    return 1;  // 不支持的语句类型
+    if (s == NULL) {
+        return 1;
+    }
+
+    return GPS_Dispatch_Sentence(s, data);
 }
 
 /**
@@ -193,10 +655,13 @@ uint8_t GPS_Parse_NMEA(char *sentence, GPS_Data_t *data)
 void GPS_Print_Data(GPS_Data_t *data)
 {
     if (data->fix_valid) {
-        printf("GPS: Lat=%.6f%c, Lon=%.6f%c, Sats=%d\r\n",
-               data->latitude, data->lat_dir,
-               data->longitude, data->lon_dir,
-               data->satellites);
+        char lat[16];
+        char lon[16];
+
+        // 使用定点坐标输出，保留全部7位小数
+        GPS_E7_Format(data->lat_e7, lat, sizeof(lat));
+        GPS_E7_Format(data->lon_e7, lon, sizeof(lon));
+        printf("GPS: Lat=%s, Lon=%s, Sats=%d\r\n", lat, lon, data->satellites);
     } else {
         printf("GPS: No Fix (Status: %c)\r\n", data->fix_status);
     }
@@ -207,38 +672,71 @@ void GPS_Print_Data(GPS_Data_t *data)
  */
 void gps_task(void)
 {
-    if (sentence_ready) {
-        GPS_Parse_NMEA(gps_sentence, &gps_data);
-        GPS_Print_Data(&gps_data);
-        sentence_ready = false;
+    if (!GPS_Drain_Sentences()) {
+        return;
     }
+
+    // 每个定位周期的GGA/GSA/GSV/VTG/ZDA也都解析成功，只有RMC给出新定位（fix_seq变化）时
+    // 才输出和检测围栏；未定位时只在状态变化时打印一次
+    if (gps_data.fix_seq == gps_task_fix_seq) {
+        if (!gps_data.fix_valid && gps_data.fix_status != gps_task_fix_status) {
+            GPS_Print_Data(&gps_data);
+        }
+        gps_task_fix_status = gps_data.fix_status;
+        return;
+    }
+    gps_task_fix_seq = gps_data.fix_seq;
+    gps_task_fix_status = gps_data.fix_status;
+
+    GPS_Print_Data(&gps_data);
+    GEOFENCE_Update(&gps_data);  // 新定位检测电子围栏
+    TRACK_Add_Fix(&gps_data);    // 新定位送入轨迹压缩，抽稀后等待上传
+    DR_Correct(&dr_state, &gps_data);   // 新定位修正航位推算
+    DR_Get_Output(&dr_state, &dr_output);
 }
 
 /**
- * @brief UART接收回调函数
+ * @brief UART接收事件回调（DMA半满/全满或空闲线，中断上下文）
  * @param huart: UART句柄
+ * @param pos: DMA缓冲区当前写入位置
  */
-void GPS_UART_RxCpltCallback(UART_HandleTypeDef *huart)
+void GPS_UART_RxEventCallback(UART_HandleTypeDef *huart, uint16_t pos)
 {
     if (huart->Instance == USART2) {
-        char received = gps_rx_buffer[0];
-
-        // 检测到$符号，开始新语句
-        if (received == '$') {
-            gps_rx_index = 0;
-            gps_sentence[gps_rx_index++] = received;
-        }
-        // 检测到换行符，语句结束
-        else if (received == '\n') {
-            gps_sentence[gps_rx_index] = '\0';
-            sentence_ready = true;
-        }
-        // 正常字符
-        else if (gps_rx_index < GPS_SENTENCE_MAX_LEN - 1) {
-            gps_sentence[gps_rx_index++] = received;
+        gps_rx_stats.events++;
+
+        if (pos != gps_rx_pos) {
+            if (pos > gps_rx_pos) {
+                GPS_Process_Bytes(&gps_rx_buffer[gps_rx_pos], pos - gps_rx_pos);
+            } else {
+                // 写入位置已回绕：先处理到缓冲区末尾，再处理开头部分
+                GPS_Process_Bytes(&gps_rx_buffer[gps_rx_pos], GPS_UART_BUFFER_SIZE - gps_rx_pos);
+                GPS_Process_Bytes(gps_rx_buffer, pos);
+            }
+            gps_rx_pos = (pos == GPS_UART_BUFFER_SIZE) ? 0 : pos;
         }
+    }
+}
 
-        // 继续接收下一个字节
-        HAL_UART_Receive_IT(&huart2, (uint8_t *)gps_rx_buffer, 1);
+/**
+ * @brief UART错误回调（溢出/噪声等导致DMA接收停止时重新启动）
+ * @param huart: UART句柄
+ */
+void GPS_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+    if (huart->Instance == USART2) {
+        gps_rx_stats.errors++;
+        HAL_UART_DMAStop(&huart2);
+        gps_assembling = false;     // 错误前的半句已不完整
+        GPS_UART_Start_DMA();
     }
 }
+
+/**
+ * @brief 获取GPS串口接收统计
+ * @retval 统计数据指针
+ */
+const GPS_RX_Stats_t *GPS_Get_RX_Stats(void)
+{
+    return &gps_rx_stats;
+}
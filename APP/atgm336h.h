@@ -8,7 +8,8 @@
   * @attention
   *
   * ATGM336H是GPS+北斗双模定位模块
-  * - 使用UART2通信（PA2-TX, PA3-RX, 9600波特率）
+  * - 使用UART2通信（PA2-TX, PA3-RX, 上电默认9600波特率）
+  * - 初始化时通过PCAS指令提高波特率、设置定位频率、关闭不用的语句
   * - 输出NMEA-0183协议数据
   * - 定位精度：3-5米
   * - 冷启动时间：约35秒
@@ -20,15 +21,78 @@
 #define __ATGM336H_H
 
 #include "main.h"
+#include "nmea.h"
 #include <stdbool.h>
 
 /* ==================== 配置参数 ==================== */
 
-#define GPS_UART_BUFFER_SIZE    256     // UART接收缓冲区大小
+#define GPS_UART_BUFFER_SIZE    256     // UART循环DMA接收缓冲区大小（半满/全满各触发一次事件）
 #define GPS_SENTENCE_MAX_LEN    128     // NMEA语句最大长度
+#define GPS_SENTENCE_SLOTS      16      // 中断与任务之间的语句槽位数（2的幂，容纳1秒内的一组语句含多条GSV）
+#define GPS_E7_SCALE            10000000L  // 定点坐标比例：1e-7度（约1.1cm）
+
+#define GPS_DEFAULT_BAUDRATE    9600    // 模块出厂波特率
+#define GPS_CONFIG_BAUDRATE     115200  // 初始化时切换到的波特率
+#define GPS_CONFIG_RATE         GPS_RATE_1HZ
+#define GPS_CONFIG_SENTENCES    (GPS_MSG_RMC | GPS_MSG_GGA | GPS_MSG_GSA | \
+                                 GPS_MSG_GSV | GPS_MSG_VTG | GPS_MSG_ZDA)  // 驱动实际解析的语句
+#define GPS_VERIFY_TIMEOUT      2500    // 等待有效语句的超时（ms，大于两个1Hz定位周期）
+#define GPS_MAX_SATELLITES      24      // 卫星表容量（各系统合计）
+#define GPS_CMD_DELAY           50      // 每条PCAS指令后的处理间隔（ms）
+#define GPS_VERIFY_SENTENCES    2       // 判定链路正常所需的校验通过语句数
+
+/* ==================== PCAS03语句掩码 ==================== */
+
+#define GPS_MSG_GGA             (1U << 0)
+#define GPS_MSG_GLL             (1U << 1)
+#define GPS_MSG_GSA             (1U << 2)
+#define GPS_MSG_GSV             (1U << 3)
+#define GPS_MSG_RMC             (1U << 4)
+#define GPS_MSG_VTG             (1U << 5)
+#define GPS_MSG_ZDA             (1U << 6)
 
 /* ==================== 数据结构 ==================== */
 
+/**
+ * @brief 定位更新频率（PCAS02）
+ */
+typedef enum {
+    GPS_RATE_1HZ = 1,
+    GPS_RATE_5HZ = 5,
+    GPS_RATE_10HZ = 10
+} GPS_Rate_t;
+
+/**
+ * @brief 模块运行配置
+ */
+typedef struct {
+    uint32_t baudrate;       // 4800/9600/19200/38400/57600/115200
+    GPS_Rate_t rate;         // 定位更新频率
+    uint16_t sentence_mask;  // 输出语句，GPS_MSG_xxx按位或
+} GPS_Config_t;
+
+/**
+ * @brief 卫星系统（由GSV语句的发送方区分）
+ */
+typedef enum {
+    GPS_SYSTEM_UNKNOWN = 0,
+    GPS_SYSTEM_GPS,         // $GP
+    GPS_SYSTEM_BDS,         // $BD / $GB
+    GPS_SYSTEM_GLONASS,     // $GL
+    GPS_SYSTEM_GALILEO      // $GA
+} GPS_System_t;
+
+/**
+ * @brief 可见卫星（6字节）
+ */
+typedef struct {
+    uint8_t prn;         // 卫星号
+    uint8_t system;      // GPS_System_t
+    int8_t elevation;    // 仰角（度）
+    uint8_t snr;         // 信噪比（dB-Hz，0表示未跟踪）
+    uint16_t azimuth;    // 方位角（度）
+} GPS_Satellite_t;
+
 /**
  * @brief GPS数据结构
  */
@@ -38,19 +102,63 @@ typedef struct {
     float longitude;     // 经度（度）
     char lon_dir;        // 经度方向（E/W）
 
+    int32_t lat_e7;      // 纬度（1e-7度，带符号，北正南负），由NMEA数字直接换算
+    int32_t lon_e7;      // 经度（1e-7度，带符号，东正西负）
+
     uint8_t hour;        // 时（UTC）
     uint8_t minute;      // 分
     uint8_t second;      // 秒
+    uint8_t day;         // 日（UTC，来自ZDA）
+    uint8_t month;       // 月
+    uint16_t year;       // 年
 
-    uint8_t satellites;  // 可见卫星数
+    uint8_t satellites;  // 参与定位的卫星数
+    uint8_t fix_mode;    // 定位模式（1=未定位, 2=2D, 3=3D，来自GSA）
     float hdop;          // 水平精度因子
+    float pdop;          // 位置精度因子
+    float vdop;          // 垂直精度因子
     float altitude;      // 海拔高度（米）
 
+    float speed_kmh;     // 地面速度（km/h，来自VTG）
+    float course;        // 地面航向（度，真北）
+
+    uint8_t sat_count;   // 卫星表有效条数
+    GPS_Satellite_t sats[GPS_MAX_SATELLITES];  // 可见卫星表（来自GSV）
+
     bool fix_valid;      // 定位有效标志
     char fix_status;     // 定位状态（A=有效, V=无效）
+    uint32_t fix_seq;    // 定位序号，RMC给出有效位置时加1（供使用者判断是否为新定位）
 
 } GPS_Data_t;
 
+/**
+ * @brief GPS串口接收统计
+ */
+typedef struct {
+    uint32_t events;           // 接收事件中断次数（半满/全满/空闲线）
+    uint32_t bytes;            // 累计接收字节数
+    uint32_t errors;           // UART错误次数（每次错误可能丢失字节）
+    uint32_t sentences;        // 交给任务的完整语句数
+    uint32_t dropped_full;     // 槽位池满丢弃的语句数（任务来不及处理）
+    uint32_t dropped_partial;  // 未收到换行即被下一个'$'打断的语句数
+} GPS_RX_Stats_t;
+
+/**
+ * @brief 语句解析函数
+ * @param s: 已校验的语句
+ * @param data: GPS数据结构指针
+ * @retval 0: 成功, 1: 失败
+ */
+typedef uint8_t (*GPS_Sentence_Parser_t)(const NMEA_Sentence_t *s, GPS_Data_t *data);
+
+/**
+ * @brief 语句解析表项
+ */
+typedef struct {
+    uint32_t type;                  // 语句类型，NMEA_TYPE编码
+    GPS_Sentence_Parser_t parse;    // 解析函数
+} GPS_Sentence_Handler_t;
+
 /* ==================== 函数声明 ==================== */
 
 /**
@@ -58,6 +166,15 @@ typedef struct {
  */
 void GPS_Init(void);
 
+/**
+ * @brief 配置模块波特率、定位频率和输出语句，并将USART2切换到新波特率
+ * @note 阻塞执行，仅在初始化阶段调用；先确认当前链路（模块可能已处于目标波特率），
+ *       切换后等待校验通过的语句确认生效，失败时恢复原波特率
+ * @param config: 配置
+ * @retval 0: 成功, 1: 失败（链路不通或切换未生效）
+ */
+uint8_t GPS_Configure(const GPS_Config_t *config);
+
 /**
  * @brief 解析NMEA语句
  * @param sentence: NMEA语句字符串
@@ -67,20 +184,60 @@ void GPS_Init(void);
 uint8_t GPS_Parse_NMEA(char *sentence, GPS_Data_t *data);
 
 /**
- * @brief 解析$GNRMC语句
- * @param sentence: NMEA语句字符串
+ * @brief 按语句类型查表分发已校验的语句（与发送方无关）
+ * @param s: 已校验的语句
  * @param data: GPS数据结构指针
  * @retval 0: 成功, 1: 失败
  */
-uint8_t GPS_Parse_GNRMC(char *sentence, GPS_Data_t *data);
+uint8_t GPS_Dispatch_Sentence(const NMEA_Sentence_t *s, GPS_Data_t *data);
 
 /**
- * @brief 解析$GNGGA语句
- * @param sentence: NMEA语句字符串
+ * @brief 解析RMC语句（推荐最小定位信息）
+ * @param s: 已校验的语句
+ * @param data: GPS数据结构指针
+ * @retval 0: 成功, 1: 失败
+ */
+uint8_t GPS_Parse_RMC(const NMEA_Sentence_t *s, GPS_Data_t *data);
+
+/**
+ * @brief 解析GGA语句（定位数据）
+ * @param s: 已校验的语句
  * @param data: GPS数据结构指针
  * @retval 0: 成功, 1: 失败
  */
-uint8_t GPS_Parse_GNGGA(char *sentence, GPS_Data_t *data);
+uint8_t GPS_Parse_GGA(const NMEA_Sentence_t *s, GPS_Data_t *data);
+
+/**
+ * @brief 解析GSA语句（精度因子与定位模式）
+ * @param s: 已校验的语句
+ * @param data: GPS数据结构指针
+ * @retval 0: 成功, 1: 失败
+ */
+uint8_t GPS_Parse_GSA(const NMEA_Sentence_t *s, GPS_Data_t *data);
+
+/**
+ * @brief 解析GSV语句（可见卫星信噪比）
+ * @param s: 已校验的语句
+ * @param data: GPS数据结构指针
+ * @retval 0: 成功, 1: 失败
+ */
+uint8_t GPS_Parse_GSV(const NMEA_Sentence_t *s, GPS_Data_t *data);
+
+/**
+ * @brief 解析VTG语句（地面航向与速度）
+ * @param s: 已校验的语句
+ * @param data: GPS数据结构指针
+ * @retval 0: 成功, 1: 失败
+ */
+uint8_t GPS_Parse_VTG(const NMEA_Sentence_t *s, GPS_Data_t *data);
+
+/**
+ * @brief 解析ZDA语句（UTC日期与时间）
+ * @param s: 已校验的语句
+ * @param data: GPS数据结构指针
+ * @retval 0: 成功, 1: 失败
+ */
+uint8_t GPS_Parse_ZDA(const NMEA_Sentence_t *s, GPS_Data_t *data);
 
 /**
  * @brief NMEA坐标转换为十进制度数
@@ -89,6 +246,36 @@ uint8_t GPS_Parse_GNGGA(char *sentence, GPS_Data_t *data);
  */
 float GPS_NMEA_To_Decimal(float nmea_coord);
 
+/**
+ * @brief NMEA坐标字段直接换算为1e-7度定点值（整数运算，不经过float）
+ * @param field: 坐标字段（ddmm.mmmmm或dddmm.mmmmm）
+ * @retval 1e-7度（不含方向符号）
+ */
+int32_t GPS_NMEA_To_E7(const NMEA_Field_t *field);
+
+/**
+ * @brief 1e-7度定点坐标转换为double度数
+ * @param e7: 1e-7度
+ * @retval 度
+ */
+double GPS_E7_To_Degrees(int32_t e7);
+
+/**
+ * @brief 度数转换为1e-7度定点坐标（四舍五入）
+ * @param degrees: 度
+ * @retval 1e-7度
+ */
+int32_t GPS_Degrees_To_E7(double degrees);
+
+/**
+ * @brief 将1e-7度定点坐标格式化为十进制字符串（如"-116.4808500"），不使用浮点
+ * @param e7: 1e-7度
+ * @param buf: 输出缓冲区（至少14字节）
+ * @param size: 缓冲区大小
+ * @retval 写入的字符数
+ */
+int GPS_E7_Format(int32_t e7, char *buf, uint32_t size);
+
 /**
  * @brief GPS任务函数（供调度器调用）
  */
@@ -101,9 +288,22 @@ void gps_task(void);
 void GPS_Print_Data(GPS_Data_t *data);
 
 /**
- * @brief UART接收回调函数
+ * @brief UART接收事件回调（在HAL_UARTEx_RxEventCallback中调用）
+ * @param huart: UART句柄
+ * @param pos: DMA缓冲区当前写入位置
+ */
+void GPS_UART_RxEventCallback(UART_HandleTypeDef *huart, uint16_t pos);
+
+/**
+ * @brief UART错误回调（在HAL_UART_ErrorCallback中调用）
  * @param huart: UART句柄
  */
-void GPS_UART_RxCpltCallback(UART_HandleTypeDef *huart);
+void GPS_UART_ErrorCallback(UART_HandleTypeDef *huart);
+
+/**
+ * @brief 获取GPS串口接收统计
+ * @retval 统计数据指针
+ */
+const GPS_RX_Stats_t *GPS_Get_RX_Stats(void);
 
 #endif /* __ATGM336H_H */
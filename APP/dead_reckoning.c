@@ -0,0 +1,203 @@
+/**
+  ******************************************************************************
+  * @file           : dead_reckoning.c
+  * @brief          : IMU辅助航位推算（GPS定位间隔内的位置估计）实现
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-11
+  ******************************************************************************
+  */
+
+#include "dead_reckoning.h"
+#include <math.h>
+#include <string.h>
+
+/* ==================== 常量 ==================== */
+
+#define DR_DEG_TO_RAD           0.017453293f
+#define DR_REBASE_DISTANCE      10000.0f    // 离原点超过该距离（m）时以新定位为原点，保持float精度
+
+/* ==================== 全局变量 ==================== */
+
+DR_State_t dr_state;
+DR_Output_t dr_output;
+
+/* ==================== 内部函数 ==================== */
+
+/**
+ * @brief 角度归一化到[0, 360)
+ */
+static float DR_Wrap_360(float deg)
+{
+    while (deg >= 360.0f) deg -= 360.0f;
+    while (deg < 0.0f) deg += 360.0f;
+    return deg;
+}
+
+/**
+ * @brief 角度差归一化到[-180, 180)
+ */
+static float DR_Wrap_180(float deg)
+{
+    while (deg >= 180.0f) deg -= 360.0f;
+    while (deg < -180.0f) deg += 360.0f;
+    return deg;
+}
+
+/**
+ * @brief 以指定定位为局部坐标原点
+ */
+static void DR_Set_Origin(DR_State_t *dr, int32_t lat_e7, int32_t lon_e7)
+{
+    dr->ref_lat_e7 = lat_e7;
+    dr->ref_lon_e7 = lon_e7;
+    dr->m_per_e7_lat = DR_EARTH_RADIUS * DR_DEG_TO_RAD / (float)GPS_E7_SCALE;
+    dr->m_per_e7_lon = dr->m_per_e7_lat * cosf((float)lat_e7 / (float)GPS_E7_SCALE * DR_DEG_TO_RAD);
+    dr->north = 0.0f;
+    dr->east = 0.0f;
+}
+
+/* ==================== 函数实现 ==================== */
+
+/**
+ * @brief 初始化推算状态（等待首个有效定位建立原点）
+ * @param dr: 推算状态
+ */
+void DR_Init(DR_State_t *dr)
+{
+    memset(dr, 0, sizeof(DR_State_t));
+    dr->accel_mean = 1.0f;
+}
+
+/**
+ * @brief 按固定步长DR_STEP_MS推算一步
+ * @param dr: 推算状态
+ * @param imu: IMU数据（加速度g、角速度°/s、俯仰/横滚°）
+ */
+void DR_Predict(DR_State_t *dr, const ICM20608_Data_t *imu)
+{
+    float accel = sqrtf(imu->accel_x * imu->accel_x +
+                        imu->accel_y * imu->accel_y +
+                        imu->accel_z * imu->accel_z);
+    float diff = accel - dr->accel_mean;
+    float yaw_rate;
+    float h;
+
+    // 加速度模长的指数滑动均值/方差，方差很小说明静止
+    dr->accel_mean += DR_STILL_ALPHA * diff;
+    dr->accel_var = (1.0f - DR_STILL_ALPHA) * (dr->accel_var + DR_STILL_ALPHA * diff * diff);
+    dr->stationary = (dr->accel_var < DR_STILL_ACCEL_VAR);
+
+    // 水平面航向角速度：Z轴角速度按俯仰、横滚投影（头部倾斜不大时的近似）
+    yaw_rate = imu->gyro_z * cosf(imu->pitch * DR_DEG_TO_RAD) * cosf(imu->roll * DR_DEG_TO_RAD);
+
+    if (dr->stationary) {
+        // 静止：此时的角速度即为零偏，速度清零（零速修正）
+        dr->gyro_bias += DR_BIAS_ALPHA * (yaw_rate - dr->gyro_bias);
+        dr->speed = 0.0f;
+    }
+
+    // Z轴朝上时逆时针为正，航向按顺时针计
+    dr->heading = DR_Wrap_360(dr->heading - (yaw_rate - dr->gyro_bias) * DR_STEP_S);
+
+    if (!dr->initialized) {
+        return;
+    }
+
+    h = dr->heading * DR_DEG_TO_RAD;
+    dr->north += dr->speed * cosf(h) * DR_STEP_S;
+    dr->east += dr->speed * sinf(h) * DR_STEP_S;
+    dr->steps_since_fix++;
+
+    // 运动时误差随推算时间增长：速度误差 + 航向误差引起的横向偏移
+    if (!dr->stationary) {
+        float lateral = dr->speed * DR_HEADING_NOISE;
+
+        dr->pos_var += (DR_SPEED_NOISE * DR_SPEED_NOISE + lateral * lateral) * DR_STEP_S;
+        if (dr->pos_var > DR_MAX_ERROR * DR_MAX_ERROR * 4.0f) {
+            dr->pos_var = DR_MAX_ERROR * DR_MAX_ERROR * 4.0f;  // 限幅，避免长期无定位时溢出
+        }
+    }
+}
+
+/**
+ * @brief 用GPS定位修正位置、速度和航向（同一定位只处理一次）
+ * @param dr: 推算状态
+ * @param gps: GPS数据
+ */
+void DR_Correct(DR_State_t *dr, const GPS_Data_t *gps)
+{
+    float hdop = (gps->hdop > 1.0f) ? gps->hdop : 1.0f;
+    float meas_var = (DR_GPS_UERE * hdop) * (DR_GPS_UERE * hdop);
+    float gps_speed = gps->speed_kmh / 3.6f;
+    float north;
+    float east;
+    float k;
+
+    if (!gps->fix_valid || gps->fix_seq == dr->fix_seq) {
+        return;
+    }
+    dr->fix_seq = gps->fix_seq;
+    dr->steps_since_fix = 0;
+
+    if (!dr->initialized ||
+        fabsf(dr->north) > DR_REBASE_DISTANCE || fabsf(dr->east) > DR_REBASE_DISTANCE) {
+        // 首个定位或离原点太远：直接采用定位结果作为新原点
+        DR_Set_Origin(dr, gps->lat_e7, gps->lon_e7);
+        dr->pos_var = meas_var;
+        dr->initialized = true;
+    } else {
+        north = (float)((int64_t)gps->lat_e7 - dr->ref_lat_e7) * dr->m_per_e7_lat;
+        east = (float)((int64_t)gps->lon_e7 - dr->ref_lon_e7) * dr->m_per_e7_lon;
+
+        // 标量卡尔曼增益：推算误差越大越相信GPS
+        k = dr->pos_var / (dr->pos_var + meas_var);
+        dr->north += k * (north - dr->north);
+        dr->east += k * (east - dr->east);
+        dr->pos_var *= (1.0f - k);
+    }
+
+    // 速度取GPS地面速度；速度足够时GPS航向可信，修正陀螺积分航向
+    if (!dr->stationary) {
+        dr->speed = gps_speed;
+    }
+    if (gps_speed >= DR_COURSE_MIN_SPEED) {
+        dr->heading = DR_Wrap_360(dr->heading + DR_COURSE_GAIN * DR_Wrap_180(gps->course - dr->heading));
+    }
+}
+
+/**
+ * @brief 获取当前推算结果
+ * @param dr: 推算状态
+ * @param out: 输出
+ */
+void DR_Get_Output(const DR_State_t *dr, DR_Output_t *out)
+{
+    float dlat = 0.0f;
+    float dlon = 0.0f;
+
+    if (dr->initialized) {
+        dlat = dr->north / dr->m_per_e7_lat;
+        dlon = dr->east / dr->m_per_e7_lon;
+    }
+
+    out->lat_e7 = dr->ref_lat_e7 + (int32_t)(dlat >= 0.0f ? dlat + 0.5f : dlat - 0.5f);
+    out->lon_e7 = dr->ref_lon_e7 + (int32_t)(dlon >= 0.0f ? dlon + 0.5f : dlon - 0.5f);
+    out->error_m = sqrtf(dr->pos_var);
+    out->heading = dr->heading;
+    out->speed = dr->speed;
+    out->valid = dr->initialized && (out->error_m <= DR_MAX_ERROR);
+}
+
+/**
+ * @brief 航位推算任务函数（供调度器每DR_STEP_MS调用）
+ */
+void dr_task(void)
+{
+    // ICM20608尚未产生首个样本时icm_data全为0，会被误判为静止
+    if (icm_filter.last_update == 0) {
+        return;
+    }
+
+    DR_Predict(&dr_state, &icm_data);
+    DR_Get_Output(&dr_state, &dr_output);
+}
@@ -0,0 +1,131 @@
+/**
+  ******************************************************************************
+  * @file           : dead_reckoning.h
+  * @brief          : IMU辅助航位推算（GPS定位间隔内的位置估计）头文件
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-11
+  ******************************************************************************
+  * @attention
+  *
+  * GPS最快1Hz且在室内、脚手架下经常丢失，两次定位之间用ICM20608推算位置：
+  * - 固定步长DR_STEP_MS调用DR_Predict，输出频率20Hz
+  * - 航向：陀螺仪Z轴按俯仰/横滚投影到水平面后积分，静止时估计零偏
+  * - 速度：取自GPS地面速度；加速度模长方差判断静止，静止时速度清零
+  *   （MEMS加速度二次积分漂移过大，不直接积分加速度）
+  * - 位置：以首个有效定位为原点的北东坐标（米），输出换算回1e-7度
+  * - 误差：位置方差随推算时间增长，每次定位按HDOP加权修正（标量卡尔曼增益），
+  *   误差超过DR_MAX_ERROR时输出无效
+  *
+  * 系统中的接入：
+  *   DR_Init(&dr_state);
+  *   scheduler_add_task(dr_task, DR_STEP_MS);   // ICM20608就绪后注册，推算并刷新dr_output
+  *   gps_task中每个新定位调用DR_Correct(&dr_state, &gps_data)
+  *
+  ******************************************************************************
+  */
+
+#ifndef __DEAD_RECKONING_H
+#define __DEAD_RECKONING_H
+
+#include "main.h"
+#include "atgm336h.h"
+#include "icm20608.h"
+#include <stdbool.h>
+
+/* ==================== 配置参数 ==================== */
+
+#define DR_STEP_MS              50          // 推算步长（ms），20Hz输出
+#define DR_STEP_S               (DR_STEP_MS / 1000.0f)
+
+#define DR_GPS_UERE             2.5f        // GPS单位HDOP对应的定位误差（m，1σ）
+#define DR_SPEED_NOISE          0.5f        // 速度随机游走（m/s/√s），位置方差增长率
+#define DR_HEADING_NOISE        0.05f       // 航向不确定度（rad/√s），与速度共同决定横向误差增长
+#define DR_MAX_ERROR            50.0f       // 误差估计上限（m），超过后输出无效
+
+#define DR_COURSE_MIN_SPEED     1.0f        // GPS航向可信的最低速度（m/s）
+#define DR_COURSE_GAIN          0.5f        // GPS航向修正陀螺航向的权重
+#define DR_STILL_ACCEL_VAR      0.0004f     // 静止判定：加速度模长方差阈值（g^2）
+#define DR_STILL_ALPHA          0.1f        // 加速度均值/方差低通系数
+#define DR_BIAS_ALPHA           0.01f       // 静止时陀螺零偏估计低通系数
+
+#define DR_EARTH_RADIUS         6371000.0f  // 地球平均半径（m）
+
+/* ==================== 数据结构 ==================== */
+
+/**
+ * @brief 航位推算状态
+ */
+typedef struct {
+    int32_t ref_lat_e7;     // 局部坐标原点（首个有效定位）
+    int32_t ref_lon_e7;
+    float m_per_e7_lat;     // 1e-7度纬度对应的米数
+    float m_per_e7_lon;     // 1e-7度经度对应的米数（随原点纬度变化）
+
+    float north;            // 北向位置（m）
+    float east;             // 东向位置（m）
+    float speed;            // 地面速度（m/s）
+    float heading;          // 航向（度，0=北，顺时针）
+    float gyro_bias;        // 水平面航向角速度零偏（°/s）
+    float pos_var;          // 位置方差（m^2，两轴相同）
+
+    float accel_mean;       // 加速度模长均值（g）
+    float accel_var;        // 加速度模长方差（g^2）
+    bool stationary;        // 静止
+
+    uint32_t fix_seq;       // 已处理的GPS定位序号
+    uint32_t steps_since_fix;  // 上次修正后的推算步数
+    bool initialized;       // 已建立局部坐标原点
+} DR_State_t;
+
+/**
+ * @brief 推算输出
+ */
+typedef struct {
+    int32_t lat_e7;         // 纬度（1e-7度）
+    int32_t lon_e7;         // 经度（1e-7度）
+    float error_m;          // 位置误差估计（m，1σ）
+    float heading;          // 航向（度）
+    float speed;            // 速度（m/s）
+    bool valid;             // 已初始化且误差未超限
+} DR_Output_t;
+
+/* ==================== 函数声明 ==================== */
+
+/**
+ * @brief 初始化推算状态（等待首个有效定位建立原点）
+ * @param dr: 推算状态
+ */
+void DR_Init(DR_State_t *dr);
+
+/**
+ * @brief 按固定步长DR_STEP_MS推算一步
+ * @param dr: 推算状态
+ * @param imu: IMU数据（加速度g、角速度°/s、俯仰/横滚°）
+ */
+void DR_Predict(DR_State_t *dr, const ICM20608_Data_t *imu);
+
+/**
+ * @brief 用GPS定位修正位置、速度和航向（同一定位只处理一次）
+ * @param dr: 推算状态
+ * @param gps: GPS数据
+ */
+void DR_Correct(DR_State_t *dr, const GPS_Data_t *gps);
+
+/**
+ * @brief 获取当前推算结果
+ * @param dr: 推算状态
+ * @param out: 输出
+ */
+void DR_Get_Output(const DR_State_t *dr, DR_Output_t *out);
+
+/**
+ * @brief 航位推算任务函数（供调度器每DR_STEP_MS调用）
+ */
+void dr_task(void);
+
+/* ==================== 全局变量 ==================== */
+
+extern DR_State_t dr_state;     // 系统航位推算状态
+extern DR_Output_t dr_output;   // 最新推算结果（每DR_STEP_MS及每次GPS修正后更新）
+
+#endif /* __DEAD_RECKONING_H */
@@ -5,37 +5,382 @@
   * @author         : STM32智能安全帽项目组
   * @date           : 2025-12-01
   ******************************************************************************
+  * @attention
+  *
+  * AT引擎工作流程（esp_at_task为事件任务，不轮询）：
+  * 1. ESP_AT_Submit把指令复制进队列后唤醒esp_at_task，立即返回
+  * 2. esp_at_task取队首指令中断发送，并用scheduler_notify_after登记超时时刻
+  * 3. UART3接收中断把字节写入环形缓冲区，收到'\n'或'>'时唤醒esp_at_task
+  * 4. esp_at_task逐行解析：OK/ERROR结束当前指令，'>'提示符后发送附加数据，
+  *    其余行按URC处理（更新WiFi/MQTT连接状态）
+  * 5. 超时时刻到达时esp_at_task被唤醒并以ESP_AT_TIMEOUT结束当前指令；
+  *    UART3接收错误（如溢出）在ESP_UART_ErrorCallback中立即重新启动接收
+  *
+  ******************************************************************************
   */
 
 #include "esp01s.h"
 #include "usart.h"
+#include "scheduler.h"
+#include "track.h"
 #include <stdio.h>
+#include <stdarg.h>
 #include <string.h>
 
+/* ==================== 类型定义 ==================== */
+
+/**
+ * @brief 排队中的AT指令
+ */
+typedef struct {
+    char buf[ESP_AT_CMD_MAX_LEN];   // 指令（含\r\n）后紧跟附加数据
+    uint16_t cmd_len;               // 指令长度
+    uint16_t data_len;              // 附加数据长度（0表示无'>'阶段）
+    uint32_t timeout_ms;            // 超时时间
+    ESP_AT_Callback_t cb;           // 完成回调
+    void *ctx;                      // 回调上下文
+} ESP_AT_Cmd_t;
+
+/**
+ * @brief 当前指令所处阶段
+ */
+typedef enum {
+    AT_STATE_IDLE = 0,      // 无指令执行
+    AT_STATE_SEND_CMD,      // 等待UART空闲后发送指令
+    AT_STATE_WAIT_RESP,     // 等待OK/ERROR
+    AT_STATE_WAIT_PROMPT,   // 等待'>'提示符
+    AT_STATE_WAIT_SEND      // 附加数据已发送，等待发送结果
+} ESP_AT_State_t;
+
 /* ==================== 全局变量 ==================== */
 
 static ESP_Data_t esp_data = {0};
-static char esp_rx_buffer[256] = {0};
 
-/* ==================== 函数实现 ==================== */
+// 接收环形缓冲区（中断写head，任务读tail）
+static uint8_t esp_rx_ring[ESP_AT_RX_RING_SIZE];
+static volatile uint16_t esp_rx_head = 0;
+static uint16_t esp_rx_tail = 0;
+static uint8_t esp_rx_byte;
+
+// 行缓冲区
+static char esp_line[ESP_AT_LINE_MAX_LEN];
+static uint16_t esp_line_len = 0;
+
+// 指令队列
+static ESP_AT_Cmd_t esp_at_queue[ESP_AT_QUEUE_SIZE];
+static uint8_t esp_at_head = 0;
+static uint8_t esp_at_tail = 0;
+static uint8_t esp_at_count = 0;
+
+static ESP_AT_State_t esp_at_state = AT_STATE_IDLE;
+static uint32_t esp_at_start = 0;           // 当前指令开始时刻
+static ESP_URC_Handler_t esp_urc_handler = NULL;
+
+static bool esp_publish_pending = false;    // 上一次发布尚未完成
+static uint32_t esp_track_next_seq = 0;     // 本次发布携带的轨迹点，成功后从队列移除
+static bool esp_track_pending = false;
+
+/* ==================== AT引擎 ==================== */
 
 /**
- * @brief 发送AT指令
- * @param cmd: AT指令字符串
+ * @brief 结束当前指令并回调
+ * @param result: 完成结果
+ */
+static void ESP_AT_Complete(ESP_AT_Result_t result)
+{
+    ESP_AT_Cmd_t *cmd = &esp_at_queue[esp_at_tail];
+    ESP_AT_Callback_t cb = cmd->cb;
+    void *ctx = cmd->ctx;
+
+    // 超时时可能仍在发送，中止以便下一条指令使用UART
+    if (result == ESP_AT_TIMEOUT) {
+        HAL_UART_AbortTransmit_IT(&huart3);
+    }
+
+    esp_at_tail = (esp_at_tail + 1) % ESP_AT_QUEUE_SIZE;
+    esp_at_count--;
+    esp_at_state = AT_STATE_IDLE;
+
+    // 先出队再回调，回调中可以继续提交指令
+    if (cb != NULL) {
+        cb(result, ctx);
+    }
+}
+
+/**
+ * @brief 处理URC及指令执行期间的信息行
+ * @param line: 一行响应
+ */
+static void ESP_AT_Handle_URC(const char *line)
+{
+    if (strcmp(line, "WIFI GOT IP") == 0) {
+        esp_data.wifi_connected = true;
+    } else if (strcmp(line, "WIFI DISCONNECT") == 0) {
+        esp_data.wifi_connected = false;
+        esp_data.mqtt_connected = false;
+        esp_data.status = ESP_IDLE;
+    } else if (strncmp(line, "+MQTTDISCONNECTED", 17) == 0) {
+        esp_data.mqtt_connected = false;
+        if (esp_data.wifi_connected) {
+            esp_data.status = ESP_WIFI_CONNECTED;
+        }
+    } else if (strncmp(line, "+MQTTCONNECTED", 14) == 0) {
+        esp_data.mqtt_connected = true;
+        esp_data.status = ESP_MQTT_CONNECTED;
+    } else if (strcmp(line, "ready") == 0) {
+        // 模块复位，连接全部失效
+        esp_data.wifi_connected = false;
+        esp_data.mqtt_connected = false;
+        esp_data.status = ESP_IDLE;
+    }
+
+    if (esp_urc_handler != NULL) {
+        esp_urc_handler(line);
+    }
+}
+
+/**
+ * @brief 处理一行完整响应
+ * @param line: 去掉\r\n的响应行
+ */
+static void ESP_AT_Handle_Line(const char *line)
+{
+    bool waiting = (esp_at_state == AT_STATE_WAIT_RESP ||
+                    esp_at_state == AT_STATE_WAIT_PROMPT ||
+                    esp_at_state == AT_STATE_WAIT_SEND);
+
+    if (line[0] == '\0') {
+        return;
+    }
+
+    if (waiting) {
+        if (strcmp(line, "OK") == 0) {
+            // 带'>'阶段的指令先回OK再给提示符，发送数据后的OK也不是最终结果
+            if (esp_at_state == AT_STATE_WAIT_RESP) {
+                ESP_AT_Complete(ESP_AT_OK);
+            }
+            return;
+        }
+
+        if (esp_at_state == AT_STATE_WAIT_SEND &&
+            (strcmp(line, "SEND OK") == 0 || strcmp(line, "+MQTTPUB:OK") == 0)) {
+            ESP_AT_Complete(ESP_AT_OK);
+            return;
+        }
+
+        if (strcmp(line, "ERROR") == 0 || strcmp(line, "FAIL") == 0 ||
+            strcmp(line, "SEND FAIL") == 0 || strcmp(line, "+MQTTPUB:FAIL") == 0) {
+            ESP_AT_Complete(ESP_AT_ERROR);
+            return;
+        }
+    }
+
+    ESP_AT_Handle_URC(line);
+}
+
+/**
+ * @brief 从环形缓冲区取出字节并按行解析
+ */
+static void ESP_AT_Process_RX(void)
+{
+    uint16_t head = esp_rx_head;
+
+    while (esp_rx_tail != head) {
+        char c = (char)esp_rx_ring[esp_rx_tail];
+        esp_rx_tail = (esp_rx_tail + 1) & (ESP_AT_RX_RING_SIZE - 1);
+
+        // '>'提示符后没有换行，行首出现即视为提示符
+        if (c == '>' && esp_line_len == 0 && esp_at_state == AT_STATE_WAIT_PROMPT) {
+            ESP_AT_Cmd_t *cmd = &esp_at_queue[esp_at_tail];
+
+            if (HAL_UART_Transmit_IT(&huart3, (uint8_t *)&cmd->buf[cmd->cmd_len],
+                                     cmd->data_len) == HAL_OK) {
+                esp_at_state = AT_STATE_WAIT_SEND;
+            } else {
+                ESP_AT_Complete(ESP_AT_ERROR);
+            }
+            continue;
+        }
+
+        if (c == '\n') {
+            // 去掉行尾\r
+            if (esp_line_len > 0 && esp_line[esp_line_len - 1] == '\r') {
+                esp_line_len--;
+            }
+            esp_line[esp_line_len] = '\0';
+            esp_line_len = 0;
+            ESP_AT_Handle_Line(esp_line);
+        } else if (esp_line_len < ESP_AT_LINE_MAX_LEN - 1) {
+            esp_line[esp_line_len++] = c;
+        }
+    }
+}
+
+/**
+ * @brief 提交AT指令到队列（非阻塞）
+ * @param cmd: AT指令字符串（含\r\n）
+ * @param data: 收到'>'提示符后发送的数据，无则为NULL
+ * @param data_len: 数据长度
+ * @param timeout_ms: 超时时间（毫秒），从指令开始发送计时
+ * @param cb: 完成回调，可为NULL
+ * @param ctx: 回调上下文
+ * @retval 0: 已排队, 1: 队列满或指令过长
+ */
+uint8_t ESP_AT_Submit(const char *cmd, const uint8_t *data, uint16_t data_len,
+                      uint32_t timeout_ms, ESP_AT_Callback_t cb, void *ctx)
+{
+    ESP_AT_Cmd_t *slot;
+    size_t cmd_len = strlen(cmd);
+
+    if (data == NULL) {
+        data_len = 0;
+    }
+
+    if (esp_at_count >= ESP_AT_QUEUE_SIZE || cmd_len + data_len > ESP_AT_CMD_MAX_LEN) {
+        return 1;
+    }
+
+    slot = &esp_at_queue[esp_at_head];
+    memcpy(slot->buf, cmd, cmd_len);
+    if (data_len > 0) {
+        memcpy(&slot->buf[cmd_len], data, data_len);
+    }
+    slot->cmd_len = (uint16_t)cmd_len;
+    slot->data_len = data_len;
+    slot->timeout_ms = timeout_ms;
+    slot->cb = cb;
+    slot->ctx = ctx;
+
+    esp_at_head = (esp_at_head + 1) % ESP_AT_QUEUE_SIZE;
+    esp_at_count++;
+
+    // 空闲时由下一轮esp_at_task开始发送
+    scheduler_notify(esp_at_task);
+
+    return 0;
+}
+
+/**
+ * @brief 发送AT指令（非阻塞，仅排队，不关心结果）
+ * @param cmd: AT指令字符串（含\r\n）
  * @param timeout_ms: 超时时间（毫秒）
- * @retval 0: 成功, 1: 失败
+ * @retval 0: 已排队, 1: 队列满或指令过长
  */
 uint8_t ESP_Send_AT(char *cmd, uint32_t timeout_ms)
 {
-    // 发送AT指令
-    HAL_UART_Transmit(&huart3, (uint8_t *)cmd, strlen(cmd), 1000);
+    return ESP_AT_Submit(cmd, NULL, 0, timeout_ms, NULL, NULL);
+}
+
+/**
+ * @brief 查询AT引擎是否有未完成指令
+ * @retval true: 忙, false: 空闲
+ */
+bool ESP_AT_Busy(void)
+{
+    return esp_at_count > 0;
+}
 
-    // 等待响应（简化版，实际应使用中断接收）
-    HAL_Delay(timeout_ms);
+/**
+ * @brief 设置URC处理回调
+ * @param handler: 回调函数，NULL表示不处理
+ */
+void ESP_AT_Set_URC_Handler(ESP_URC_Handler_t handler)
+{
+    esp_urc_handler = handler;
+}
 
-    return 0;
+/**
+ * @brief AT引擎任务：解析接收数据、发送排队指令、检查超时（事件任务）
+ * @note  由接收中断（整行或'>'）、ESP_AT_Submit和超时时刻唤醒
+ */
+void esp_at_task(void)
+{
+    uint32_t elapsed;
+    uint32_t wait;
+
+    ESP_AT_Process_RX();
+
+    // 取下一条指令开始发送
+    if (esp_at_state == AT_STATE_IDLE && esp_at_count > 0) {
+        esp_at_state = AT_STATE_SEND_CMD;
+        esp_at_start = HAL_GetTick();
+    }
+
+    if (esp_at_state == AT_STATE_SEND_CMD) {
+        ESP_AT_Cmd_t *cmd = &esp_at_queue[esp_at_tail];
+
+        // 上一次发送（如超时后中止的发送）未结束时返回HAL_BUSY，稍后重试
+        if (HAL_UART_Transmit_IT(&huart3, (uint8_t *)cmd->buf, cmd->cmd_len) == HAL_OK) {
+            esp_at_state = cmd->data_len ? AT_STATE_WAIT_PROMPT : AT_STATE_WAIT_RESP;
+        }
+    }
+
+    // 超时检查
+    if (esp_at_state != AT_STATE_IDLE) {
+        elapsed = HAL_GetTick() - esp_at_start;
+        if (elapsed >= esp_at_queue[esp_at_tail].timeout_ms) {
+            ESP_AT_Complete(ESP_AT_TIMEOUT);
+        } else {
+            // 在超时时刻唤醒（收到结束符时被接收中断提前唤醒，截止时刻随之撤销）；
+            // 发送忙时提前到重试间隔
+            wait = esp_at_queue[esp_at_tail].timeout_ms - elapsed;
+            if (esp_at_state == AT_STATE_SEND_CMD && wait > ESP_AT_RETRY_MS) {
+                wait = ESP_AT_RETRY_MS;
+            }
+            scheduler_notify_after(esp_at_task, wait);
+        }
+    }
+
+    // 本轮结束了一条指令且队列中还有：下一轮发送
+    if (esp_at_state == AT_STATE_IDLE && esp_at_count > 0) {
+        scheduler_notify(esp_at_task);
+    }
 }
 
+/**
+ * @brief UART3接收完成回调
+ * @param huart: UART句柄
+ */
+void ESP_UART_RxCpltCallback(UART_HandleTypeDef *huart)
+{
+    if (huart->Instance == USART3) {
+        uint16_t next = (esp_rx_head + 1) & (ESP_AT_RX_RING_SIZE - 1);
+
+        if (next != esp_rx_tail) {
+            esp_rx_ring[esp_rx_head] = esp_rx_byte;
+            esp_rx_head = next;
+        } else {
+            esp_data.rx_overflow++;
+        }
+
+        // 一行结束或出现提示符时唤醒AT引擎
+        if (esp_rx_byte == '\n' || esp_rx_byte == '>') {
+            scheduler_notify(esp_at_task);
+        }
+
+        // 继续接收下一个字节
+        HAL_UART_Receive_IT(&huart3, &esp_rx_byte, 1);
+    }
+}
+
+/**
+ * @brief UART3错误回调（在HAL_UART_ErrorCallback中调用）
+ * @note  溢出/噪声/帧错误时HAL已结束本次接收，在此立即重新启动，
+ *        不依赖esp_at_task运行；错误前的半行可能不完整，由行解析按URC丢弃
+ * @param huart: UART句柄
+ */
+void ESP_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+    if (huart->Instance == USART3) {
+        esp_data.rx_errors++;
+        if (huart->RxState == HAL_UART_STATE_READY) {
+            HAL_UART_Receive_IT(&huart3, &esp_rx_byte, 1);
+        }
+    }
+}
+
+/* ==================== 函数实现 ==================== */
+
 /**
  * @brief 初始化ESP01S模块
  * @retval 0: 成功, 1: 失败
@@ -44,20 +389,42 @@ uint8_t ESP_Init(void)
 {
     printf("ESP01S: Initializing...\r\n");
 
+    // 启动中断接收
+    HAL_UART_Receive_IT(&huart3, &esp_rx_byte, 1);
+
     // 测试AT指令
-    ESP_Send_AT("AT\r\n", 100);
+    ESP_Send_AT("AT\r\n", ESP_AT_TIMEOUT_SHORT);
+
+    // 关闭回显，避免指令回显干扰解析
+    ESP_Send_AT("ATE0\r\n", ESP_AT_TIMEOUT_SHORT);
 
     // 设置WiFi模式为Station
-    ESP_Send_AT("AT+CWMODE=1\r\n", 500);
+    ESP_Send_AT("AT+CWMODE=1\r\n", ESP_AT_TIMEOUT_SHORT);
 
-    printf("ESP01S: Init Success\r\n");
+    printf("ESP01S: Init Queued\r\n");
 
     return 0;
 }
 
+/**
+ * @brief WiFi连接指令完成回调
+ */
+static void ESP_WiFi_Callback(ESP_AT_Result_t result, void *ctx)
+{
+    if (result == ESP_AT_OK) {
+        esp_data.wifi_connected = true;
+        esp_data.status = ESP_WIFI_CONNECTED;
+        printf("ESP01S: WiFi Connected\r\n");
+    } else {
+        esp_data.wifi_connected = false;
+        esp_data.status = ESP_ERROR;
+        printf("ESP01S: WiFi Failed (%d)\r\n", result);
+    }
+}
+
 /**
  * @brief 连接WiFi
- * @retval 0: 成功, 1: 失败
+ * @retval 0: 已排队, 1: 失败
  */
 uint8_t ESP_Connect_WiFi(void)
 {
@@ -68,20 +435,35 @@ uint8_t ESP_Connect_WiFi(void)
     // 构建连接命令
     snprintf(cmd, sizeof(cmd), "AT+CWJAP=\"%s\",\"%s\"\r\n", WIFI_SSID, WIFI_PASSWORD);
 
-    // 发送连接命令（需要较长时间）
-    ESP_Send_AT(cmd, 5000);
-
-    esp_data.wifi_connected = true;
-    esp_data.status = ESP_WIFI_CONNECTED;
+    // 连接需要较长时间，结果在回调中处理
+    if (ESP_AT_Submit(cmd, NULL, 0, ESP_AT_TIMEOUT_CWJAP, ESP_WiFi_Callback, NULL)) {
+        return 1;
+    }
 
-    printf("ESP01S: WiFi Connected\r\n");
+    esp_data.status = ESP_WIFI_CONNECTING;
 
     return 0;
 }
 
+/**
+ * @brief MQTT连接指令完成回调
+ */
+static void ESP_MQTT_Callback(ESP_AT_Result_t result, void *ctx)
+{
+    if (result == ESP_AT_OK) {
+        esp_data.mqtt_connected = true;
+        esp_data.status = ESP_MQTT_CONNECTED;
+        printf("ESP01S: MQTT Connected\r\n");
+    } else {
+        esp_data.mqtt_connected = false;
+        esp_data.status = esp_data.wifi_connected ? ESP_WIFI_CONNECTED : ESP_ERROR;
+        printf("ESP01S: MQTT Failed (%d)\r\n", result);
+    }
+}
+
 /**
  * @brief 连接MQTT服务器
- * @retval 0: 成功, 1: 失败
+ * @retval 0: 已排队, 1: 失败
  */
 uint8_t ESP_Connect_MQTT(void)
 {
@@ -93,63 +475,149 @@ uint8_t ESP_Connect_MQTT(void)
     snprintf(cmd, sizeof(cmd),
              "AT+MQTTUSERCFG=0,1,\"NULL\",\"%s\",\"%s\",0,0,\"\"\r\n",
              MQTT_USERNAME, MQTT_PASSWORD);
-    ESP_Send_AT(cmd, 1000);
+    if (ESP_Send_AT(cmd, ESP_AT_TIMEOUT_MQTTCFG)) {
+        return 1;
+    }
 
     // 连接MQTT服务器
     snprintf(cmd, sizeof(cmd),
              "AT+MQTTCONN=0,\"%s\",%d,1\r\n",
              MQTT_SERVER, MQTT_PORT);
-    ESP_Send_AT(cmd, 3000);
-
-    esp_data.mqtt_connected = true;
-    esp_data.status = ESP_MQTT_CONNECTED;
+    if (ESP_AT_Submit(cmd, NULL, 0, ESP_AT_TIMEOUT_MQTTCONN, ESP_MQTT_Callback, NULL)) {
+        return 1;
+    }
 
-    printf("ESP01S: MQTT Connected\r\n");
+    esp_data.status = ESP_MQTT_CONNECTING;
 
     return 0;
 }
 
+/**
+ * @brief 发布指令完成回调
+ */
+static void ESP_Publish_Callback(ESP_AT_Result_t result, void *ctx)
+{
+    esp_publish_pending = false;
+
+    if (result == ESP_AT_OK) {
+        esp_data.publish_ok++;
+        if (esp_track_pending) {
+            TRACK_Consume(esp_track_next_seq);
+        }
+    } else {
+        esp_data.publish_fail++;
+    }
+}
+
 /**
  * @brief 发布MQTT消息
  * @param topic: 主题
  * @param payload: 消息内容（JSON格式）
- * @retval 0: 成功, 1: 失败
+ * @retval 0: 已排队, 1: 失败
  */
 uint8_t ESP_Publish_MQTT(char *topic, char *payload)
 {
-    char cmd[512];
+    char cmd[ESP_PUBRAW_CMD_LEN + 1];
+    uint16_t len = (uint16_t)strlen(payload);
 
-    // 构建发布命令
+    // 使用MQTTPUBRAW：收到'>'后发送原始数据，JSON中的引号和逗号无需转义
     snprintf(cmd, sizeof(cmd),
-             "AT+MQTTPUB=0,\"%s\",\"%s\",0,0\r\n",
-             topic, payload);
+             "AT+MQTTPUBRAW=0,\"%s\",%u,0,0\r\n",
+             topic, len);
 
-    ESP_Send_AT(cmd, 1000);
+    if (ESP_AT_Submit(cmd, (const uint8_t *)payload, len, ESP_AT_TIMEOUT_MQTTPUB,
+                      ESP_Publish_Callback, NULL)) {
+        return 1;
+    }
+
+    esp_publish_pending = true;
 
     return 0;
 }
 
 /**
- * @brief 上传传感器数据到云平台
- * @retval 0: 成功, 1: 失败
+ * @brief 向缓冲区追加格式化内容
+ * @param len: 已写入长度，小于0表示此前已溢出
+ * @retval 追加后的长度，放不下时返回-1
  */
-uint8_t ESP_Upload_Data(void)
+static int ESP_Append(char *buf, size_t size, int len, const char *fmt, ...)
+{
+    va_list args;
+    int n;
+
+    if (len < 0) {
+        return -1;
+    }
+
+    va_start(args, fmt);
+    n = vsnprintf(buf + len, size - (size_t)len, fmt, args);
+    va_end(args);
+
+    if (n < 0 || (size_t)n >= size - (size_t)len) {
+        return -1;
+    }
+    return len + n;
+}
+
+/**
+ * @brief 构建上传消息
+ * @param points: 附带的轨迹点
+ * @param count: 轨迹点数
+ * @retval 消息长度，缓冲区放不下时返回-1
+ */
+static int ESP_Build_Payload(char *buf, size_t size, const TRACK_Point_t *points, uint8_t count)
 {
-    char json_data[256];
+    int len;
+    uint8_t i;
 
     // 构建JSON格式数据（示例）
-    snprintf(json_data, sizeof(json_data),
-             "{\"services\":[{\"service_id\":\"BasicData\",\"properties\":{"
-             "\"temperature\":25,"
-             "\"humidity\":60,"
-             "\"heart_rate\":75,"
-             "\"fall_flag\":0"
-             "}}]}");
+    len = ESP_Append(buf, size, 0,
+                     "{\"services\":[{\"service_id\":\"BasicData\",\"properties\":{"
+                     "\"temperature\":25,"
+                     "\"humidity\":60,"
+                     "\"heart_rate\":75,"
+                     "\"fall_flag\":0");
+
+    // 附带抽稀后的轨迹点：[纬度1e-7度, 经度1e-7度, UTC当日秒数]
+    if (count > 0) {
+        len = ESP_Append(buf, size, len, ",\"track\":[");
+        for (i = 0; i < count; i++) {
+            len = ESP_Append(buf, size, len, "%s[%ld,%ld,%lu]",
+                             (i > 0) ? "," : "", (long)points[i].lat_e7,
+                             (long)points[i].lon_e7, (unsigned long)points[i].time);
+        }
+        len = ESP_Append(buf, size, len, "]");
+    }
 
-    // 发布到MQTT主题
-    ESP_Publish_MQTT((char *)MQTT_TOPIC, json_data);
+    return ESP_Append(buf, size, len, "}}]}");
+}
 
-    return 0;
+/**
+ * @brief 上传传感器数据到云平台
+ * @retval 0: 成功, 1: 失败
+ */
+uint8_t ESP_Upload_Data(void)
+{
+    char json_data[ESP_PAYLOAD_MAX_LEN];
+    TRACK_Point_t points[TRACK_UPLOAD_MAX];
+    uint8_t count = TRACK_UPLOAD_MAX;
+
+    // 消息放不下或指令被拒绝时少带一个轨迹点重试，
+    // 避免同一批点每次都失败导致轨迹上传永久停滞，基础数据照常上传
+    while (1) {
+        count = TRACK_Peek(points, count, &esp_track_next_seq);
+        esp_track_pending = (count > 0);
+
+        if (ESP_Build_Payload(json_data, sizeof(json_data), points, count) >= 0 &&
+            ESP_Publish_MQTT((char *)MQTT_TOPIC, json_data) == 0) {
+            return 0;
+        }
+        if (count == 0) {
+            esp_track_pending = false;
+            return 1;
+        }
+        count--;
+    }
 }
 
 /**
@@ -160,12 +628,19 @@ void ESP_Check_Connection(void)
     static uint32_t last_check = 0;
     uint32_t now = HAL_GetTick();
 
+    // 连接过程中不重复发起
+    if (esp_data.status == ESP_WIFI_CONNECTING || esp_data.status == ESP_MQTT_CONNECTING) {
+        return;
+    }
+
     // 每30秒检查一次
     if (now - last_check > 30000) {
         if (!esp_data.wifi_connected) {
+            esp_data.reconnect_count++;
             ESP_Connect_WiFi();
         }
-        if (esp_data.wifi_connected && !esp_data.mqtt_connected) {
+        if (!esp_data.mqtt_connected) {
+            // WiFi连接指令在前，排队执行；WiFi失败时MQTT连接返回ERROR
             ESP_Connect_MQTT();
         }
         last_check = now;
@@ -180,8 +655,8 @@ void esp_task(void)
     // 检查连接状态
     ESP_Check_Connection();
 
-    // 上传数据
-    if (esp_data.mqtt_connected) {
+    // 上传数据（上一次发布未完成时跳过，避免队列堆积）
+    if (esp_data.mqtt_connected && !esp_publish_pending) {
         ESP_Upload_Data();
     }
 }
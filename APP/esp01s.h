@@ -9,7 +9,8 @@
   *
   * ESP01S是基于ESP8266的WiFi模块
   * - 使用UART3通信（PB10-TX, PB11-RX, 115200波特率）
-  * - AT指令控制
+  * - AT指令控制：非阻塞AT引擎，指令排队发送，从接收环形缓冲区逐行解析
+  *   OK/ERROR/'>'提示符及URC，收到结束符或超时即完成并回调结果
   * - 支持MQTT协议
   *
   * ⚠️ 供电要求：
@@ -39,8 +40,47 @@
 #define MQTT_PASSWORD       "your_device_secret"
 #define MQTT_TOPIC          "$oc/devices/your_device_id/sys/properties/report"
 
+/* ==================== AT引擎参数 ==================== */
+
+#define ESP_AT_RX_RING_SIZE     512   // 接收环形缓冲区大小（2的幂）
+#define ESP_AT_LINE_MAX_LEN     128   // 单行响应最大长度（超长部分截断）
+#define ESP_PAYLOAD_MAX_LEN     256   // MQTT消息体最大长度（TRACK_UPLOAD_MAX=3个点最坏约235字节）
+#define ESP_PUBRAW_CMD_LEN      (sizeof("AT+MQTTPUBRAW=0,\"\",65535,0,0\r\n") - 1 + sizeof(MQTT_TOPIC) - 1)
+#define ESP_AT_CMD_MAX_LEN      (ESP_PUBRAW_CMD_LEN + ESP_PAYLOAD_MAX_LEN)  // 单条指令 + 附加数据最大长度（按实际主题长度计算）
+#define ESP_AT_QUEUE_SIZE       8     // 指令队列深度
+#define ESP_AT_RETRY_MS         2     // UART发送忙时重试间隔（毫秒）
+
+// 各指令超时（毫秒）
+#define ESP_AT_TIMEOUT_SHORT    500   // AT、ATE0、CWMODE等
+#define ESP_AT_TIMEOUT_CWJAP    20000 // 连接WiFi
+#define ESP_AT_TIMEOUT_MQTTCFG  2000  // MQTT用户配置
+#define ESP_AT_TIMEOUT_MQTTCONN 10000 // 连接MQTT服务器
+#define ESP_AT_TIMEOUT_MQTTPUB  5000  // 发布消息
+
 /* ==================== 数据结构 ==================== */
 
+/**
+ * @brief AT指令完成结果
+ */
+typedef enum {
+    ESP_AT_OK = 0,      // 收到OK / SEND OK / +MQTTPUB:OK
+    ESP_AT_ERROR,       // 收到ERROR / FAIL
+    ESP_AT_TIMEOUT      // 超时未收到结束符
+} ESP_AT_Result_t;
+
+/**
+ * @brief AT指令完成回调（在esp_at_task中调用）
+ * @param result: 完成结果
+ * @param ctx: 提交时传入的上下文
+ */
+typedef void (*ESP_AT_Callback_t)(ESP_AT_Result_t result, void *ctx);
+
+/**
+ * @brief URC（非请求结果码）处理回调
+ * @param line: 去掉行尾的一行响应
+ */
+typedef void (*ESP_URC_Handler_t)(const char *line);
+
 /**
  * @brief ESP01S状态
  */
@@ -61,6 +101,10 @@ typedef struct {
     bool wifi_connected;
     bool mqtt_connected;
     uint32_t reconnect_count;
+    uint32_t publish_ok;        // 发布成功次数
+    uint32_t publish_fail;      // 发布失败次数（ERROR或超时）
+    uint32_t rx_overflow;       // 接收环形缓冲区溢出丢弃字节数
+    uint32_t rx_errors;         // UART3接收错误（溢出/噪声/帧错误）次数
 } ESP_Data_t;
 
 /* ==================== 函数声明 ==================== */
@@ -84,13 +128,56 @@ uint8_t ESP_Connect_WiFi(void);
 uint8_t ESP_Connect_MQTT(void);
 
 /**
- * @brief 发送AT指令
- * @param cmd: AT指令字符串
+ * @brief 发送AT指令（非阻塞，仅排队，不关心结果）
+ * @param cmd: AT指令字符串（含\r\n）
  * @param timeout_ms: 超时时间（毫秒）
- * @retval 0: 成功, 1: 失败
+ * @retval 0: 已排队, 1: 队列满或指令过长
  */
 uint8_t ESP_Send_AT(char *cmd, uint32_t timeout_ms);
 
+/**
+ * @brief 提交AT指令到队列（非阻塞）
+ * @param cmd: AT指令字符串（含\r\n）
+ * @param data: 收到'>'提示符后发送的数据，无则为NULL
+ * @param data_len: 数据长度
+ * @param timeout_ms: 超时时间（毫秒），从指令开始发送计时
+ * @param cb: 完成回调，可为NULL
+ * @param ctx: 回调上下文
+ * @retval 0: 已排队, 1: 队列满或指令过长
+ */
+uint8_t ESP_AT_Submit(const char *cmd, const uint8_t *data, uint16_t data_len,
+                      uint32_t timeout_ms, ESP_AT_Callback_t cb, void *ctx);
+
+/**
+ * @brief 查询AT引擎是否有未完成指令
+ * @retval true: 忙, false: 空闲
+ */
+bool ESP_AT_Busy(void);
+
+/**
+ * @brief 设置URC处理回调（内置处理WiFi/MQTT连接状态后再调用）
+ * @param handler: 回调函数，NULL表示不处理
+ */
+void ESP_AT_Set_URC_Handler(ESP_URC_Handler_t handler);
+
+/**
+ * @brief AT引擎任务：解析接收数据、发送排队指令、检查超时
+ * @note  事件任务（scheduler_add_event_task），由接收中断、提交指令和超时时刻唤醒
+ */
+void esp_at_task(void);
+
+/**
+ * @brief UART3接收完成回调（在HAL_UART_RxCpltCallback中调用）
+ * @param huart: UART句柄
+ */
+void ESP_UART_RxCpltCallback(UART_HandleTypeDef *huart);
+
+/**
+ * @brief UART3错误回调（在HAL_UART_ErrorCallback中调用），重新启动接收
+ * @param huart: UART句柄
+ */
+void ESP_UART_ErrorCallback(UART_HandleTypeDef *huart);
+
 /**
  * @brief 发布MQTT消息
  * @param topic: 主题
@@ -0,0 +1,405 @@
+/**
+  ******************************************************************************
+  * @file           : geofence.c
+  * @brief          : 电子围栏（禁入区/危险区多边形检测）实现
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-10
+  ******************************************************************************
+  */
+
+#include "geofence.h"
+#include <stdio.h>
+#include <string.h>
+
+/* ==================== 全局变量 ==================== */
+
+static GEOFENCE_Zone_t geofence_zones[GEOFENCE_MAX_ZONES];
+static GEOFENCE_Point_t geofence_vertices[GEOFENCE_MAX_VERTICES];  // 全部区域共用的顶点池
+static uint16_t geofence_zone_count = 0;
+static uint16_t geofence_vertex_count = 0;
+
+// 网格索引（压缩行存储）：第c格的区域为cell_zones[cell_start[c] .. cell_start[c+1]-1]
+static uint16_t geofence_cell_start[GEOFENCE_GRID_DIM * GEOFENCE_GRID_DIM + 1];
+static uint16_t geofence_cell_zones[GEOFENCE_MAX_CELL_ENTRIES];
+static int32_t geofence_grid_min_lat;
+static int32_t geofence_grid_min_lon;
+static int64_t geofence_grid_span_lat;      // 网格覆盖范围（1e-7度，含端点）
+static int64_t geofence_grid_span_lon;
+static bool geofence_built = false;
+
+// 当前所在区域
+static uint16_t geofence_inside[GEOFENCE_MAX_INSIDE];
+static uint8_t geofence_inside_count = 0;
+
+static int32_t geofence_last_lat;
+static int32_t geofence_last_lon;
+static bool geofence_has_last = false;
+
+static GEOFENCE_Event_Handler_t geofence_handler = NULL;
+static GEOFENCE_Stats_t geofence_stats = {0};
+
+/* ==================== 内部函数 ==================== */
+
+/**
+ * @brief 点是否在区域外包矩形内
+ */
+static bool GEOFENCE_Bbox_Contains(const GEOFENCE_Zone_t *z, int32_t lat_e7, int32_t lon_e7)
+{
+    return lat_e7 >= z->min_lat && lat_e7 <= z->max_lat &&
+           lon_e7 >= z->min_lon && lon_e7 <= z->max_lon;
+}
+
+/**
+ * @brief 整数射线法判断点是否在多边形内（调用前已确认在外包矩形内）
+ * @note 坐标先平移到外包矩形左下角，差值小于2^30，叉积不会溢出int64
+ */
+static bool GEOFENCE_Polygon_Contains(const GEOFENCE_Zone_t *z, int32_t lat_e7, int32_t lon_e7)
+{
+    const GEOFENCE_Point_t *v = &geofence_vertices[z->first_vertex];
+    int64_t px = (int64_t)lon_e7 - z->min_lon;
+    int64_t py = (int64_t)lat_e7 - z->min_lat;
+    bool inside = false;
+    uint16_t i;
+    uint16_t j;
+
+    for (i = 0, j = z->vertex_count - 1; i < z->vertex_count; j = i++) {
+        int64_t xi = (int64_t)v[i].lon_e7 - z->min_lon;
+        int64_t yi = (int64_t)v[i].lat_e7 - z->min_lat;
+        int64_t xj = (int64_t)v[j].lon_e7 - z->min_lon;
+        int64_t yj = (int64_t)v[j].lat_e7 - z->min_lat;
+        int64_t cross = (xj - xi) * (py - yi) - (px - xi) * (yj - yi);
+
+        // 点在边上（共线且在线段范围内）：视为在区域内
+        if (cross == 0 &&
+            px >= (xi < xj ? xi : xj) && px <= (xi < xj ? xj : xi) &&
+            py >= (yi < yj ? yi : yj) && py <= (yi < yj ? yj : yi)) {
+            return true;
+        }
+
+        // 边跨过水平射线（半开区间，顶点不重复计数），且交点在点的右侧
+        if ((yi > py) != (yj > py)) {
+            if ((yj > yi) ? (cross > 0) : (cross < 0)) {
+                inside = !inside;
+            }
+        }
+    }
+
+    return inside;
+}
+
+/**
+ * @brief 坐标映射到网格行/列
+ * @param value: 坐标（1e-7度）
+ * @param min: 网格起点
+ * @param span: 网格跨度
+ * @retval 行/列号，超出网格返回-1
+ */
+static int16_t GEOFENCE_Grid_Index(int32_t value, int32_t min, int64_t span)
+{
+    int64_t offset = (int64_t)value - min;
+
+    if (offset < 0 || offset >= span) {
+        return -1;
+    }
+
+    return (int16_t)(offset * GEOFENCE_GRID_DIM / span);
+}
+
+/**
+ * @brief 当前是否在区域列表中
+ */
+static bool GEOFENCE_List_Has(const uint16_t *list, uint8_t count, uint16_t zone)
+{
+    uint8_t i;
+
+    for (i = 0; i < count; i++) {
+        if (list[i] == zone) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief 产生围栏事件
+ */
+static void GEOFENCE_Emit(uint16_t zone, GEOFENCE_Event_Type_t type, int32_t lat_e7, int32_t lon_e7)
+{
+    GEOFENCE_Event_t event;
+
+    event.zone = zone;
+    event.zone_type = (GEOFENCE_Zone_Type_t)geofence_zones[zone].type;
+    event.type = type;
+    event.lat_e7 = lat_e7;
+    event.lon_e7 = lon_e7;
+
+    geofence_stats.events++;
+
+    printf("GEOFENCE: %s %s zone %u\r\n",
+           (type == GEOFENCE_EVENT_ENTER) ? "Enter" : "Leave",
+           (event.zone_type == GEOFENCE_ZONE_RESTRICTED) ? "restricted" : "hazard",
+           (unsigned)zone);
+
+    if (geofence_handler != NULL) {
+        geofence_handler(&event);
+    }
+}
+
+/* ==================== 函数实现 ==================== */
+
+/**
+ * @brief 初始化（清空全部区域）
+ */
+void GEOFENCE_Init(void)
+{
+    geofence_zone_count = 0;
+    geofence_vertex_count = 0;
+    geofence_inside_count = 0;
+    geofence_has_last = false;
+    geofence_built = false;
+    memset(&geofence_stats, 0, sizeof(geofence_stats));
+}
+
+/**
+ * @brief 添加多边形区域（添加完成后需调用GEOFENCE_Build重建索引）
+ * @param vertices: 顶点数组（按顺序首尾相连，无需重复首点）
+ * @param count: 顶点数（至少3个）
+ * @param type: 区域类型
+ * @retval 区域编号，失败返回-1（容量不足、顶点不足或跨度过大）
+ */
+int16_t GEOFENCE_Add_Zone(const GEOFENCE_Point_t *vertices, uint16_t count, GEOFENCE_Zone_Type_t type)
+{
+    GEOFENCE_Zone_t *z;
+    uint16_t i;
+
+    if (count < 3 || geofence_zone_count >= GEOFENCE_MAX_ZONES ||
+        count > GEOFENCE_MAX_VERTICES - geofence_vertex_count) {
+        return -1;
+    }
+
+    z = &geofence_zones[geofence_zone_count];
+    z->min_lat = z->max_lat = vertices[0].lat_e7;
+    z->min_lon = z->max_lon = vertices[0].lon_e7;
+
+    // 预计算外包矩形
+    for (i = 1; i < count; i++) {
+        if (vertices[i].lat_e7 < z->min_lat) z->min_lat = vertices[i].lat_e7;
+        if (vertices[i].lat_e7 > z->max_lat) z->max_lat = vertices[i].lat_e7;
+        if (vertices[i].lon_e7 < z->min_lon) z->min_lon = vertices[i].lon_e7;
+        if (vertices[i].lon_e7 > z->max_lon) z->max_lon = vertices[i].lon_e7;
+    }
+
+    if ((int64_t)z->max_lat - z->min_lat >= GEOFENCE_MAX_SPAN ||
+        (int64_t)z->max_lon - z->min_lon >= GEOFENCE_MAX_SPAN) {
+        return -1;
+    }
+
+    memcpy(&geofence_vertices[geofence_vertex_count], vertices, count * sizeof(GEOFENCE_Point_t));
+    z->first_vertex = geofence_vertex_count;
+    z->vertex_count = count;
+    z->type = (uint8_t)type;
+
+    geofence_vertex_count += count;
+    geofence_built = false;
+
+    return (int16_t)geofence_zone_count++;
+}
+
+/**
+ * @brief 根据全部区域的外包矩形重建网格索引
+ * @retval 0: 成功, 1: 网格引用数超出GEOFENCE_MAX_CELL_ENTRIES
+ */
+uint8_t GEOFENCE_Build(void)
+{
+    static uint16_t fill[GEOFENCE_GRID_DIM * GEOFENCE_GRID_DIM];
+    int32_t max_lat;
+    int32_t max_lon;
+    uint32_t total = 0;
+    uint16_t c;
+    uint16_t z;
+    uint8_t pass;
+
+    geofence_built = false;
+    geofence_has_last = false;
+
+    if (geofence_zone_count == 0) {
+        return 0;
+    }
+
+    // 网格覆盖全部区域的外包矩形
+    geofence_grid_min_lat = geofence_zones[0].min_lat;
+    geofence_grid_min_lon = geofence_zones[0].min_lon;
+    max_lat = geofence_zones[0].max_lat;
+    max_lon = geofence_zones[0].max_lon;
+    for (z = 1; z < geofence_zone_count; z++) {
+        if (geofence_zones[z].min_lat < geofence_grid_min_lat) geofence_grid_min_lat = geofence_zones[z].min_lat;
+        if (geofence_zones[z].min_lon < geofence_grid_min_lon) geofence_grid_min_lon = geofence_zones[z].min_lon;
+        if (geofence_zones[z].max_lat > max_lat) max_lat = geofence_zones[z].max_lat;
+        if (geofence_zones[z].max_lon > max_lon) max_lon = geofence_zones[z].max_lon;
+    }
+    geofence_grid_span_lat = (int64_t)max_lat - geofence_grid_min_lat + 1;
+    geofence_grid_span_lon = (int64_t)max_lon - geofence_grid_min_lon + 1;
+
+    // 两遍：第一遍统计每格区域数并求前缀和，第二遍填入区域编号
+    memset(fill, 0, sizeof(fill));
+    for (pass = 0; pass < 2; pass++) {
+        for (z = 0; z < geofence_zone_count; z++) {
+            const GEOFENCE_Zone_t *zone = &geofence_zones[z];
+            int16_t r0 = GEOFENCE_Grid_Index(zone->min_lat, geofence_grid_min_lat, geofence_grid_span_lat);
+            int16_t r1 = GEOFENCE_Grid_Index(zone->max_lat, geofence_grid_min_lat, geofence_grid_span_lat);
+            int16_t c0 = GEOFENCE_Grid_Index(zone->min_lon, geofence_grid_min_lon, geofence_grid_span_lon);
+            int16_t c1 = GEOFENCE_Grid_Index(zone->max_lon, geofence_grid_min_lon, geofence_grid_span_lon);
+            int16_t r;
+            int16_t col;
+
+            for (r = r0; r <= r1; r++) {
+                for (col = c0; col <= c1; col++) {
+                    c = (uint16_t)(r * GEOFENCE_GRID_DIM + col);
+                    if (pass == 0) {
+                        fill[c]++;
+                    } else {
+                        geofence_cell_zones[geofence_cell_start[c] + fill[c]++] = z;
+                    }
+                }
+            }
+        }
+
+        if (pass == 0) {
+            for (c = 0; c < GEOFENCE_GRID_DIM * GEOFENCE_GRID_DIM; c++) {
+                geofence_cell_start[c] = (uint16_t)total;
+                total += fill[c];
+                fill[c] = 0;
+            }
+            geofence_cell_start[c] = (uint16_t)total;
+
+            if (total > GEOFENCE_MAX_CELL_ENTRIES) {
+                printf("GEOFENCE: Index overflow (%lu entries)\r\n", (unsigned long)total);
+                return 1;
+            }
+        }
+    }
+
+    geofence_built = true;
+    printf("GEOFENCE: %u zones, %lu grid entries\r\n", (unsigned)geofence_zone_count, (unsigned long)total);
+    return 0;
+}
+
+/**
+ * @brief 设置进入/离开事件回调
+ * @param handler: 回调函数，NULL表示只打印
+ */
+void GEOFENCE_Set_Event_Handler(GEOFENCE_Event_Handler_t handler)
+{
+    geofence_handler = handler;
+}
+
+/**
+ * @brief 用新的定位结果检测区域，进入/离开时产生事件
+ * @param data: GPS数据（仅fix_valid时检测，位置未变化时跳过）
+ */
+void GEOFENCE_Update(const GPS_Data_t *data)
+{
+    uint16_t now_inside[GEOFENCE_MAX_INSIDE];
+    uint8_t now_count = 0;
+    int32_t lat = data->lat_e7;
+    int32_t lon = data->lon_e7;
+    int16_t row;
+    int16_t col;
+    uint8_t i;
+
+    if (!geofence_built || !data->fix_valid) {
+        return;
+    }
+
+    if (geofence_has_last && lat == geofence_last_lat && lon == geofence_last_lon) {
+        return;
+    }
+    geofence_last_lat = lat;
+    geofence_last_lon = lon;
+    geofence_has_last = true;
+    geofence_stats.updates++;
+
+    // 只检查所在网格登记的区域；网格外不在任何区域内
+    row = GEOFENCE_Grid_Index(lat, geofence_grid_min_lat, geofence_grid_span_lat);
+    col = GEOFENCE_Grid_Index(lon, geofence_grid_min_lon, geofence_grid_span_lon);
+    if (row >= 0 && col >= 0) {
+        uint16_t c = (uint16_t)(row * GEOFENCE_GRID_DIM + col);
+        uint16_t k;
+
+        for (k = geofence_cell_start[c]; k < geofence_cell_start[c + 1]; k++) {
+            uint16_t z = geofence_cell_zones[k];
+
+            geofence_stats.candidates++;
+            if (!GEOFENCE_Bbox_Contains(&geofence_zones[z], lat, lon)) {
+                continue;
+            }
+
+            geofence_stats.polygon_tests++;
+            if (GEOFENCE_Polygon_Contains(&geofence_zones[z], lat, lon) &&
+                now_count < GEOFENCE_MAX_INSIDE) {
+                now_inside[now_count++] = z;
+            }
+        }
+    }
+
+    // 与上次结果比较，产生离开/进入事件
+    for (i = 0; i < geofence_inside_count; i++) {
+        if (!GEOFENCE_List_Has(now_inside, now_count, geofence_inside[i])) {
+            GEOFENCE_Emit(geofence_inside[i], GEOFENCE_EVENT_LEAVE, lat, lon);
+        }
+    }
+    for (i = 0; i < now_count; i++) {
+        if (!GEOFENCE_List_Has(geofence_inside, geofence_inside_count, now_inside[i])) {
+            GEOFENCE_Emit(now_inside[i], GEOFENCE_EVENT_ENTER, lat, lon);
+        }
+    }
+
+    memcpy(geofence_inside, now_inside, now_count * sizeof(uint16_t));
+    geofence_inside_count = now_count;
+}
+
+/**
+ * @brief 判断点是否在指定区域内（边上视为在内）
+ * @param zone: 区域编号
+ * @param lat_e7: 纬度（1e-7度）
+ * @param lon_e7: 经度（1e-7度）
+ * @retval true: 在区域内
+ */
+bool GEOFENCE_Zone_Contains(uint16_t zone, int32_t lat_e7, int32_t lon_e7)
+{
+    if (zone >= geofence_zone_count ||
+        !GEOFENCE_Bbox_Contains(&geofence_zones[zone], lat_e7, lon_e7)) {
+        return false;
+    }
+
+    return GEOFENCE_Polygon_Contains(&geofence_zones[zone], lat_e7, lon_e7);
+}
+
+/**
+ * @brief 当前是否位于指定区域内
+ * @param zone: 区域编号
+ * @retval true: 在区域内
+ */
+bool GEOFENCE_Is_Inside(uint16_t zone)
+{
+    return GEOFENCE_List_Has(geofence_inside, geofence_inside_count, zone);
+}
+
+/**
+ * @brief 当前所在区域数
+ * @retval 区域数
+ */
+uint8_t GEOFENCE_Inside_Count(void)
+{
+    return geofence_inside_count;
+}
+
+/**
+ * @brief 获取检测统计
+ * @retval 统计数据指针
+ */
+const GEOFENCE_Stats_t *GEOFENCE_Get_Stats(void)
+{
+    return &geofence_stats;
+}
@@ -0,0 +1,178 @@
+/**
+  ******************************************************************************
+  * @file           : geofence.h
+  * @brief          : 电子围栏（禁入区/危险区多边形检测）头文件
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-10
+  ******************************************************************************
+  * @attention
+  *
+  * 每次GPS定位更新时检测佩戴者是否位于施工现场的禁入区或危险区内：
+  * - 区域为多边形，顶点使用1e-7度定点坐标（与GPS_Data_t.lat_e7/lon_e7一致）
+  * - 添加区域时预计算外包矩形；GEOFENCE_Build()把全部区域映射到
+  *   GEOFENCE_GRID_DIM x GEOFENCE_GRID_DIM网格，每格只记录与其相交的区域
+  * - 定位时只检查所在网格的候选区域：先比外包矩形，再做整数射线法判断，
+  *   区域数量增加时单次检测开销基本不变
+  * - 位于多边形边上或顶点上视为在区域内
+  * - 进入/离开区域时产生事件
+  *
+  ******************************************************************************
+  */
+
+#ifndef __GEOFENCE_H
+#define __GEOFENCE_H
+
+#include "main.h"
+#include "atgm336h.h"
+#include <stdbool.h>
+
+/* ==================== 配置参数 ==================== */
+
+// 容量与网格参数，主机测试可在编译时覆盖（区域编号为int16_t，顶点与网格引用下标为uint16_t）
+#ifndef GEOFENCE_MAX_ZONES
+#define GEOFENCE_MAX_ZONES          256     // 最大区域数
+#endif
+#ifndef GEOFENCE_MAX_VERTICES
+#define GEOFENCE_MAX_VERTICES       1024    // 全部区域顶点总数上限
+#endif
+#ifndef GEOFENCE_GRID_DIM
+#define GEOFENCE_GRID_DIM           16      // 网格每边格数
+#endif
+#ifndef GEOFENCE_MAX_CELL_ENTRIES
+#define GEOFENCE_MAX_CELL_ENTRIES   2048    // 网格中区域引用总数上限
+#endif
+
+#if GEOFENCE_MAX_ZONES > 32767 || GEOFENCE_MAX_VERTICES > 65535 || GEOFENCE_MAX_CELL_ENTRIES > 65535
+#error "geofence capacity exceeds its 16-bit indices"
+#endif
+#define GEOFENCE_MAX_INSIDE         16      // 同时所在区域数上限
+#define GEOFENCE_MAX_SPAN           (1L << 30)  // 单个区域外包矩形最大跨度（1e-7度，约107度）
+
+/* ==================== 数据结构 ==================== */
+
+/**
+ * @brief 区域类型
+ */
+typedef enum {
+    GEOFENCE_ZONE_RESTRICTED = 0,   // 禁入区
+    GEOFENCE_ZONE_HAZARD            // 危险区
+} GEOFENCE_Zone_Type_t;
+
+/**
+ * @brief 围栏事件类型
+ */
+typedef enum {
+    GEOFENCE_EVENT_ENTER = 0,       // 进入区域
+    GEOFENCE_EVENT_LEAVE            // 离开区域
+} GEOFENCE_Event_Type_t;
+
+/**
+ * @brief 顶点坐标
+ */
+typedef struct {
+    int32_t lat_e7;     // 纬度（1e-7度）
+    int32_t lon_e7;     // 经度（1e-7度）
+} GEOFENCE_Point_t;
+
+/**
+ * @brief 区域
+ */
+typedef struct {
+    uint16_t first_vertex;  // 在顶点池中的起始位置
+    uint16_t vertex_count;  // 顶点数
+    uint8_t type;           // GEOFENCE_Zone_Type_t
+    int32_t min_lat;        // 外包矩形
+    int32_t max_lat;
+    int32_t min_lon;
+    int32_t max_lon;
+} GEOFENCE_Zone_t;
+
+/**
+ * @brief 围栏事件
+ */
+typedef struct {
+    uint16_t zone;                  // 区域编号
+    GEOFENCE_Zone_Type_t zone_type; // 区域类型
+    GEOFENCE_Event_Type_t type;     // 进入/离开
+    int32_t lat_e7;                 // 触发时的位置
+    int32_t lon_e7;
+} GEOFENCE_Event_t;
+
+/**
+ * @brief 围栏事件回调
+ */
+typedef void (*GEOFENCE_Event_Handler_t)(const GEOFENCE_Event_t *event);
+
+/**
+ * @brief 检测统计
+ */
+typedef struct {
+    uint32_t updates;       // 定位检测次数
+    uint32_t candidates;    // 累计检查的候选区域数（网格筛选后）
+    uint32_t polygon_tests; // 累计多边形精确判断次数（外包矩形命中后）
+    uint32_t events;        // 累计产生的事件数
+} GEOFENCE_Stats_t;
+
+/* ==================== 函数声明 ==================== */
+
+/**
+ * @brief 初始化（清空全部区域）
+ */
+void GEOFENCE_Init(void);
+
+/**
+ * @brief 添加多边形区域（添加完成后需调用GEOFENCE_Build重建索引）
+ * @param vertices: 顶点数组（按顺序首尾相连，无需重复首点）
+ * @param count: 顶点数（至少3个）
+ * @param type: 区域类型
+ * @retval 区域编号，失败返回-1（容量不足、顶点不足或跨度过大）
+ */
+int16_t GEOFENCE_Add_Zone(const GEOFENCE_Point_t *vertices, uint16_t count, GEOFENCE_Zone_Type_t type);
+
+/**
+ * @brief 根据全部区域的外包矩形重建网格索引
+ * @retval 0: 成功, 1: 网格引用数超出GEOFENCE_MAX_CELL_ENTRIES
+ */
+uint8_t GEOFENCE_Build(void);
+
+/**
+ * @brief 设置进入/离开事件回调
+ * @param handler: 回调函数，NULL表示只打印
+ */
+void GEOFENCE_Set_Event_Handler(GEOFENCE_Event_Handler_t handler);
+
+/**
+ * @brief 用新的定位结果检测区域，进入/离开时产生事件
+ * @param data: GPS数据（仅fix_valid时检测，位置未变化时跳过）
+ */
+void GEOFENCE_Update(const GPS_Data_t *data);
+
+/**
+ * @brief 判断点是否在指定区域内（边上视为在内）
+ * @param zone: 区域编号
+ * @param lat_e7: 纬度（1e-7度）
+ * @param lon_e7: 经度（1e-7度）
+ * @retval true: 在区域内
+ */
+bool GEOFENCE_Zone_Contains(uint16_t zone, int32_t lat_e7, int32_t lon_e7);
+
+/**
+ * @brief 当前是否位于指定区域内
+ * @param zone: 区域编号
+ * @retval true: 在区域内
+ */
+bool GEOFENCE_Is_Inside(uint16_t zone);
+
+/**
+ * @brief 当前所在区域数
+ * @retval 区域数
+ */
+uint8_t GEOFENCE_Inside_Count(void);
+
+/**
+ * @brief 获取检测统计
+ * @retval 统计数据指针
+ */
+const GEOFENCE_Stats_t *GEOFENCE_Get_Stats(void);
+
+#endif /* __GEOFENCE_H */
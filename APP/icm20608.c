@@ -8,6 +8,7 @@
   */
 
 #include "icm20608.h"
+#include "scheduler.h"
 #include <stdio.h>
 
 /* ==================== Global Variables ==================== */
@@ -104,12 +105,17 @@ uint8_t ICM20608_Init(I2C_HandleTypeDef *hi2c) {
         return 6;
     }
 
-    // Step 6: Set sample rate divider (optional, default 1kHz)
-    // CONFIG register: DLPF_CFG = 0 (Accel: 460Hz, Gyro: 250Hz)
-    temp = 0x00;
+    // Step 6: Set output data rate to 100Hz
+    // CONFIG register: DLPF_CFG = 3 (Gyro: 41Hz, 1kHz internal rate)
+    // Data-ready fires at 1kHz / (1 + SMPLRT_DIV); each one wakes icm20608_task
+    temp = ICM20608_DLPF_CFG_41HZ;
     if(ICM20608_WriteReg(hi2c, ICM20608_CONFIG, temp) != HAL_OK) {
         return 7;
     }
+    temp = ICM20608_DEFAULT_SMPLRT_DIV;
+    if(ICM20608_WriteReg(hi2c, ICM20608_SMPLRT_DIV, temp) != HAL_OK) {
+        return 7;
+    }
 
     // Step 7: Enable all axes
     temp = 0x00;  // PWR_MGMT_2: Enable all sensors
@@ -239,8 +245,9 @@ uint8_t ICM20608_DetectFall(ICM20608_Data_t *data, float threshold) {
 uint8_t ICM20608_EnableInterrupt(I2C_HandleTypeDef *hi2c) {
     uint8_t temp;
 
-    // Configure INT pin (active low, push-pull, latched)
-    temp = 0xA0;  // INT_PIN_CFG: LATCH_INT_EN | INT_RD_CLEAR
+    // Configure INT pin (active high, push-pull, 50us pulse)
+    // Matches the PA15 rising-edge EXTI; a pulse cannot stay latched if a read is missed
+    temp = 0x00;  // INT_PIN_CFG: ACTL=0, OPEN=0, LATCH_INT_EN=0
     if(ICM20608_WriteReg(hi2c, ICM20608_INT_PIN_CFG, temp) != HAL_OK) {
         return 1;
     }
@@ -282,12 +289,11 @@ void icm20608_task(void) {
 
 /**
  * @brief  EXTI callback for PA15 interrupt (data ready)
- *         Add this to stm32f1xx_it.c: HAL_GPIO_EXTI_Callback()
+ *         Call this from HAL_GPIO_EXTI_Callback() in main.c
  */
-void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin) {
+void ICM20608_EXTI_Callback(uint16_t GPIO_Pin) {
     if(GPIO_Pin == GPIO_PIN_15) {  // PA15: ICM-20608-G INT
-        // Interrupt triggered, data is ready
-        // Set a flag or call icm20608_task() directly
-        icm20608_task();
+        // Data is ready: defer the I2C read to the scheduler loop
+        scheduler_notify(icm20608_task);
     }
 }
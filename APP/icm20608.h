@@ -14,7 +14,7 @@
 #ifndef __ICM20608_H
 #define __ICM20608_H
 
-#include "stm32f1xx_hal.h"
+#include "main.h"
 #include <math.h>
 
 /* ==================== ICM-20608-G Register Addresses ==================== */
@@ -26,6 +26,7 @@
 #define ICM20608_PWR_MGMT_2         0x6C    // Power Management 2
 
 // Configuration
+#define ICM20608_SMPLRT_DIV         0x19    // Sample Rate Divider
 #define ICM20608_CONFIG             0x1A    // Configuration
 #define ICM20608_GYRO_CONFIG        0x1B    // Gyroscope Configuration
 #define ICM20608_ACCEL_CONFIG       0x1C    // Accelerometer Configuration
@@ -80,6 +81,10 @@
 #define ICM20608_ACCEL_FS_8G        0x10    // ±8g
 #define ICM20608_ACCEL_FS_16G       0x18    // ±16g
 
+// Output data rate: 1kHz internal rate (DLPF_CFG=3, gyro BW 41Hz) / (1 + SMPLRT_DIV)
+#define ICM20608_DLPF_CFG_41HZ      0x03
+#define ICM20608_DEFAULT_SMPLRT_DIV 9       // 100Hz data-ready rate
+
 // Default full scale ranges
 #define ICM20608_DEFAULT_GYRO_FS    ICM20608_GYRO_FS_2000    // ±2000 °/s
 #define ICM20608_DEFAULT_ACCEL_FS   ICM20608_ACCEL_FS_16G    // ±16g
@@ -197,12 +202,19 @@ uint8_t ICM20608_DetectFall(ICM20608_Data_t *data, float threshold);
 uint8_t ICM20608_EnableInterrupt(I2C_HandleTypeDef *hi2c);
 
 /**
- * @brief  Task function for scheduler (call every 100ms)
+ * @brief  Task function for scheduler (event task, woken by data-ready EXTI)
  * @param  None
  * @retval None
  */
 void icm20608_task(void);
 
+/**
+ * @brief  Data-ready EXTI callback, wakes icm20608_task via scheduler_notify()
+ * @param  GPIO_Pin: EXTI pin that fired
+ * @retval None
+ */
+void ICM20608_EXTI_Callback(uint16_t GPIO_Pin);
+
 /* ==================== Global Variables (extern) ==================== */
 extern I2C_HandleTypeDef hi2c1;             // I2C handle defined in main.c
 extern ICM20608_Data_t icm_data;            // Global sensor data
@@ -226,9 +238,12 @@ extern uint8_t fall_flag;                   // Fall detection flag
  *         // Error handling
  *     }
  *
+ *     // Event-driven: HAL_GPIO_EXTI_Callback() calls ICM20608_EXTI_Callback()
+ *     scheduler_add_event_task(icm20608_task);
+ *
  *     // In scheduler
  *     while(1) {
- *         icm20608_task();  // Call every 100ms
+ *         scheduler_run();
  *
  *         if(fall_flag) {
  *             // Handle fall event
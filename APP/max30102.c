@@ -9,10 +9,15 @@
   *
   * 本驱动实现了MAX30102的完整功能：
   * 1. 软件I2C通信（PB14-SDA, PB15-SCL）
-  * 2. FIFO数据读取
+  * 2. FIFO数据读取（按读写指针突发读取）
   * 3. 三级滤波算法（硬件滤波 + 滑动平均 + 低通滤波）
   * 4. 心率血氧计算
   * 5. 报警检测
+  * 6. TIM1更新中断驱动的异步软件I2C引擎，寄存器读写为其阻塞封装
+  * 7. 流式心率血氧估计：逐样本O(1)更新，每次心跳输出结果
+  * 8. 定点DSP前端（ppg_filter）：去直流 + 0.5~4Hz带通，供流式估计和批量计算使用
+  * 9. INT引脚中断采集（PB13）：A_FULL/PPG_RDY中断置挂起标志并唤醒事件任务，
+  *    任务中启动异步排空，读完后再次唤醒任务处理样本
   *
   * 核心优化：
   * - LED电流从7mA优化到24mA，提升信噪比
@@ -24,11 +29,16 @@
   */
 
 #include "max30102.h"
+#include "scheduler.h"
 #include "tim.h"
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
 
+#if MAX30102_SAMPLE_RATE != PPG_FILTER_FS
+#error "PPG带通系数按PPG_FILTER_FS设计，须与MAX30102_SAMPLE_RATE一致"
+#endif
+
 /* ==================== 引脚定义 ==================== */
 
 // 软件I2C引脚定义（使用PB14/PB15）
@@ -55,13 +65,75 @@
 /* ==================== 全局变量 ==================== */
 
 static MAX30102_Data_t max30102_data = {0};  // 传感器数据
+static MAX30102_Stream_t max30102_stream;     // 流式心率血氧估计器
+
+// PPG定点DSP前端（去直流 + 带通）
+static PPG_Filter_t ppg_filter;
 
 // 滑动平均滤波缓冲区
 static int32_t hr_ma_buffer[MAX30102_MA_SIZE] = {0};
 static uint8_t hr_ma_index = 0;
-
-// 低通滤波上一次的值
-static int32_t hr_prev_filtered = 0;
+static int32_t hr_ma_sum = 0;
+
+// 低通滤波上一次的值（Q8）
+static int32_t hr_prev_filtered_q8 = 0;
+
+// 软件I2C总线累计传输字节数（用于评估总线开销）
+static uint32_t bus_byte_count = 0;
+
+/* ==================== 异步I2C引擎状态 ==================== */
+
+// 事务阶段
+typedef enum {
+    I2C_STAGE_START = 0,    // 起始信号
+    I2C_STAGE_ADDR_W,       // 器件地址+写
+    I2C_STAGE_REG,          // 寄存器地址
+    I2C_STAGE_WRITE,        // 写数据
+    I2C_STAGE_RESTART,      // 重复起始
+    I2C_STAGE_ADDR_R,       // 器件地址+读
+    I2C_STAGE_READ,         // 读数据
+    I2C_STAGE_STOP          // 停止信号
+} I2C_Stage_t;
+
+// 异步事务描述
+typedef struct {
+    uint8_t reg_addr;
+    bool is_read;
+    uint8_t *buf;
+    uint32_t len;
+    MAX30102_I2C_Callback_t cb;
+    void *ctx;
+} I2C_Xfer_t;
+
+// 引擎运行状态（中断与主循环共享）
+static I2C_Xfer_t i2c_queue[MAX30102_ASYNC_QUEUE_SIZE];
+static volatile uint8_t i2c_queue_head = 0;   // 入队位置
+static volatile uint8_t i2c_queue_tail = 0;   // 当前执行事务
+static volatile uint8_t i2c_queue_count = 0;
+
+static I2C_Stage_t i2c_stage;     // 当前阶段
+static uint8_t i2c_step;          // 起始/停止信号内的节拍序号
+static uint8_t i2c_bit;           // 字节内位序号（0~7数据，8应答）
+static uint8_t i2c_phase;         // 位内节拍（0: 待拉低SCL, 1: 待释放SCL, 2: SCL高电平待采样）
+static uint8_t i2c_shift;         // 移位寄存器
+static uint32_t i2c_index;        // 数据字节序号
+static uint8_t i2c_status;        // 事务结果（0: 成功, 1: 无应答）
+
+// 阻塞封装使用的完成标志
+static volatile bool i2c_sync_done;
+static volatile uint8_t i2c_sync_status;
+
+// 任务异步读取FIFO使用的缓冲区
+static uint8_t fifo_ptr_raw[3];
+static uint8_t fifo_raw[MAX30102_FIFO_DEPTH * MAX30102_FIFO_SAMPLE_BYTES];
+static volatile uint32_t fifo_raw_count = 0;   // fifo_raw中的样本数
+static volatile bool fifo_raw_ready = false;   // 数据已读完待处理
+static volatile bool fifo_async_busy = false;  // 异步读取进行中
+
+// 中断采集状态
+static uint8_t int_status_raw[2];                     // INT_STATUS_1/2
+static volatile bool int_pending = false;             // INT引脚中断挂起
+static volatile uint32_t fifo_overflow_count = 0;     // FIFO累计溢出样本数
 
 /* ==================== 软件I2C实现 ==================== */
 
@@ -84,6 +156,21 @@ void MAX30102_I2C_Init(void)
     MAX30102_SCL_H();
 }
 
+/**
+ * @brief INT引脚初始化（开漏低有效，下降沿触发EXTI）
+ */
+static void MAX30102_INT_Init(void)
+{
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+    GPIO_InitStruct.Pin = MAX30102_INT_PIN;
+    GPIO_InitStruct.Mode = GPIO_MODE_IT_FALLING;
+    GPIO_InitStruct.Pull = GPIO_PULLUP;
+    HAL_GPIO_Init(MAX30102_INT_GPIO_PORT, &GPIO_InitStruct);
+
+    // EXTI13与ICM_INT共用EXTI15_10中断，已在MX_GPIO_Init中使能
+}
+
 /**
  * @brief 软件I2C起始信号
  * SCL高电平期间，SDA由高到低跳变
@@ -121,6 +208,8 @@ uint8_t MAX30102_I2C_Send_Byte(uint8_t byte)
     uint8_t i;
     uint8_t ack;
 
+    bus_byte_count++;
+
     // 发送8位数据
     for (i = 0; i < 8; i++) {
         MAX30102_SCL_L();
@@ -162,6 +251,8 @@ uint8_t MAX30102_I2C_Recv_Byte(uint8_t ack)
     uint8_t i;
     uint8_t byte = 0;
 
+    bus_byte_count++;
+
     MAX30102_SDA_H();  // 释放SDA
 
     // 接收8位数据
@@ -197,6 +288,391 @@ uint8_t MAX30102_I2C_Recv_Byte(uint8_t ack)
     return byte;
 }
 
+/* ==================== 异步软件I2C引擎 ==================== */
+
+/**
+ * @brief 启动TIM1节拍中断
+ * @note  引擎忙期间TIM1自动重装值改为节拍周期，空闲时恢复为自由计数供延时宏使用
+ */
+static void I2C_Async_Timer_Start(void)
+{
+    __HAL_TIM_SET_AUTORELOAD(&htim1, MAX30102_ASYNC_TICK_US - 1);
+    __HAL_TIM_SET_COUNTER(&htim1, 0);
+    __HAL_TIM_CLEAR_FLAG(&htim1, TIM_FLAG_UPDATE);
+    __HAL_TIM_ENABLE_IT(&htim1, TIM_IT_UPDATE);
+}
+
+/**
+ * @brief 停止TIM1节拍中断
+ */
+static void I2C_Async_Timer_Stop(void)
+{
+    __HAL_TIM_DISABLE_IT(&htim1, TIM_IT_UPDATE);
+    __HAL_TIM_SET_AUTORELOAD(&htim1, 0xFFFF);
+    __HAL_TIM_CLEAR_FLAG(&htim1, TIM_FLAG_UPDATE);
+}
+
+/**
+ * @brief 开始执行队首事务
+ */
+static void I2C_Async_Begin(void)
+{
+    i2c_stage = I2C_STAGE_START;
+    i2c_step = 0;
+    i2c_bit = 0;
+    i2c_phase = 0;
+    i2c_index = 0;
+    i2c_status = 0;
+}
+
+/**
+ * @brief 事务入队
+ * @retval 0: 已入队, 1: 队列已满
+ */
+static uint8_t I2C_Async_Submit(uint8_t reg_addr, bool is_read, uint8_t *buf, uint32_t len,
+                                MAX30102_I2C_Callback_t cb, void *ctx)
+{
+    uint32_t primask = __get_PRIMASK();
+    I2C_Xfer_t *xfer;
+
+    __disable_irq();
+
+    if (i2c_queue_count >= MAX30102_ASYNC_QUEUE_SIZE) {
+        __set_PRIMASK(primask);
+        return 1;
+    }
+
+    xfer = &i2c_queue[i2c_queue_head];
+    xfer->reg_addr = reg_addr;
+    xfer->is_read = is_read;
+    xfer->buf = buf;
+    xfer->len = len;
+    xfer->cb = cb;
+    xfer->ctx = ctx;
+
+    i2c_queue_head = (i2c_queue_head + 1) % MAX30102_ASYNC_QUEUE_SIZE;
+    i2c_queue_count++;
+
+    // 队列由空变为非空时启动引擎
+    if (i2c_queue_count == 1) {
+        I2C_Async_Begin();
+        I2C_Async_Timer_Start();
+    }
+
+    __set_PRIMASK(primask);
+
+    return 0;
+}
+
+/**
+ * @brief 当前事务结束：回调通知并启动下一事务
+ */
+static void I2C_Async_Complete(void)
+{
+    I2C_Xfer_t xfer = i2c_queue[i2c_queue_tail];
+
+    i2c_queue_tail = (i2c_queue_tail + 1) % MAX30102_ASYNC_QUEUE_SIZE;
+    i2c_queue_count--;
+
+    if (i2c_queue_count > 0) {
+        I2C_Async_Begin();
+    } else {
+        I2C_Async_Timer_Stop();
+    }
+
+    // 回调中允许提交新事务
+    if (xfer.cb != NULL) {
+        xfer.cb(i2c_status, xfer.ctx);
+    }
+}
+
+/**
+ * @brief 进入下一个字节阶段
+ * @param stage: 新阶段
+ * @param byte: 待发送字节（读阶段忽略）
+ */
+static void I2C_Async_Next_Byte(I2C_Stage_t stage, uint8_t byte)
+{
+    i2c_stage = stage;
+    i2c_shift = byte;
+    i2c_bit = 0;
+    i2c_phase = 0;
+    bus_byte_count++;
+}
+
+/**
+ * @brief 当前字节（含应答位）传输完毕后的阶段切换
+ * @param xfer: 当前事务
+ */
+static void I2C_Async_Byte_Done(I2C_Xfer_t *xfer)
+{
+    // 写方向收到NACK：终止事务
+    if (i2c_stage != I2C_STAGE_READ && i2c_status) {
+        i2c_stage = I2C_STAGE_STOP;
+        i2c_step = 0;
+        return;
+    }
+
+    switch (i2c_stage) {
+        case I2C_STAGE_ADDR_W:
+            I2C_Async_Next_Byte(I2C_STAGE_REG, xfer->reg_addr);
+            break;
+
+        case I2C_STAGE_REG:
+            if (xfer->is_read) {
+                i2c_stage = I2C_STAGE_RESTART;
+                i2c_step = 0;
+            } else if (xfer->len > 0) {
+                I2C_Async_Next_Byte(I2C_STAGE_WRITE, xfer->buf[0]);
+            } else {
+                i2c_stage = I2C_STAGE_STOP;
+                i2c_step = 0;
+            }
+            break;
+
+        case I2C_STAGE_WRITE:
+            i2c_index++;
+            if (i2c_index < xfer->len) {
+                I2C_Async_Next_Byte(I2C_STAGE_WRITE, xfer->buf[i2c_index]);
+            } else {
+                i2c_stage = I2C_STAGE_STOP;
+                i2c_step = 0;
+            }
+            break;
+
+        case I2C_STAGE_ADDR_R:
+            I2C_Async_Next_Byte(I2C_STAGE_READ, 0);
+            break;
+
+        case I2C_STAGE_READ:
+            xfer->buf[i2c_index++] = i2c_shift;
+            if (i2c_index < xfer->len) {
+                I2C_Async_Next_Byte(I2C_STAGE_READ, 0);
+            } else {
+                i2c_stage = I2C_STAGE_STOP;
+                i2c_step = 0;
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief 引擎节拍（TIM1更新中断中调用）
+ *
+ * 每个位占2个节拍：低电平节拍拉低SCL并设置SDA，高电平节拍释放SCL；
+ * 需要采样的位在下一个节拍开始、拉低SCL之前读取SDA，保证SCL高电平保持完整节拍。
+ * 起始/停止信号各占3个节拍。
+ */
+static void I2C_Async_Tick(void)
+{
+    I2C_Xfer_t *xfer;
+
+    if (i2c_queue_count == 0) {
+        I2C_Async_Timer_Stop();
+        return;
+    }
+
+    xfer = &i2c_queue[i2c_queue_tail];
+
+    // 字节阶段：处理上一高电平节拍的采样
+    if (i2c_stage != I2C_STAGE_START && i2c_stage != I2C_STAGE_RESTART &&
+        i2c_stage != I2C_STAGE_STOP && i2c_phase == 2) {
+        uint8_t sda = (MAX30102_SDA_READ() == GPIO_PIN_SET) ? 1 : 0;
+
+        if (i2c_bit < 8) {
+            if (i2c_stage == I2C_STAGE_READ) {
+                i2c_shift = (uint8_t)((i2c_shift << 1) | sda);
+            } else {
+                i2c_shift <<= 1;
+            }
+        } else if (i2c_stage != I2C_STAGE_READ) {
+            i2c_status |= sda;  // 应答位：0=ACK
+        }
+
+        i2c_phase = 0;
+        i2c_bit++;
+
+        if (i2c_bit > 8) {
+            I2C_Async_Byte_Done(xfer);
+        }
+    }
+
+    switch (i2c_stage) {
+        case I2C_STAGE_START:
+        case I2C_STAGE_RESTART:
+            if (i2c_step == 0) {
+                MAX30102_SCL_L();
+                MAX30102_SDA_H();
+            } else if (i2c_step == 1) {
+                MAX30102_SCL_H();
+            } else {
+                MAX30102_SDA_L();  // SCL高电平期间SDA下降沿
+                I2C_Async_Next_Byte(i2c_stage == I2C_STAGE_START ? I2C_STAGE_ADDR_W : I2C_STAGE_ADDR_R,
+                                    i2c_stage == I2C_STAGE_START ? MAX30102_I2C_ADDR : (MAX30102_I2C_ADDR | 0x01));
+                break;
+            }
+            i2c_step++;
+            break;
+
+        case I2C_STAGE_STOP:
+            if (i2c_step == 0) {
+                MAX30102_SCL_L();
+                MAX30102_SDA_L();
+            } else if (i2c_step == 1) {
+                MAX30102_SCL_H();
+            } else {
+                MAX30102_SDA_H();  // SCL高电平期间SDA上升沿
+                I2C_Async_Complete();
+                break;
+            }
+            i2c_step++;
+            break;
+
+        default:
+            if (i2c_phase == 0) {
+                // 低电平节拍：拉低SCL，设置SDA
+                MAX30102_SCL_L();
+                if (i2c_bit < 8) {
+                    if (i2c_stage == I2C_STAGE_READ || (i2c_shift & 0x80) != 0) {
+                        MAX30102_SDA_H();
+                    } else {
+                        MAX30102_SDA_L();
+                    }
+                } else if (i2c_stage == I2C_STAGE_READ && i2c_index + 1 < xfer->len) {
+                    MAX30102_SDA_L();  // 主机ACK
+                } else {
+                    MAX30102_SDA_H();  // 释放SDA等待从机应答 / 最后一字节NACK
+                }
+            } else {
+                // 高电平节拍：释放SCL，下一节拍采样
+                MAX30102_SCL_H();
+            }
+            i2c_phase++;
+            break;
+    }
+}
+
+/**
+ * @brief 提交异步写事务
+ * @retval 0: 已入队, 1: 队列已满
+ */
+uint8_t MAX30102_I2C_Async_Write(uint8_t reg_addr, const uint8_t *buf, uint32_t len,
+                                 MAX30102_I2C_Callback_t cb, void *ctx)
+{
+    return I2C_Async_Submit(reg_addr, false, (uint8_t *)buf, len, cb, ctx);
+}
+
+/**
+ * @brief 提交异步读事务
+ * @retval 0: 已入队, 1: 队列已满
+ */
+uint8_t MAX30102_I2C_Async_Read(uint8_t reg_addr, uint8_t *buf, uint32_t len,
+                                MAX30102_I2C_Callback_t cb, void *ctx)
+{
+    if (len == 0) {
+        return 1;
+    }
+
+    return I2C_Async_Submit(reg_addr, true, buf, len, cb, ctx);
+}
+
+/**
+ * @brief 查询异步引擎是否忙
+ * @retval true: 有事务在执行或排队
+ */
+bool MAX30102_I2C_Async_Busy(void)
+{
+    return i2c_queue_count != 0;
+}
+
+/**
+ * @brief TIM1更新中断回调
+ * @param htim: 定时器句柄
+ */
+void MAX30102_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
+{
+    if (htim->Instance == TIM1) {
+        I2C_Async_Tick();
+    }
+}
+
+/**
+ * @brief 终止引擎：排队事务全部以失败状态回调，并恢复总线
+ * @note  回调在调用者上下文执行；先取出全部事务再回调，回调中可提交新事务
+ */
+static void I2C_Async_Abort(void)
+{
+    I2C_Xfer_t aborted[MAX30102_ASYNC_QUEUE_SIZE];
+    uint8_t count;
+    uint8_t i;
+
+    __disable_irq();
+    I2C_Async_Timer_Stop();
+    count = i2c_queue_count;
+    for (i = 0; i < count; i++) {
+        aborted[i] = i2c_queue[(i2c_queue_tail + i) % MAX30102_ASYNC_QUEUE_SIZE];
+    }
+    i2c_queue_head = 0;
+    i2c_queue_tail = 0;
+    i2c_queue_count = 0;
+    __enable_irq();
+
+    // 事务可能停在从机发送0位或应答位处：释放SDA后补时钟直到从机放开SDA，再发STOP
+    MAX30102_SCL_L();
+    MAX30102_DELAY_US(5);
+    MAX30102_SDA_H();
+    MAX30102_DELAY_US(5);
+    for (i = 0; i < 9 && MAX30102_SDA_READ() == GPIO_PIN_RESET; i++) {
+        MAX30102_SCL_H();
+        MAX30102_DELAY_US(5);
+        MAX30102_SCL_L();
+        MAX30102_DELAY_US(5);
+    }
+    MAX30102_SDA_L();
+    MAX30102_DELAY_US(5);
+    MAX30102_SCL_H();
+    MAX30102_DELAY_US(5);
+    MAX30102_SDA_H();
+
+    // 逐个以失败状态完成，释放调用方的占用标志（如fifo_async_busy）
+    for (i = 0; i < count; i++) {
+        if (aborted[i].cb != NULL) {
+            aborted[i].cb(1, aborted[i].ctx);
+        }
+    }
+}
+
+/**
+ * @brief 阻塞封装的完成回调
+ */
+static void I2C_Sync_Callback(uint8_t status, void *ctx)
+{
+    i2c_sync_status = status;
+    i2c_sync_done = true;
+}
+
+/**
+ * @brief 等待阻塞封装提交的事务完成
+ * @retval 0: 成功, 1: 失败或超时
+ */
+static uint8_t I2C_Sync_Wait(void)
+{
+    uint32_t start = HAL_GetTick();
+
+    while (!i2c_sync_done) {
+        if (HAL_GetTick() - start > MAX30102_ASYNC_TIMEOUT_MS) {
+            // 超时：终止引擎，包括本事务在内的排队事务均以失败回调
+            I2C_Async_Abort();
+            return 1;
+        }
+    }
+
+    return i2c_sync_status;
+}
+
 /* ==================== 寄存器读写函数 ==================== */
 
 /**
@@ -207,29 +683,13 @@ uint8_t MAX30102_I2C_Recv_Byte(uint8_t ack)
  */
 uint8_t MAX30102_Write_Reg(uint8_t reg_addr, uint8_t data)
 {
-    uint8_t ack;
-
-    MAX30102_I2C_Start();
+    i2c_sync_done = false;
 
-    // 发送器件地址+写命令
-    ack = MAX30102_I2C_Send_Byte(MAX30102_I2C_ADDR);
-    if (ack) {
-        MAX30102_I2C_Stop();
-        return 1;
-    }
-
-    // 发送寄存器地址
-    ack = MAX30102_I2C_Send_Byte(reg_addr);
-    if (ack) {
-        MAX30102_I2C_Stop();
+    if (MAX30102_I2C_Async_Write(reg_addr, &data, 1, I2C_Sync_Callback, NULL)) {
         return 1;
     }
 
-    // 发送数据
-    ack = MAX30102_I2C_Send_Byte(data);
-    MAX30102_I2C_Stop();
-
-    return ack;
+    return I2C_Sync_Wait();
 }
 
 /**
@@ -240,40 +700,29 @@ uint8_t MAX30102_Write_Reg(uint8_t reg_addr, uint8_t data)
  */
 uint8_t MAX30102_Read_Reg(uint8_t reg_addr, uint8_t *data)
 {
-    uint8_t ack;
-
-    MAX30102_I2C_Start();
-
-    // 发送器件地址+写命令
-    ack = MAX30102_I2C_Send_Byte(MAX30102_I2C_ADDR);
-    if (ack) {
-        MAX30102_I2C_Stop();
-        return 1;
-    }
+    return MAX30102_Read_Regs(reg_addr, data, 1);
+}
 
-    // 发送寄存器地址
-    ack = MAX30102_I2C_Send_Byte(reg_addr);
-    if (ack) {
-        MAX30102_I2C_Stop();
-        return 1;
+/**
+ * @brief 连续读MAX30102多个寄存器
+ * @param reg_addr: 起始寄存器地址
+ * @param buf: 读取的数据缓冲区
+ * @param len: 读取字节数
+ * @retval 0: 成功, 1: 失败
+ */
+uint8_t MAX30102_Read_Regs(uint8_t reg_addr, uint8_t *buf, uint32_t len)
+{
+    if (len == 0) {
+        return 0;
     }
 
-    // 重新起始
-    MAX30102_I2C_Start();
+    i2c_sync_done = false;
 
-    // 发送器件地址+读命令
-    ack = MAX30102_I2C_Send_Byte(MAX30102_I2C_ADDR | 0x01);
-    if (ack) {
-        MAX30102_I2C_Stop();
+    if (MAX30102_I2C_Async_Read(reg_addr, buf, len, I2C_Sync_Callback, NULL)) {
         return 1;
     }
 
-    // 读取数据
-    *data = MAX30102_I2C_Recv_Byte(1);  // NACK
-
-    MAX30102_I2C_Stop();
-
-    return 0;
+    return I2C_Sync_Wait();
 }
 
 /* ==================== 初始化函数 ==================== */
@@ -339,15 +788,20 @@ uint8_t MAX30102_Init(void)
         return 1;
     }
 
-    // 配置中断（禁用所有中断）
+    // 配置中断：中断采集模式下使能FIFO几乎满和新样本就绪
+#if MAX30102_USE_IRQ
+    MAX30102_Write_Reg(MAX30102_INT_ENABLE_1, MAX30102_INT_A_FULL | MAX30102_INT_PPG_RDY);
+#else
     MAX30102_Write_Reg(MAX30102_INT_ENABLE_1, 0x00);
+#endif
     MAX30102_Write_Reg(MAX30102_INT_ENABLE_2, 0x00);
 
     // 配置FIFO
     // [7:5] SMP_AVE: 样本平均（000=1, 001=2, 010=4, 011=8, 100=16, 101=32）
     // [4] FIFO_ROLLOVER_EN: FIFO满时覆盖旧数据
-    // [3:0] FIFO_A_FULL: FIFO几乎满中断阈值
-    MAX30102_Write_Reg(MAX30102_FIFO_CONFIG, 0x4F);  // 平均16个样本，覆盖模式
+    // [3:0] FIFO_A_FULL: FIFO几乎满中断阈值（剩余空位数）
+    // 不平均（FIFO输出率=SR=MAX30102_SAMPLE_RATE），不覆盖：FIFO满后新样本丢弃并计入FIFO_OVF_CNT
+    MAX30102_Write_Reg(MAX30102_FIFO_CONFIG, 0x00 | MAX30102_FIFO_A_FULL);
 
     // 配置模式（心率+血氧模式）
     MAX30102_Write_Reg(MAX30102_MODE_CONFIG, MAX30102_MODE_SPO2);
@@ -368,8 +822,19 @@ uint8_t MAX30102_Init(void)
     MAX30102_Write_Reg(MAX30102_FIFO_OVF_CNT, 0x00);
     MAX30102_Write_Reg(MAX30102_FIFO_RD_PTR, 0x00);
 
+    // 读状态寄存器清除上电/复位遗留中断，释放INT引脚
+    MAX30102_Read_Regs(MAX30102_INT_STATUS_1, int_status_raw, 2);
+    int_pending = false;
+    fifo_overflow_count = 0;
+
+#if MAX30102_USE_IRQ
+    MAX30102_INT_Init();
+#endif
+
     // 初始化数据结构
     memset(&max30102_data, 0, sizeof(MAX30102_Data_t));
+    MAX30102_Stream_Init(&max30102_stream);
+    PPG_Filter_Init(&ppg_filter);
 
     printf("MAX30102: Init Success (ID=0x%02X)\r\n", part_id);
 
@@ -387,35 +852,12 @@ uint8_t MAX30102_Init(void)
 uint8_t MAX30102_Read_FIFO(uint32_t *red_led, uint32_t *ir_led)
 {
     uint8_t temp[6];
-    uint8_t ret;
 
     // 读取6字节FIFO数据（红光3字节 + 红外3字节）
-    MAX30102_I2C_Start();
-    ret = MAX30102_I2C_Send_Byte(MAX30102_I2C_ADDR);
-    if (ret) {
-        MAX30102_I2C_Stop();
+    if (MAX30102_Read_Regs(MAX30102_FIFO_DATA, temp, 6)) {
         return 1;
     }
 
-    ret = MAX30102_I2C_Send_Byte(MAX30102_FIFO_DATA);
-    if (ret) {
-        MAX30102_I2C_Stop();
-        return 1;
-    }
-
-    MAX30102_I2C_Start();
-    ret = MAX30102_I2C_Send_Byte(MAX30102_I2C_ADDR | 0x01);
-    if (ret) {
-        MAX30102_I2C_Stop();
-        return 1;
-    }
-
-    for (int i = 0; i < 6; i++) {
-        temp[i] = MAX30102_I2C_Recv_Byte(i == 5 ? 1 : 0);  // 最后一个字节NACK
-    }
-
-    MAX30102_I2C_Stop();
-
     // 解析数据（18位有效，高18位）
     *red_led = ((uint32_t)temp[0] << 16) | ((uint32_t)temp[1] << 8) | temp[2];
     *red_led &= 0x03FFFF;  // 保留低18位
@@ -426,6 +868,24 @@ uint8_t MAX30102_Read_FIFO(uint32_t *red_led, uint32_t *ir_led)
     return 0;
 }
 
+/**
+ * @brief 保存一个样本并经DSP前端得到交流/直流分量
+ * @param data: 数据结构指针
+ * @param index: 缓冲区位置
+ * @param red: 红光原始样本
+ * @param ir: 红外原始样本
+ */
+static void MAX30102_Store_Sample(MAX30102_Data_t *data, uint32_t index, uint32_t red, uint32_t ir)
+{
+    data->red_buffer[index] = red;
+    data->ir_buffer[index] = ir;
+
+    PPG_Filter_Process(&ppg_filter, red, ir, &data->red_ac_buffer[index], &data->ir_ac_buffer[index]);
+
+    data->red_dc = ppg_filter.red.dc;
+    data->ir_dc = ppg_filter.ir.dc;
+}
+
 /**
  * @brief 读取多个FIFO样本
  * @param data: 数据结构指针
@@ -445,8 +905,7 @@ uint32_t MAX30102_Read_FIFO_Multi(MAX30102_Data_t *data, uint32_t num_samples)
     for (i = 0; i < num_samples; i++) {
         ret = MAX30102_Read_FIFO(&red, &ir);
         if (ret == 0) {
-            data->red_buffer[i] = red;
-            data->ir_buffer[i] = ir;
+            MAX30102_Store_Sample(data, i, red, ir);
         } else {
             break;
         }
@@ -457,42 +916,209 @@ uint32_t MAX30102_Read_FIFO_Multi(MAX30102_Data_t *data, uint32_t num_samples)
     return i;
 }
 
+/**
+ * @brief 由FIFO指针寄存器计算待读样本数
+ * @param ptr: FIFO_WR_PTR、FIFO_OVF_CNT、FIFO_RD_PTR三个寄存器值
+ * @retval 待读样本数
+ */
+static uint32_t MAX30102_FIFO_Pending(const uint8_t *ptr)
+{
+    // 指针为5位循环计数，写指针追上读指针且有溢出时表示FIFO已满
+    uint32_t pending = (uint32_t)(ptr[0] - ptr[2]) & (MAX30102_FIFO_DEPTH - 1);
+
+    if (pending == 0 && ptr[1] != 0) {
+        pending = MAX30102_FIFO_DEPTH;
+    }
+
+    return pending;
+}
+
+/**
+ * @brief 将突发读取的原始FIFO字节追加到样本缓冲区
+ * @param data: 数据结构指针
+ * @param raw: 原始FIFO字节（每样本6字节）
+ * @param num_samples: 样本数
+ */
+static void MAX30102_FIFO_Append(MAX30102_Data_t *data, const uint8_t *raw, uint32_t num_samples)
+{
+    uint32_t i;
+
+    // 缓冲区空间不足时丢弃最旧样本，保持时间顺序
+    if (data->buffer_index + num_samples > MAX30102_BUFFER_SIZE) {
+        uint32_t drop = data->buffer_index + num_samples - MAX30102_BUFFER_SIZE;
+        uint32_t keep = data->buffer_index - drop;
+
+        memmove(data->red_buffer, &data->red_buffer[drop], keep * sizeof(uint32_t));
+        memmove(data->ir_buffer, &data->ir_buffer[drop], keep * sizeof(uint32_t));
+        memmove(data->red_ac_buffer, &data->red_ac_buffer[drop], keep * sizeof(int16_t));
+        memmove(data->ir_ac_buffer, &data->ir_ac_buffer[drop], keep * sizeof(int16_t));
+        data->buffer_index = keep;
+    }
+
+    // 解析数据（18位有效）
+    for (i = 0; i < num_samples; i++) {
+        const uint8_t *p = &raw[i * MAX30102_FIFO_SAMPLE_BYTES];
+
+        MAX30102_Store_Sample(data, data->buffer_index,
+                              (((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2]) & 0x03FFFF,
+                              (((uint32_t)p[3] << 16) | ((uint32_t)p[4] << 8) | p[5]) & 0x03FFFF);
+        data->buffer_index++;
+    }
+
+    data->sample_count = data->buffer_index;
+}
+
+/**
+ * @brief 突发读取FIFO中全部待读样本
+ * @param data: 数据结构指针
+ * @retval 本次读取的样本数
+ */
+uint32_t MAX30102_Read_FIFO_Burst(MAX30102_Data_t *data)
+{
+    uint8_t ptr[3];
+    uint8_t fifo[MAX30102_FIFO_DEPTH * MAX30102_FIFO_SAMPLE_BYTES];
+    uint32_t pending;
+
+    // 一次读出FIFO_WR_PTR、FIFO_OVF_CNT、FIFO_RD_PTR（0x04~0x06连续）
+    if (MAX30102_Read_Regs(MAX30102_FIFO_WR_PTR, ptr, 3)) {
+        return 0;
+    }
+
+    fifo_overflow_count += ptr[1];
+
+    pending = MAX30102_FIFO_Pending(ptr);
+    if (pending == 0) {
+        return 0;
+    }
+
+    // FIFO_DATA不自动递增地址，连续读取即依次弹出样本
+    if (MAX30102_Read_Regs(MAX30102_FIFO_DATA, fifo, pending * MAX30102_FIFO_SAMPLE_BYTES)) {
+        return 0;
+    }
+
+    MAX30102_FIFO_Append(data, fifo, pending);
+
+    return pending;
+}
+
+/**
+ * @brief 异步排空结束（成功、失败或无数据），唤醒任务处理样本或
+ *        处理排空期间到达的INT
+ */
+static void MAX30102_Drain_Done(void)
+{
+    fifo_async_busy = false;
+    scheduler_notify(max30102_task);
+}
+
+/**
+ * @brief FIFO数据突发读取完成回调（TIM1中断上下文）
+ */
+static void MAX30102_FIFO_Data_Callback(uint8_t status, void *ctx)
+{
+    if (status) {
+        fifo_raw_count = 0;
+    }
+
+    fifo_raw_ready = true;
+    MAX30102_Drain_Done();
+}
+
+/**
+ * @brief FIFO指针读取完成回调（TIM1中断上下文），随即排队数据突发读取
+ */
+static void MAX30102_FIFO_Ptr_Callback(uint8_t status, void *ctx)
+{
+    uint32_t pending = status ? 0 : MAX30102_FIFO_Pending(fifo_ptr_raw);
+
+    if (!status) {
+        fifo_overflow_count += fifo_ptr_raw[1];
+    }
+
+    if (pending == 0 ||
+        MAX30102_I2C_Async_Read(MAX30102_FIFO_DATA, fifo_raw,
+                                pending * MAX30102_FIFO_SAMPLE_BYTES,
+                                MAX30102_FIFO_Data_Callback, NULL)) {
+        MAX30102_Drain_Done();
+        return;
+    }
+
+    fifo_raw_count = pending;
+}
+
+/**
+ * @brief 中断状态读取完成回调（TIM1中断上下文），数据类中断随即排队FIFO指针读取
+ */
+static void MAX30102_Int_Status_Callback(uint8_t status, void *ctx)
+{
+    // 读INT_STATUS_1后INT引脚即释放；仅A_FULL/PPG_RDY需要排空FIFO
+    if (status ||
+        !(int_status_raw[0] & (MAX30102_INT_A_FULL | MAX30102_INT_PPG_RDY)) ||
+        MAX30102_I2C_Async_Read(MAX30102_FIFO_WR_PTR, fifo_ptr_raw, 3,
+                                MAX30102_FIFO_Ptr_Callback, NULL)) {
+        MAX30102_Drain_Done();
+    }
+}
+
+/**
+ * @brief INT引脚外部中断回调，标记数据待读并唤醒max30102_task完成排空
+ * @param GPIO_Pin: 触发中断的引脚
+ */
+void MAX30102_EXTI_Callback(uint16_t GPIO_Pin)
+{
+    if (GPIO_Pin == MAX30102_INT_PIN) {
+        int_pending = true;
+        scheduler_notify(max30102_task);
+    }
+}
+
+/**
+ * @brief 获取FIFO累计溢出（丢失）样本数
+ * @retval 累计丢失样本数
+ */
+uint32_t MAX30102_Get_Overflow_Count(void)
+{
+    return fifo_overflow_count;
+}
+
+/**
+ * @brief 获取软件I2C总线累计传输字节数
+ * @retval 累计字节数
+ */
+uint32_t MAX30102_Get_Bus_Bytes(void)
+{
+    return bus_byte_count;
+}
+
 /* ==================== 滤波算法 ==================== */
 
 /**
- * @brief 滑动平均滤波
+ * @brief 滑动平均滤波（整数运行和，O(1)）
  * @param new_value: 新值
  * @retval 滤波后的值
  */
 static int32_t Moving_Average_Filter(int32_t new_value)
 {
-    int32_t sum = 0;
-
-    // 更新缓冲区
+    // 更新缓冲区与运行和
+    hr_ma_sum += new_value - hr_ma_buffer[hr_ma_index];
     hr_ma_buffer[hr_ma_index] = new_value;
     hr_ma_index = (hr_ma_index + 1) % MAX30102_MA_SIZE;
 
-    // 计算平均值
-    for (int i = 0; i < MAX30102_MA_SIZE; i++) {
-        sum += hr_ma_buffer[i];
-    }
-
-    return sum / MAX30102_MA_SIZE;
+    return hr_ma_sum / MAX30102_MA_SIZE;
 }
 
 /**
- * @brief 低通滤波
+ * @brief 低通滤波（Q8定点，α=1/20）
  * @param new_value: 新值
  * @retval 滤波后的值
  */
 static int32_t Low_Pass_Filter(int32_t new_value)
 {
-    #define ALPHA 0.05f
+    #define LPF_DIV 20  // α = 0.05
 
-    int32_t filtered = (int32_t)(ALPHA * new_value + (1.0f - ALPHA) * hr_prev_filtered);
-    hr_prev_filtered = filtered;
+    hr_prev_filtered_q8 += ((new_value << 8) - hr_prev_filtered_q8) / LPF_DIV;
 
-    return filtered;
+    return hr_prev_filtered_q8 >> 8;
 }
 
 /* ==================== 心率血氧计算 ==================== */
@@ -505,12 +1131,12 @@ static int32_t Low_Pass_Filter(int32_t new_value)
 uint8_t MAX30102_Calculate(MAX30102_Data_t *data)
 {
     uint32_t i;
-    int32_t max_val = 0;
-    int32_t min_val = 0x7FFFFFFF;
+    int32_t max_val = -32768;
+    int32_t min_val = 32767;
     int32_t threshold;
     uint32_t peak_count = 0;
     uint32_t last_peak_index = 0;
-    float avg_interval;
+    const int16_t *red = data->red_ac_buffer;
 
     // 至少需要50个样本
     if (data->sample_count < 50) {
@@ -519,18 +1145,18 @@ uint8_t MAX30102_Calculate(MAX30102_Data_t *data)
         return 1;
     }
 
-    // 1. 找出最大值和最小值
+    // 1. 找出带通交流分量的最大值和最小值
     for (i = 0; i < data->sample_count; i++) {
-        if ((int32_t)data->red_buffer[i] > max_val) {
-            max_val = (int32_t)data->red_buffer[i];
+        if (red[i] > max_val) {
+            max_val = red[i];
         }
-        if ((int32_t)data->red_buffer[i] < min_val) {
-            min_val = (int32_t)data->red_buffer[i];
+        if (red[i] < min_val) {
+            min_val = red[i];
         }
     }
 
     // 检查信号幅度是否足够
-    if (max_val - min_val < 1000) {
+    if (max_val - min_val < MAX30102_MIN_AC_PP) {
         data->hr_valid = false;
         data->spo2_valid = false;
         return 1;
@@ -541,9 +1167,7 @@ uint8_t MAX30102_Calculate(MAX30102_Data_t *data)
 
     // 3. 检测峰值
     for (i = 1; i < data->sample_count - 1; i++) {
-        if ((int32_t)data->red_buffer[i] > threshold &&
-            (int32_t)data->red_buffer[i] > (int32_t)data->red_buffer[i-1] &&
-            (int32_t)data->red_buffer[i] > (int32_t)data->red_buffer[i+1]) {
+        if (red[i] > threshold && red[i] > red[i-1] && red[i] > red[i+1]) {
 
             // 找到一个峰值
             if (peak_count == 0 || (i - last_peak_index) > 20) {  // 至少间隔20个样本(0.2秒)
@@ -553,10 +1177,9 @@ uint8_t MAX30102_Calculate(MAX30102_Data_t *data)
         }
     }
 
-    // 4. 计算心率
+    // 4. 计算心率：60 * 采样率 * 峰值数 / 样本数
     if (peak_count >= 2) {
-        avg_interval = (float)data->sample_count / (float)peak_count / (float)MAX30102_SAMPLE_RATE;  // 秒
-        data->heart_rate = (int32_t)(60.0f / avg_interval);
+        data->heart_rate = (int32_t)(60U * MAX30102_SAMPLE_RATE * peak_count / data->sample_count);
 
         // 滤波
         data->heart_rate = Moving_Average_Filter(data->heart_rate);
@@ -572,22 +1195,20 @@ uint8_t MAX30102_Calculate(MAX30102_Data_t *data)
         data->hr_valid = false;
     }
 
-    // 5. 计算血氧（简化算法，使用R值查表法）
+    // 5. 计算血氧（R值法，交流取带通峰峰值，直流取前端直流估计）
     if (data->hr_valid) {
-        uint32_t red_ac = max_val - min_val;
-        uint32_t red_dc = (max_val + min_val) / 2;
+        int32_t red_ac = max_val - min_val;
+        int32_t ir_max = -32768, ir_min = 32767;
 
-        uint32_t ir_max = 0, ir_min = 0x7FFFFFFF;
         for (i = 0; i < data->sample_count; i++) {
-            if (data->ir_buffer[i] > ir_max) ir_max = data->ir_buffer[i];
-            if (data->ir_buffer[i] < ir_min) ir_min = data->ir_buffer[i];
+            if (data->ir_ac_buffer[i] > ir_max) ir_max = data->ir_ac_buffer[i];
+            if (data->ir_ac_buffer[i] < ir_min) ir_min = data->ir_ac_buffer[i];
         }
 
-        uint32_t ir_ac = ir_max - ir_min;
-        uint32_t ir_dc = (ir_max + ir_min) / 2;
+        int32_t ir_ac = ir_max - ir_min;
 
-        if (red_dc != 0 && ir_dc != 0) {
-            float R = ((float)red_ac / (float)red_dc) / ((float)ir_ac / (float)ir_dc);
+        if (data->red_dc != 0 && data->ir_dc != 0 && ir_ac > 0) {
+            float R = ((float)red_ac / (float)data->red_dc) / ((float)ir_ac / (float)data->ir_dc);
 
             // 简化的SpO2计算公式：SpO2 = 110 - 25*R
             data->spo2 = (int32_t)(110.0f - 25.0f * R);
@@ -607,6 +1228,146 @@ uint8_t MAX30102_Calculate(MAX30102_Data_t *data)
     return 0;
 }
 
+/* ==================== 流式心率血氧估计 ==================== */
+
+/**
+ * @brief 以当前交流分量重置心跳周期内的极值跟踪
+ */
+static void Stream_Reset_Extrema(MAX30102_Stream_t *stream, int32_t red_ac, int32_t ir_ac)
+{
+    stream->red_ac_max = red_ac;
+    stream->red_ac_min = red_ac;
+    stream->ir_ac_max = ir_ac;
+    stream->ir_ac_min = ir_ac;
+}
+
+/**
+ * @brief 清空心跳间期历史
+ */
+static void Stream_Reset_IBI(MAX30102_Stream_t *stream)
+{
+    stream->ibi_sum = 0;
+    stream->ibi_index = 0;
+    stream->ibi_count = 0;
+    stream->hr_valid = false;
+    stream->spo2_valid = false;
+}
+
+/**
+ * @brief 初始化流式估计器
+ * @param stream: 估计器指针
+ */
+void MAX30102_Stream_Init(MAX30102_Stream_t *stream)
+{
+    memset(stream, 0, sizeof(MAX30102_Stream_t));
+}
+
+/**
+ * @brief 向流式估计器输入一个样本
+ * @param stream: 估计器指针
+ * @param red_ac: 红光带通交流分量（PPG_Filter_Process输出）
+ * @param ir_ac: 红外带通交流分量
+ * @param red_dc: 红光直流分量（PPG_Channel_t.dc）
+ * @param ir_dc: 红外直流分量
+ * @retval true: 检测到新心跳，心率/血氧已更新
+ */
+bool MAX30102_Stream_Update(MAX30102_Stream_t *stream, int16_t red_ac, int16_t ir_ac,
+                            uint32_t red_dc, uint32_t ir_dc)
+{
+    int32_t mag, thr;
+    bool beat = false;
+
+    // 1. 幅度包络：快速跟随上升，缓慢衰减（输入已经0.5~4Hz带通，不再另做去直流和低通）
+    mag = red_ac < 0 ? -red_ac : red_ac;
+    if (mag > stream->envelope) {
+        stream->envelope = mag;
+    } else {
+        stream->envelope -= stream->envelope >> MAX30102_STREAM_ENV_SHIFT;
+    }
+    thr = stream->envelope >> 2;
+
+    // 2. 心跳周期内红光/红外交流极值
+    if (red_ac > stream->red_ac_max) stream->red_ac_max = red_ac;
+    if (red_ac < stream->red_ac_min) stream->red_ac_min = red_ac;
+    if (ir_ac > stream->ir_ac_max) stream->ir_ac_max = ir_ac;
+    if (ir_ac < stream->ir_ac_min) stream->ir_ac_min = ir_ac;
+
+    // 3. 带迟滞的峰值检测：回到负半周后上穿+1/4包络进入脉搏，
+    //    跟踪正半周最大值，回落过零时确认该最大值为一个峰值
+    //    （带通后的脉搏波正半周窄而高、负半周宽而浅，负侧不设阈值）
+    if (!stream->in_pulse) {
+        if (red_ac < 0) {
+            stream->armed = true;
+        }
+        if (stream->armed && red_ac > thr && stream->envelope >= MAX30102_STREAM_MIN_AMP) {
+            stream->armed = false;
+            stream->in_pulse = true;
+            stream->pulse_max = red_ac;
+            stream->pulse_max_index = stream->sample_index;
+        }
+    } else if (red_ac > stream->pulse_max) {
+        stream->pulse_max = red_ac;
+        stream->pulse_max_index = stream->sample_index;
+    } else if (red_ac < 0) {
+        uint32_t peak_index = stream->pulse_max_index;
+        uint32_t interval = peak_index - stream->last_peak_index;
+
+        stream->in_pulse = false;
+
+        if (!stream->has_peak ||
+            interval > (uint32_t)(60 * MAX30102_SAMPLE_RATE / MAX30102_HR_MIN)) {
+            // 首个峰值或间隔过长（脱落/丢拍）：重新开始计时
+            stream->has_peak = true;
+            stream->last_peak_index = peak_index;
+            Stream_Reset_IBI(stream);
+            Stream_Reset_Extrema(stream, red_ac, ir_ac);
+        } else if (interval >= (uint32_t)(60 * MAX30102_SAMPLE_RATE / MAX30102_HR_MAX)) {
+            // 有效心跳：更新间期滑动和
+            if (stream->ibi_count == MAX30102_STREAM_IBI_COUNT) {
+                stream->ibi_sum -= stream->ibi[stream->ibi_index];
+            } else {
+                stream->ibi_count++;
+            }
+            stream->ibi[stream->ibi_index] = interval;
+            stream->ibi_sum += interval;
+            stream->ibi_index = (stream->ibi_index + 1) % MAX30102_STREAM_IBI_COUNT;
+
+            stream->heart_rate = (int32_t)((60U * MAX30102_SAMPLE_RATE * stream->ibi_count +
+                                            stream->ibi_sum / 2) / stream->ibi_sum);
+            stream->hr_valid = (stream->heart_rate >= MAX30102_HR_MIN &&
+                                stream->heart_rate <= MAX30102_HR_MAX);
+
+            // 血氧：本周期 R = (AC_red/DC_red) / (AC_ir/DC_ir)，SpO2 = 110 - 25*R
+            {
+                int64_t red_pp = stream->red_ac_max - stream->red_ac_min;
+                int64_t ir_pp = stream->ir_ac_max - stream->ir_ac_min;
+
+                if (red_pp > 0 && ir_pp > 0 && red_dc > 0 && ir_dc > 0) {
+                    int32_t r_x100 = (int32_t)((red_pp * (int64_t)ir_dc * 100) / ((int64_t)red_dc * ir_pp));
+                    int32_t spo2 = (11000 - 25 * r_x100) / 100;
+
+                    if (spo2 < MAX30102_SPO2_MIN) spo2 = MAX30102_SPO2_MIN;
+                    if (spo2 > MAX30102_SPO2_MAX) spo2 = MAX30102_SPO2_MAX;
+
+                    stream->spo2 = spo2;
+                    stream->spo2_valid = stream->hr_valid;
+                } else {
+                    stream->spo2_valid = false;
+                }
+            }
+
+            stream->last_peak_index = peak_index;
+            Stream_Reset_Extrema(stream, red_ac, ir_ac);
+            beat = true;
+        }
+        // 间隔小于不应期：视为同一心跳的重搏波，忽略
+    }
+
+    stream->sample_index++;
+
+    return beat;
+}
+
 /**
  * @brief 检查心率血氧报警
  * @param data: 数据结构指针
@@ -633,18 +1394,13 @@ void MAX30102_Check_Alarm(MAX30102_Data_t *data)
 }
 
 /**
- * @brief 获取传感器数据
+ * @brief 对滑动窗口内的样本计算心率血氧并检查报警
  * @param data: 数据结构指针
- * @retval 0: 成功, 1: 失败
+ * @retval 0: 成功, 1: 样本不足
  */
-uint8_t MAX30102_Get_Data(MAX30102_Data_t *data)
+static uint8_t MAX30102_Process(MAX30102_Data_t *data)
 {
-    uint32_t num_read;
-
-    // 读取100个样本
-    num_read = MAX30102_Read_FIFO_Multi(data, 100);
-
-    if (num_read < 50) {
+    if (data->sample_count < 50) {
         return 1;
     }
 
@@ -657,6 +1413,19 @@ uint8_t MAX30102_Get_Data(MAX30102_Data_t *data)
     return 0;
 }
 
+/**
+ * @brief 获取传感器数据
+ * @param data: 数据结构指针
+ * @retval 0: 成功, 1: 失败
+ */
+uint8_t MAX30102_Get_Data(MAX30102_Data_t *data)
+{
+    // 突发读取FIFO中已有的新样本，累积到滑动窗口
+    MAX30102_Read_FIFO_Burst(data);
+
+    return MAX30102_Process(data);
+}
+
 /**
  * @brief 打印MAX30102数据
  * @param data: 数据结构指针
@@ -675,6 +1444,61 @@ void MAX30102_Print_Data(MAX30102_Data_t *data)
  */
 void max30102_task(void)
 {
-    MAX30102_Get_Data(&max30102_data);
-    MAX30102_Print_Data(&max30102_data);
+    // 处理上一周期异步读回的FIFO数据
+    if (fifo_raw_ready) {
+        MAX30102_Data_t *data = &max30102_data;
+        uint32_t count = fifo_raw_count;
+        uint32_t i;
+        bool beat = false;
+
+        MAX30102_FIFO_Append(data, fifo_raw, count);
+        fifo_raw_ready = false;
+
+        // 带通后的交流分量逐样本送入流式估计器，每检测到一次心跳即更新结果；
+        // 直流变化远慢于一批样本的时长，取本批最新估计
+        for (i = data->buffer_index - count; i < data->buffer_index; i++) {
+            beat |= MAX30102_Stream_Update(&max30102_stream, data->red_ac_buffer[i], data->ir_ac_buffer[i],
+                                           data->red_dc, data->ir_dc);
+        }
+
+        // 结果只在心跳时变化，只在心跳时打印
+        if (beat) {
+            data->heart_rate = max30102_stream.heart_rate;
+            data->spo2 = max30102_stream.spo2;
+            data->hr_valid = max30102_stream.hr_valid;
+            data->spo2_valid = max30102_stream.spo2_valid;
+            MAX30102_Check_Alarm(data);
+            MAX30102_Print_Data(data);
+        }
+    }
+
+#if MAX30102_USE_IRQ
+    // 延迟排空：有挂起中断（或INT仍为低，防止漏掉边沿）时先读中断状态，
+    // 状态读完后在中断中依次排队指针读取和数据突发读取；
+    // 上一批数据尚未处理时不启动（回调可能在上面的判断之后才置位fifo_raw_ready）。
+    // 此时不启动的排空由MAX30102_Drain_Done再次唤醒任务后补上
+    if (!fifo_async_busy && !fifo_raw_ready &&
+        (int_pending ||
+         HAL_GPIO_ReadPin(MAX30102_INT_GPIO_PORT, MAX30102_INT_PIN) == GPIO_PIN_RESET)) {
+        int_pending = false;
+        fifo_async_busy = true;
+        fifo_raw_count = 0;
+        if (MAX30102_I2C_Async_Read(MAX30102_INT_STATUS_1, int_status_raw, 2,
+                                    MAX30102_Int_Status_Callback, NULL)) {
+            // 队列已满：保留挂起，下一轮重试
+            int_pending = true;
+            MAX30102_Drain_Done();
+        }
+    }
+#else
+    // 启动下一次异步读取：指针读完后在中断中自动排队数据突发读取
+    if (!fifo_async_busy && !fifo_raw_ready) {
+        fifo_async_busy = true;
+        fifo_raw_count = 0;
+        if (MAX30102_I2C_Async_Read(MAX30102_FIFO_WR_PTR, fifo_ptr_raw, 3,
+                                    MAX30102_FIFO_Ptr_Callback, NULL)) {
+            fifo_async_busy = false;
+        }
+    }
+#endif
 }
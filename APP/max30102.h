@@ -26,6 +26,7 @@
 #define __MAX30102_H
 
 #include "main.h"
+#include "ppg_filter.h"
 #include <stdbool.h>
 
 /* ==================== 寄存器地址定义 ==================== */
@@ -36,12 +37,21 @@
 #define MAX30102_INT_ENABLE_1       0x02  // 中断使能1
 #define MAX30102_INT_ENABLE_2       0x03  // 中断使能2
 
+// 中断标志位（INT_STATUS_1 / INT_ENABLE_1）
+#define MAX30102_INT_A_FULL         0x80  // FIFO几乎满
+#define MAX30102_INT_PPG_RDY        0x40  // 新样本就绪
+#define MAX30102_INT_ALC_OVF        0x20  // 环境光消除溢出
+#define MAX30102_INT_PWR_RDY        0x01  // 上电就绪
+
 // FIFO寄存器
 #define MAX30102_FIFO_WR_PTR        0x04  // FIFO写指针
 #define MAX30102_FIFO_OVF_CNT       0x05  // FIFO溢出计数
 #define MAX30102_FIFO_RD_PTR        0x06  // FIFO读指针
 #define MAX30102_FIFO_DATA          0x07  // FIFO数据寄存器
 
+#define MAX30102_FIFO_DEPTH         32    // FIFO深度（样本数）
+#define MAX30102_FIFO_SAMPLE_BYTES  6     // 每个样本字节数（红光3 + 红外3）
+
 // 配置寄存器
 #define MAX30102_FIFO_CONFIG        0x08  // FIFO配置
 #define MAX30102_MODE_CONFIG        0x09  // 模式配置
@@ -92,7 +102,8 @@
 
 #define MAX30102_BUFFER_SIZE        100   // FIFO缓冲区大小
 #define MAX30102_MA_SIZE            20    // 滑动平均窗口大小
-#define MAX30102_SAMPLE_RATE        100   // 采样率(Hz)
+#define MAX30102_MIN_AC_PP          200   // 带通后最小有效脉搏峰峰值
+#define MAX30102_SAMPLE_RATE        100   // FIFO输出率(Hz)：SR=100Hz且SMP_AVE=1，修改SR或SMP_AVE时须同步
 
 // 心率范围
 #define MAX30102_HR_MIN             40    // 最小心率(bpm)
@@ -107,6 +118,26 @@
 #define MAX30102_HR_ALARM_HIGH      120   // 心率过高报警
 #define MAX30102_SPO2_ALARM_LOW     90    // 血氧过低报警
 
+/* ==================== 流式估计参数 ==================== */
+
+#define MAX30102_STREAM_ENV_SHIFT   7     // 峰值包络衰减系数 1/128
+#define MAX30102_STREAM_IBI_COUNT   8     // 参与平均的心跳间期个数
+#define MAX30102_STREAM_MIN_AMP     50    // 最小有效脉搏幅度（交流分量）
+
+/* ==================== 异步I2C参数 ==================== */
+
+#define MAX30102_ASYNC_TICK_US      5     // TIM1更新中断周期(us)，每位2个节拍，约100kHz
+#define MAX30102_ASYNC_QUEUE_SIZE   4     // 异步事务队列深度
+#define MAX30102_ASYNC_TIMEOUT_MS   50    // 阻塞封装等待超时(ms)
+
+/* ==================== 中断采集参数 ==================== */
+
+#define MAX30102_USE_IRQ            1     // 1: INT引脚中断唤醒事件任务采集, 0: 调度器周期轮询
+#define MAX30102_POLL_MS            20    // MAX30102_USE_IRQ为0时的任务轮询周期(ms)
+#define MAX30102_INT_PIN            GPIO_PIN_13   // INT引脚（PB13，开漏低有效，EXTI13）
+#define MAX30102_INT_GPIO_PORT      GPIOB
+#define MAX30102_FIFO_A_FULL        15    // FIFO剩余空位数为该值时触发A_FULL（即存满17个样本）
+
 /* ==================== 数据结构 ==================== */
 
 /**
@@ -115,6 +146,10 @@
 typedef struct {
     uint32_t red_buffer[MAX30102_BUFFER_SIZE];   // 红光数据缓冲区
     uint32_t ir_buffer[MAX30102_BUFFER_SIZE];    // 红外数据缓冲区
+    int16_t red_ac_buffer[MAX30102_BUFFER_SIZE]; // 红光带通交流分量
+    int16_t ir_ac_buffer[MAX30102_BUFFER_SIZE];  // 红外带通交流分量
+    uint32_t red_dc;                             // 红光直流分量
+    uint32_t ir_dc;                              // 红外直流分量
 
     int32_t heart_rate;                          // 心率值(bpm)
     int32_t spo2;                                // 血氧饱和度(%)
@@ -130,6 +165,44 @@ typedef struct {
 
 } MAX30102_Data_t;
 
+/**
+ * @brief 流式心率血氧估计器
+ * @note  输入ppg_filter的带通输出，每个样本O(1)更新：幅度包络、带迟滞的峰值检测、
+ *        心跳间期，每检测到一次心跳即输出一次心率/血氧
+ */
+typedef struct {
+    uint32_t sample_index;                         // 已输入样本总数
+
+    int32_t envelope;                              // 红光交流幅度包络
+    bool armed;                                    // 已回到负半周，等待下一次脉搏上升
+    bool in_pulse;                                 // 处于脉搏正半周，跟踪峰值
+    int32_t pulse_max;                             // 当前正半周最大值
+    uint32_t pulse_max_index;                      // 当前正半周最大值样本序号
+
+    int32_t red_ac_max, red_ac_min;                // 当前心跳周期内红光交流极值
+    int32_t ir_ac_max, ir_ac_min;                  // 当前心跳周期内红外交流极值
+
+    uint32_t last_peak_index;                      // 上一个峰值的样本序号
+    bool has_peak;                                 // 是否已检测到过峰值
+
+    uint32_t ibi[MAX30102_STREAM_IBI_COUNT];       // 最近心跳间期（样本数）
+    uint32_t ibi_sum;                              // 心跳间期累加和
+    uint8_t ibi_index;                             // 间期环形索引
+    uint8_t ibi_count;                             // 有效间期个数
+
+    int32_t heart_rate;                            // 最新心率(bpm)
+    int32_t spo2;                                  // 最新血氧(%)
+    bool hr_valid;                                 // 心率有效
+    bool spo2_valid;                               // 血氧有效
+} MAX30102_Stream_t;
+
+/**
+ * @brief 异步I2C事务完成回调（在TIM1中断上下文中调用）
+ * @param status: 0: 成功, 1: 无应答
+ * @param ctx: 提交事务时传入的用户参数
+ */
+typedef void (*MAX30102_I2C_Callback_t)(uint8_t status, void *ctx);
+
 /* ==================== 函数声明 ==================== */
 
 /**
@@ -160,6 +233,33 @@ uint8_t MAX30102_Read_FIFO(uint32_t *red_led, uint32_t *ir_led);
  */
 uint32_t MAX30102_Read_FIFO_Multi(MAX30102_Data_t *data, uint32_t num_samples);
 
+/**
+ * @brief 突发读取FIFO中全部待读样本
+ * @note  根据FIFO_WR_PTR/FIFO_RD_PTR计算待读样本数，一次I2C事务连续读出，
+ *        新样本追加到red_buffer/ir_buffer末尾，缓冲区满时丢弃最旧样本
+ * @param data: 数据结构指针
+ * @retval 本次读取的样本数
+ */
+uint32_t MAX30102_Read_FIFO_Burst(MAX30102_Data_t *data);
+
+/**
+ * @brief 获取软件I2C总线累计传输字节数（含地址和寄存器字节）
+ * @retval 累计字节数
+ */
+uint32_t MAX30102_Get_Bus_Bytes(void);
+
+/**
+ * @brief 获取FIFO累计溢出（丢失）样本数，来自FIFO_OVF_CNT
+ * @retval 累计丢失样本数
+ */
+uint32_t MAX30102_Get_Overflow_Count(void);
+
+/**
+ * @brief INT引脚外部中断回调（在HAL_GPIO_EXTI_Callback中调用），标记数据待读并唤醒max30102_task
+ * @param GPIO_Pin: 触发中断的引脚
+ */
+void MAX30102_EXTI_Callback(uint16_t GPIO_Pin);
+
 /**
  * @brief 计算心率和血氧
  * @param data: 数据结构指针
@@ -167,6 +267,24 @@ uint32_t MAX30102_Read_FIFO_Multi(MAX30102_Data_t *data, uint32_t num_samples);
  */
 uint8_t MAX30102_Calculate(MAX30102_Data_t *data);
 
+/**
+ * @brief 初始化流式估计器
+ * @param stream: 估计器指针
+ */
+void MAX30102_Stream_Init(MAX30102_Stream_t *stream);
+
+/**
+ * @brief 向流式估计器输入一个样本
+ * @param stream: 估计器指针
+ * @param red_ac: 红光带通交流分量（PPG_Filter_Process输出）
+ * @param ir_ac: 红外带通交流分量
+ * @param red_dc: 红光直流分量（PPG_Channel_t.dc）
+ * @param ir_dc: 红外直流分量
+ * @retval true: 检测到新心跳，心率/血氧已更新
+ */
+bool MAX30102_Stream_Update(MAX30102_Stream_t *stream, int16_t red_ac, int16_t ir_ac,
+                            uint32_t red_dc, uint32_t ir_dc);
+
 /**
  * @brief 获取传感器数据
  * @param data: 数据结构指针
@@ -209,6 +327,15 @@ uint8_t MAX30102_Write_Reg(uint8_t reg_addr, uint8_t data);
  */
 uint8_t MAX30102_Read_Reg(uint8_t reg_addr, uint8_t *data);
 
+/**
+ * @brief 连续读MAX30102多个寄存器（地址自动递增，FIFO_DATA除外）
+ * @param reg_addr: 起始寄存器地址
+ * @param buf: 读取的数据缓冲区
+ * @param len: 读取字节数
+ * @retval 0: 成功, 1: 失败
+ */
+uint8_t MAX30102_Read_Regs(uint8_t reg_addr, uint8_t *buf, uint32_t len);
+
 /**
  * @brief 软件I2C初始化
  */
@@ -216,6 +343,7 @@ void MAX30102_I2C_Init(void);
 
 /**
  * @brief 软件I2C起始信号
+ * @note  以下位级函数为阻塞实现，异步引擎忙时不可调用
  */
 void MAX30102_I2C_Start(void);
 
@@ -238,4 +366,44 @@ uint8_t MAX30102_I2C_Send_Byte(uint8_t byte);
  */
 uint8_t MAX30102_I2C_Recv_Byte(uint8_t ack);
 
+/* ==================== 异步软件I2C引擎 ==================== */
+
+/**
+ * @brief 提交异步写事务（START + 地址 + 寄存器 + 数据 + STOP）
+ * @note  buf在回调前必须保持有效；可在中断上下文（含完成回调）中调用
+ * @param reg_addr: 起始寄存器地址
+ * @param buf: 待写数据
+ * @param len: 数据字节数
+ * @param cb: 完成回调（可为NULL）
+ * @param ctx: 回调用户参数
+ * @retval 0: 已入队, 1: 队列已满
+ */
+uint8_t MAX30102_I2C_Async_Write(uint8_t reg_addr, const uint8_t *buf, uint32_t len,
+                                 MAX30102_I2C_Callback_t cb, void *ctx);
+
+/**
+ * @brief 提交异步读事务（START + 地址 + 寄存器 + RESTART + 地址 + 数据 + STOP）
+ * @note  buf在回调前必须保持有效；可在中断上下文（含完成回调）中调用
+ * @param reg_addr: 起始寄存器地址
+ * @param buf: 读取数据缓冲区
+ * @param len: 数据字节数
+ * @param cb: 完成回调（可为NULL）
+ * @param ctx: 回调用户参数
+ * @retval 0: 已入队, 1: 队列已满
+ */
+uint8_t MAX30102_I2C_Async_Read(uint8_t reg_addr, uint8_t *buf, uint32_t len,
+                                MAX30102_I2C_Callback_t cb, void *ctx);
+
+/**
+ * @brief 查询异步引擎是否忙
+ * @retval true: 有事务在执行或排队
+ */
+bool MAX30102_I2C_Async_Busy(void);
+
+/**
+ * @brief TIM1更新中断回调（在HAL_TIM_PeriodElapsedCallback中调用）
+ * @param htim: 定时器句柄
+ */
+void MAX30102_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim);
+
 #endif /* __MAX30102_H */
@@ -8,67 +8,474 @@
   */
 
 #include "mq2.h"
-#include "adc.h"
+#include "adc_scan.h"
+#include "aht20.h"
+#include "scheduler.h"
 #include <stdio.h>
 #include <math.h>
 
+/* ==================== 常量 ==================== */
+
+// 表项单位1/MQ2_PPM_TABLE_SCALE ppm：查表后还要乘补偿增益（-10℃/20%RH时约3.9），
+// 表须容纳MQ2_PPM_MAX / 最小增益（50℃/100%RH时约0.55）即约18200ppm
+#define MQ2_PPM_TABLE_SCALE     3
+
+// 温湿度补偿表：各温湿度下清洁空气Rs相对参考条件（20℃/65%RH）的比值，
+// 按数据手册温湿度特性曲线取点（低温、低湿时Rs偏大）
+static const float mq2_comp_table[MQ2_COMP_T_POINTS][MQ2_COMP_RH_POINTS] = {
+    /* 20%    40%    60%    80%    100%RH */
+    {1.67f, 1.61f, 1.54f, 1.47f, 1.41f},   // -10℃
+    {1.39f, 1.34f, 1.28f, 1.22f, 1.17f},   // 0℃
+    {1.21f, 1.16f, 1.12f, 1.07f, 1.02f},   // 10℃
+    {1.10f, 1.05f, 1.01f, 0.97f, 0.92f},   // 20℃
+    {1.03f, 0.99f, 0.94f, 0.90f, 0.86f},   // 30℃
+    {0.98f, 0.94f, 0.90f, 0.86f, 0.82f},   // 40℃
+    {0.95f, 0.91f, 0.88f, 0.84f, 0.80f},   // 50℃
+};
+
 /* ==================== 全局变量 ==================== */
 
 static MQ2_Data_t mq2_data = {0};
 static float R0 = MQ2_R0_CLEAN_AIR;  // 基准电阻
+static float mq2_comp_k = 1.0f;      // 当前温湿度补偿系数k
+static float mq2_comp_gain_scaled = 1.0f / (float)MQ2_PPM_TABLE_SCALE; // 查表值乘它得ppm：k^(-B)/表项倍数
 
-/* ==================== 函数实现 ==================== */
+static uint16_t mq2_ppm_table[MQ2_ADC_MAX + 1];  // ADC码 -> 参考温湿度下的ppm x MQ2_PPM_TABLE_SCALE，随R0重建
+static uint16_t mq2_alarm_adc = MQ2_ADC_MAX + 1; // ppm超过报警阈值的最小ADC码（ppm随ADC码单调递增）
+static uint16_t mq2_release_adc = MQ2_ADC_MAX + 1; // ppm超过解除阈值的最小ADC码，低于它时解除报警
+
+// 模拟看门狗：阈值为换算到实测VDDA下的原始ADC码
+static volatile bool mq2_alarm_active = false;
+static uint16_t mq2_awd_alarm_raw = MQ2_ADC_MAX + 1;
+static uint16_t mq2_awd_release_raw = MQ2_ADC_MAX + 1;
+static volatile bool mq2_awd_pending = false;      // 单次转换越界，待平均值确认
+static volatile uint32_t mq2_awd_trip_count = 0;   // 越界时已产生的平均值个数
+
+static int8_t mq2_scan_index = -1;  // ADC扫描服务中的通道编号
+static uint32_t mq2_scan_count = 0; // 已处理的平均值个数，用于判断是否有新样本
+
+// 预热、校准与基线跟踪
+static MQ2_Status_t mq2_status = {0};
+static uint32_t mq2_preheat_start = 0;
+static float mq2_calib_sum_Rs = 0.0f;
+
+/* ==================== 内部函数 ==================== */
 
 /**
- * @brief 初始化MQ2传感器
+ * @brief ADC码换算为传感器电阻Rs
+ * @param adc_value: ADC码（不小于MQ2_ADC_VALID_MIN，可带平均得到的小数）
+ * @retval Rs(kΩ)
  */
-void MQ2_Init(void)
+static float MQ2_ADC_To_Rs(float adc_value)
 {
-    // ADC已在CubeMX中配置，此处仅启动ADC
-    HAL_ADC_Start(&hadc1);
+    // Rs = (Vc - Vout) / Vout * RL，Vout = adc * Vref / 4095
+    // 化简为 Rs = (Vc / Vref * 4095 - adc) / adc * RL，只需一次除法
+    return ((MQ2_VCC / MQ2_VREF * (float)MQ2_ADC_MAX) - adc_value) /
+           adc_value * MQ2_LOAD_RESISTANCE;
+}
 
-    printf("MQ2: Init Success, Preheating...\r\n");
-    printf("MQ2: Please wait 3 minutes for preheating\r\n");
+/**
+ * @brief 传感器电阻Rs换算为ADC码（MQ2_ADC_To_Rs的反函数）
+ * @param Rs: 传感器电阻(kΩ)
+ * @retval ADC码（带小数，Rs很小时可超过满量程）
+ */
+static float MQ2_Rs_To_ADC(float Rs)
+{
+    // Vout = Vc * RL / (Rs + RL)
+    return (MQ2_VCC / MQ2_VREF * (float)MQ2_ADC_MAX) * MQ2_LOAD_RESISTANCE / (Rs + MQ2_LOAD_RESISTANCE);
 }
 
 /**
- * @brief 校准MQ2传感器（在清洁空气中）
- * @retval R0值(kΩ)
+ * @brief 读数的传感器电阻Rs（只在校准和基线跟踪取样时计算，读数本身不需要）
+ * @param data: 读数
+ * @retval Rs(kΩ)，电压过低时返回0
+ */
+static float MQ2_Data_Rs(const MQ2_Data_t *data)
+{
+    if (data->adc_ref < ((uint32_t)MQ2_ADC_VALID_MIN << ADC_SCAN_FRAC_BITS)) {
+        return 0.0f;
+    }
+
+    return MQ2_ADC_To_Rs((float)data->adc_ref * (1.0f / (float)(1U << ADC_SCAN_FRAC_BITS)));
+}
+
+/**
+ * @brief 按当前AHT20数据更新补偿系数k，数据无效时不补偿
  */
-float MQ2_Calibrate(void)
+static void MQ2_Update_Compensation(void)
 {
-    float sum_Rs = 0.0f;
-    uint32_t adc_value;
-    float voltage, Rs;
+    float k = 1.0f;
+
+    if (aht20_data.is_valid) {
+        k = MQ2_Compensation_Factor(aht20_data.temperature, aht20_data.humidity);
+    }
+
+    // ppm = A * (Rs/R0/k)^B = A * (Rs/R0)^B * k^(-B)：补偿作为查表后的乘数，
+    // AHT20约2秒更新一次，k变化时才重算powf
+    if (k != mq2_comp_k) {
+        mq2_comp_k = k;
+        mq2_comp_gain_scaled = powf(k, -MQ2_CURVE_B) * (1.0f / (float)MQ2_PPM_TABLE_SCALE);
+    }
+}
 
-    printf("MQ2: Calibration started (50 samples)...\r\n");
+/**
+ * @brief 按当前R0重建ADC码到ppm的查找表
+ */
+static void MQ2_Build_Table(void)
+{
+    uint32_t adc;
 
-    // 采集50个样本求平均
-    for (int i = 0; i < 50; i++) {
-        HAL_ADC_PollForConversion(&hadc1, 100);
-        adc_value = HAL_ADC_GetValue(&hadc1);
+    mq2_alarm_adc = MQ2_ADC_MAX + 1;
+    mq2_release_adc = MQ2_ADC_MAX + 1;
 
-        // 转换为电压 (3.3V参考)
-        voltage = (float)adc_value * 3.3f / 4095.0f;
+    for (adc = 0; adc <= MQ2_ADC_MAX; adc++) {
+        float ppm = 0.0f;
 
-        // 计算传感器电阻 Rs (kΩ)
-        // Rs = (Vc - Vout) / Vout * RL
-        // Vc = 5V (MQ2供电电压)
-        if (voltage > 0.1f) {  // 避免除零
-            Rs = ((5.0f - voltage) / voltage) * MQ2_LOAD_RESISTANCE;
-            sum_Rs += Rs;
+        if (adc >= MQ2_ADC_VALID_MIN) {
+            // 不限幅到MQ2_PPM_MAX：补偿增益可小于1，查表乘增益后再限幅
+            ppm = MQ2_CURVE_A * powf(MQ2_ADC_To_Rs((float)adc) / R0, MQ2_CURVE_B);
+            if (ppm > MQ2_ALARM_THRESHOLD && mq2_alarm_adc > MQ2_ADC_MAX) {
+                mq2_alarm_adc = (uint16_t)adc;
+            }
+            if (ppm > MQ2_ALARM_RELEASE && mq2_release_adc > MQ2_ADC_MAX) {
+                mq2_release_adc = (uint16_t)adc;
+            }
         }
 
-        HAL_Delay(100);
+        ppm *= (float)MQ2_PPM_TABLE_SCALE;
+        mq2_ppm_table[adc] = (ppm < (float)UINT16_MAX) ? (uint16_t)(ppm + 0.5f) : UINT16_MAX;
     }
+}
+
+/**
+ * @brief 查找表中的阈值码换算为实测VDDA和当前温湿度下的原始ADC码（向上取整）
+ * @param code: MQ2_VREF参考下的ADC码，超过满量程表示不可达
+ * @param vdda: 实测VDDA(V)
+ * @param comp: 温湿度补偿系数
+ * @retval 原始ADC码，不可达时返回MQ2_ADC_MAX + 1
+ */
+static uint16_t MQ2_Code_To_Raw(uint16_t code, float vdda, float comp)
+{
+    float raw;
 
-    float avg_Rs = sum_Rs / 50.0f;
+    if (code > MQ2_ADC_MAX) {
+        return MQ2_ADC_MAX + 1;
+    }
 
-    // 清洁空气中 Rs/R0 = 9.9 (根据MQ2数据手册)
-    R0 = avg_Rs / 9.9f;
+    // 补偿后Rs/k达到阈值对应的实测Rs为阈值Rs x k
+    raw = ceilf(MQ2_Rs_To_ADC(MQ2_ADC_To_Rs((float)code) * comp) * (MQ2_VREF / vdda));
+    if (raw > (float)MQ2_ADC_MAX) {
+        return MQ2_ADC_MAX + 1;
+    }
+    return (uint16_t)raw;
+}
 
-    printf("MQ2: Calibration completed, R0=%.2f kΩ\r\n", R0);
+/**
+ * @brief 按当前报警状态设置模拟看门狗窗口
+ */
+static void MQ2_Arm_Watchdog(void)
+{
+    if (mq2_status.state == MQ2_STATE_PREHEAT) {
+        // 预热中输出偏高且不稳定，窗口取满量程不触发
+        ADC_SCAN_Set_Watchdog_Window(0, MQ2_ADC_MAX);
+    } else if (mq2_awd_pending) {
+        // 待确认：窗口取满量程，确认前不再每次转换都进中断
+        ADC_SCAN_Set_Watchdog_Window(0, MQ2_ADC_MAX);
+    } else if (!mq2_alarm_active) {
+        // 布防：转换结果 ≥ 报警码时触发（高阈值为报警码-1，不可达时设满量程不触发）
+        ADC_SCAN_Set_Watchdog_Window(0, (mq2_awd_alarm_raw > MQ2_ADC_MAX) ? MQ2_ADC_MAX : mq2_awd_alarm_raw - 1);
+    } else {
+        // 报警中：转换结果 < 解除码时触发
+        ADC_SCAN_Set_Watchdog_Window((mq2_awd_release_raw > MQ2_ADC_MAX) ? MQ2_ADC_MAX : mq2_awd_release_raw, MQ2_ADC_MAX);
+    }
+}
 
+/**
+ * @brief 模拟看门狗越界（ADC中断中调用）：记下越界，唤醒mq2_alarm_task确认
+ * @note  看门狗比较的是单次转换，未经抽取，噪声尖峰也会越界；
+ *        报警状态只在平均值确认后切换
+ */
+static void MQ2_Watchdog_Handler(void)
+{
+    mq2_awd_pending = true;
+    mq2_awd_trip_count = ADC_SCAN_Get_Count(mq2_scan_index);
+    mq2_status.awd_trips++;
+    MQ2_Arm_Watchdog();
+    scheduler_notify(mq2_alarm_task);
+}
+
+/**
+ * @brief 用越界后完成的平均值确认看门狗越界（任务中调用）
+ * @param toggled: 输出，报警状态是否切换
+ * @retval true: 已处理（确认或否决）, false: 尚无新的平均值
+ */
+static bool MQ2_Confirm_Watchdog(bool *toggled)
+{
+    uint32_t primask;
+    uint16_t code;
+    bool crossed;
+
+    *toggled = false;
+    if (ADC_SCAN_Get_Count(mq2_scan_index) == mq2_awd_trip_count ||
+        !ADC_SCAN_Read(mq2_scan_index, &code)) {
+        return false;
+    }
+
+    // 平均值与单次转换用同一原始码阈值比较（平均值带ADC_SCAN_FRAC_BITS位小数）
+    if (!mq2_alarm_active) {
+        crossed = ((uint32_t)code >= ((uint32_t)mq2_awd_alarm_raw << ADC_SCAN_FRAC_BITS));
+    } else {
+        crossed = ((uint32_t)code < ((uint32_t)mq2_awd_release_raw << ADC_SCAN_FRAC_BITS));
+    }
+
+    // 未确认时恢复原窗口，仍越界的下一次转换会再次触发
+    primask = __get_PRIMASK();
+    __disable_irq();
+    if (crossed) {
+        mq2_alarm_active = !mq2_alarm_active;
+    } else {
+        mq2_status.awd_rejected++;
+    }
+    mq2_awd_pending = false;
+    MQ2_Arm_Watchdog();
+    __set_PRIMASK(primask);
+
+    *toggled = crossed;
+    return true;
+}
+
+/**
+ * @brief 设置看门狗阈值并重新布防（任务中调用）
+ * @param alarm_raw: 报警原始ADC码
+ * @param release_raw: 解除原始ADC码
+ */
+static void MQ2_Apply_Watchdog(uint16_t alarm_raw, uint16_t release_raw)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    // 与看门狗中断互斥：中断中会切换状态并改写窗口
+    __disable_irq();
+    mq2_awd_alarm_raw = alarm_raw;
+    mq2_awd_release_raw = release_raw;
+    MQ2_Arm_Watchdog();
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief 按当前查找表、实测VDDA和温湿度更新看门狗阈值（任一变化时）
+ */
+static void MQ2_Update_Watchdog(void)
+{
+    float vdda = ADC_SCAN_Get_VDDA();
+    uint16_t alarm_raw;
+    uint16_t release_raw;
+    bool unreachable;
+
+    MQ2_Update_Compensation();
+    alarm_raw = MQ2_Code_To_Raw(mq2_alarm_adc, vdda, mq2_comp_k);
+    release_raw = MQ2_Code_To_Raw(mq2_release_adc, vdda, mq2_comp_k);
+    unreachable = (alarm_raw > MQ2_ADC_MAX);
+
+    // 阈值超出量程时看门狗只能取满量程窗口，报警不会触发：报告错误而不是静默撤防
+    if (unreachable != mq2_status.alarm_unreachable) {
+        mq2_status.alarm_unreachable = unreachable;
+        if (unreachable) {
+            printf("MQ2: Error, %.0f ppm alarm unreachable (R0=%.2f kΩ), watchdog disarmed\r\n",
+                   MQ2_ALARM_THRESHOLD, R0);
+        }
+    }
+
+    if (alarm_raw != mq2_awd_alarm_raw || release_raw != mq2_awd_release_raw) {
+        MQ2_Apply_Watchdog(alarm_raw, release_raw);
+    }
+}
+
+/**
+ * @brief 开始一次校准采样
+ */
+static void MQ2_Begin_Calibration(void)
+{
+    mq2_calib_sum_Rs = 0.0f;
+    mq2_status.calib_samples = 0;
+    mq2_status.calib_rejected = 0;
+    mq2_status.calib = MQ2_CALIB_RUNNING;
+    mq2_status.state = MQ2_STATE_CALIBRATING;
+}
+
+/**
+ * @brief 校准：累计一个样本，凑够有效样本后按有效样本数求平均
+ * @param data: 本次读数
+ */
+static void MQ2_Calibrate_Step(const MQ2_Data_t *data)
+{
+    float Rs = MQ2_Data_Rs(data);
+
+    if (Rs > 0.0f) {
+        mq2_calib_sum_Rs += Rs / data->comp;  // 折算到参考温湿度
+        mq2_status.calib_samples++;
+    } else {
+        mq2_status.calib_rejected++;  // 电压过低，不计入平均
+    }
+
+    if (mq2_status.calib_samples >= MQ2_CALIB_SAMPLES) {
+        // 清洁空气中 Rs/R0 = 9.9 (根据MQ2数据手册)，R0变化后重建查找表
+        MQ2_Set_R0(mq2_calib_sum_Rs / (float)mq2_status.calib_samples / MQ2_CLEAN_AIR_RATIO);
+        mq2_status.calib_R0 = R0;
+        mq2_status.drift_R0 = R0;
+        mq2_status.calib = MQ2_CALIB_DONE;
+        mq2_status.state = MQ2_STATE_READY;
+        printf("MQ2: Calibration completed, R0=%.2f kΩ (%u rejected)\r\n",
+               R0, mq2_status.calib_rejected);
+    } else if (mq2_status.calib_rejected >= MQ2_CALIB_MAX_REJECT) {
+        mq2_status.calib = MQ2_CALIB_FAILED;
+        mq2_status.state = MQ2_STATE_READY;
+        printf("MQ2: Calibration failed, R0=%.2f kΩ kept\r\n", R0);
+    }
+}
+
+/**
+ * @brief 基线跟踪：无报警且读数接近清洁空气时，慢速跟踪R0漂移
+ * @param data: 本次读数
+ */
+static void MQ2_Track_Baseline(const MQ2_Data_t *data)
+{
+    const float alpha = (MQ2_TASK_PERIOD_MS / 1000.0f) / MQ2_DRIFT_TAU_S;
+    float Rs;
+    float r0;
+
+    if (mq2_alarm_active) {
+        return;
+    }
+
+    Rs = MQ2_Data_Rs(data);
+    if (!(Rs > 0.0f)) {
+        return;
+    }
+
+    // Rs明显低于清洁空气预期说明有气体，明显偏高多为异常，都不用于跟踪
+    r0 = Rs / data->comp * (1.0f / MQ2_CLEAN_AIR_RATIO);
+    if (fabsf(r0 - mq2_status.drift_R0) > MQ2_DRIFT_BAND * mq2_status.drift_R0) {
+        return;
+    }
+
+    mq2_status.drift_R0 += alpha * (r0 - mq2_status.drift_R0);
+    mq2_status.drift_samples++;
+
+    // 漂移累计到一定程度才重建查找表（约4096次powf）
+    if (fabsf(mq2_status.drift_R0 - R0) > MQ2_DRIFT_REBUILD * R0) {
+        MQ2_Set_R0(mq2_status.drift_R0);
+        mq2_status.drift_updates++;
+    }
+}
+
+/**
+ * @brief 推进预热/校准/基线跟踪状态（每次任务调用）
+ * @param data: 本次读数
+ */
+static void MQ2_Update_State(const MQ2_Data_t *data)
+{
+    uint32_t count = ADC_SCAN_Get_Count(mq2_scan_index);
+    bool fresh = (count != mq2_scan_count);
+
+    mq2_scan_count = count;
+
+    if (mq2_status.state == MQ2_STATE_PREHEAT) {
+        uint32_t elapsed = HAL_GetTick() - mq2_preheat_start;
+
+        if (elapsed < MQ2_PREHEAT_MS) {
+            mq2_status.preheat_remaining_ms = MQ2_PREHEAT_MS - elapsed;
+            return;
+        }
+
+        mq2_status.preheat_remaining_ms = 0;
+        mq2_status.state = MQ2_STATE_READY;
+        if (mq2_status.calib == MQ2_CALIB_PENDING) {
+            MQ2_Begin_Calibration();
+        }
+        MQ2_Apply_Watchdog(mq2_awd_alarm_raw, mq2_awd_release_raw);  // 预热结束，布防报警
+        printf("MQ2: Preheat done\r\n");
+        return;
+    }
+
+    if (!fresh) {
+        return;
+    }
+
+    if (mq2_status.state == MQ2_STATE_CALIBRATING) {
+        MQ2_Calibrate_Step(data);
+    } else {
+        MQ2_Track_Baseline(data);
+    }
+}
+
+/* ==================== 函数实现 ==================== */
+
+/**
+ * @brief 初始化MQ2传感器（登记ADC扫描通道，需在ADC_SCAN_Start之前调用）
+ */
+void MQ2_Init(void)
+{
+    // MQ2输出阻抗较高，用最长采样时间
+    mq2_scan_index = ADC_SCAN_Add_Channel(MQ2_ADC_CHANNEL, ADC_SAMPLETIME_480CYCLES, MQ2_OVERSAMPLE_SHIFT);
+    if (mq2_scan_index < 0 || ADC_SCAN_Set_Watchdog(mq2_scan_index, MQ2_Watchdog_Handler) != 0) {
+        printf("MQ2: ADC channel register failed\r\n");
+    }
+
+    // 预热开始计时，预热结束前不布防报警
+    mq2_status.state = MQ2_STATE_PREHEAT;
+    mq2_status.preheat_remaining_ms = MQ2_PREHEAT_MS;
+    mq2_preheat_start = HAL_GetTick();
+
+    // 按默认R0建立查找表，校准或基线跟踪后重建
+    MQ2_Set_R0(MQ2_R0_CLEAN_AIR);
+    mq2_status.drift_R0 = R0;
+
+    printf("MQ2: Init Success, Preheating...\r\n");
+}
+
+/**
+ * @brief 开始校准（在清洁空气中，不阻塞；预热未结束时等到预热结束再开始）
+ */
+void MQ2_Start_Calibration(void)
+{
+    if (mq2_status.state == MQ2_STATE_PREHEAT) {
+        mq2_status.calib = MQ2_CALIB_PENDING;
+        return;
+    }
+
+    MQ2_Begin_Calibration();
+}
+
+/**
+ * @brief 获取校准与基线跟踪状态
+ * @retval 状态指针
+ */
+const MQ2_Status_t *MQ2_Get_Status(void)
+{
+    return &mq2_status;
+}
+
+/**
+ * @brief 设置基准电阻R0并重建ADC码到ppm的查找表
+ * @param r0: 清洁空气中的基准电阻(kΩ)
+ */
+void MQ2_Set_R0(float r0)
+{
+    if (!(r0 > 0.0f)) {
+        return;  // 校准无有效样本时保持原值
+    }
+
+    R0 = r0;
+    MQ2_Build_Table();
+    MQ2_Update_Watchdog();
+}
+
+/**
+ * @brief 获取当前基准电阻R0
+ * @retval R0值(kΩ)
+ */
+float MQ2_Get_R0(void)
+{
     return R0;
 }
 
@@ -78,35 +485,94 @@ float MQ2_Calibrate(void)
  */
 void MQ2_Read_Data(MQ2_Data_t *data)
 {
-    // 读取ADC值
-    HAL_ADC_PollForConversion(&hadc1, 100);
-    data->adc_value = HAL_ADC_GetValue(&hadc1);
+    uint16_t raw;
+    uint32_t code;
+    uint32_t frac;
+    float adc;
 
-    // 转换为电压
-    data->voltage = (float)data->adc_value * 3.3f / 4095.0f;
+    // 读取扫描服务的最新平均值，不等待转换
+    if (!ADC_SCAN_Read(mq2_scan_index, &raw)) {
+        raw = 0;
+    }
+    data->adc_value = (raw + (1U << (ADC_SCAN_FRAC_BITS - 1))) >> ADC_SCAN_FRAC_BITS;
+    data->voltage = ADC_SCAN_Get_Voltage(mq2_scan_index);
+
+    MQ2_Update_Compensation();
+    data->comp = mq2_comp_k;
 
-    // 计算传感器电阻 Rs
-    if (data->voltage > 0.1f) {
-        data->Rs = ((5.0f - data->voltage) / data->voltage) * MQ2_LOAD_RESISTANCE;
+    // 按实测电压折算成MQ2_VREF参考下的ADC码（保留小数位），查找表按该参考建立
+    adc = data->voltage * ((float)MQ2_ADC_MAX * (float)(1U << ADC_SCAN_FRAC_BITS) / MQ2_VREF) + 0.5f;
+    if (adc < 0.0f) adc = 0.0f;
+    if (adc > (float)(MQ2_ADC_MAX << ADC_SCAN_FRAC_BITS)) adc = (float)(MQ2_ADC_MAX << ADC_SCAN_FRAC_BITS);
+    data->adc_ref = (uint32_t)adc;
 
-        // 计算Rs/R0比值
-        data->ratio = data->Rs / R0;
+    if (data->adc_ref >= ((uint32_t)MQ2_ADC_VALID_MIN << ADC_SCAN_FRAC_BITS)) {
+        uint32_t next;
+        int32_t step;
+        float ppm;
 
-        // 计算ppm浓度
-        data->ppm = MQ2_Calculate_PPM(data->Rs, R0);
+        code = data->adc_ref >> ADC_SCAN_FRAC_BITS;
+        frac = data->adc_ref & ((1U << ADC_SCAN_FRAC_BITS) - 1);
 
-        // 检查报警
-        data->alarm = (data->ppm > MQ2_ALARM_THRESHOLD);
+        // 参考温湿度下的ppm按相邻两个ADC码的表项线性插值，再乘补偿增益
+        next = (code < MQ2_ADC_MAX) ? code + 1 : code;
+        step = (int32_t)mq2_ppm_table[next] - (int32_t)mq2_ppm_table[code];
+        ppm = ((float)mq2_ppm_table[code] +
+               (float)(step * (int32_t)frac) * (1.0f / (float)(1U << ADC_SCAN_FRAC_BITS))) * mq2_comp_gain_scaled;
+        data->ppm = (ppm > MQ2_PPM_MAX) ? MQ2_PPM_MAX : ppm;
+        data->alarm = mq2_alarm_active;
     } else {
-        data->Rs = 0;
-        data->ratio = 0;
         data->ppm = 0;
         data->alarm = false;
     }
 }
 
 /**
- * @brief 计算烟雾浓度
+ * @brief 当前是否处于报警状态
+ * @retval true: 报警
+ */
+bool MQ2_Is_Alarm(void)
+{
+    return mq2_alarm_active;
+}
+
+/**
+ * @brief 温湿度补偿系数（补偿表双线性插值）
+ * @param temperature: 温度(℃)
+ * @param humidity: 相对湿度(%RH)
+ * @retval 系数k，补偿后Rs/R0 = 实测Rs/R0 / k
+ */
+float MQ2_Compensation_Factor(float temperature, float humidity)
+{
+    float ft = (temperature - MQ2_COMP_T_MIN) * (1.0f / MQ2_COMP_T_STEP);
+    float fh = (humidity - MQ2_COMP_RH_MIN) * (1.0f / MQ2_COMP_RH_STEP);
+    uint32_t i;
+    uint32_t j;
+    float k0;
+    float k1;
+
+    // 超出表范围按边界取值
+    if (ft < 0.0f) ft = 0.0f;
+    if (ft > (float)(MQ2_COMP_T_POINTS - 1)) ft = (float)(MQ2_COMP_T_POINTS - 1);
+    if (fh < 0.0f) fh = 0.0f;
+    if (fh > (float)(MQ2_COMP_RH_POINTS - 1)) fh = (float)(MQ2_COMP_RH_POINTS - 1);
+
+    // 所在格左下角，落在最后一行/列时取前一格（小数部分为1）
+    i = (uint32_t)ft;
+    j = (uint32_t)fh;
+    if (i > MQ2_COMP_T_POINTS - 2) i = MQ2_COMP_T_POINTS - 2;
+    if (j > MQ2_COMP_RH_POINTS - 2) j = MQ2_COMP_RH_POINTS - 2;
+    ft -= (float)i;
+    fh -= (float)j;
+
+    k0 = mq2_comp_table[i][j] + fh * (mq2_comp_table[i][j + 1] - mq2_comp_table[i][j]);
+    k1 = mq2_comp_table[i + 1][j] + fh * (mq2_comp_table[i + 1][j + 1] - mq2_comp_table[i + 1][j]);
+
+    return k0 + ft * (k1 - k0);
+}
+
+/**
+ * @brief 计算烟雾浓度（直接按特性曲线计算；读数走查找表，不调用本函数）
  * @param Rs: 传感器电阻(kΩ)
  * @param R0: 清洁空气中的基准电阻(kΩ)
  * @retval 烟雾浓度(ppm)
@@ -115,15 +581,16 @@ float MQ2_Calculate_PPM(float Rs, float R0)
 {
     float ratio = Rs / R0;
 
-    // MQ2的ppm计算公式（根据数据手册拟合）
-    // ppm = (ratio / a) ^ (1/b)
-    // 其中 a=11.5428, b=-1.5278 (经验值)
+    // MQ2的ppm计算公式（根据数据手册烟雾特性曲线拟合）
+    // ppm = a * ratio ^ b，其中 a=MQ2_CURVE_A, b=MQ2_CURVE_B
+    // （原拟合 ppm = (ratio/11.5428)^(1/-1.5278) 在清洁空气只有约1ppm，
+    //   满量程不足25ppm，报警阈值永远达不到）
 
-    float ppm = powf(ratio / 11.5428f, 1.0f / -1.5278f);
+    float ppm = MQ2_CURVE_A * powf(ratio, MQ2_CURVE_B);
 
     // 限制范围
     if (ppm < 0) ppm = 0;
-    if (ppm > 10000) ppm = 10000;
+    if (ppm > MQ2_PPM_MAX) ppm = MQ2_PPM_MAX;
 
     return ppm;
 }
@@ -144,6 +611,32 @@ void MQ2_Print_Data(MQ2_Data_t *data)
  */
 void mq2_task(void)
 {
+    // VDDA随电池电压变化，看门狗阈值随之换算
+    MQ2_Update_Watchdog();
     MQ2_Read_Data(&mq2_data);
+    MQ2_Update_State(&mq2_data);
     MQ2_Print_Data(&mq2_data);
 }
+
+/**
+ * @brief MQ2报警事件任务（模拟看门狗中断唤醒，按平均值确认后切换报警状态）
+ */
+void mq2_alarm_task(void)
+{
+    bool toggled;
+
+    if (!mq2_awd_pending) {
+        return;
+    }
+    if (!MQ2_Confirm_Watchdog(&toggled)) {
+        // 越界样本尚未抽取成平均值，稍后再查
+        scheduler_notify_after(mq2_alarm_task, MQ2_CONFIRM_POLL_MS);
+        return;
+    }
+    if (!toggled) {
+        return;
+    }
+
+    mq2_data.alarm = mq2_alarm_active;
+    printf("MQ2: Alarm %s\r\n", mq2_data.alarm ? "ON" : "OFF");
+}
@@ -11,7 +11,25 @@
   * - 使用ADC1_IN0（PA0）采集模拟电压
   * - 检测范围：200-10000ppm
   * - 响应时间：<10秒
-  * - 需要预热3分钟
+  * - 需要预热3分钟：预热期间状态为MQ2_STATE_PREHEAT，不布防报警
+  * - ADC为12位，给定R0时每个ADC码对应固定的ppm：R0变化时重建4096项查找表，
+  *   每次采样只需查表，不再调用powf
+ * - 通过ADC扫描服务（adc_scan）采样：每2^MQ2_OVERSAMPLE_SHIFT次采样输出一个
+ *   平均值，任务直接读取最新平均值，不再轮询等待转换
+ * - 电压按VREFINT实测的VDDA换算，再折算成MQ2_VREF参考下的ADC码查表
+ * - 报警由ADC1模拟看门狗检测：报警阈值经R0和实测VDDA换算为原始ADC码，
+ *   单次转换越过即进入中断唤醒mq2_alarm_task，不依赖500ms轮询；看门狗比较的是
+ *   未抽取的单次转换，由mq2_alarm_task用越界后完成的平均值确认后才置位报警，
+ *   未确认则恢复窗口（噪声尖峰不报警）；报警后窗口改为检测回落到
+ *   MQ2_ALARM_RELEASE以下（滞回），解除同样经平均值确认
+ * - 校准不阻塞：MQ2_Start_Calibration()后由mq2_task每次取一个平均值，
+ *   凑够MQ2_CALIB_SAMPLES个有效样本后按有效样本数求平均得到R0
+ * - 基线跟踪：无报警且Rs接近清洁空气预期时，以小时级时间常数跟踪R0漂移，
+ *   偏离当前R0超过MQ2_DRIFT_REBUILD时更新R0并重建查找表
+ * - 温湿度补偿：按AHT20温湿度在补偿表中双线性插值得到系数k，Rs/R0除以k；
+ *   特性曲线为幂律，等价于查表所得ppm乘以k^(-B)（k变化时重算），读数路径
+ *   不做除法，也不计算Rs。R0、查找表均对应参考条件20℃/65%RH；
+ *   aht20_data无效时k=1，退回未补偿读数
   *
   ******************************************************************************
   */
@@ -26,34 +44,119 @@
 
 #define MQ2_LOAD_RESISTANCE     4.7f    // 负载电阻(kΩ)
 #define MQ2_R0_CLEAN_AIR        10.0f   // 清洁空气中的R0值(kΩ，需校准)
+#define MQ2_CLEAN_AIR_RATIO     9.9f    // 清洁空气中Rs/R0（数据手册）
 #define MQ2_ALARM_THRESHOLD     300.0f  // 报警阈值(ppm)
+#define MQ2_ALARM_RELEASE       250.0f  // 报警解除阈值(ppm)，与报警阈值之间为滞回区
+#define MQ2_CURVE_A             3616.1f // 烟雾特性曲线 ppm = A * (Rs/R0)^B（数据手册Smoke曲线拟合）
+#define MQ2_CURVE_B             -2.675f // 清洁空气约8ppm，300ppm对应Rs/R0约2.54
+#define MQ2_PPM_MAX             10000.0f // 输出上限(ppm)
+
+#define MQ2_ADC_MAX             4095    // 12位ADC满量程
+#define MQ2_VREF                3.3f    // 查找表对应的ADC参考电压(V)，实测VDDA偏离时按比例折算
+#define MQ2_VCC                 5.0f    // MQ2供电电压(V)
+#define MQ2_ADC_VALID_MIN       125     // 低于该值（约0.1V）视为无效，避免Rs计算除零
+#define MQ2_TASK_PERIOD_MS      500     // mq2_task调用周期(ms)
+#define MQ2_PREHEAT_MS          180000  // 预热时间(ms)
+
+#define MQ2_CALIB_SAMPLES       50      // 校准所需有效样本数（每次任务取一个，约25秒）
+#define MQ2_CALIB_MAX_REJECT    50      // 无效样本（电压过低）达到该数时校准失败
+
+#define MQ2_DRIFT_TAU_S         7200.0f // 基线跟踪时间常数(s)
+#define MQ2_DRIFT_BAND          0.2f    // Rs偏离清洁空气预期超过±20%的样本不参与跟踪（可能有气体）
+#define MQ2_DRIFT_REBUILD       0.02f   // 跟踪值偏离当前R0超过2%时更新R0
+
+#define MQ2_COMP_T_MIN          -10.0f  // 补偿表温度起点(℃)
+#define MQ2_COMP_T_STEP         10.0f   // 补偿表温度间隔(℃)
+#define MQ2_COMP_T_POINTS       7       // -10~50℃，超出范围按边界取值
+#define MQ2_COMP_RH_MIN         20.0f   // 补偿表湿度起点(%RH)
+#define MQ2_COMP_RH_STEP        20.0f   // 补偿表湿度间隔(%RH)
+#define MQ2_COMP_RH_POINTS      5       // 20~100%RH
+
+#define MQ2_ADC_CHANNEL         ADC_CHANNEL_0   // PA0
+#define MQ2_OVERSAMPLE_SHIFT    6       // 每个输出平均64次采样（1kHz触发时约15.6Hz输出）
+#define MQ2_CONFIRM_POLL_MS     16      // 看门狗越界后查询新平均值的间隔(ms)，1kHz触发时DMA每16ms抽取一次
 
 /* ==================== 数据结构 ==================== */
 
+/**
+ * @brief MQ2工作状态
+ */
+typedef enum {
+    MQ2_STATE_PREHEAT = 0,      // 预热中（读数不可靠，不布防报警）
+    MQ2_STATE_CALIBRATING,      // 校准中（须处于清洁空气）
+    MQ2_STATE_READY             // 正常检测
+} MQ2_State_t;
+
+/**
+ * @brief 校准结果
+ */
+typedef enum {
+    MQ2_CALIB_NONE = 0,         // 未校准（使用默认R0）
+    MQ2_CALIB_PENDING,          // 已请求，等待预热结束
+    MQ2_CALIB_RUNNING,          // 采样中
+    MQ2_CALIB_DONE,             // 完成
+    MQ2_CALIB_FAILED            // 无效样本过多，R0保持不变
+} MQ2_Calib_Result_t;
+
+/**
+ * @brief 校准与基线跟踪状态
+ */
+typedef struct {
+    MQ2_State_t state;              // 工作状态
+    uint32_t preheat_remaining_ms;  // 剩余预热时间(ms)
+    MQ2_Calib_Result_t calib;       // 校准结果
+    uint16_t calib_samples;         // 本次校准有效样本数
+    uint16_t calib_rejected;        // 本次校准无效样本数
+    float calib_R0;                 // 最近一次校准得到的R0(kΩ)
+    float drift_R0;                 // 基线跟踪估计的清洁空气R0(kΩ)
+    uint32_t drift_samples;         // 参与跟踪的样本数
+    uint32_t drift_updates;         // 因漂移更新R0的次数
+    bool alarm_unreachable;         // 报警阈值超出ADC量程，看门狗无法布防（错误）
+    uint32_t awd_trips;             // 看门狗越界次数（单次转换）
+    uint32_t awd_rejected;          // 其中未被平均值确认的次数
+} MQ2_Status_t;
+
 /**
  * @brief MQ2数据结构
  */
 typedef struct {
-    uint32_t adc_value;      // ADC原始值(0-4095)
+    uint32_t adc_value;      // ADC平均值(0-4095，四舍五入)
     float voltage;           // 电压值(V)
-    float Rs;                // 传感器电阻(kΩ)
-    float ratio;             // Rs/R0比值
-    float ppm;               // 烟雾浓度(ppm)
-    bool alarm;              // 报警标志
+    uint32_t adc_ref;        // 折算到MQ2_VREF参考下的ADC码（ADC_SCAN_FRAC_BITS位小数），查表用
+    float comp;              // 温湿度补偿系数k（AHT20无效时为1）
+    float ppm;               // 烟雾浓度(ppm，已做温湿度补偿)
+    bool alarm;              // 报警标志（模拟看门狗滞回状态）
 } MQ2_Data_t;
 
 /* ==================== 函数声明 ==================== */
 
 /**
- * @brief 初始化MQ2传感器
+ * @brief 初始化MQ2传感器（登记ADC扫描通道，需在ADC_SCAN_Start之前调用）
  */
 void MQ2_Init(void);
 
 /**
- * @brief 校准MQ2传感器（在清洁空气中）
+ * @brief 开始校准（在清洁空气中，不阻塞；预热未结束时等到预热结束再开始）
+ */
+void MQ2_Start_Calibration(void);
+
+/**
+ * @brief 获取校准与基线跟踪状态
+ * @retval 状态指针
+ */
+const MQ2_Status_t *MQ2_Get_Status(void);
+
+/**
+ * @brief 设置基准电阻R0并重建ADC码到ppm的查找表
+ * @param r0: 清洁空气中的基准电阻(kΩ)
+ */
+void MQ2_Set_R0(float r0);
+
+/**
+ * @brief 获取当前基准电阻R0
  * @retval R0值(kΩ)
  */
-float MQ2_Calibrate(void);
+float MQ2_Get_R0(void);
 
 /**
  * @brief 读取MQ2传感器数据
@@ -61,6 +164,20 @@ float MQ2_Calibrate(void);
  */
 void MQ2_Read_Data(MQ2_Data_t *data);
 
+/**
+ * @brief 当前是否处于报警状态
+ * @retval true: 报警
+ */
+bool MQ2_Is_Alarm(void);
+
+/**
+ * @brief 温湿度补偿系数（补偿表双线性插值）
+ * @param temperature: 温度(℃)
+ * @param humidity: 相对湿度(%RH)
+ * @retval 系数k，补偿后Rs/R0 = 实测Rs/R0 / k
+ */
+float MQ2_Compensation_Factor(float temperature, float humidity);
+
 /**
  * @brief 计算烟雾浓度
  * @param Rs: 传感器电阻(kΩ)
@@ -74,6 +191,11 @@ float MQ2_Calculate_PPM(float Rs, float R0);
  */
 void mq2_task(void);
 
+/**
+ * @brief MQ2报警事件任务（模拟看门狗中断唤醒，按平均值确认后切换报警状态）
+ */
+void mq2_alarm_task(void);
+
 /**
  * @brief 打印MQ2数据
  * @param data: 数据结构指针
@@ -0,0 +1,304 @@
+/**
+  ******************************************************************************
+  * @file           : nmea.c
+  * @brief          : NMEA 0183流式解析器实现
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-08
+  ******************************************************************************
+  */
+
+#include "nmea.h"
+#include <string.h>
+
+/* ==================== 常量 ==================== */
+
+// 10的幂，用于定点换算
+static const int32_t nmea_pow10[10] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+// 累加前的上限，保证value*10+9不溢出int32
+#define NMEA_VALUE_LIMIT    214748363
+
+// 小数位数上限，保证nmea_pow10[frac_digits]不越界（值为0时幅值不增长，需单独限制）
+#define NMEA_MAX_FRAC_DIGITS    9
+
+/* ==================== 内部函数 ==================== */
+
+/**
+ * @brief 十六进制字符转数值
+ * @retval 0~15，非法字符返回0xFF
+ */
+static uint8_t NMEA_Hex_Value(char c)
+{
+    if (c >= '0' && c <= '9') return (uint8_t)(c - '0');
+    if (c >= 'A' && c <= 'F') return (uint8_t)(c - 'A' + 10);
+    if (c >= 'a' && c <= 'f') return (uint8_t)(c - 'a' + 10);
+    return 0xFF;
+}
+
+/**
+ * @brief 当前写入的字段（超出容量时写入scratch丢弃）
+ */
+static NMEA_Field_t *NMEA_Current_Field(NMEA_Parser_t *parser)
+{
+    if (parser->field_index < NMEA_MAX_FIELDS) {
+        return &parser->sentence.field[parser->field_index];
+    }
+    return &parser->scratch;
+}
+
+/**
+ * @brief 开始一个新字段
+ */
+static void NMEA_Begin_Field(NMEA_Parser_t *parser)
+{
+    NMEA_Field_t *field = NMEA_Current_Field(parser);
+
+    field->value = 0;
+    field->frac_digits = 0;
+    field->len = 0;
+    field->first = '\0';
+    field->numeric = true;
+    parser->in_frac = false;
+}
+
+/**
+ * @brief 结束当前字段
+ */
+static void NMEA_End_Field(NMEA_Parser_t *parser)
+{
+    NMEA_Field_t *field = NMEA_Current_Field(parser);
+
+    // 只有符号或小数点的字段不是数字
+    if (field->len == 0 || (field->len == 1 && (field->first == '-' || field->first == '.'))) {
+        field->numeric = false;
+    }
+
+    parser->field_index++;
+    if (parser->field_index <= NMEA_MAX_FIELDS) {
+        parser->sentence.field_count = parser->field_index;
+    }
+}
+
+/**
+ * @brief 向当前字段追加一个字符，同时完成数字转换
+ */
+static void NMEA_Field_Char(NMEA_Parser_t *parser, char c)
+{
+    NMEA_Field_t *field = NMEA_Current_Field(parser);
+
+    if (field->len == 0) {
+        field->first = c;
+    }
+    if (field->len < 0xFF) {
+        field->len++;
+    }
+
+    if (!field->numeric) {
+        return;
+    }
+
+    if (c >= '0' && c <= '9') {
+        int32_t mag = field->value < 0 ? -field->value : field->value;
+
+        if (parser->in_frac && field->frac_digits >= NMEA_MAX_FRAC_DIGITS) {
+            // 超出的小数位截断
+            return;
+        }
+        if (mag > NMEA_VALUE_LIMIT) {
+            // 小数部分超出精度直接截断，整数部分溢出则视为非数字
+            if (!parser->in_frac) {
+                field->numeric = false;
+            }
+            return;
+        }
+
+        mag = mag * 10 + (c - '0');
+        field->value = (field->first == '-') ? -mag : mag;
+        if (parser->in_frac) {
+            field->frac_digits++;
+        }
+    } else if (c == '.' && !parser->in_frac) {
+        parser->in_frac = true;
+    } else if (c == '-' && field->len == 1) {
+        // 负号只允许出现在首位
+    } else {
+        field->numeric = false;
+    }
+}
+
+/* ==================== 函数实现 ==================== */
+
+/**
+ * @brief 初始化解析器
+ * @param parser: 解析器指针
+ */
+void NMEA_Parser_Init(NMEA_Parser_t *parser)
+{
+    memset(parser, 0, sizeof(NMEA_Parser_t));
+    parser->state = NMEA_STATE_START;
+}
+
+/**
+ * @brief 输入一个字节
+ * @param parser: 解析器指针
+ * @param c: 接收到的字符
+ * @retval 语句完整且校验通过时返回语句指针（下次输入前有效），否则NULL
+ */
+const NMEA_Sentence_t *NMEA_Parser_Feed(NMEA_Parser_t *parser, char c)
+{
+    uint8_t hex;
+
+    // 任何状态下遇到'$'都重新开始，未完成的语句计为格式错误
+    if (c == '$') {
+        if (parser->state != NMEA_STATE_START) {
+            parser->format_errors++;
+        }
+        parser->state = NMEA_STATE_ADDRESS;
+        parser->checksum = 0;
+        parser->addr_len = 0;
+        parser->length = 1;
+        parser->field_index = 0;
+        parser->sentence.talker = 0;
+        parser->sentence.type = 0;
+        parser->sentence.field_count = 0;
+        return NULL;
+    }
+
+    if (parser->state == NMEA_STATE_START) {
+        return NULL;
+    }
+
+    // 语句中出现行结束符或超长：丢弃
+    if (++parser->length > NMEA_MAX_LEN || c == '\r' || c == '\n') {
+        parser->format_errors++;
+        parser->state = NMEA_STATE_START;
+        return NULL;
+    }
+
+    switch (parser->state) {
+        case NMEA_STATE_ADDRESS:
+            if (c == '*') {
+                parser->state = NMEA_STATE_CHECKSUM_HI;
+                break;
+            }
+            parser->checksum ^= (uint8_t)c;
+            if (c == ',') {
+                parser->state = NMEA_STATE_FIELD;
+                NMEA_Begin_Field(parser);
+            } else if (parser->addr_len < 2) {
+                // 前两个字符为发送方
+                parser->sentence.talker = (uint16_t)((parser->sentence.talker << 8) | (uint8_t)c);
+                parser->addr_len++;
+            } else if (parser->addr_len < 6) {
+                // 其余为语句类型（专有语句如PCAS01最多4个字符，均打包保存）
+                parser->sentence.type = (parser->sentence.type << 8) | (uint8_t)c;
+                parser->addr_len++;
+            } else {
+                parser->format_errors++;
+                parser->state = NMEA_STATE_START;
+            }
+            break;
+
+        case NMEA_STATE_FIELD:
+            if (c == '*') {
+                NMEA_End_Field(parser);
+                parser->state = NMEA_STATE_CHECKSUM_HI;
+                break;
+            }
+            parser->checksum ^= (uint8_t)c;
+            if (c == ',') {
+                NMEA_End_Field(parser);
+                NMEA_Begin_Field(parser);
+            } else {
+                NMEA_Field_Char(parser, c);
+            }
+            break;
+
+        case NMEA_STATE_CHECKSUM_HI:
+            hex = NMEA_Hex_Value(c);
+            if (hex == 0xFF) {
+                parser->format_errors++;
+                parser->state = NMEA_STATE_START;
+                break;
+            }
+            parser->rx_checksum = (uint8_t)(hex << 4);
+            parser->state = NMEA_STATE_CHECKSUM_LO;
+            break;
+
+        case NMEA_STATE_CHECKSUM_LO:
+            hex = NMEA_Hex_Value(c);
+            parser->state = NMEA_STATE_START;
+            if (hex == 0xFF) {
+                parser->format_errors++;
+                break;
+            }
+            parser->rx_checksum |= hex;
+            if (parser->rx_checksum != parser->checksum) {
+                parser->checksum_errors++;
+                break;
+            }
+            parser->sentence_count++;
+            return &parser->sentence;
+
+        default:
+            parser->state = NMEA_STATE_START;
+            break;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief 字段是否为非空有效数字
+ * @param field: 字段指针
+ * @retval true: 有效
+ */
+bool NMEA_Field_Is_Number(const NMEA_Field_t *field)
+{
+    return field->len > 0 && field->numeric;
+}
+
+/**
+ * @brief 将数字字段换算为指定小数位数的定点整数（多余小数位截断）
+ * @param field: 字段指针
+ * @param digits: 目标小数位数，如2表示结果为原值*100
+ * @retval 定点整数
+ */
+int32_t NMEA_Field_To_Fixed(const NMEA_Field_t *field, uint8_t digits)
+{
+    if (!NMEA_Field_Is_Number(field)) {
+        return 0;
+    }
+
+    if (digits >= field->frac_digits) {
+        uint8_t shift = digits - field->frac_digits;
+        int64_t v;
+
+        if (shift >= 10) {
+            return 0;
+        }
+        // 补小数位可能超出int32，饱和处理（只可能出现在畸形字段上）
+        v = (int64_t)field->value * nmea_pow10[shift];
+        if (v > INT32_MAX) return INT32_MAX;
+        if (v < -INT32_MAX) return -INT32_MAX;
+        return (int32_t)v;
+    }
+
+    return field->value / nmea_pow10[field->frac_digits - digits];
+}
+
+/**
+ * @brief 将数字字段转换为float（兼容浮点数据字段）
+ * @param field: 字段指针
+ * @retval 浮点值
+ */
+float NMEA_Field_To_Float(const NMEA_Field_t *field)
+{
+    if (!NMEA_Field_Is_Number(field)) {
+        return 0.0f;
+    }
+
+    return (float)field->value / (float)nmea_pow10[field->frac_digits];
+}
@@ -0,0 +1,127 @@
+/**
+  ******************************************************************************
+  * @file           : nmea.h
+  * @brief          : NMEA 0183流式解析器头文件
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-08
+  ******************************************************************************
+  * @attention
+  *
+  * 逐字节状态机解析NMEA语句，不复制字符串、不使用strtok/atof：
+  * - 地址字段打包成整数（发送方2字符 + 语句类型），按整数比较分发
+  * - 数据字段边接收边转换：数字去掉小数点累加为int32，记录小数位数
+  * - 空字段保留位置（len=0），字段序号不会因空字段错位
+  * - 校验'*'之前所有字符的XOR，校验通过才输出整条语句
+  *
+  ******************************************************************************
+  */
+
+#ifndef __NMEA_H
+#define __NMEA_H
+
+#include "main.h"
+#include <stdbool.h>
+
+/* ==================== 配置参数 ==================== */
+
+#define NMEA_MAX_FIELDS         20      // 每条语句最多保存的数据字段数（GSV为19）
+#define NMEA_MAX_LEN            96      // 语句最大长度（标准82，留余量）
+
+/* ==================== 地址编码 ==================== */
+
+// 发送方（如GN/GP/BD）和语句类型（如RMC/GGA）打包为整数
+#define NMEA_TALKER(a, b)       ((uint16_t)(((uint16_t)(a) << 8) | (uint8_t)(b)))
+#define NMEA_TYPE(a, b, c)      ((uint32_t)(((uint32_t)(a) << 16) | ((uint32_t)(b) << 8) | (uint8_t)(c)))
+
+/* ==================== 数据结构 ==================== */
+
+/**
+ * @brief 单个数据字段
+ */
+typedef struct {
+    int32_t value;          // 去掉小数点后的整数值（含符号），如"3954.52200" -> 395452200
+    uint8_t frac_digits;    // 小数位数，如"3954.52200" -> 5（最多9位，多余截断）
+    uint8_t len;            // 字段字符数（0表示空字段）
+    char first;             // 首字符（单字符字段如A/V、N/S直接取用）
+    bool numeric;           // 是否为有效数字
+} NMEA_Field_t;
+
+/**
+ * @brief 一条已校验的语句
+ */
+typedef struct {
+    uint16_t talker;                        // 发送方，NMEA_TALKER编码
+    uint32_t type;                          // 语句类型，NMEA_TYPE编码
+    uint8_t field_count;                    // 数据字段数（不含地址字段）
+    NMEA_Field_t field[NMEA_MAX_FIELDS];    // field[0]为地址后的第一个字段
+} NMEA_Sentence_t;
+
+/**
+ * @brief 解析器状态
+ */
+typedef enum {
+    NMEA_STATE_START = 0,   // 等待'$'
+    NMEA_STATE_ADDRESS,     // 地址字段
+    NMEA_STATE_FIELD,       // 数据字段
+    NMEA_STATE_CHECKSUM_HI, // 校验和高位
+    NMEA_STATE_CHECKSUM_LO  // 校验和低位
+} NMEA_State_t;
+
+/**
+ * @brief 解析器
+ */
+typedef struct {
+    NMEA_State_t state;
+    uint8_t checksum;           // 累计XOR
+    uint8_t rx_checksum;        // 语句携带的校验和
+    uint8_t addr_len;           // 已接收地址字符数
+    uint8_t length;             // 已接收语句长度
+    uint8_t field_index;        // 当前字段序号
+    bool in_frac;               // 当前字段已出现小数点
+    NMEA_Field_t scratch;       // 超出NMEA_MAX_FIELDS的字段写到这里丢弃
+    NMEA_Sentence_t sentence;   // 正在接收的语句
+
+    uint32_t sentence_count;    // 校验通过的语句数
+    uint32_t checksum_errors;   // 校验失败数
+    uint32_t format_errors;     // 格式错误数（超长、缺校验和等）
+} NMEA_Parser_t;
+
+/* ==================== 函数声明 ==================== */
+
+/**
+ * @brief 初始化解析器
+ * @param parser: 解析器指针
+ */
+void NMEA_Parser_Init(NMEA_Parser_t *parser);
+
+/**
+ * @brief 输入一个字节
+ * @param parser: 解析器指针
+ * @param c: 接收到的字符
+ * @retval 语句完整且校验通过时返回语句指针（下次输入前有效），否则NULL
+ */
+const NMEA_Sentence_t *NMEA_Parser_Feed(NMEA_Parser_t *parser, char c);
+
+/**
+ * @brief 字段是否为非空有效数字
+ * @param field: 字段指针
+ * @retval true: 有效
+ */
+bool NMEA_Field_Is_Number(const NMEA_Field_t *field);
+
+/**
+ * @brief 将数字字段换算为指定小数位数的定点整数（多余小数位截断）
+ * @param field: 字段指针
+ * @param digits: 目标小数位数，如2表示结果为原值*100
+ * @retval 定点整数
+ */
+int32_t NMEA_Field_To_Fixed(const NMEA_Field_t *field, uint8_t digits);
+
+/**
+ * @brief 将数字字段转换为float（兼容浮点数据字段）
+ * @param field: 字段指针
+ * @retval 浮点值
+ */
+float NMEA_Field_To_Float(const NMEA_Field_t *field);
+
+#endif /* __NMEA_H */
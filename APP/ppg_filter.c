@@ -0,0 +1,145 @@
+/**
+  ******************************************************************************
+  * @file           : ppg_filter.c
+  * @brief          : PPG定点DSP前端（去直流 + 级联双二阶带通）实现
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-05
+  ******************************************************************************
+  */
+
+#include "ppg_filter.h"
+#include <string.h>
+
+#if defined(__arm__)
+#include "cmsis_compiler.h"     // __SMLAD/__PKHBT/__SSAT，并按内核定义__ARM_FEATURE_DSP
+#endif
+
+/* ==================== 滤波器系数 ==================== */
+
+// 直接I型双二阶：y = b0*x0 + b1*x1 + b2*x2 - a1*y1 - a2*y2
+// 系数按fs=PPG_FILTER_FS设计，按__SMLAD操作数预先打包：低半字对应第一个样本，高半字对应第二个样本
+#define PPG_PACK(lo, hi)    (((uint32_t)(uint16_t)(int16_t)(lo)) | ((uint32_t)(uint16_t)(int16_t)(hi) << 16))
+
+typedef struct {
+    uint32_t b0_b1;     // (b0, b1)
+    uint32_t b2_na1;    // (b2, -a1)
+    int16_t na2;        // -a2
+} PPG_Biquad_Coef_t;
+
+static const PPG_Biquad_Coef_t ppg_coef[PPG_FILTER_STAGES] = {
+    // 0.5Hz二阶Butterworth高通：b={0.97803,-1.95606,0.97803}, a={1,-1.95558,0.95654}
+    { PPG_PACK(16024, -32048), PPG_PACK(16024, 32040), -15672 },
+    // 4Hz二阶Butterworth低通：b={0.01336,0.02672,0.01336}, a={1,-1.64746,0.70090}
+    { PPG_PACK(219, 438),      PPG_PACK(219, 26992),   -11483 },
+};
+
+/* ==================== 定点运算原语 ==================== */
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+
+#define PPG_SMLAD(x, y, acc)    ((int32_t)__SMLAD((x), (y), (uint32_t)(acc)))
+#define PPG_PACK_SAMPLES(a, b)  __PKHBT((uint16_t)(a), (int32_t)(b), 16)
+#define PPG_SAT16(x)            ((int16_t)__SSAT((x), 16))
+
+#else
+
+/**
+ * @brief __SMLAD的C实现：两组有符号16位乘积与累加器求和（32位回绕）
+ */
+static inline int32_t PPG_SMLAD(uint32_t x, uint32_t y, int32_t acc)
+{
+    int32_t lo = (int32_t)(int16_t)x * (int16_t)y;
+    int32_t hi = (int32_t)(int16_t)(x >> 16) * (int16_t)(y >> 16);
+
+    return (int32_t)((uint32_t)acc + (uint32_t)lo + (uint32_t)hi);
+}
+
+#define PPG_PACK_SAMPLES(a, b)  PPG_PACK((a), (b))
+
+/**
+ * @brief __SSAT(x, 16)的C实现
+ */
+static inline int16_t PPG_SAT16(int32_t x)
+{
+    if (x > 32767) return 32767;
+    if (x < -32768) return -32768;
+    return (int16_t)x;
+}
+
+#endif
+
+/* ==================== 函数实现 ==================== */
+
+/**
+ * @brief 单通道处理：去直流后经级联双二阶
+ * @param ch: 通道状态
+ * @param x: 原始样本
+ * @retval 带通输出
+ */
+static int16_t PPG_Channel_Process(PPG_Channel_t *ch, uint32_t x)
+{
+    int32_t acc;
+    int16_t in;
+    int16_t out;
+    uint32_t s;
+
+    if (!ch->primed) {
+        ch->x_prev = x;
+        ch->dc_y_q8 = 0;
+        ch->primed = true;
+    }
+
+    // DC阻断器：y = (x - x_prev) + a*y_prev，Q8保留小数避免截断偏置
+    ch->dc_y_q8 = (int32_t)(((int32_t)x - (int32_t)ch->x_prev) << 8) +
+                  (int32_t)(((int64_t)PPG_FILTER_DC_ALPHA * ch->dc_y_q8) >> 15);
+    ch->x_prev = x;
+    ch->dc = x - (uint32_t)(ch->dc_y_q8 >> 8);
+
+    in = PPG_SAT16(ch->dc_y_q8 >> 8);
+
+    for (s = 0; s < PPG_FILTER_STAGES; s++) {
+        const PPG_Biquad_Coef_t *c = &ppg_coef[s];
+
+        acc = PPG_SMLAD(PPG_PACK_SAMPLES(in, ch->x1[s]), c->b0_b1, 0);
+        acc = PPG_SMLAD(PPG_PACK_SAMPLES(ch->x2[s], ch->y1[s]), c->b2_na1, acc);
+        acc += (int32_t)c->na2 * ch->y2[s];
+
+        // 误差反馈：加上次截断余数，本次余数留到下次，消除截断偏置
+        acc += ch->err[s];
+        out = PPG_SAT16(acc >> PPG_FILTER_COEF_SHIFT);
+        ch->err[s] = (int16_t)(acc & ((1 << PPG_FILTER_COEF_SHIFT) - 1));
+
+        ch->x2[s] = ch->x1[s];
+        ch->x1[s] = in;
+        ch->y2[s] = ch->y1[s];
+        ch->y1[s] = out;
+
+        in = out;
+    }
+
+    return in;
+}
+
+/**
+ * @brief 初始化滤波器
+ * @param filter: 滤波器指针
+ */
+void PPG_Filter_Init(PPG_Filter_t *filter)
+{
+    memset(filter, 0, sizeof(PPG_Filter_t));
+}
+
+/**
+ * @brief 处理一组红光/红外样本
+ * @param filter: 滤波器指针
+ * @param red: 红光原始样本（18位）
+ * @param ir: 红外原始样本（18位）
+ * @param red_ac: 输出红光带通交流分量
+ * @param ir_ac: 输出红外带通交流分量
+ */
+void PPG_Filter_Process(PPG_Filter_t *filter, uint32_t red, uint32_t ir,
+                        int16_t *red_ac, int16_t *ir_ac)
+{
+    *red_ac = PPG_Channel_Process(&filter->red, red);
+    *ir_ac = PPG_Channel_Process(&filter->ir, ir);
+}
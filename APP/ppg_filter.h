@@ -0,0 +1,81 @@
+/**
+  ******************************************************************************
+  * @file           : ppg_filter.h
+  * @brief          : PPG定点DSP前端（去直流 + 级联双二阶带通）头文件
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-05
+  ******************************************************************************
+  * @attention
+  *
+  * 对MAX30102红光/红外原始样本同时进行定点滤波：
+  * - 去直流：一阶DC阻断器 y[n] = x[n] - x[n-1] + a*y[n-1]，状态保留Q8小数
+  * - 带通：0.5Hz二阶Butterworth高通 + 4Hz二阶Butterworth低通（fs=PPG_FILTER_FS）
+  * - 系数Q14（Q15缩放1/2以容纳|a1|<2），样本Q15，32位累加器
+  * - 输出截断余数反馈到下一次累加：0.5Hz高通极点接近1，直接截断的
+  *   -0.5LSB偏置会被放大约1000倍成为约-500的直流偏移
+  *
+  * Cortex-M4上使用DSP SIMD指令（__SMLAD一次完成两组16位乘加），
+  * 其他平台使用按__SMLAD语义逐位等价的C实现，两条路径输出逐位一致。
+  * 本模块不依赖HAL，可在主机上单独编译验证。
+  *
+  ******************************************************************************
+  */
+
+#ifndef __PPG_FILTER_H
+#define __PPG_FILTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ==================== 配置参数 ==================== */
+
+#define PPG_FILTER_FS           100     // 系数设计采样率(Hz)，须与MAX30102 FIFO输出率一致
+#define PPG_FILTER_STAGES       2       // 双二阶级数（高通 + 低通）
+#define PPG_FILTER_COEF_SHIFT   14      // 系数小数位数（Q14）
+#define PPG_FILTER_DC_ALPHA     32440   // DC阻断器极点 a=0.99（Q15）
+
+/* ==================== 数据结构 ==================== */
+
+/**
+ * @brief 单通道滤波状态
+ */
+typedef struct {
+    uint32_t x_prev;                            // 上一原始样本
+    int32_t dc_y_q8;                            // DC阻断器输出（Q8）
+    int16_t x1[PPG_FILTER_STAGES];              // 各级输入延迟 x[n-1]
+    int16_t x2[PPG_FILTER_STAGES];              // 各级输入延迟 x[n-2]
+    int16_t y1[PPG_FILTER_STAGES];              // 各级输出延迟 y[n-1]
+    int16_t y2[PPG_FILTER_STAGES];              // 各级输出延迟 y[n-2]
+    int16_t err[PPG_FILTER_STAGES];             // 各级截断余数（误差反馈）
+    uint32_t dc;                                // 当前直流分量估计
+    bool primed;                                // 已用首个样本初始化
+} PPG_Channel_t;
+
+/**
+ * @brief 红光/红外双通道滤波器
+ */
+typedef struct {
+    PPG_Channel_t red;                          // 红光通道
+    PPG_Channel_t ir;                           // 红外通道
+} PPG_Filter_t;
+
+/* ==================== 函数声明 ==================== */
+
+/**
+ * @brief 初始化滤波器
+ * @param filter: 滤波器指针
+ */
+void PPG_Filter_Init(PPG_Filter_t *filter);
+
+/**
+ * @brief 处理一组红光/红外样本
+ * @param filter: 滤波器指针
+ * @param red: 红光原始样本（18位）
+ * @param ir: 红外原始样本（18位）
+ * @param red_ac: 输出红光带通交流分量
+ * @param ir_ac: 输出红外带通交流分量
+ */
+void PPG_Filter_Process(PPG_Filter_t *filter, uint32_t red, uint32_t ir,
+                        int16_t *red_ac, int16_t *ir_ac);
+
+#endif /* __PPG_FILTER_H */
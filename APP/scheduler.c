@@ -5,21 +5,244 @@
   * @author         : STM32智能安全帽项目组
   * @date           : 2025-11-30
   ******************************************************************************
+  * @attention
+  *
+  * 周期任务按下次到期时刻组织成最小堆，scheduler_run只检查堆顶，
+  * 每次取出/重排为O(log n)；同一时刻到期的任务按优先级从高到低运行。
+  * 事件任务不入堆，由scheduler_notify置位挂起标志后在下一轮运行；
+  * 需要超时的事件任务可用scheduler_notify_after登记一个单次截止时刻，
+  * 到期时与周期任务一样从堆顶取出运行，任务无论因何运行都撤销该截止时刻。
+  *
+  * scheduler_idle在两次调度之间休眠（低功耗分级）：
+  * - 距下次到期不足SCHEDULER_TICKLESS_MIN_MS：保持1ms节拍，WFI等下一个节拍
+  * - 更长间隔：SysTick改为HCLK/8单次定时（最长约798ms），WFI期间
+  *   串口/EXTI/定时器中断均可提前唤醒，醒来后按实际流逝时间补偿uwTick
+  * - 没有任何周期任务或单次截止时刻：进入STOP模式，由EXTI（传感器INT引脚等）唤醒；
+  *   scheduler_stop_allowed返回0时（定时器驱动的操作进行中）改为单次定时休眠
+  *
+  * SCHEDULER_PROFILE开启时，每次分派用DWT周期计数器测量任务执行时间，
+  * 并记录相对计划时刻的延迟；scheduler_dump_stats输出统计报告。
+  *
+  ******************************************************************************
   */
 
 /* Includes ------------------------------------------------------------------*/
 #include "scheduler.h"
+#include <stdio.h>
+#include <string.h>
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 static task_t task_list[MAX_TASKS];  // 任务列表
-static uint8_t task_count = 0;        // 当前任务数量
+static task_index_t task_count = 0;   // 当前任务数量
+
+static task_index_t task_heap[MAX_TASKS];  // 周期任务最小堆（存task_list下标）
+static task_index_t heap_size = 0;    // 堆中任务数量
+
+static volatile uint8_t any_pending = 0;  // 至少有一个任务被通知
+
+static uint32_t idle_ms_total = 0;    // 累计休眠时间（毫秒）
+static uint32_t idle_wakeups = 0;     // 累计唤醒次数
 
 /* Private function prototypes -----------------------------------------------*/
 /* Private user code ---------------------------------------------------------*/
 
+/**
+  * @brief  比较两个任务的紧迫程度（到期时刻早者优先，相同则优先级高者优先）
+  * @param  a: 任务下标
+  * @param  b: 任务下标
+  * @retval 1: a比b更紧迫, 0: 否
+  */
+static uint8_t heap_before(task_index_t a, task_index_t b)
+{
+    // 差值按有符号比较，HAL_GetTick回绕后仍正确
+    int32_t diff = (int32_t)(task_list[a].next_run - task_list[b].next_run);
+
+    if (diff != 0) {
+        return diff < 0;
+    }
+
+    return task_list[a].priority > task_list[b].priority;
+}
+
+/**
+  * @brief  交换堆中两个位置并更新任务记录的位置
+  */
+static void heap_swap(task_index_t i, task_index_t j)
+{
+    task_index_t t = task_heap[i];
+
+    task_heap[i] = task_heap[j];
+    task_heap[j] = t;
+    task_list[task_heap[i]].heap_index = i;
+    task_list[task_heap[j]].heap_index = j;
+}
+
+/**
+  * @brief  上浮
+  */
+static void heap_sift_up(task_index_t i)
+{
+    while (i > 0) {
+        task_index_t parent = (i - 1) / 2;
+
+        if (!heap_before(task_heap[i], task_heap[parent])) {
+            break;
+        }
+        heap_swap(i, parent);
+        i = parent;
+    }
+}
+
+/**
+  * @brief  下沉
+  */
+static void heap_sift_down(task_index_t i)
+{
+    for (;;) {
+        uint32_t l = 2U * i + 1U;
+        uint32_t r = l + 1U;
+        task_index_t m = i;
+
+        if (l < heap_size && heap_before(task_heap[l], task_heap[m])) {
+            m = (task_index_t)l;
+        }
+        if (r < heap_size && heap_before(task_heap[r], task_heap[m])) {
+            m = (task_index_t)r;
+        }
+        if (m == i) {
+            break;
+        }
+        heap_swap(i, m);
+        i = m;
+    }
+}
+
+/**
+  * @brief  从堆中移除任意位置的任务（用末尾元素填补后重新调整）
+  */
+static void heap_remove(task_index_t i)
+{
+    heap_size--;
+    if (i != heap_size) {
+        heap_swap(i, heap_size);
+        heap_sift_down(i);
+        heap_sift_up(i);
+    }
+}
+
+#if SCHEDULER_PROFILE
+/**
+  * @brief  记录一次执行统计
+  * @param  stats: 统计结构
+  * @param  cycles: 本次执行周期数
+  * @param  late_ms: 相对计划时刻的延迟
+  * @param  period_ms: 任务周期（事件任务为0）
+  */
+static void profile_record(task_stats_t *stats, uint32_t cycles, uint32_t late_ms,
+                           uint32_t period_ms)
+{
+    // 只存原始周期数，不做除法；换算成微秒留到scheduler_dump_stats
+    uint32_t bin = 32U - __CLZ(cycles >> SCHEDULER_HIST_SHIFT);
+
+    stats->runs++;
+    stats->total_cycles += cycles;
+    if (cycles < stats->min_cycles) {
+        stats->min_cycles = cycles;
+    }
+    if (cycles > stats->max_cycles) {
+        stats->max_cycles = cycles;
+    }
+
+    if (late_ms > stats->max_late_ms) {
+        stats->max_late_ms = late_ms;
+    }
+    if (period_ms != 0 && late_ms >= period_ms) {
+        stats->missed++;
+    }
+
+    stats->hist[bin < SCHEDULER_HIST_BINS ? bin : SCHEDULER_HIST_BINS - 1]++;
+}
+#endif
+
+/**
+  * @brief  执行任务并重新计算其到期时刻
+  * @param  idx: 任务下标
+  * @param  current_time: 当前时刻
+  */
+static void run_task(task_index_t idx, uint32_t current_time)
+{
+    task_t *task = &task_list[idx];
+#if SCHEDULER_PROFILE
+    int32_t late = task->event_only ? 0 : (int32_t)(current_time - task->next_run);
+    uint32_t start;
+#endif
+
+    // 先清除挂起标志，任务执行期间的新通知留到下一轮
+    task->pending = 0;
+    task->last_run = current_time;
+
+    if (!task->event_only) {
+        // 与原轮询方式一致：下次到期 = 本次运行时刻 + 周期
+        task->next_run = current_time + task->period_ms;
+        heap_sift_down(task->heap_index);
+    } else if (task->armed) {
+        // 单次截止时刻：到期或先被通知，运行一次即撤销，需要时由任务重新登记
+        task->armed = 0;
+        heap_remove(task->heap_index);
+    }
+
+    // 执行任务
+    if (task->task_func != NULL) {
+#if SCHEDULER_PROFILE
+        start = SCHEDULER_CYCLE_COUNT();
+        task->task_func();
+        // 被通知提前执行的周期任务延迟为负，按0计
+        profile_record(&task->stats, SCHEDULER_CYCLE_COUNT() - start,
+                       late > 0 ? (uint32_t)late : 0, task->period_ms);
+#else
+        task->task_func();
+#endif
+    }
+}
+
+/**
+  * @brief  登记任务
+  */
+static void register_task(void (*func)(void), uint32_t period_ms, uint8_t priority,
+                          uint8_t event_only)
+{
+    task_t *task;
+
+    if (task_count >= MAX_TASKS || func == NULL) {
+        return;
+    }
+
+    task = &task_list[task_count];
+    task->task_func = func;
+    task->period_ms = period_ms;
+    task->last_run = 0;
+    task->next_run = period_ms;
+    task->priority = priority;
+    task->event_only = event_only;
+    task->armed = 0;
+    task->pending = 0;
+#if SCHEDULER_PROFILE
+    memset(&task->stats, 0, sizeof(task_stats_t));
+    task->stats.min_cycles = 0xFFFFFFFFU;
+#endif
+
+    if (!event_only) {
+        task->heap_index = heap_size;
+        task_heap[heap_size++] = task_count;
+        heap_sift_up(task->heap_index);
+    }
+
+    task_count++;
+}
+
 /**
   * @brief  调度器初始化
   * @retval None
@@ -27,13 +250,28 @@ static uint8_t task_count = 0;        // 当前任务数量
 void scheduler_init(void)
 {
     task_count = 0;
-    
+    heap_size = 0;
+    any_pending = 0;
+
     // 清空任务列表
-    for (uint8_t i = 0; i < MAX_TASKS; i++) {
+    for (task_index_t i = 0; i < MAX_TASKS; i++) {
         task_list[i].task_func = NULL;
         task_list[i].period_ms = 0;
         task_list[i].last_run = 0;
+        task_list[i].next_run = 0;
+        task_list[i].priority = SCHEDULER_PRIORITY_DEFAULT;
+        task_list[i].heap_index = 0;
+        task_list[i].event_only = 0;
+        task_list[i].armed = 0;
+        task_list[i].pending = 0;
     }
+
+#if SCHEDULER_PROFILE
+    // 使能DWT周期计数器
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
 }
 
 /**
@@ -44,12 +282,289 @@ void scheduler_init(void)
   */
 void scheduler_add_task(void (*func)(void), uint32_t period_ms)
 {
-    if (task_count < MAX_TASKS && func != NULL) {
-        task_list[task_count].task_func = func;
-        task_list[task_count].period_ms = period_ms;
-        task_list[task_count].last_run = 0;
-        task_count++;
+    register_task(func, period_ms, SCHEDULER_PRIORITY_DEFAULT, 0);
+}
+
+/**
+  * @brief  添加带优先级的周期任务
+  * @param  func: 任务函数指针
+  * @param  period_ms: 执行周期（毫秒）
+  * @param  priority: 优先级（同一时刻到期时数值大者先运行）
+  * @retval None
+  */
+void scheduler_add_task_prio(void (*func)(void), uint32_t period_ms, uint8_t priority)
+{
+    register_task(func, period_ms, priority, 0);
+}
+
+/**
+  * @brief  添加事件触发任务（只在scheduler_notify后的下一轮运行）
+  * @param  func: 任务函数指针
+  * @retval None
+  */
+void scheduler_add_event_task(void (*func)(void))
+{
+    register_task(func, 0, SCHEDULER_PRIORITY_DEFAULT, 1);
+}
+
+/**
+  * @brief  通知任务就绪，下一轮scheduler_run时执行（可在中断中调用）
+  * @note   只写单字节挂起标志，无需关中断；周期任务被通知时提前执行一次
+  * @param  func: 任务函数指针
+  * @retval None
+  */
+void scheduler_notify(void (*func)(void))
+{
+    for (task_index_t i = 0; i < task_count; i++) {
+        if (task_list[i].task_func == func) {
+            task_list[i].pending = 1;
+            any_pending = 1;
+            return;
+        }
+    }
+}
+
+/**
+  * @brief  登记事件任务的单次截止时刻，到期时运行一次（如等待响应的超时）
+  * @note   操作截止时间堆，只能在任务中调用，不可在中断中调用；
+  *         重复登记以最后一次为准，任务运行（到期或被通知）后自动撤销
+  * @param  func: 事件任务函数指针（周期任务忽略）
+  * @param  delay_ms: 距现在的毫秒数
+  * @retval None
+  */
+void scheduler_notify_after(void (*func)(void), uint32_t delay_ms)
+{
+    for (task_index_t i = 0; i < task_count; i++) {
+        task_t *task = &task_list[i];
+
+        if (task->task_func != func) {
+            continue;
+        }
+        if (!task->event_only) {
+            return;
+        }
+
+        task->next_run = HAL_GetTick() + delay_ms;
+        if (task->armed) {
+            heap_sift_down(task->heap_index);
+            heap_sift_up(task->heap_index);
+        } else {
+            task->armed = 1;
+            task->heap_index = heap_size;
+            task_heap[heap_size++] = i;
+            heap_sift_up(task->heap_index);
+        }
+        return;
+    }
+}
+
+/**
+  * @brief  距下一个截止时刻（周期任务或事件任务的单次截止时刻）的时间
+  * @retval 毫秒数（已到期或有挂起事件返回0，堆为空返回SCHEDULER_NO_DEADLINE）
+  */
+uint32_t scheduler_next_due(void)
+{
+    int32_t remain;
+
+    if (any_pending) {
+        return 0;
+    }
+
+    if (heap_size == 0) {
+        return SCHEDULER_NO_DEADLINE;
+    }
+
+    remain = (int32_t)(task_list[task_heap[0]].next_run - HAL_GetTick());
+
+    return remain > 0 ? (uint32_t)remain : 0;
+}
+
+/**
+  * @brief  读取SysTick计数值，并判断是否已回绕且中断尚未处理（关中断时调用）
+  * @param  val: 输出，当前计数值
+  * @retval 1: 已回绕, 0: 未回绕
+  */
+static uint32_t systick_read(uint32_t *val)
+{
+    *val = SysTick->VAL;
+    if (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) {
+        // 挂起位可能在读VAL之后才置位，重读保证取到回绕后的计数值
+        *val = SysTick->VAL;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+  * @brief  停用1ms节拍，以SysTick单次定时休眠
+  * @note   节拍内已走过的周期数和唤醒时不足1ms的余数都以HCLK周期累计，
+  *         整毫秒计入uwTick，余数折算进恢复后的第一个节拍，不随唤醒丢失
+  * @param  sleep_ms: 期望休眠时间（毫秒）
+  * @retval None
+  */
+static void tickless_sleep(uint32_t sleep_ms)
+{
+    uint32_t tick_cycles = SystemCoreClock / 1000U;
+    uint32_t max_ms = (SysTick_LOAD_RELOAD_Msk + 1U) * 8U / tick_cycles - 1U;
+    uint32_t carry;
+    uint32_t load;
+    uint32_t val;
+    uint32_t ms;
+
+    if (sleep_ms > max_ms) {
+        sleep_ms = max_ms;
+    }
+
+    __disable_irq();
+
+    // 关中断后再确认一次，避免错过刚刚到达的通知
+    if (any_pending) {
+        __enable_irq();
+        return;
+    }
+
+    // 当前1ms节拍已走过的周期数；关中断后已回绕但未处理的节拍一并计入
+    load = SysTick->LOAD;
+    carry = systick_read(&val) ? tick_cycles : 0U;
+    carry += load - val;
+    ms = carry / tick_cycles;
+    carry -= ms * tick_cycles;
+    uwTick += ms;
+    sleep_ms -= ms;
+
+    // CLKSOURCE=0选择HCLK/8，加大单次可定时长度；扣除已走过的余数，对齐到期时刻
+    load = (sleep_ms * tick_cycles - carry) / 8U - 1U;
+    SysTick->CTRL = 0;
+    SysTick->LOAD = load;
+    SysTick->VAL = 0;
+    SysTick->CTRL = SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+    SCB->ICSR = SCB_ICSR_PENDSTCLR_Msk;
+
+    // PRIMASK置位时中断挂起仍会唤醒内核，但处理函数在补偿节拍后才执行
+    __DSB();
+    __WFI();
+
+    // 单次定时到期后计数器重装继续递减，回绕时加上一整轮
+    if (systick_read(&val)) {
+        carry += (load + 1U) * 8U;
+    }
+    carry += (load - val) * 8U;
+    ms = carry / tick_cycles;
+    carry -= ms * tick_cycles;
+    uwTick += ms;
+
+    // 恢复1ms节拍：第一个节拍只走剩余部分，之后LOAD生效为完整1ms
+    // （VAL写入任意值都只能清零，余数只能通过首个周期的LOAD体现）
+    if (tick_cycles - carry < 2U) {
+        uwTick++;
+        carry = 0;
+    }
+    SysTick->CTRL = 0;
+    SysTick->LOAD = tick_cycles - carry - 1U;
+    SysTick->VAL = 0;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+    SysTick->LOAD = tick_cycles - 1U;
+    SCB->ICSR = SCB_ICSR_PENDSTCLR_Msk;
+
+    __enable_irq();
+
+    idle_ms_total += ms;
+    idle_wakeups++;
+}
+
+/**
+  * @brief  进入STOP模式，直到EXTI唤醒
+  * @retval 1: 已进入并退出STOP, 0: 关中断后条件不再满足，未进入
+  */
+static uint8_t stop_sleep(void)
+{
+    __disable_irq();
+
+    // 关中断后再确认一次：刚到达的通知、中断中登记的周期任务或刚启动的
+    // 定时器驱动操作都放弃进入STOP，由调用方改走普通休眠路径
+    if (any_pending || heap_size != 0 || !scheduler_stop_allowed()) {
+        __enable_irq();
+        return 0;
+    }
+
+    HAL_SuspendTick();
+    // PRIMASK置位时EXTI挂起仍会唤醒内核，处理函数在恢复时钟后才执行
+    HAL_PWR_EnterSTOPMode(PWR_LOWPOWERREGULATOR_ON, PWR_STOPENTRY_WFI);
+
+    // 退出STOP后系统时钟为HSI，由钩子恢复PLL
+    scheduler_stop_exit_hook();
+    HAL_ResumeTick();
+
+    __enable_irq();
+
+    idle_wakeups++;
+    return 1;
+}
+
+/**
+  * @brief  STOP模式退出钩子（弱定义），应用中重写以恢复系统时钟
+  * @retval None
+  */
+__weak void scheduler_stop_exit_hook(void)
+{
+}
+
+/**
+  * @brief  是否允许进入STOP模式（弱定义），应用中重写以在依赖定时器的
+  *         异步操作（如TIM1驱动的软件I2C）进行期间改用普通休眠
+  * @retval 1: 允许, 0: 不允许
+  */
+__weak uint8_t scheduler_stop_allowed(void)
+{
+    return 1;
+}
+
+/**
+  * @brief  两次调度之间休眠直到下一个任务到期或被中断唤醒（主循环中调用）
+  * @retval None
+  */
+void scheduler_idle(void)
+{
+    uint32_t sleep_ms = scheduler_next_due();
+
+    if (sleep_ms == 0) {
+        return;
     }
+
+    if (sleep_ms == SCHEDULER_NO_DEADLINE) {
+#if SCHEDULER_USE_STOP
+        // STOP模式下定时器停止计数，定时器驱动的操作完成前只做单次定时休眠
+        if (stop_sleep()) {
+            return;
+        }
+        // 未进入STOP：重新计算，通知已到达时直接返回
+        sleep_ms = scheduler_next_due();
+        if (sleep_ms == 0) {
+            return;
+        }
+#endif
+    }
+
+    if (sleep_ms < SCHEDULER_TICKLESS_MIN_MS) {
+        // 1ms节拍仍在运行，下一个节拍即唤醒
+        __WFI();
+        idle_wakeups++;
+        return;
+    }
+
+    tickless_sleep(sleep_ms);
+}
+
+/**
+  * @brief  获取休眠统计
+  * @param  idle_ms: 累计休眠时间（毫秒，不含STOP模式）
+  * @param  wakeups: 累计唤醒次数
+  * @retval None
+  */
+void scheduler_get_idle_stats(uint32_t *idle_ms, uint32_t *wakeups)
+{
+    *idle_ms = idle_ms_total;
+    *wakeups = idle_wakeups;
 }
 
 /**
@@ -59,18 +574,76 @@ void scheduler_add_task(void (*func)(void), uint32_t period_ms)
 void scheduler_run(void)
 {
     uint32_t current_time = HAL_GetTick();
-    
-    for (uint8_t i = 0; i < task_count; i++) {
-        // 检查是否到达执行时刻
-        if (current_time - task_list[i].last_run >= task_list[i].period_ms) {
-            task_list[i].last_run = current_time;
-            
-            // 执行任务
-            if (task_list[i].task_func != NULL) {
-                task_list[i].task_func();
+
+    // 处理事件通知
+    if (any_pending) {
+        any_pending = 0;
+        for (task_index_t i = 0; i < task_count; i++) {
+            if (task_list[i].pending) {
+                run_task(i, current_time);
+            }
+        }
+    }
+
+    // 只检查堆顶：依次运行已到期任务，每轮每个任务最多运行一次
+    for (task_index_t n = heap_size; n > 0; n--) {
+        task_index_t idx = task_heap[0];
+
+        if ((int32_t)(current_time - task_list[idx].next_run) < 0) {
+            break;
+        }
+
+        run_task(idx, current_time);
+    }
+}
+
+/**
+  * @brief  打印各任务执行统计
+  * @retval None
+  */
+void scheduler_dump_stats(void)
+{
+#if SCHEDULER_PROFILE
+    uint32_t idle_ms;
+    uint32_t wakeups;
+
+    printf("\r\n========== Scheduler Stats ==========\r\n");
+    printf("Task Func        Period  Runs     Min(us)  Mean(us) Max(us)  Late(ms) Miss\r\n");
+
+    for (task_index_t i = 0; i < task_count; i++) {
+        const task_stats_t *st = &task_list[i].stats;
+        uint32_t mean = st->runs ? (uint32_t)(st->total_cycles / st->runs) : 0;
+
+        printf("%-4u 0x%08lX  %-7lu %-8lu %-8lu %-8lu %-8lu %-8lu %lu\r\n",
+               i, (unsigned long)(uintptr_t)task_list[i].task_func,
+               (unsigned long)task_list[i].period_ms, (unsigned long)st->runs,
+               (unsigned long)(st->runs ? st->min_cycles / SCHEDULER_CYCLES_PER_US : 0),
+               (unsigned long)(mean / SCHEDULER_CYCLES_PER_US),
+               (unsigned long)(st->max_cycles / SCHEDULER_CYCLES_PER_US),
+               (unsigned long)st->max_late_ms, (unsigned long)st->missed);
+
+        // 直方图：只打印非零档，"<Nus"表示执行时间小于N微秒（档边界按周期数换算）
+        printf("     hist:");
+        for (uint8_t b = 0; b < SCHEDULER_HIST_BINS; b++) {
+            if (st->hist[b]) {
+                if (b == SCHEDULER_HIST_BINS - 1) {
+                    printf(" >=%.1fus:%lu",
+                           (float)(1UL << (b - 1 + SCHEDULER_HIST_SHIFT)) / SCHEDULER_CYCLES_PER_US,
+                           (unsigned long)st->hist[b]);
+                } else {
+                    printf(" <%.1fus:%lu",
+                           (float)(1UL << (b + SCHEDULER_HIST_SHIFT)) / SCHEDULER_CYCLES_PER_US,
+                           (unsigned long)st->hist[b]);
+                }
             }
         }
+        printf("\r\n");
     }
+
+    scheduler_get_idle_stats(&idle_ms, &wakeups);
+    printf("Idle: %lu ms, Wakeups: %lu\r\n", (unsigned long)idle_ms, (unsigned long)wakeups);
+    printf("=====================================\r\n");
+#endif
 }
 
 /************************ (C) COPYRIGHT STM32智能安全帽项目组 *****END OF FILE****/
@@ -17,22 +17,80 @@ extern "C" {
 /* Includes ------------------------------------------------------------------*/
 #include "main.h"
 
+/* Exported constants --------------------------------------------------------*/
+#ifndef MAX_TASKS
+#define MAX_TASKS 16  // 最大任务数量（主机测试可在编译时覆盖）
+#endif
+
+#define SCHEDULER_PRIORITY_DEFAULT  0           // scheduler_add_task使用的默认优先级
+#define SCHEDULER_NO_DEADLINE       0xFFFFFFFFU // 无任何截止时刻时scheduler_next_due的返回值
+
+#define SCHEDULER_TICKLESS_MIN_MS   2   // 空闲不少于该值时停用1ms节拍，SysTick单次定时唤醒
+#define SCHEDULER_USE_STOP          1   // 1: 无周期任务待到期时进入STOP模式，仅由EXTI唤醒
+
+#ifndef SCHEDULER_PROFILE
+#define SCHEDULER_PROFILE       1   // 1: 统计每个任务的执行时间、抖动和错过截止次数
+#endif
+#define SCHEDULER_HIST_BINS     16  // 执行时间直方图档数（按周期数取log2，末档含更长）
+#define SCHEDULER_HIST_SHIFT    7   // 直方图最小单位2^7=128周期（168MHz下约0.76us）
+
+// 周期计数时钟，默认使用DWT->CYCCNT；主机端仿真可在包含本文件前替换
+#ifndef SCHEDULER_CYCLE_COUNT
+#define SCHEDULER_CYCLE_COUNT()     (DWT->CYCCNT)
+#endif
+#ifndef SCHEDULER_CYCLES_PER_US
+#define SCHEDULER_CYCLES_PER_US     (SystemCoreClock / 1000000U)
+#endif
+
 /* Exported types ------------------------------------------------------------*/
+// 任务下标/堆位置类型，任务数超过255时加宽
+#if MAX_TASKS > 255
+typedef uint16_t task_index_t;
+#else
+typedef uint8_t task_index_t;
+#endif
+
+typedef struct {
+    uint32_t runs;                          // 执行次数
+    uint32_t min_cycles;                    // 最短执行时间（周期）
+    uint32_t max_cycles;                    // 最长执行时间（周期）
+    uint64_t total_cycles;                  // 累计执行时间（周期），均值 = total / runs
+    uint32_t max_late_ms;                   // 相对计划时刻的最大延迟（周期抖动）
+    uint32_t missed;                        // 错过截止次数（延迟达到一个周期以上）
+    uint32_t hist[SCHEDULER_HIST_BINS];     // 执行时间直方图，第k档为[2^(k-1), 2^k)个2^SHIFT周期
+} task_stats_t;
+
 typedef struct {
     void (*task_func)(void);  // 任务函数指针
     uint32_t period_ms;       // 执行周期（毫秒）
     uint32_t last_run;        // 上次运行时刻（毫秒）
+    uint32_t next_run;        // 下次到期时刻（毫秒，堆排序键）
+    uint8_t priority;         // 优先级（同一时刻到期时数值大者先运行）
+    task_index_t heap_index;  // 在截止时间堆中的位置
+    uint8_t event_only;       // 1: 仅由事件触发，不按周期运行
+    uint8_t armed;            // 事件任务：已用scheduler_notify_after登记单次截止时刻（在堆中）
+    volatile uint8_t pending; // 事件挂起标志（可在中断中置位）
+#if SCHEDULER_PROFILE
+    task_stats_t stats;       // 执行统计
+#endif
 } task_t;
 
-/* Exported constants --------------------------------------------------------*/
-#define MAX_TASKS 16  // 最大任务数量
-
 /* Exported macro ------------------------------------------------------------*/
 
 /* Exported functions prototypes ---------------------------------------------*/
 void scheduler_init(void);
 void scheduler_run(void);
 void scheduler_add_task(void (*func)(void), uint32_t period_ms);
+void scheduler_add_task_prio(void (*func)(void), uint32_t period_ms, uint8_t priority);
+void scheduler_add_event_task(void (*func)(void));
+void scheduler_notify(void (*func)(void));
+void scheduler_notify_after(void (*func)(void), uint32_t delay_ms);
+uint32_t scheduler_next_due(void);
+void scheduler_idle(void);
+void scheduler_get_idle_stats(uint32_t *idle_ms, uint32_t *wakeups);
+void scheduler_stop_exit_hook(void);
+uint8_t scheduler_stop_allowed(void);
+void scheduler_dump_stats(void);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,198 @@
+/**
+  ******************************************************************************
+  * @file           : track.c
+  * @brief          : 轨迹流式压缩（上传前抽稀）实现
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-12
+  ******************************************************************************
+  */
+
+#include "track.h"
+#include <math.h>
+#include <string.h>
+
+/* ==================== 常量 ==================== */
+
+#define TRACK_M_PER_E7          0.011119493f    // 1e-7度纬度对应的米数
+#define TRACK_DEG_TO_RAD        0.017453293f
+#define TRACK_SECONDS_PER_DAY   86400UL
+
+/* ==================== 全局变量 ==================== */
+
+static TRACK_Point_t track_anchor;                          // 最后输出的点
+static bool track_has_anchor = false;
+static float track_m_per_e7_lon;                            // 锚点纬度处1e-7度经度对应的米数
+static TRACK_Point_t track_window[TRACK_WINDOW_SIZE];       // 锚点之后尚未输出的定位
+static uint8_t track_window_count = 0;
+static uint32_t track_fix_seq = 0;
+
+static TRACK_Point_t track_queue[TRACK_QUEUE_SIZE];         // 待上传队列
+static uint32_t track_queue_head = 0;                       // 写入序号
+static uint32_t track_queue_tail = 0;                       // 读取序号
+
+static TRACK_Stats_t track_stats = {0};
+
+/* ==================== 内部函数 ==================== */
+
+/**
+ * @brief 点p到线段a-b的距离（米，锚点附近平面近似）
+ */
+static float TRACK_Segment_Distance(const TRACK_Point_t *a, const TRACK_Point_t *b, const TRACK_Point_t *p)
+{
+    float bx = (float)((int64_t)b->lon_e7 - a->lon_e7) * track_m_per_e7_lon;
+    float by = (float)((int64_t)b->lat_e7 - a->lat_e7) * TRACK_M_PER_E7;
+    float px = (float)((int64_t)p->lon_e7 - a->lon_e7) * track_m_per_e7_lon;
+    float py = (float)((int64_t)p->lat_e7 - a->lat_e7) * TRACK_M_PER_E7;
+    float len2 = bx * bx + by * by;
+    float t;
+
+    // 投影参数限制在线段内，落在端点外时取到端点的距离
+    t = (len2 > 0.0f) ? (px * bx + py * by) / len2 : 0.0f;
+    if (t < 0.0f) t = 0.0f;
+    if (t > 1.0f) t = 1.0f;
+
+    px -= t * bx;
+    py -= t * by;
+    return sqrtf(px * px + py * py);
+}
+
+/**
+ * @brief 两个时间之间的秒数（跨UTC零点时回绕）
+ */
+static uint32_t TRACK_Elapsed(uint32_t from, uint32_t to)
+{
+    return (to >= from) ? (to - from) : (to + TRACK_SECONDS_PER_DAY - from);
+}
+
+/**
+ * @brief 输出一个点：放入上传队列并作为新锚点
+ */
+static void TRACK_Emit(const TRACK_Point_t *p)
+{
+    // 被省略的窗口点到最终线段（锚点-本点）的距离即为重建误差
+    if (track_has_anchor) {
+        uint8_t i;
+
+        for (i = 0; i < track_window_count; i++) {
+            float d = TRACK_Segment_Distance(&track_anchor, p, &track_window[i]);
+            if (d > track_stats.max_error_m) {
+                track_stats.max_error_m = d;
+            }
+        }
+    }
+
+    if (track_queue_head - track_queue_tail >= TRACK_QUEUE_SIZE) {
+        track_queue_tail++;
+        track_stats.dropped++;
+    }
+    track_queue[track_queue_head & (TRACK_QUEUE_SIZE - 1)] = *p;
+    track_queue_head++;
+    track_stats.emitted++;
+
+    track_anchor = *p;
+    track_has_anchor = true;
+    track_m_per_e7_lon = TRACK_M_PER_E7 * cosf((float)p->lat_e7 / (float)GPS_E7_SCALE * TRACK_DEG_TO_RAD);
+    track_window_count = 0;
+}
+
+/* ==================== 函数实现 ==================== */
+
+/**
+ * @brief 初始化轨迹压缩
+ */
+void TRACK_Init(void)
+{
+    track_has_anchor = false;
+    track_window_count = 0;
+    track_queue_head = 0;
+    track_queue_tail = 0;
+    memset(&track_stats, 0, sizeof(track_stats));
+}
+
+/**
+ * @brief 输入GPS数据（每个有效定位只处理一次）
+ * @param data: GPS数据
+ */
+void TRACK_Add_Fix(const GPS_Data_t *data)
+{
+    TRACK_Point_t p;
+    uint8_t i;
+
+    if (!data->fix_valid || data->fix_seq == track_fix_seq) {
+        return;
+    }
+    track_fix_seq = data->fix_seq;
+    track_stats.fixes++;
+
+    p.lat_e7 = data->lat_e7;
+    p.lon_e7 = data->lon_e7;
+    p.time = (uint32_t)data->hour * 3600UL + (uint32_t)data->minute * 60UL + data->second;
+
+    if (!track_has_anchor) {
+        TRACK_Emit(&p);
+        return;
+    }
+
+    // 窗口内任一点偏离"锚点-新定位"超过容差，或窗口已满：
+    // 输出窗口最后一点（此前已验证锚点到它的线段覆盖全部窗口点）
+    for (i = 0; i < track_window_count; i++) {
+        if (TRACK_Segment_Distance(&track_anchor, &p, &track_window[i]) > TRACK_TOLERANCE_M) {
+            break;
+        }
+    }
+    if (i < track_window_count || track_window_count >= TRACK_WINDOW_SIZE) {
+        track_window_count--;
+        TRACK_Emit(&track_window[track_window_count]);
+    }
+
+    // 超时：直接输出当前点（静止时也保持最低上报频率），此时窗口点均在容差内
+    if (TRACK_Elapsed(track_anchor.time, p.time) >= TRACK_MAX_INTERVAL) {
+        TRACK_Emit(&p);
+        return;
+    }
+
+    track_window[track_window_count++] = p;
+}
+
+/**
+ * @brief 读取待上传的点（不移除）
+ * @param points: 输出数组
+ * @param max: 最多读取点数
+ * @param next_seq: 输出，上传成功后传给TRACK_Consume的序号
+ * @retval 读取的点数
+ */
+uint8_t TRACK_Peek(TRACK_Point_t *points, uint8_t max, uint32_t *next_seq)
+{
+    uint32_t seq = track_queue_tail;
+    uint8_t n = 0;
+
+    while (n < max && seq != track_queue_head) {
+        points[n++] = track_queue[seq & (TRACK_QUEUE_SIZE - 1)];
+        seq++;
+    }
+
+    *next_seq = seq;
+    return n;
+}
+
+/**
+ * @brief 上传成功后移除已上传的点
+ * @param next_seq: TRACK_Peek给出的序号
+ */
+void TRACK_Consume(uint32_t next_seq)
+{
+    // 上传期间队列满丢弃过旧点时，读取序号可能已越过next_seq
+    if ((int32_t)(next_seq - track_queue_tail) > 0 &&
+        (int32_t)(track_queue_head - next_seq) >= 0) {
+        track_queue_tail = next_seq;
+    }
+}
+
+/**
+ * @brief 获取压缩统计
+ * @retval 统计数据指针
+ */
+const TRACK_Stats_t *TRACK_Get_Stats(void)
+{
+    return &track_stats;
+}
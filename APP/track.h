@@ -0,0 +1,93 @@
+/**
+  ******************************************************************************
+  * @file           : track.h
+  * @brief          : 轨迹流式压缩（上传前抽稀）头文件
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-12
+  ******************************************************************************
+  * @attention
+  *
+  * 静止或直线行走时逐点上传浪费WiFi时间和电量，上传前用开窗法在线抽稀：
+  * - 以最后输出的点为锚点，后续定位先放入窗口
+  * - 每来一个新定位，检查窗口内各点到"锚点-新定位"线段的距离，
+  *   超过TRACK_TOLERANCE_M时输出窗口最后一点并作为新锚点
+  * - 窗口满或距上次输出超过TRACK_MAX_INTERVAL秒时也输出，保证实时性
+  * - 由输出点连线重建的轨迹与原始定位的偏差不超过TRACK_TOLERANCE_M
+  * - 输出点进入待上传队列，上传成功后才移除
+  *
+  ******************************************************************************
+  */
+
+#ifndef __TRACK_H
+#define __TRACK_H
+
+#include "main.h"
+#include "atgm336h.h"
+#include <stdbool.h>
+
+/* ==================== 配置参数 ==================== */
+
+#ifndef TRACK_TOLERANCE_M
+#define TRACK_TOLERANCE_M       5.0f    // 允许的最大重建误差（m，主机测试可在编译时覆盖）
+#endif
+#define TRACK_WINDOW_SIZE       32      // 窗口容量（定位点数），满时强制输出
+#define TRACK_MAX_INTERVAL      30      // 两个输出点最大时间间隔（s）
+#define TRACK_QUEUE_SIZE        32      // 待上传队列容量（2的幂），满时丢弃最旧的点
+#define TRACK_UPLOAD_MAX        3       // 每次上传的最多点数
+
+/* ==================== 数据结构 ==================== */
+
+/**
+ * @brief 轨迹点
+ */
+typedef struct {
+    int32_t lat_e7;     // 纬度（1e-7度）
+    int32_t lon_e7;     // 经度（1e-7度）
+    uint32_t time;      // UTC时间（当日秒数）
+} TRACK_Point_t;
+
+/**
+ * @brief 压缩统计
+ */
+typedef struct {
+    uint32_t fixes;         // 输入定位数
+    uint32_t emitted;       // 输出点数
+    uint32_t dropped;       // 上传队列满丢弃的点数
+    float max_error_m;      // 被省略点到重建线段的最大距离（m）
+} TRACK_Stats_t;
+
+/* ==================== 函数声明 ==================== */
+
+/**
+ * @brief 初始化轨迹压缩
+ */
+void TRACK_Init(void);
+
+/**
+ * @brief 输入GPS数据（每个有效定位只处理一次）
+ * @param data: GPS数据
+ */
+void TRACK_Add_Fix(const GPS_Data_t *data);
+
+/**
+ * @brief 读取待上传的点（不移除）
+ * @param points: 输出数组
+ * @param max: 最多读取点数
+ * @param next_seq: 输出，上传成功后传给TRACK_Consume的序号
+ * @retval 读取的点数
+ */
+uint8_t TRACK_Peek(TRACK_Point_t *points, uint8_t max, uint32_t *next_seq);
+
+/**
+ * @brief 上传成功后移除已上传的点
+ * @param next_seq: TRACK_Peek给出的序号
+ */
+void TRACK_Consume(uint32_t next_seq);
+
+/**
+ * @brief 获取压缩统计
+ * @retval 统计数据指针
+ */
+const TRACK_Stats_t *TRACK_Get_Stats(void);
+
+#endif /* __TRACK_H */
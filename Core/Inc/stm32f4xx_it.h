@@ -58,6 +58,11 @@ void SysTick_Handler(void);
 void EXTI15_10_IRQHandler(void);
 void USART2_IRQHandler(void);
 /* USER CODE BEGIN EFP */
+void TIM1_UP_TIM10_IRQHandler(void);
+void USART3_IRQHandler(void);
+void DMA1_Stream5_IRQHandler(void);
+void DMA2_Stream0_IRQHandler(void);
+void ADC_IRQHandler(void);
 
 /* USER CODE END EFP */
 
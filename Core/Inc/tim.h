@@ -35,13 +35,13 @@ extern "C" {
 extern TIM_HandleTypeDef htim1;
 
 /* USER CODE BEGIN Private defines */
-
+extern TIM_HandleTypeDef htim3;
 /* USER CODE END Private defines */
 
 void MX_TIM1_Init(void);
 
 /* USER CODE BEGIN Prototypes */
-
+void MX_TIM3_Init(void);
 /* USER CODE END Prototypes */
 
 #ifdef __cplusplus
@@ -30,8 +30,14 @@
 /* USER CODE BEGIN Includes */
 #include "scheduler.h"
 #include "max30102.h"
+#include "adc_scan.h"
+#include "aht20.h"
 #include "mq2.h"
+#include "icm20608.h"
+#include "dead_reckoning.h"
 #include "atgm336h.h"
+#include "geofence.h"
+#include "track.h"
 #include "esp01s.h"
 #include "asr_pro.h"
 /* USER CODE END Includes */
@@ -107,9 +113,13 @@ int main(void)
   MX_USART3_UART_Init();
   /* USER CODE BEGIN 2 */
 
-  // 启动TIM1用于软件I2C时序
+  // 启动TIM1用于软件I2C时序（空闲时作1us计数器，异步传输时产生节拍中断）
   HAL_TIM_Base_Start(&htim1);
 
+  // TIM3产生1kHz TRGO触发ADC1扫描（在ADC_SCAN_Start中启动）
+  MX_TIM3_Init();
+  ADC_SCAN_Init();
+
   // 初始化调度器
   scheduler_init();
 
@@ -120,23 +130,53 @@ int main(void)
 
   // 1. MAX30102心率血氧传感器
   MAX30102_Init();
-  scheduler_add_task(max30102_task, 200);  // 200ms采集一次
-
-  // 2. MQ2烟雾传感器
+#if MAX30102_USE_IRQ
+  scheduler_add_event_task(max30102_task);  // INT引脚中断和异步排空完成时唤醒
+  scheduler_notify(max30102_task);  // 登记前INT可能已拉低（无新边沿），先按引脚电平排空一次
+#else
+  scheduler_add_task(max30102_task, MAX30102_POLL_MS);
+#endif
+
+  // 2. MQ2烟雾传感器（AHT20温湿度用于MQ2补偿，未接或初始化失败时MQ2不补偿）
+  if (AHT20_Init(&hi2c1) == 0) {
+    scheduler_add_task(aht20_task, 2000);  // 2000ms读取一次（本次读取上次触发的结果并触发下一次，不阻塞）
+  } else {
+    printf("AHT20: Init failed, MQ2 compensation disabled\r\n");
+  }
   MQ2_Init();
-  scheduler_add_task(mq2_task, 500);  // 500ms检测一次
+  scheduler_add_task(mq2_task, MQ2_TASK_PERIOD_MS);  // 500ms检测一次，校准和基线跟踪随之推进
+  scheduler_add_event_task(mq2_alarm_task);  // 模拟看门狗越过报警/解除阈值时由ADC中断唤醒
+
+  // PA1备用模拟输入（电池电压分压，分压比用ADC_SCAN_Set_Calibration设置）
+  ADC_SCAN_Add_Channel(ADC_CHANNEL_1, ADC_SAMPLETIME_480CYCLES, 6);
+  if (ADC_SCAN_Start() != 0) {
+    printf("ADC: Scan start failed\r\n");
+  }
+
+  // 3. ICM20608六轴传感器（100Hz数据就绪，PA15上升沿唤醒icm20608_task）
+  DR_Init(&dr_state);  // GPS定位之间的航位推算，gps_task中用新定位修正
+  if (ICM20608_Init(&hi2c1) == 0 && ICM20608_EnableInterrupt(&hi2c1) == 0) {
+    scheduler_add_event_task(icm20608_task);
+    scheduler_add_task(dr_task, DR_STEP_MS);  // 50ms推算一次，输出20Hz位置
+  } else {
+    printf("ICM20608: Init failed\r\n");
+  }
 
-  // 3. ATGM336H GPS模块
+  // 4. ATGM336H GPS模块
   GPS_Init();
-  scheduler_add_task(gps_task, 1000);  // 1000ms更新一次
+  scheduler_add_event_task(gps_task);  // 收到完整NMEA语句时由串口中断唤醒
+  GEOFENCE_Init();  // 现场禁入区/危险区用GEOFENCE_Add_Zone添加后调用GEOFENCE_Build
+  GEOFENCE_Build();
+  TRACK_Init();  // 轨迹抽稀后随esp_task上传
 
-  // 4. ESP01S WiFi模块
+  // 5. ESP01S WiFi模块（先登记AT引擎，下面提交的指令才能唤醒它）
+  scheduler_add_event_task(esp_at_task);  // AT引擎：收到一行响应、提交指令或指令超时时唤醒
   ESP_Init();
   ESP_Connect_WiFi();
   ESP_Connect_MQTT();
   scheduler_add_task(esp_task, 5000);  // 5000ms上传一次数据
 
-  // 5. ASR-PRO语音模块
+  // 6. ASR-PRO语音模块
   ASR_Init();
   scheduler_add_task(asr_task, 1000);  // 1000ms轮询一次
 
@@ -153,6 +193,7 @@ int main(void)
 
     /* USER CODE BEGIN 3 */
     scheduler_run();
+    scheduler_idle();  // 休眠到下一个任务到期或被中断唤醒
   }
   /* USER CODE END 3 */
 }
@@ -210,8 +251,112 @@ void SystemClock_Config(void)
  */
 void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
 {
-    // GPS模块接收回调（UART2）
-    GPS_UART_RxCpltCallback(huart);
+    // ESP01S接收回调（UART3）
+    ESP_UART_RxCpltCallback(huart);
+}
+
+/**
+ * @brief UART接收事件回调函数（DMA半满/全满或空闲线）
+ * @param huart: UART句柄指针
+ * @param Size: DMA缓冲区当前写入位置
+ */
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
+{
+    // GPS模块接收回调（UART2循环DMA）
+    GPS_UART_RxEventCallback(huart, Size);
+}
+
+/**
+ * @brief UART错误回调函数
+ * @param huart: UART句柄指针
+ */
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+    // GPS模块DMA接收因错误停止时重新启动
+    GPS_UART_ErrorCallback(huart);
+
+    // ESP01S中断接收因错误（如溢出）停止时重新启动（UART3）
+    ESP_UART_ErrorCallback(huart);
+}
+
+/**
+ * @brief 定时器更新中断回调函数
+ * @param htim: 定时器句柄指针
+ */
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
+{
+    // MAX30102异步软件I2C节拍（TIM1）
+    MAX30102_TIM_PeriodElapsedCallback(htim);
+}
+
+/**
+ * @brief ADC DMA半满回调函数
+ * @param hadc: ADC句柄指针
+ */
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc)
+{
+    // ADC1扫描缓冲前半区抽取（循环DMA）
+    ADC_SCAN_ConvHalfCpltCallback(hadc);
+}
+
+/**
+ * @brief ADC DMA全满回调函数
+ * @param hadc: ADC句柄指针
+ */
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc)
+{
+    // ADC1扫描缓冲后半区抽取
+    ADC_SCAN_ConvCpltCallback(hadc);
+}
+
+/**
+ * @brief ADC模拟看门狗回调函数
+ * @param hadc: ADC句柄指针
+ */
+void HAL_ADC_LevelOutOfWindowCallback(ADC_HandleTypeDef *hadc)
+{
+    // MQ2报警阈值越界（ADC1模拟看门狗）
+    ADC_SCAN_LevelOutOfWindowCallback(hadc);
+}
+
+/**
+ * @brief ADC错误回调函数
+ * @param hadc: ADC句柄指针
+ */
+void HAL_ADC_ErrorCallback(ADC_HandleTypeDef *hadc)
+{
+    // ADC1溢出或DMA错误后重启扫描
+    ADC_SCAN_ErrorCallback(hadc);
+}
+
+/**
+ * @brief 调度器STOP模式退出钩子：恢复PLL系统时钟
+ */
+void scheduler_stop_exit_hook(void)
+{
+    SystemClock_Config();
+}
+
+/**
+ * @brief 调度器STOP模式许可：MAX30102异步I2C事务由TIM1节拍推进，进行中不进入STOP
+ * @retval 1: 允许, 0: 不允许
+ */
+uint8_t scheduler_stop_allowed(void)
+{
+    return !MAX30102_I2C_Async_Busy();
+}
+
+/**
+ * @brief GPIO外部中断回调函数
+ * @param GPIO_Pin: 触发中断的引脚
+ */
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+    // MAX30102 INT引脚（PB13）：标记FIFO数据待读，唤醒max30102_task
+    MAX30102_EXTI_Callback(GPIO_Pin);
+
+    // ICM20608 INT引脚（PA15）：唤醒icm20608_task读取新样本
+    ICM20608_EXTI_Callback(GPIO_Pin);
 }
 
 /* USER CODE END 4 */
@@ -0,0 +1,16 @@
+/**
+  ******************************************************************************
+  * @file           : adc.h
+  * @brief          : 主机测试用adc.h替身（句柄由hal_stub.c定义）
+  ******************************************************************************
+  */
+
+#ifndef __ADC_H__
+#define __ADC_H__
+
+#include "main.h"
+
+extern ADC_HandleTypeDef hadc1;
+extern DMA_HandleTypeDef hdma_adc1;
+
+#endif /* __ADC_H__ */
@@ -0,0 +1,327 @@
+/**
+  ******************************************************************************
+  * @file           : adc_decimator_test.c
+  * @brief          : ADC扫描服务DMA缓冲与抽取的模型测试：有效分辨率与CPU开销（主机测试）
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-20
+  ******************************************************************************
+  * @attention
+  *
+  * 直接包含固件adc_scan.c，ADC1/DMA/TIM3由adc_scan_sim模拟：1kHz触发，
+  * 扫描VREFINT、温度传感器和三路测试通道（抽取2^4、2^6即MQ2所用、2^8）。
+  * 测试通道输入为缓慢斜坡（每秒7.31LSB，覆盖各小数位置）叠加高斯噪声，
+  * 四舍五入并截断到12位。检查与报告：
+  * - 逐位一致：每个平均值与按采样历史独立计算的累加和移位结果相同；
+  * - 平均值个数与触发数一致，DMA中断次数为触发数/ADC_SCAN_FRAMES；
+  * - 有效分辨率：单次采样与平均值相对真实输入（窗口内斜坡均值）的均方根
+  *   误差，按理想量化器换算为位数 12 - log2(rms x sqrt(12))；噪声≥1LSB时
+  *   要求平均2^shift次至少增加shift/2 - 0.25位；
+  * - CPU开销：主机上ADC_SCAN_Decimate处理半个缓冲的纳秒数，折算到每个
+  *   采样和每个MQ2平均值（Cortex-M4周期数需在目标板上用DWT测量）。
+  *
+  * 编译运行（仓库根目录）：
+  *   gcc -O2 -Itools/host -IAPP tools/host/adc_decimator_test.c tools/host/adc_scan_sim.c \
+  *       tools/host/hal_stub.c -lm -o adc_decimator_test
+  *   ./adc_decimator_test [每种噪声仿真秒数]
+  *
+  ******************************************************************************
+  */
+
+// 出厂校准值在主机上没有对应地址，替换为常数（VREFINT采样取同一值，VDDA = 3.3V）
+#define ADC_SCAN_VREFINT_CAL    1500U
+#define ADC_SCAN_TS_CAL1        940U
+#define ADC_SCAN_TS_CAL2        1200U
+
+#include "adc_scan.c"
+#include "adc_scan_sim.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define TEST_CHANNELS   3U
+#define MAX_SECONDS     120U
+#define RAMP_START      1000.0          // LSB
+#define RAMP_RATE       7.31            // LSB/s
+#define MQ2_SHIFT       6               // 与MQ2_OVERSAMPLE_SHIFT相同
+#define GAIN_MARGIN_BITS 0.25
+
+static const uint32_t test_channel[TEST_CHANNELS] = { ADC_CHANNEL_1, ADC_CHANNEL_0, ADC_CHANNEL_2 };
+static const uint8_t test_shift[TEST_CHANNELS] = { 4, MQ2_SHIFT, 8 };
+
+static int8_t test_index[TEST_CHANNELS];
+static uint16_t history[TEST_CHANNELS][MAX_SECONDS * 1000U];
+static double truth[TEST_CHANNELS][MAX_SECONDS * 1000U];
+static uint32_t history_len[TEST_CHANNELS];
+static uint32_t checked_count[TEST_CHANNELS];
+static uint32_t mismatches;
+static double noise_lsb;
+
+static uint32_t rng_state = 0x2545F491U;
+
+static double uniform(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return (rng_state + 0.5) / 4294967296.0;
+}
+
+static double gaussian(void)
+{
+    return sqrt(-2.0 * log(uniform())) * cos(2.0 * M_PI * uniform());
+}
+
+/* ==================== 模拟输入 ==================== */
+
+static int32_t sample(uint32_t channel, uint64_t t)
+{
+    uint32_t i;
+
+    if (channel == ADC_CHANNEL_VREFINT) {
+        return ADC_SCAN_VREFINT_CAL;
+    }
+    if (channel == ADC_CHANNEL_TEMPSENSOR) {
+        return 1000;
+    }
+
+    for (i = 0; i < TEST_CHANNELS; i++) {
+        if (channel == test_channel[i]) {
+            double x = RAMP_START + RAMP_RATE * (double)t / HOST_CPU_HZ;
+            int32_t v = (int32_t)lround(x + noise_lsb * gaussian());
+
+            if (v < 0) v = 0;
+            if (v > ADC_SCAN_CODE_MAX) v = ADC_SCAN_CODE_MAX;
+            if (history_len[i] < MAX_SECONDS * 1000U) {
+                truth[i][history_len[i]] = x;
+                history[i][history_len[i]++] = (uint16_t)v;
+            }
+            return v;
+        }
+    }
+    return 0;
+}
+
+/* ==================== 逐位一致检查 ==================== */
+
+/**
+ * @brief 每次抽取后检查新平均值（每半个缓冲每个通道至多产生一个平均值）
+ */
+static void check_outputs(void)
+{
+    uint32_t i, k;
+
+    for (i = 0; i < TEST_CHANNELS; i++) {
+        const ADC_SCAN_Channel_t *ch = &adc_scan_channels[test_index[i]];
+        uint32_t n = 1U << ch->shift;
+        uint32_t sum = 0;
+        uint16_t expected;
+
+        if (ch->count == checked_count[i]) {
+            continue;
+        }
+        if (ch->count != checked_count[i] + 1U) {
+            printf("FAIL: channel %u produced %u averages in one half buffer\n",
+                   (unsigned)test_channel[i], (unsigned)(ch->count - checked_count[i]));
+            mismatches++;
+        }
+        checked_count[i] = ch->count;
+
+        for (k = (ch->count - 1U) * n; k < ch->count * n; k++) {
+            sum += history[i][k];
+        }
+        expected = (uint16_t)(ch->shift >= ADC_SCAN_FRAC_BITS ? sum >> (ch->shift - ADC_SCAN_FRAC_BITS)
+                                                              : sum << (ADC_SCAN_FRAC_BITS - ch->shift));
+        if (ch->code != expected) {
+            mismatches++;
+        }
+    }
+}
+
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc)
+{
+    ADC_SCAN_ConvHalfCpltCallback(hadc);
+    check_outputs();
+}
+
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc)
+{
+    ADC_SCAN_ConvCpltCallback(hadc);
+    check_outputs();
+}
+
+/* ==================== 分辨率 ==================== */
+
+static double bits(double rms)
+{
+    return 12.0 - log2(rms * sqrt(12.0));
+}
+
+/**
+ * @brief 按采样历史统计单次采样与各平均值的均方根误差
+ * @retval 分辨率增益不足的通道数
+ */
+static uint32_t report(void)
+{
+    uint32_t failures = 0;
+    uint32_t i, k, j;
+
+    for (i = 0; i < TEST_CHANNELS; i++) {
+        uint32_t n = 1U << test_shift[i];
+        uint32_t outputs = history_len[i] / n;
+        double raw_sq = 0, avg_sq = 0;
+
+        for (k = 0; k < outputs * n; k++) {
+            double e = history[i][k] - truth[i][k];
+
+            raw_sq += e * e;
+        }
+        for (k = 0; k < outputs; k++) {
+            uint32_t sum = 0;
+            double mean_truth = 0;
+            double e;
+
+            for (j = k * n; j < (k + 1U) * n; j++) {
+                sum += history[i][j];
+                mean_truth += truth[i][j];
+            }
+            // 平均值保留ADC_SCAN_FRAC_BITS位小数（截断），与固件输出相同
+            e = (double)(test_shift[i] >= ADC_SCAN_FRAC_BITS ? sum >> (test_shift[i] - ADC_SCAN_FRAC_BITS)
+                                                             : sum << (ADC_SCAN_FRAC_BITS - test_shift[i])) /
+                (1U << ADC_SCAN_FRAC_BITS) - mean_truth / n;
+            avg_sq += e * e;
+        }
+
+        {
+            double raw_rms = sqrt(raw_sq / (outputs * n));
+            double avg_rms = sqrt(avg_sq / outputs);
+
+            printf("%5.1f  %4u %8u   %7.3f %6.2f   %7.4f %6.2f   %+5.2f  %4.1f Hz%s\n",
+                   noise_lsb, n, (unsigned)outputs, raw_rms, bits(raw_rms), avg_rms, bits(avg_rms),
+                   bits(avg_rms) - bits(raw_rms), 1000.0 / n, test_shift[i] == MQ2_SHIFT ? "  MQ2" : "");
+
+            // 噪声≥1LSB时量化误差近似白噪声，平均2^shift次应增加shift/2位
+            if (noise_lsb >= 1.0 && bits(avg_rms) - bits(raw_rms) < test_shift[i] / 2.0 - GAIN_MARGIN_BITS) {
+                printf("FAIL: %u-sample average gains %.2f bits, expected %.1f\n", (unsigned)n,
+                       bits(avg_rms) - bits(raw_rms), test_shift[i] / 2.0);
+                failures++;
+            }
+        }
+    }
+    return failures;
+}
+
+/* ==================== 运行 ==================== */
+
+static uint32_t run(double noise, uint32_t seconds)
+{
+    uint32_t failures = 0;
+    uint32_t i;
+    uint32_t irq0;
+
+    noise_lsb = noise;
+    memset(history_len, 0, sizeof(history_len));
+    memset(checked_count, 0, sizeof(checked_count));
+    mismatches = 0;
+
+    host_init();
+    ADC_Scan_Sim_Init(1000U, sample);
+    ADC_SCAN_Init();
+    for (i = 0; i < TEST_CHANNELS; i++) {
+        test_index[i] = ADC_SCAN_Add_Channel(test_channel[i], ADC_SAMPLETIME_480CYCLES, test_shift[i]);
+    }
+    if (ADC_SCAN_Start() != 0) {
+        printf("FAIL: ADC_SCAN_Start\n");
+        return 1;
+    }
+
+    irq0 = adc_scan_sim.irq_ht + adc_scan_sim.irq_tc;
+    host_advance((uint64_t)seconds * HOST_CPU_HZ);
+
+    failures += report();
+
+    if (mismatches != 0) {
+        printf("FAIL: %u averages differ from the reference sum\n", (unsigned)mismatches);
+        failures++;
+    }
+    for (i = 0; i < TEST_CHANNELS; i++) {
+        uint32_t expected = adc_scan_sim.triggers / ADC_SCAN_FRAMES * ADC_SCAN_FRAMES >> test_shift[i];
+
+        if (adc_scan_channels[test_index[i]].count != expected) {
+            printf("FAIL: channel %u produced %u averages, expected %u\n", (unsigned)test_channel[i],
+                   (unsigned)adc_scan_channels[test_index[i]].count, (unsigned)expected);
+            failures++;
+        }
+    }
+    if (adc_scan_sim.irq_ht + adc_scan_sim.irq_tc - irq0 != adc_scan_sim.triggers / ADC_SCAN_FRAMES) {
+        printf("FAIL: %u DMA interrupts for %u triggers\n",
+               (unsigned)(adc_scan_sim.irq_ht + adc_scan_sim.irq_tc - irq0), (unsigned)adc_scan_sim.triggers);
+        failures++;
+    }
+    return failures;
+}
+
+/* ==================== CPU开销 ==================== */
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void cost(void)
+{
+    uint32_t rounds = 200000U;
+    uint32_t samples_per_half = (uint32_t)adc_scan_channel_count * ADC_SCAN_FRAMES;
+    double best = 1e30;
+    uint32_t r, k;
+
+    for (k = 0; k < 5; k++) {
+        double t0 = now_ns();
+        double ns;
+
+        for (r = 0; r < rounds; r++) {
+            ADC_SCAN_Decimate(&adc_scan_buffer[(r & 1U) * samples_per_half]);
+        }
+        ns = (now_ns() - t0) / rounds;
+        if (ns < best) {
+            best = ns;
+        }
+    }
+
+    printf("\nhost cost of ADC_SCAN_Decimate (%u channels x %u frames per half buffer):\n",
+           (unsigned)adc_scan_channel_count, (unsigned)ADC_SCAN_FRAMES);
+    printf("  %.1f ns per half buffer, %.2f ns per sample, %.1f ns of it per MQ2 average (%u samples)\n",
+           best, best / samples_per_half, best / samples_per_half * (1U << MQ2_SHIFT),
+           1U << MQ2_SHIFT);
+    printf("  %.1f DMA interrupts/s at a 1 kHz trigger; host load %.4f%%\n",
+           1000.0 / ADC_SCAN_FRAMES, best * (1000.0 / ADC_SCAN_FRAMES) / 1e7);
+    printf("  (measure Cortex-M4 cycles with DWT on target)\n");
+}
+
+int main(int argc, char **argv)
+{
+    static const double noise[] = { 0.3, 0.5, 1.0, 2.0, 5.0, 10.0 };
+    uint32_t seconds = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : 60U;
+    uint32_t failures = 0;
+    uint32_t i;
+
+    if (seconds > MAX_SECONDS) {
+        seconds = MAX_SECONDS;
+    }
+
+    printf("1 kHz trigger, %u s per noise level, ramp %.2f LSB/s, %u fraction bits kept\n",
+           (unsigned)seconds, RAMP_RATE, (unsigned)ADC_SCAN_FRAC_BITS);
+    printf("noise  avg  outputs   raw rms  bits    avg rms   bits    gain   rate\n");
+    printf("(LSB)                 (LSB)              (LSB)\n");
+    for (i = 0; i < sizeof(noise) / sizeof(noise[0]); i++) {
+        failures += run(noise[i], seconds);
+    }
+
+    cost();
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
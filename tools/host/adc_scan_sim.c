@@ -0,0 +1,230 @@
+/**
+  ******************************************************************************
+  * @file           : adc_scan_sim.c
+  * @brief          : ADC1定时触发扫描 + 循环DMA模型（主机测试用）
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-20
+  ******************************************************************************
+  */
+
+#include "adc_scan_sim.h"
+#include "adc.h"
+#include "tim.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+ADC_Scan_Sim_t adc_scan_sim;
+
+// ADC_SAMPLETIME_xCYCLES编码对应的采样周期数
+static const uint16_t sample_cycles[8] = { 3, 15, 28, 56, 84, 112, 144, 480 };
+
+static struct {
+    uint32_t channel;
+    uint32_t sampling_time;
+} ranks[ADC_SCAN_SIM_MAX_RANKS];
+
+static uint32_t rank_count;
+static uint32_t rank;               // 正在转换的序列位置
+static uint64_t next_trigger;
+static uint64_t next_conversion;    // 下一个转换结束时刻（UINT64_MAX: 未运行）
+static uint32_t tim3_running;
+
+static uint16_t *dma_buffer;
+static uint32_t dma_length;
+static uint32_t dma_pos;
+static uint32_t dma_running;
+static uint32_t ht_flag;
+static uint32_t tc_flag;
+
+static uint32_t awd_channel;
+static uint32_t awd_enabled;
+static uint32_t awd_flag;
+
+static uint64_t conversion_cycles(uint32_t r)
+{
+    uint32_t adc_clocks = sample_cycles[ranks[r].sampling_time & 7U] + 12U;
+
+    return (uint64_t)adc_clocks * HOST_CPU_HZ / ADC_SCAN_SIM_CLOCK_HZ;
+}
+
+uint64_t ADC_Scan_Sim_Sequence_Cycles(void)
+{
+    uint64_t total = 0;
+    uint32_t r;
+
+    for (r = 0; r < rank_count; r++) {
+        total += conversion_cycles(r);
+    }
+    return total;
+}
+
+static void schedule(void)
+{
+    if (!tim3_running || !dma_running || rank_count == 0) {
+        next_conversion = UINT64_MAX;
+        return;
+    }
+    next_conversion = next_trigger + conversion_cycles(0);
+}
+
+void ADC_Scan_Sim_Init(uint32_t trigger_hz, int32_t (*sample)(uint32_t channel, uint64_t t))
+{
+    memset(&adc_scan_sim, 0, sizeof(adc_scan_sim));
+    adc_scan_sim.trigger_hz = trigger_hz;
+    adc_scan_sim.sample = sample;
+    rank_count = 0;
+    rank = 0;
+    tim3_running = 0;
+    dma_running = 0;
+    awd_enabled = 0;
+    ht_flag = tc_flag = awd_flag = 0;
+    next_conversion = UINT64_MAX;
+}
+
+/* ==================== 中断 ==================== */
+
+static void dma_isr(void)
+{
+    // HAL_DMA_IRQHandler：先半满后全满
+    if (ht_flag) {
+        ht_flag = 0;
+        adc_scan_sim.irq_ht++;
+        HAL_ADC_ConvHalfCpltCallback(&hadc1);
+    }
+    if (tc_flag) {
+        tc_flag = 0;
+        adc_scan_sim.irq_tc++;
+        HAL_ADC_ConvCpltCallback(&hadc1);
+    }
+}
+
+static void adc_isr(void)
+{
+    if (awd_flag) {
+        awd_flag = 0;
+        adc_scan_sim.irq_awd++;
+        HAL_ADC_LevelOutOfWindowCallback(&hadc1);
+    }
+}
+
+/* ==================== 转换 ==================== */
+
+static void convert(uint64_t t)
+{
+    uint32_t channel = ranks[rank].channel;
+    int32_t v = adc_scan_sim.sample(channel, t);
+
+    if (v < 0) v = 0;
+    if (v > 4095) v = 4095;
+
+    dma_buffer[dma_pos++] = (uint16_t)v;
+    adc_scan_sim.conversions++;
+
+    if (awd_enabled && channel == awd_channel &&
+        ((uint32_t)v > ADC1->HTR || (uint32_t)v < ADC1->LTR)) {
+        adc_scan_sim.awd_hits++;
+        awd_flag = 1;
+        host_raise_irq(adc_isr);
+    }
+
+    if (dma_pos == dma_length / 2U) {
+        ht_flag = 1;
+        host_raise_irq(dma_isr);
+    } else if (dma_pos == dma_length) {
+        dma_pos = 0;
+        tc_flag = 1;
+        host_raise_irq(dma_isr);
+    }
+
+    if (++rank < rank_count) {
+        next_conversion = t + conversion_cycles(rank);
+    } else {
+        rank = 0;
+        next_trigger += HOST_CPU_HZ / adc_scan_sim.trigger_hz;
+        adc_scan_sim.triggers++;
+        schedule();
+    }
+}
+
+uint64_t host_event_next(void)
+{
+    return next_conversion;
+}
+
+void host_event_poll(uint64_t now)
+{
+    while (next_conversion <= now) {
+        convert(next_conversion);
+    }
+}
+
+/* ==================== HAL接口 ==================== */
+
+HAL_StatusTypeDef HAL_ADC_Init(ADC_HandleTypeDef *hadc)
+{
+    if (hadc->Init.NbrOfConversion > ADC_SCAN_SIM_MAX_RANKS) {
+        return HAL_ERROR;
+    }
+    rank_count = hadc->Init.NbrOfConversion;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_ConfigChannel(ADC_HandleTypeDef *hadc, ADC_ChannelConfTypeDef *sConfig)
+{
+    (void)hadc;
+    if (sConfig->Rank == 0 || sConfig->Rank > ADC_SCAN_SIM_MAX_RANKS) {
+        return HAL_ERROR;
+    }
+    ranks[sConfig->Rank - 1U].channel = sConfig->Channel;
+    ranks[sConfig->Rank - 1U].sampling_time = sConfig->SamplingTime;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_AnalogWDGConfig(ADC_HandleTypeDef *hadc, ADC_AnalogWDGConfTypeDef *AnalogWDGConfig)
+{
+    hadc->Instance->HTR = AnalogWDGConfig->HighThreshold;
+    hadc->Instance->LTR = AnalogWDGConfig->LowThreshold;
+    awd_channel = AnalogWDGConfig->Channel;
+    awd_enabled = (AnalogWDGConfig->ITMode == ENABLE);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef *hadc, uint32_t *pData, uint32_t Length)
+{
+    (void)hadc;
+    if (Length % rank_count != 0U || ADC_Scan_Sim_Sequence_Cycles() >= HOST_CPU_HZ / adc_scan_sim.trigger_hz) {
+        fprintf(stderr, "adc_scan_sim: DMA length or scan sequence does not fit the trigger period\n");
+        abort();
+    }
+    dma_buffer = (uint16_t *)pData;
+    dma_length = Length;
+    dma_pos = 0;
+    rank = 0;
+    dma_running = 1;
+    ht_flag = tc_flag = 0;
+    // 停止期间错过的触发不补做
+    while (tim3_running && next_trigger < host_cycles()) {
+        next_trigger += HOST_CPU_HZ / adc_scan_sim.trigger_hz;
+    }
+    schedule();
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Stop_DMA(ADC_HandleTypeDef *hadc)
+{
+    (void)hadc;
+    dma_running = 0;
+    schedule();
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Start(TIM_HandleTypeDef *htim)
+{
+    if (htim == &htim3 && !tim3_running) {
+        tim3_running = 1;
+        next_trigger = host_cycles() + HOST_CPU_HZ / adc_scan_sim.trigger_hz;
+        schedule();
+    }
+    return HAL_OK;
+}
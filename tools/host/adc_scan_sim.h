@@ -0,0 +1,59 @@
+/**
+  ******************************************************************************
+  * @file           : adc_scan_sim.h
+  * @brief          : ADC1定时触发扫描 + 循环DMA模型（主机测试用）
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-20
+  ******************************************************************************
+  * @attention
+  *
+  * 模拟TIM3 TRGO触发的ADC1规则组扫描（HAL_ADC_Start_DMA，循环模式）：
+  * - HAL_TIM_Base_Start(&htim3)后每1/trigger_hz触发一次扫描，序列中各通道
+  *   依次转换，转换时间为（采样周期 + 12）个ADC时钟（21MHz）；
+  * - 每个转换结束时向测试程序的sample回调取12位结果，写入DMA缓冲区；
+  *   写到一半/写满时挂起DMA中断，执行时调用HAL_ADC_ConvHalfCpltCallback/
+  *   HAL_ADC_ConvCpltCallback；
+  * - 模拟看门狗：配置的通道转换结果大于ADC1->HTR或小于ADC1->LTR时置标志
+  *   并挂起ADC中断，执行时调用HAL_ADC_LevelOutOfWindowCallback（中断挂起
+  *   期间的多次越界合并为一次，与硬件标志相同）。
+  * 不模拟STOP模式（ADC在STOP中停止）。与uart_rx_sim一样定义
+  * host_event_next/host_event_poll，不能与其同时链接。
+  *
+  ******************************************************************************
+  */
+
+#ifndef __ADC_SCAN_SIM_H
+#define __ADC_SCAN_SIM_H
+
+#include "main.h"
+
+#define ADC_SCAN_SIM_MAX_RANKS  16
+#define ADC_SCAN_SIM_CLOCK_HZ   21000000U   // PCLK2 84MHz / 4
+
+typedef struct {
+    uint32_t trigger_hz;        // TIM3触发频率
+    uint32_t triggers;          // 已触发的扫描次数
+    uint32_t conversions;       // 写入DMA缓冲区的转换数
+    uint32_t irq_ht;            // DMA半满中断次数
+    uint32_t irq_tc;            // DMA全满中断次数
+    uint32_t irq_awd;           // 看门狗回调次数
+    uint32_t awd_hits;          // 越出窗口的看门狗通道转换数
+    // 每个转换结束时调用：通道、时刻（周期），返回转换结果（超出0~4095时截断）
+    int32_t (*sample)(uint32_t channel, uint64_t t);
+} ADC_Scan_Sim_t;
+
+extern ADC_Scan_Sim_t adc_scan_sim;
+
+/**
+ * @brief 复位模型（在ADC_SCAN_Start之前调用）
+ * @param trigger_hz: TIM3触发频率
+ * @param sample: 转换结果回调
+ */
+void ADC_Scan_Sim_Init(uint32_t trigger_hz, int32_t (*sample)(uint32_t channel, uint64_t t));
+
+/**
+ * @brief 一次扫描序列的转换时间（周期）
+ */
+uint64_t ADC_Scan_Sim_Sequence_Cycles(void);
+
+#endif /* __ADC_SCAN_SIM_H */
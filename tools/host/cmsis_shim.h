@@ -0,0 +1,48 @@
+/**
+  ******************************************************************************
+  * @file           : cmsis_shim.h
+  * @brief          : CMSIS DSP内建函数的主机实现（主机测试用）
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-20
+  ******************************************************************************
+  * @attention
+  *
+  * 按ARMv7-M架构手册的指令语义实现cmsis_gcc.h中固件用到的SIMD内建函数，
+  * 使主机测试能编译__ARM_FEATURE_DSP分支并与C实现逐位比较：
+  * - SMLAD：两组有符号16位乘积与累加器相加，结果按32位回绕（溢出只置Q标志）；
+  * - PKHBT：低半字取第一个操作数，高半字取第二个操作数左移后的低半字；
+  * - SSAT：有符号饱和到sat位。
+  * 参数与返回类型同cmsis_gcc.h。
+  *
+  ******************************************************************************
+  */
+
+#ifndef __CMSIS_SHIM_H
+#define __CMSIS_SHIM_H
+
+#include <stdint.h>
+
+static inline uint32_t __SMLAD(uint32_t op1, uint32_t op2, uint32_t op3)
+{
+    int32_t lo = (int32_t)(int16_t)(op1 & 0xFFFFU) * (int32_t)(int16_t)(op2 & 0xFFFFU);
+    int32_t hi = (int32_t)(int16_t)(op1 >> 16) * (int32_t)(int16_t)(op2 >> 16);
+
+    return op3 + (uint32_t)lo + (uint32_t)hi;
+}
+
+static inline uint32_t __PKHBT(uint32_t op1, uint32_t op2, uint32_t shift)
+{
+    return (op1 & 0x0000FFFFU) | ((op2 << shift) & 0xFFFF0000U);
+}
+
+static inline int32_t __SSAT(int32_t val, uint32_t sat)
+{
+    const int32_t max = (int32_t)((1U << (sat - 1U)) - 1U);
+    const int32_t min = -1 - max;
+
+    if (val > max) return max;
+    if (val < min) return min;
+    return val;
+}
+
+#endif /* __CMSIS_SHIM_H */
@@ -0,0 +1,443 @@
+/**
+  ******************************************************************************
+  * @file           : esp_at_emu.c
+  * @brief          : ESP01S AT引擎与模块仿真的联调测试（主机测试）
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-20
+  ******************************************************************************
+  * @attention
+  *
+  * 直接包含固件esp01s.c，与固件scheduler.c一起按main.c的方式运行
+  * （ESP_Init/ESP_Connect_WiFi/ESP_Connect_MQTT，esp_task每5秒上传）。
+  * 本文件模拟ESP-AT固件（MQTT指令集）和115200波特率的UART3：
+  * - MCU发送的字节按帧时间逐个到达模块，模块按行解析指令，
+  *   ATE0之前回显指令；CWJAP约2.5秒、MQTTCONN约300ms后完成；
+  *   MQTTPUBRAW回OK和'>'，收齐原始数据后约50ms回+MQTTPUB:OK；
+  * - 模块发出的字节按帧时间逐个到达，接收未启动时到达的字节计为丢失；
+  * - 故障注入：20秒起的一次发布不回+MQTTPUB（须按5秒超时结束）；
+  *   32.5秒起的一条URC中注入一次接收溢出（ORE：丢1字节，HAL结束接收并
+  *   调用HAL_UART_ErrorCallback，须立即重新启动接收）。
+  * 两种登记方式对比：event为事件任务（当前main.c），poll10为原来的10ms周期任务。
+  * 报告发布成功/失败数、超时实际触发时刻、接收错误与丢失字节、
+  * 每秒唤醒次数和最长一次休眠（仿真中任务执行不耗时，不报告休眠占比）。
+  *
+  * 编译运行（仓库根目录）：
+  *   gcc -O2 -Itools/host -IAPP tools/host/esp_at_emu.c tools/host/hal_stub.c \
+  *       APP/scheduler.c -o esp_at_emu
+  *   ./esp_at_emu
+  *
+  ******************************************************************************
+  */
+
+#include "esp01s.c"
+#include <stdlib.h>
+
+#define EMU_BAUD            115200U
+#define EMU_FRAME_CYCLES    (10ULL * HOST_CPU_HZ / EMU_BAUD)
+#define EMU_MS              (HOST_CPU_HZ / 1000U)
+#define EMU_MAX_REPLIES     16
+#define EMU_RX_QUEUE        4096U
+#define RUN_MS              60000U
+#define DROP_PUB_AT_MS      20000U  // 此后第一次发布不回+MQTTPUB
+#define ORE_AT_MS           32500U  // 发出带溢出的URC
+#define ORE_BYTE            10U     // URC中第几个字节溢出
+
+typedef struct {
+    uint64_t at;
+    char text[192];
+} Emu_Reply_t;
+
+/* ---------- 模块状态 ---------- */
+
+static char emu_line[ESP_AT_CMD_MAX_LEN];
+static uint32_t emu_line_len;
+static uint32_t emu_raw_remaining;      // '>'之后待收的原始数据字节数
+static int emu_echo;                    // 指令回显（ATE0关闭）
+static int emu_drop_pub;                // 下一次发布不回结果
+static uint32_t emu_pub_attempts;
+static uint64_t emu_drop_cmd_time;      // 被丢弃结果的发布指令首字节到达时刻
+static uint32_t emu_cmd_first;          // 当前行首字节到达时刻（毫秒，uwTick）
+
+static Emu_Reply_t replies[EMU_MAX_REPLIES];
+static uint32_t reply_count;
+
+/* ---------- UART3线路 ---------- */
+
+static const uint8_t *tx_data;          // MCU正在发送的数据
+static uint16_t tx_len, tx_pos;
+static uint64_t tx_next = UINT64_MAX;   // 下一个发送字节到达模块的时刻
+
+static uint8_t rx_q[EMU_RX_QUEUE];      // 模块待发出的字节
+static uint32_t rx_head, rx_tail;
+static uint64_t rx_next = UINT64_MAX;   // 下一个字节到达MCU的时刻
+
+static uint8_t usart_dr;
+static int usart_rxne, usart_ore;
+static uint32_t ore_countdown;          // 非0时第n个字节溢出
+static uint64_t ore_event = UINT64_MAX;
+static uint64_t drop_event = UINT64_MAX;
+static uint32_t lost_bytes;
+static uint32_t ore_restarted;          // 错误回调返回时接收已重新启动
+
+/* ==================== 模块侧 ==================== */
+
+static void emu_reply(uint32_t delay_ms, const char *text)
+{
+    if (reply_count >= EMU_MAX_REPLIES) {
+        fprintf(stderr, "esp_at_emu: too many replies\n");
+        abort();
+    }
+    replies[reply_count].at = host_cycles() + (uint64_t)delay_ms * EMU_MS;
+    snprintf(replies[reply_count].text, sizeof(replies[0].text), "%s", text);
+    reply_count++;
+}
+
+static void emu_handle_line(const char *line)
+{
+    const char *p;
+
+    if (emu_echo) {
+        char echo[ESP_AT_CMD_MAX_LEN + 4];
+
+        snprintf(echo, sizeof(echo), "%s\r\n", line);
+        emu_reply(0, echo);
+    }
+
+    if (strcmp(line, "AT") == 0 || strncmp(line, "AT+CWMODE=", 10) == 0 ||
+        strncmp(line, "AT+MQTTUSERCFG=", 15) == 0) {
+        emu_reply(1, "\r\nOK\r\n");
+    } else if (strcmp(line, "ATE0") == 0) {
+        emu_echo = 0;
+        emu_reply(1, "\r\nOK\r\n");
+    } else if (strncmp(line, "AT+CWJAP=", 9) == 0) {
+        emu_reply(2000, "WIFI CONNECTED\r\n");
+        emu_reply(2500, "WIFI GOT IP\r\n\r\nOK\r\n");
+    } else if (strncmp(line, "AT+MQTTCONN=", 12) == 0) {
+        emu_reply(300, "+MQTTCONNECTED:0,1,\"server\",\"1883\",\"\",1\r\n\r\nOK\r\n");
+    } else if (strncmp(line, "AT+MQTTPUBRAW=", 14) == 0 && (p = strrchr(line, '"')) != NULL) {
+        emu_raw_remaining = (uint32_t)strtoul(p + 2, NULL, 10);
+        emu_pub_attempts++;
+        if (emu_drop_pub == 1) {
+            emu_drop_pub = 2;
+            emu_drop_cmd_time = (uint64_t)emu_cmd_first;
+        }
+        emu_reply(2, "\r\nOK\r\n\r\n>");
+    } else {
+        emu_reply(1, "\r\nERROR\r\n");
+    }
+}
+
+/**
+ * @brief 模块收到MCU发送的一个字节
+ */
+static void emu_rx_from_mcu(uint8_t b)
+{
+    if (emu_raw_remaining > 0) {
+        if (--emu_raw_remaining == 0) {
+            if (emu_drop_pub == 2) {
+                emu_drop_pub = 0;   // 吞掉结果，MCU侧按超时结束
+            } else {
+                emu_reply(50, "+MQTTPUB:OK\r\n");
+            }
+        }
+        return;
+    }
+
+    if (emu_line_len == 0) {
+        emu_cmd_first = uwTick;
+    }
+    if (b == '\n') {
+        if (emu_line_len > 0 && emu_line[emu_line_len - 1] == '\r') {
+            emu_line_len--;
+        }
+        emu_line[emu_line_len] = '\0';
+        emu_line_len = 0;
+        emu_handle_line(emu_line);
+    } else if (emu_line_len < sizeof(emu_line) - 1U) {
+        emu_line[emu_line_len++] = (char)b;
+    }
+}
+
+/* ==================== UART3 ==================== */
+
+/**
+ * @brief USART3中断：同HAL_UART_IRQHandler，先收字节，再处理溢出（结束接收并回调）
+ */
+static void usart3_isr(void)
+{
+    if (usart_rxne) {
+        usart_rxne = 0;
+        if (huart3.RxState == HAL_UART_STATE_BUSY_RX) {
+            huart3.pRxBuffPtr[0] = usart_dr;
+            huart3.RxState = HAL_UART_STATE_READY;
+            HAL_UART_RxCpltCallback(&huart3);
+        } else {
+            lost_bytes++;
+        }
+    }
+    if (usart_ore) {
+        usart_ore = 0;
+        huart3.ErrorCode = 0x08U;   // HAL_UART_ERROR_ORE
+        huart3.RxState = HAL_UART_STATE_READY;
+        HAL_UART_ErrorCallback(&huart3);
+        if (huart3.RxState == HAL_UART_STATE_BUSY_RX) {
+            ore_restarted++;
+        }
+    }
+}
+
+static void rx_schedule(uint64_t from)
+{
+    rx_next = rx_tail != rx_head ? from + EMU_FRAME_CYCLES : UINT64_MAX;
+}
+
+static void rx_push(const char *text)
+{
+    int was_empty = rx_tail == rx_head;
+
+    while (*text) {
+        rx_q[rx_head++ % EMU_RX_QUEUE] = (uint8_t)*text++;
+    }
+    if (was_empty) {
+        rx_schedule(host_cycles());
+    }
+}
+
+uint64_t host_event_next(void)
+{
+    uint64_t next = tx_next < rx_next ? tx_next : rx_next;
+    uint32_t i;
+
+    for (i = 0; i < reply_count; i++) {
+        if (replies[i].at < next) {
+            next = replies[i].at;
+        }
+    }
+    if (ore_event < next) next = ore_event;
+    if (drop_event < next) next = drop_event;
+    return next;
+}
+
+void host_event_poll(uint64_t now)
+{
+    uint32_t i;
+
+    while (host_event_next() <= now) {
+        if (drop_event <= now) {
+            drop_event = UINT64_MAX;
+            emu_drop_pub = 1;
+        }
+        if (ore_event <= now) {
+            ore_event = UINT64_MAX;
+            ore_countdown = ORE_BYTE;
+            rx_push("+MQTTSUBRECV:0,\"cmd\",5,hello\r\n");
+        }
+
+        // 到期的回复按登记顺序进入发送队列
+        for (i = 0; i < reply_count; ) {
+            if (replies[i].at <= now) {
+                rx_push(replies[i].text);
+                memmove(&replies[i], &replies[i + 1], (reply_count - i - 1U) * sizeof(replies[0]));
+                reply_count--;
+            } else {
+                i++;
+            }
+        }
+
+        if (tx_next <= now) {
+            uint64_t t = tx_next;
+
+            emu_rx_from_mcu(tx_data[tx_pos++]);
+            if (tx_pos >= tx_len) {
+                tx_next = UINT64_MAX;
+                huart3.gState = HAL_UART_STATE_READY;
+            } else {
+                tx_next = t + EMU_FRAME_CYCLES;
+            }
+        }
+
+        if (rx_next <= now) {
+            uint64_t t = rx_next;
+            uint8_t b = rx_q[rx_tail++ % EMU_RX_QUEUE];
+
+            if (ore_countdown != 0 && --ore_countdown == 0) {
+                // 中断响应过慢，数据寄存器被覆盖：这个字节丢失，置ORE
+                lost_bytes++;
+                usart_ore = 1;
+            } else {
+                usart_dr = b;
+                usart_rxne = 1;
+            }
+            host_raise_irq(usart3_isr);
+            rx_schedule(t);
+        }
+    }
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_IT(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size)
+{
+    if (huart != &huart3 || Size == 0) {
+        return HAL_OK;
+    }
+    if (huart->gState == HAL_UART_STATE_BUSY_TX) {
+        return HAL_BUSY;
+    }
+    huart->gState = HAL_UART_STATE_BUSY_TX;
+    tx_data = pData;
+    tx_len = Size;
+    tx_pos = 0;
+    tx_next = host_cycles() + EMU_FRAME_CYCLES;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_AbortTransmit_IT(UART_HandleTypeDef *huart)
+{
+    if (huart == &huart3) {
+        tx_next = UINT64_MAX;
+    }
+    huart->gState = HAL_UART_STATE_READY;
+    return HAL_OK;
+}
+
+/* ==================== 固件接口 ==================== */
+
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
+{
+    ESP_UART_RxCpltCallback(huart);
+}
+
+// 同main.c
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+    ESP_UART_ErrorCallback(huart);
+}
+
+uint8_t TRACK_Peek(TRACK_Point_t *points, uint8_t max, uint32_t *next_seq)
+{
+    (void)points;
+    (void)max;
+    *next_seq = 0;
+    return 0;
+}
+
+void TRACK_Consume(uint32_t next_seq)
+{
+    (void)next_seq;
+}
+
+/* ==================== 测试 ==================== */
+
+static uint32_t failures;
+
+static void expect(int cond, const char *what)
+{
+    if (!cond) {
+        printf("FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+static void reset_all(void)
+{
+    host_init();
+    scheduler_init();
+
+    memset(&esp_data, 0, sizeof(esp_data));
+    esp_rx_head = esp_rx_tail = 0;
+    esp_line_len = 0;
+    esp_at_head = esp_at_tail = esp_at_count = 0;
+    esp_at_state = AT_STATE_IDLE;
+    esp_publish_pending = false;
+    esp_track_pending = false;
+    huart3.gState = HAL_UART_STATE_READY;
+    huart3.RxState = HAL_UART_STATE_READY;
+
+    emu_line_len = 0;
+    emu_raw_remaining = 0;
+    emu_echo = 1;
+    emu_drop_pub = 0;
+    emu_pub_attempts = 0;
+    reply_count = 0;
+    tx_next = rx_next = UINT64_MAX;
+    rx_head = rx_tail = 0;
+    usart_rxne = usart_ore = 0;
+    ore_countdown = 0;
+    lost_bytes = 0;
+    ore_restarted = 0;
+}
+
+/**
+ * @brief 按main.c的方式运行RUN_MS
+ * @param poll: 0: 事件任务, 1: 原10ms周期任务
+ */
+static void run(int poll)
+{
+    uint64_t t0, end, sleep_start, longest = 0;
+    uint32_t fail_seen = 0, timeout_tick = 0;
+    uint32_t idle_ms, wakeups, idle0, wakeups0;
+
+    reset_all();
+
+    if (poll) {
+        scheduler_add_task(esp_at_task, 10);
+    } else {
+        scheduler_add_event_task(esp_at_task);
+    }
+    ESP_Init();
+    ESP_Connect_WiFi();
+    ESP_Connect_MQTT();
+    scheduler_add_task(esp_task, 5000);
+
+    t0 = host_cycles();
+    scheduler_get_idle_stats(&idle0, &wakeups0);   // 统计不随scheduler_init清零
+    drop_event = t0 + (uint64_t)DROP_PUB_AT_MS * EMU_MS;
+    ore_event = t0 + (uint64_t)ORE_AT_MS * EMU_MS;
+    end = t0 + (uint64_t)RUN_MS * EMU_MS;
+
+    while (host_cycles() < end) {
+        scheduler_run();
+        if (esp_data.publish_fail != fail_seen) {
+            fail_seen = esp_data.publish_fail;
+            timeout_tick = uwTick;
+        }
+        sleep_start = host_cycles();
+        scheduler_idle();
+        if (host_cycles() - sleep_start > longest) {
+            longest = host_cycles() - sleep_start;
+        }
+    }
+
+    scheduler_get_idle_stats(&idle_ms, &wakeups);
+
+    printf("%-6s  %3u/%-3u %4u   %+8d   %5u %5u    %7.1f   %8.1f\n",
+           poll ? "poll10" : "event",
+           (unsigned)esp_data.publish_ok, (unsigned)esp_data.publish_fail, (unsigned)emu_pub_attempts,
+           fail_seen ? (int)(timeout_tick - (uint32_t)emu_drop_cmd_time) - ESP_AT_TIMEOUT_MQTTPUB : 0,
+           (unsigned)esp_data.rx_errors, (unsigned)lost_bytes,
+           (wakeups - wakeups0) * 1000.0 / RUN_MS,
+           (double)longest * 1000.0 / HOST_CPU_HZ);
+
+    expect(esp_data.wifi_connected && esp_data.mqtt_connected, "WiFi and MQTT connected");
+    expect(esp_data.publish_fail == 1, "exactly the dropped publish fails");
+    expect(esp_data.publish_ok + 1U == emu_pub_attempts, "every other publish succeeds");
+    expect(esp_data.rx_errors == 1 && lost_bytes == 1, "one overrun, one byte lost");
+    expect(esp_data.rx_overflow == 0, "no ring overflow");
+    if (!poll) {
+        expect(ore_restarted == 1, "reception restarted from the error callback");
+        expect(timeout_tick - (uint32_t)emu_drop_cmd_time <= ESP_AT_TIMEOUT_MQTTPUB + 1U,
+               "timeout fires within 1 ms of its deadline");
+    }
+}
+
+int main(void)
+{
+    printf("ESP-AT emulator, UART3 %u baud, %u s per run\n", (unsigned)EMU_BAUD, (unsigned)(RUN_MS / 1000U));
+    printf("mode     pub ok/fail/sent  timeout   rx    lost   wakeups/s   longest\n");
+    printf("                          late(ms) errors bytes              sleep(ms)\n");
+
+    run(0);
+    run(1);
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,365 @@
+/**
+  ******************************************************************************
+  * @file           : geofence_bench.c
+  * @brief          : 电子围栏多边形边界测试与10/100/1000区域检测耗时（主机测试）
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-20
+  ******************************************************************************
+  * @attention
+  *
+  * 直接包含固件geofence.c（容量在编译时放大到1000个区域）。
+  * 边界测试（均经GEOFENCE_Update的网格路径，并与GEOFENCE_Zone_Contains对照）：
+  * - 正方形：四个顶点、各边中点在内，各边外侧1个单位（1e-7度）在外、内侧1个单位在内；
+  * - 凹多边形（U形）：缺口内在外，射线经过缺口底部两个顶点时结果正确；
+  * - 三角形斜边上的整点在内，斜边两侧1个单位分别在内/外；
+  * - 菱形：点与左右顶点同纬度（水平射线穿过顶点）时内外正确；
+  * - 网格：点位于网格最大坐标（含端点）与格线上时与逐区域判断一致；
+  * - 事件：进入一次ENTER，区域内移动和走到边上无事件，离开一次LEAVE。
+  * 耗时：约2.2km见方的工地内随机放置10/100/1000个4~8顶点的星形多边形
+  * （半径10~40m），在工地及外围10%范围内随机取定位点，比较：
+  * - naive：对每个区域直接做射线法；
+  * - bbox：逐区域先比外包矩形再做射线法（GEOFENCE_Zone_Contains）；
+  * - grid：GEOFENCE_Update（网格筛选 + 外包矩形 + 射线法 + 进出比较）。
+  * 每个定位点检查grid结果与naive完全一致，报告主机上每次检测纳秒数和
+  * 每次检测的候选区域数/射线法次数。
+  *
+  * 编译运行（仓库根目录）：
+  *   gcc -O2 -DGEOFENCE_MAX_ZONES=1024 -DGEOFENCE_MAX_VERTICES=8192 \
+  *       -DGEOFENCE_MAX_CELL_ENTRIES=16384 -Itools/host -IAPP tools/host/geofence_bench.c -lm -o geofence_bench
+  *   ./geofence_bench [定位点数]
+  *
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+
+// 固件的事件与建索引打印与本测试无关，包含期间静默
+#define printf(...) ((void)0)
+#include "geofence.c"
+#undef printf
+#include <math.h>
+#include <stdlib.h>
+#include <time.h>
+
+#if GEOFENCE_MAX_ZONES < 1000
+#error "build with -DGEOFENCE_MAX_ZONES=1024 -DGEOFENCE_MAX_VERTICES=8192 -DGEOFENCE_MAX_CELL_ENTRIES=16384"
+#endif
+
+#define SITE_LAT        399000000L  // 工地西南角（1e-7度）
+#define SITE_LON        1163900000L
+#define SITE_SPAN       200000L     // 0.02度，约2.2km
+#define METER_E7        90L         // 1米约90个1e-7度（纬度方向）
+
+static uint32_t failures;
+static uint32_t rng_state = 0x9E3779B9U;
+
+static uint32_t rng(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+/* ==================== 事件记录 ==================== */
+
+static uint32_t enter_events;
+static uint32_t leave_events;
+
+static void on_event(const GEOFENCE_Event_t *event)
+{
+    if (event->type == GEOFENCE_EVENT_ENTER) {
+        enter_events++;
+    } else {
+        leave_events++;
+    }
+}
+
+static void update(int32_t lat, int32_t lon)
+{
+    GPS_Data_t data;
+
+    memset(&data, 0, sizeof(data));
+    data.fix_valid = true;
+    data.lat_e7 = lat;
+    data.lon_e7 = lon;
+    GEOFENCE_Update(&data);
+}
+
+/* ==================== 边界测试 ==================== */
+
+/**
+ * @brief 检查一个点：网格路径与逐区域判断都须等于期望
+ */
+static void expect_point(const char *what, uint16_t zone, int32_t lat, int32_t lon, bool inside)
+{
+    bool direct = GEOFENCE_Zone_Contains(zone, lat, lon);
+    bool indexed;
+
+    update(lat, lon);
+    indexed = GEOFENCE_Is_Inside(zone);
+    if (direct != inside || indexed != inside) {
+        printf("FAIL: %s (%ld, %ld): want %s, Zone_Contains %d, Update %d\n", what,
+               (long)(lat - SITE_LAT), (long)(lon - SITE_LON), inside ? "inside" : "outside",
+               direct, indexed);
+        failures++;
+    }
+}
+
+static int16_t add_zone(const int32_t (*xy)[2], uint16_t n)
+{
+    GEOFENCE_Point_t v[16];
+    uint16_t i;
+
+    // 测试坐标以(纬度偏移, 经度偏移)给出，相对工地西南角
+    for (i = 0; i < n; i++) {
+        v[i].lat_e7 = SITE_LAT + xy[i][0];
+        v[i].lon_e7 = SITE_LON + xy[i][1];
+    }
+    return GEOFENCE_Add_Zone(v, n, GEOFENCE_ZONE_RESTRICTED);
+}
+
+static void edge_tests(void)
+{
+    static const int32_t square[][2] = { { 1000, 1000 }, { 1000, 2000 }, { 2000, 2000 }, { 2000, 1000 } };
+    // U形：底边1000~1600，两臂宽200，缺口底部在纬度3200
+    static const int32_t u_shape[][2] = {
+        { 3000, 1000 }, { 3000, 1600 }, { 3600, 1600 }, { 3600, 1400 },
+        { 3200, 1400 }, { 3200, 1200 }, { 3600, 1200 }, { 3600, 1000 },
+    };
+    static const int32_t triangle[][2] = { { 5000, 1000 }, { 5000, 1700 }, { 5700, 1000 } };
+    static const int32_t diamond[][2] = { { 7000, 1500 }, { 7500, 2000 }, { 8000, 1500 }, { 7500, 1000 } };
+    int16_t sq, u, tri, dia;
+    int32_t k;
+    uint32_t e0, l0;
+
+    GEOFENCE_Init();
+    GEOFENCE_Set_Event_Handler(on_event);
+    sq = add_zone(square, 4);
+    u = add_zone(u_shape, 8);
+    tri = add_zone(triangle, 3);
+    dia = add_zone(diamond, 4);
+    if (GEOFENCE_Build() != 0) {
+        printf("FAIL: edge-test index build\n");
+        failures++;
+        return;
+    }
+
+#define P(lat, lon) SITE_LAT + (lat), SITE_LON + (lon)
+    // 正方形：顶点、边中点、两侧1个单位
+    expect_point("square vertex", sq, P(1000, 1000), true);
+    expect_point("square vertex", sq, P(2000, 2000), true);
+    expect_point("square vertex", sq, P(1000, 2000), true);
+    expect_point("square vertex", sq, P(2000, 1000), true);
+    expect_point("square bottom edge", sq, P(1000, 1500), true);
+    expect_point("square top edge", sq, P(2000, 1500), true);
+    expect_point("square left edge", sq, P(1500, 1000), true);
+    expect_point("square right edge", sq, P(1500, 2000), true);
+    expect_point("below square", sq, P(999, 1500), false);
+    expect_point("above square", sq, P(2001, 1500), false);
+    expect_point("left of square", sq, P(1500, 999), false);
+    expect_point("right of square", sq, P(1500, 2001), false);
+    expect_point("inside bottom edge", sq, P(1001, 1500), true);
+    expect_point("inside right edge", sq, P(1500, 1999), true);
+    expect_point("outside corner", sq, P(999, 999), false);
+
+    // U形：缺口内、缺口边、射线经过缺口底部两个顶点
+    expect_point("U notch", u, P(3400, 1300), false);
+    expect_point("U notch bottom edge", u, P(3200, 1300), true);
+    expect_point("U notch side edge", u, P(3400, 1200), true);
+    expect_point("U left arm", u, P(3400, 1100), true);
+    expect_point("U right arm", u, P(3400, 1500), true);
+    expect_point("U ray through notch vertices", u, P(3200, 1100), true);
+    expect_point("left of U on notch row", u, P(3200, 900), false);
+    expect_point("U ray through arm tips", u, P(3600, 1300), false);
+    expect_point("U base", u, P(3100, 1300), true);
+
+    // 三角形斜边（纬度+经度=6700）上的整点与两侧
+    for (k = 0; k <= 700; k += 70) {
+        expect_point("triangle hypotenuse", tri, P(5000 + k, 1700 - k), true);
+        if (k > 0 && k < 700) {
+            expect_point("inside hypotenuse", tri, P(5000 + k, 1699 - k), true);
+            expect_point("outside hypotenuse", tri, P(5000 + k, 1701 - k), false);
+        }
+    }
+
+    // 菱形：水平射线穿过左右顶点
+    expect_point("diamond centre row", dia, P(7500, 1500), true);
+    expect_point("diamond left vertex", dia, P(7500, 1000), true);
+    expect_point("left of diamond on vertex row", dia, P(7500, 999), false);
+    expect_point("right of diamond on vertex row", dia, P(7500, 2001), false);
+    expect_point("diamond top vertex", dia, P(8000, 1500), true);
+    expect_point("above diamond", dia, P(8001, 1500), false);
+    expect_point("diamond edge", dia, P(7250, 1250), true);
+    expect_point("outside diamond edge", dia, P(7250, 1249), false);
+
+    // 网格：最大坐标（含端点）落在最后一格，格线上的点与逐区域判断一致
+    expect_point("grid max corner", dia, P(7500, 2000), true);
+    expect_point("grid max lat", dia, P(8000, 1500), true);
+    for (k = 1; k < GEOFENCE_GRID_DIM; k++) {
+        int32_t lat = (int32_t)(geofence_grid_min_lat + geofence_grid_span_lat * k / GEOFENCE_GRID_DIM);
+        int32_t lon = SITE_LON + 1500;
+        uint16_t z;
+
+        update(lat, lon);
+        for (z = 0; z < geofence_zone_count; z++) {
+            if (GEOFENCE_Is_Inside(z) != GEOFENCE_Zone_Contains(z, lat, lon)) {
+                printf("FAIL: grid line %ld zone %u\n", (long)k, (unsigned)z);
+                failures++;
+            }
+        }
+    }
+
+    // 事件：进入、区域内移动、走到边上、离开
+    update(P(0, 0));
+    e0 = enter_events;
+    l0 = leave_events;
+    update(P(1500, 1500));
+    update(P(1600, 1500));
+    update(P(2000, 1500));
+    update(P(2100, 1500));
+    if (enter_events - e0 != 1 || leave_events - l0 != 1) {
+        printf("FAIL: walk through square: %u enter / %u leave events, want 1 / 1\n",
+               (unsigned)(enter_events - e0), (unsigned)(leave_events - l0));
+        failures++;
+    }
+#undef P
+}
+
+/* ==================== 耗时 ==================== */
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void build_site(uint32_t zones)
+{
+    uint32_t z;
+
+    GEOFENCE_Init();
+    GEOFENCE_Set_Event_Handler(on_event);
+    for (z = 0; z < zones; z++) {
+        GEOFENCE_Point_t v[8];
+        uint16_t n = (uint16_t)(4U + rng() % 5U);
+        int32_t radius = (int32_t)((10U + rng() % 31U) * METER_E7);
+        int32_t clat = SITE_LAT + radius + (int32_t)(rng() % (uint32_t)(SITE_SPAN - 2 * radius));
+        int32_t clon = SITE_LON + radius + (int32_t)(rng() % (uint32_t)(SITE_SPAN - 2 * radius));
+        uint16_t i;
+
+        // 星形：角度均分，半径在50%~100%之间随机（可能为凹多边形）
+        for (i = 0; i < n; i++) {
+            double a = 2.0 * 3.14159265358979 * i / n;
+            double r = radius * (0.5 + (rng() % 1000U) / 2000.0);
+
+            v[i].lat_e7 = clat + (int32_t)(r * sin(a));
+            v[i].lon_e7 = clon + (int32_t)(r * cos(a));
+        }
+        if (GEOFENCE_Add_Zone(v, n, (GEOFENCE_Zone_Type_t)(z & 1U)) < 0) {
+            printf("FAIL: zone %u rejected\n", (unsigned)z);
+            failures++;
+        }
+    }
+    if (GEOFENCE_Build() != 0) {
+        printf("FAIL: index build with %u zones\n", (unsigned)zones);
+        failures++;
+    }
+}
+
+static volatile uint32_t sink;
+
+static void bench(uint32_t zones, uint32_t fixes)
+{
+    static int32_t lat[1000000];
+    static int32_t lon[1000000];
+    double t0, ns[3];
+    uint32_t i, z;
+    uint32_t mismatches = 0;
+    uint32_t inside = 0;
+    GEOFENCE_Stats_t st;
+
+    build_site(zones);
+
+    if (fixes > sizeof(lat) / sizeof(lat[0])) {
+        fixes = sizeof(lat) / sizeof(lat[0]);
+    }
+    for (i = 0; i < fixes; i++) {
+        lat[i] = SITE_LAT - SITE_SPAN / 10 + (int32_t)(rng() % (uint32_t)(SITE_SPAN * 12 / 10));
+        lon[i] = SITE_LON - SITE_SPAN / 10 + (int32_t)(rng() % (uint32_t)(SITE_SPAN * 12 / 10));
+    }
+
+    t0 = now_ns();
+    for (i = 0; i < fixes; i++) {
+        for (z = 0; z < zones; z++) {
+            sink += GEOFENCE_Polygon_Contains(&geofence_zones[z], lat[i], lon[i]);
+        }
+    }
+    ns[0] = (now_ns() - t0) / fixes;
+
+    t0 = now_ns();
+    for (i = 0; i < fixes; i++) {
+        for (z = 0; z < zones; z++) {
+            sink += GEOFENCE_Zone_Contains((uint16_t)z, lat[i], lon[i]);
+        }
+    }
+    ns[1] = (now_ns() - t0) / fixes;
+
+    memset(&geofence_stats, 0, sizeof(geofence_stats));
+    t0 = now_ns();
+    for (i = 0; i < fixes; i++) {
+        update(lat[i], lon[i]);
+    }
+    ns[2] = (now_ns() - t0) / fixes;
+    st = geofence_stats;
+
+    // 逐点对照：网格路径的所在区域集合与逐区域射线法一致
+    for (i = 0; i < fixes; i++) {
+        uint8_t count = 0;
+
+        update(lat[i], lon[i]);
+        for (z = 0; z < zones; z++) {
+            bool want = GEOFENCE_Polygon_Contains(&geofence_zones[z], lat[i], lon[i]);
+
+            count += want;
+            if (want != GEOFENCE_Is_Inside((uint16_t)z)) {
+                mismatches++;
+            }
+        }
+        inside += count != 0;
+    }
+
+    printf("%5u  %9u  %10.1f %10.1f %10.1f   %8.2f %8.2f   %5.2f%%\n",
+           (unsigned)zones, (unsigned)(geofence_cell_start[GEOFENCE_GRID_DIM * GEOFENCE_GRID_DIM]),
+           ns[0], ns[1], ns[2], (double)st.candidates / st.updates, (double)st.polygon_tests / st.updates,
+           100.0 * inside / fixes);
+
+    if (mismatches != 0) {
+        printf("FAIL: %u zones: %u zone/fix results differ from the per-zone test\n",
+               (unsigned)zones, (unsigned)mismatches);
+        failures++;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t fixes = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : 200000U;
+    static const uint32_t zone_counts[] = { 10, 100, 1000 };
+    uint32_t i;
+
+    edge_tests();
+    printf("edge tests: %s\n", failures ? "FAILED" : "passed");
+
+    printf("%u random fixes over a %ld m site (+10%% margin), %ux%u grid\n",
+           (unsigned)fixes, SITE_SPAN / METER_E7, (unsigned)GEOFENCE_GRID_DIM, (unsigned)GEOFENCE_GRID_DIM);
+    printf("zones  grid refs    naive ns    bbox ns    grid ns   cand/fix  poly/fix  in zone\n");
+    for (i = 0; i < sizeof(zone_counts) / sizeof(zone_counts[0]); i++) {
+        bench(zone_counts[i], fixes);
+    }
+
+    (void)sink;
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
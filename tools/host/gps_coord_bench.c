@@ -0,0 +1,327 @@
+/**
+  ******************************************************************************
+  * @file           : gps_coord_bench.c
+  * @brief          : GPS坐标float与1e-7度定点换算的精度和耗时对比（主机测试）
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-20
+  ******************************************************************************
+  * @attention
+  *
+  * 直接包含固件atgm336h.c。语料为各经纬度区间的真实地点坐标（NMEA
+  * ddmm.mmmmm格式，含南纬/西经、赤道与本初子午线附近、经度接近180度），
+  * 每个地点以1e-5分（约1.9cm）为步长向两侧各展开1000个点，模拟在该处
+  * 行走记录的定位。参考值由整数分数字以long double直接计算。对比：
+  * - atof+float：原固件做法，atof得到dddmm.mmmm的float后GPS_NMEA_To_Decimal；
+  * - field+float：解析器字段NMEA_Field_To_Float后GPS_NMEA_To_Decimal；
+  * - e7：GPS_NMEA_To_E7（整数运算），另列出由e7得到的float度数
+  *   （GPS_Data_t中为兼容保留的latitude/longitude）。
+  * 精度按纬度111320m/度、经度再乘cos(纬度)换算为米，报告最大和均方根误差；
+  * 耗时为主机上每个坐标的纳秒数（语句逐字节解析对各方法相同，不计入；
+  * atof一栏包含字符串扫描）。
+  *
+  * 编译运行（仓库根目录）：
+  *   gcc -O2 -Itools/host -IAPP tools/host/gps_coord_bench.c tools/host/hal_stub.c \
+  *       APP/scheduler.c APP/nmea.c -lm -o gps_coord_bench
+  *   ./gps_coord_bench [重复轮数]
+  *
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+
+// 固件打印与本测试无关，包含期间静默
+#define printf(...) ((void)0)
+#include "atgm336h.c"
+#undef printf
+#include <math.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define SPREAD          1000    // 每个地点向两侧展开的点数
+#define METERS_PER_DEG  111320.0
+
+typedef struct {
+    const char *name;
+    const char *lat;        // ddmm.mmmmm
+    const char *lon;        // dddmm.mmmmm
+} Place_t;
+
+// 南纬/西经只影响符号，换算误差只与数字有关，这里只记数字
+static const Place_t places[] = {
+    { "Beijing",      "3954.54000", "11623.76000" },
+    { "Shanghai",     "3114.41000", "12129.75000" },
+    { "Shenzhen",     "2232.63000", "11403.58000" },
+    { "Chengdu",      "3039.5900",  "10403.9800"  },
+    { "Urumqi",       "4349.53000", "08736.98000" },
+    { "Harbin",       "4545.28000", "12638.59000" },
+    { "Lhasa",        "2939.19000", "09107.18000" },
+    { "Hong Kong",    "2216.96000", "11409.53000" },
+    { "Singapore",    "0117.40000", "10351.18000" },
+    { "Quito",        "0013.15000", "07830.75000" },
+    { "Greenwich",    "5128.67200", "00000.12340" },
+    { "London",       "5130.04400", "00007.68300" },
+    { "New York",     "4041.32800", "07402.73000" },
+    { "Sao Paulo",    "2333.06000", "04638.09000" },
+    { "Cape Town",    "3355.44000", "01825.40000" },
+    { "Reykjavik",    "6408.82000", "02156.58000" },
+    { "Anchorage",    "6113.11000", "14954.06000" },
+    { "Sydney",       "3351.42800", "15112.93000" },
+    { "Auckland",     "3650.91000", "17445.85000" },
+    { "Taveuni",      "1648.50000", "17959.95000" },
+};
+
+#define PLACE_COUNT (sizeof(places) / sizeof(places[0]))
+#define COORD_COUNT (PLACE_COUNT * (2 * SPREAD + 1) * 2)
+
+typedef struct {
+    const char *place;      // 所属地点
+    char text[16];          // NMEA字段文本
+    NMEA_Field_t field;     // 解析器给出的字段
+    long double exact;      // 参考度数（不含符号）
+    double m_per_deg;       // 该坐标方向上每度的米数
+} Coord_t;
+
+static Coord_t coords[COORD_COUNT];
+
+DR_State_t dr_state;
+DR_Output_t dr_output;
+
+void GEOFENCE_Update(const GPS_Data_t *data) { (void)data; }
+void TRACK_Add_Fix(const GPS_Data_t *data) { (void)data; }
+void DR_Correct(DR_State_t *dr, const GPS_Data_t *gps) { (void)dr; (void)gps; }
+void DR_Get_Output(const DR_State_t *dr, DR_Output_t *out) { (void)dr; (void)out; }
+
+/**
+ * @brief 经真实解析器得到坐标字段：拼成GLL语句逐字节送入
+ */
+static void parse_fields(Coord_t *lat, Coord_t *lon)
+{
+    NMEA_Parser_t parser;
+    const NMEA_Sentence_t *s = NULL;
+    char body[96];
+    char line[128];
+    uint8_t cs = 0;
+    const char *p;
+
+    snprintf(body, sizeof(body), "GNGLL,%s,N,%s,E,083559.00,A,A", lat->text, lon->text);
+    for (p = body; *p; p++) {
+        cs ^= (uint8_t)*p;
+    }
+    snprintf(line, sizeof(line), "$%s*%02X\r\n", body, cs);
+
+    NMEA_Parser_Init(&parser);
+    for (p = line; *p && s == NULL; p++) {
+        s = NMEA_Parser_Feed(&parser, *p);
+    }
+    if (s == NULL) {
+        fprintf(stderr, "parser rejected %s\n", line);
+        exit(1);
+    }
+    lat->field = s->field[0];
+    lon->field = s->field[2];
+}
+
+/**
+ * @brief 由dddmm.mmmmm文本计算参考度数（整数分数字，long double）
+ */
+static long double exact_degrees(const char *text)
+{
+    const char *dot = strchr(text, '.');
+    long deg = strtol(text, NULL, 10) / 100;
+    long min_int = strtol(dot - 2, NULL, 10);
+    long frac = 0;
+    long scale = 1;
+    const char *p;
+
+    for (p = dot + 1; *p; p++) {
+        frac = frac * 10 + (*p - '0');
+        scale *= 10;
+    }
+    return deg + (min_int + (long double)frac / scale) / 60.0L;
+}
+
+/**
+ * @brief 以地点为中心按1e-5分展开，写出5位小数的坐标文本
+ */
+static void format_offset(char *out, const char *center, int width, long offset)
+{
+    const char *dot = strchr(center, '.');
+    long whole = strtol(center, NULL, 10);
+    long frac = 0;
+    int digits = 0;
+    const char *p;
+    long v;
+
+    for (p = dot + 1; *p; p++, digits++) {
+        frac = frac * 10 + (*p - '0');
+    }
+    while (digits < 5) {
+        frac *= 10;
+        digits++;
+    }
+    v = whole * 100000L + frac + offset;
+    if (v < 0) {
+        v = -v;     // 本初子午线附近越过0分时镜像到另一侧
+    }
+    snprintf(out, 16, "%0*u.%05u", width, (unsigned)(v / 100000L % 100000L), (unsigned)(v % 100000L));
+}
+
+static void build_corpus(void)
+{
+    uint32_t n = 0;
+    uint32_t i;
+    long k;
+
+    for (i = 0; i < PLACE_COUNT; i++) {
+        for (k = -SPREAD; k <= SPREAD; k++) {
+            Coord_t *lat = &coords[n++];
+            Coord_t *lon = &coords[n++];
+
+            if (k == 0) {
+                // 地点本身保持原文本（部分为4位小数）
+                snprintf(lat->text, sizeof(lat->text), "%s", places[i].lat);
+                snprintf(lon->text, sizeof(lon->text), "%s", places[i].lon);
+            } else {
+                format_offset(lat->text, places[i].lat, 4, k);
+                format_offset(lon->text, places[i].lon, 5, k);
+            }
+            lat->place = lon->place = places[i].name;
+            parse_fields(lat, lon);
+            lat->exact = exact_degrees(lat->text);
+            lon->exact = exact_degrees(lon->text);
+            lat->m_per_deg = METERS_PER_DEG;
+            lon->m_per_deg = METERS_PER_DEG * cos((double)lat->exact * M_PI / 180.0);
+        }
+    }
+}
+
+/* ==================== 精度 ==================== */
+
+typedef struct {
+    double max_m;
+    double sum_sq;
+    const Coord_t *worst;
+} Error_t;
+
+static void account(Error_t *e, const Coord_t *c, long double value)
+{
+    double m = (double)fabsl(value - c->exact) * c->m_per_deg;
+
+    if (m > e->max_m) {
+        e->max_m = m;
+        e->worst = c;
+    }
+    e->sum_sq += m * m;
+}
+
+static void report_error(const char *name, const Error_t *e)
+{
+    printf("  %-14s  max %9.4f m  rms %9.4f m   worst %s %s\n",
+           name, e->max_m, sqrt(e->sum_sq / COORD_COUNT), e->worst->place, e->worst->text);
+}
+
+/* ==================== 耗时 ==================== */
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static volatile float float_sink;
+static volatile int32_t int_sink;
+
+static double time_atof(uint32_t rounds)
+{
+    double t0 = now_ns();
+    uint32_t r, i;
+
+    for (r = 0; r < rounds; r++) {
+        for (i = 0; i < COORD_COUNT; i++) {
+            float_sink = GPS_NMEA_To_Decimal((float)atof(coords[i].text));
+        }
+    }
+    return (now_ns() - t0) / ((double)rounds * COORD_COUNT);
+}
+
+static double time_field_float(uint32_t rounds)
+{
+    double t0 = now_ns();
+    uint32_t r, i;
+
+    for (r = 0; r < rounds; r++) {
+        for (i = 0; i < COORD_COUNT; i++) {
+            float_sink = GPS_NMEA_To_Decimal(NMEA_Field_To_Float(&coords[i].field));
+        }
+    }
+    return (now_ns() - t0) / ((double)rounds * COORD_COUNT);
+}
+
+static double time_e7(uint32_t rounds)
+{
+    double t0 = now_ns();
+    uint32_t r, i;
+
+    for (r = 0; r < rounds; r++) {
+        for (i = 0; i < COORD_COUNT; i++) {
+            int_sink = GPS_NMEA_To_E7(&coords[i].field);
+        }
+    }
+    return (now_ns() - t0) / ((double)rounds * COORD_COUNT);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t rounds = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : 50U;
+    Error_t err_atof = {0}, err_field = {0}, err_e7 = {0}, err_e7_float = {0};
+    double best[3] = { 1e30, 1e30, 1e30 };
+    uint32_t failures = 0;
+    uint32_t i, k;
+
+    build_corpus();
+
+    for (i = 0; i < COORD_COUNT; i++) {
+        const Coord_t *c = &coords[i];
+        int32_t e7 = GPS_NMEA_To_E7(&c->field);
+
+        account(&err_atof, c, GPS_NMEA_To_Decimal((float)atof(c->text)));
+        account(&err_field, c, GPS_NMEA_To_Decimal(NMEA_Field_To_Float(&c->field)));
+        account(&err_e7, c, (long double)e7 / GPS_E7_SCALE);
+        account(&err_e7_float, c, (float)e7 / (float)GPS_E7_SCALE);
+
+        // 定点值与参考值之差不超过半个1e-7度
+        if (fabsl((long double)e7 - c->exact * GPS_E7_SCALE) > 0.5L) {
+            printf("FAIL: %s -> %ld, want %.2Lf\n", c->text, (long)e7, c->exact * GPS_E7_SCALE);
+            failures++;
+        }
+    }
+
+    // 交替运行取最小值，减少主机调度噪声
+    for (k = 0; k < 5; k++) {
+        double t;
+
+        t = time_atof(rounds);
+        if (t < best[0]) best[0] = t;
+        t = time_field_float(rounds);
+        if (t < best[1]) best[1] = t;
+        t = time_e7(rounds);
+        if (t < best[2]) best[2] = t;
+    }
+
+    printf("%u places x %u fixes, %u coordinates\n",
+           (unsigned)PLACE_COUNT, (unsigned)(2 * SPREAD + 1), (unsigned)COORD_COUNT);
+    printf("error against exact degrees:\n");
+    report_error("atof+float", &err_atof);
+    report_error("field+float", &err_field);
+    report_error("e7", &err_e7);
+    report_error("e7 -> float", &err_e7_float);
+    printf("host cost per coordinate (best of 5 x %u rounds):\n", (unsigned)rounds);
+    printf("  %-14s  %6.2f ns\n", "atof+float", best[0]);
+    printf("  %-14s  %6.2f ns\n", "field+float", best[1]);
+    printf("  %-14s  %6.2f ns\n", "e7", best[2]);
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,250 @@
+/**
+  ******************************************************************************
+  * @file           : gps_dispatch_bench.c
+  * @brief          : NMEA语句查表分发与原strstr/strtok解析的每语句耗时对比（主机测试）
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-20
+  ******************************************************************************
+  * @attention
+  *
+  * 直接包含固件atgm336h.c。语句为ATGM336H 1Hz一组（GGA/GSA/GSV/RMC/VTG/ZDA，
+  * 含$GP/$BD发送方）以及两条不支持的语句（GLL/TXT，查表落空的最坏情况）。
+  * 每种语句分别计时：
+  * - legacy：原固件做法，复制到缓冲区后strstr依次匹配"$GNRMC"/"$GNGGA"，
+  *   命中则strtok切分、atof换算（不校验校验和，只认$GN发送方）；
+  * - parse：GPS_Parse_NMEA，逐字节状态机（含校验）+ 查表分发 + 解析函数；
+  * - dispatch：对已解析的语句只调用GPS_Dispatch_Sentence（查表 + 解析函数）。
+  * 报告主机上每语句纳秒数与两种做法各自处理的语句数。
+  *
+  * 编译运行（仓库根目录）：
+  *   gcc -O2 -Itools/host -IAPP tools/host/gps_dispatch_bench.c tools/host/hal_stub.c \
+  *       APP/scheduler.c APP/nmea.c -lm -o gps_dispatch_bench
+  *   ./gps_dispatch_bench [重复轮数]
+  *
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+
+// 固件打印与本测试无关，包含期间静默
+#define printf(...) ((void)0)
+#include "atgm336h.c"
+#undef printf
+#include <stdlib.h>
+#include <time.h>
+
+static const char *const bench_bodies[] = {
+    "GNGGA,083559.00,3954.52200,N,11623.46150,E,1,08,1.01,499.6,M,48.0,M,,",
+    "GNGSA,A,3,10,07,05,02,29,04,08,13,,,,,1.72,1.03,1.38,1",
+    "GPGSV,3,1,11,10,63,137,17,07,61,098,15,05,59,290,20,08,54,157,30",
+    "GPGSV,3,2,11,02,39,223,19,13,28,070,17,26,23,252,,04,14,186,14",
+    "BDGSV,2,1,06,01,45,125,33,03,51,199,35,06,60,216,31,08,64,002,29",
+    "GNRMC,083559.00,A,3954.52200,N,11623.46150,E,0.004,77.52,091202,,,A",
+    "GPRMC,083559.00,A,3954.52200,N,11623.46150,E,0.004,77.52,091202,,,A",
+    "GNVTG,77.52,T,,M,0.004,N,0.008,K,A",
+    "GNZDA,083559.00,09,12,2002,00,00",
+    "GNGLL,3954.52200,N,11623.46150,E,083559.00,A,A",
+    "GPTXT,01,01,01,ANTENNA OK",
+};
+
+#define BENCH_COUNT (sizeof(bench_bodies) / sizeof(bench_bodies[0]))
+
+static char sentences[BENCH_COUNT][GPS_SENTENCE_MAX_LEN];
+static NMEA_Sentence_t parsed[BENCH_COUNT];
+static GPS_Data_t data;
+
+DR_State_t dr_state;
+DR_Output_t dr_output;
+
+void GEOFENCE_Update(const GPS_Data_t *d) { (void)d; }
+void TRACK_Add_Fix(const GPS_Data_t *d) { (void)d; }
+void DR_Correct(DR_State_t *dr, const GPS_Data_t *gps) { (void)dr; (void)gps; }
+void DR_Get_Output(const DR_State_t *dr, DR_Output_t *out) { (void)dr; (void)out; }
+
+/* ==================== 原解析方式 ==================== */
+
+static uint8_t legacy_rmc(char *sentence, GPS_Data_t *d)
+{
+    char *token = strtok(sentence, ",");
+    int field = 0;
+
+    while (token != NULL) {
+        switch (field) {
+            case 1:
+                if (strlen(token) >= 6) {
+                    d->hour = (uint8_t)((token[0] - '0') * 10 + (token[1] - '0'));
+                    d->minute = (uint8_t)((token[2] - '0') * 10 + (token[3] - '0'));
+                    d->second = (uint8_t)((token[4] - '0') * 10 + (token[5] - '0'));
+                }
+                break;
+            case 2:
+                d->fix_status = token[0];
+                d->fix_valid = (token[0] == 'A');
+                break;
+            case 3:
+                d->latitude = GPS_NMEA_To_Decimal((float)atof(token));
+                break;
+            case 4:
+                d->lat_dir = token[0];
+                break;
+            case 5:
+                d->longitude = GPS_NMEA_To_Decimal((float)atof(token));
+                break;
+            case 6:
+                d->lon_dir = token[0];
+                break;
+        }
+        token = strtok(NULL, ",");
+        field++;
+    }
+    return 0;
+}
+
+static uint8_t legacy_gga(char *sentence, GPS_Data_t *d)
+{
+    char *token = strtok(sentence, ",");
+    int field = 0;
+
+    while (token != NULL) {
+        switch (field) {
+            case 7:
+                d->satellites = (uint8_t)atoi(token);
+                break;
+            case 8:
+                d->hdop = (float)atof(token);
+                break;
+            case 9:
+                d->altitude = (float)atof(token);
+                break;
+        }
+        token = strtok(NULL, ",");
+        field++;
+    }
+    return 0;
+}
+
+static uint8_t legacy_parse(const char *sentence, GPS_Data_t *d)
+{
+    char buf[GPS_SENTENCE_MAX_LEN];
+
+    // strtok改写缓冲区，原固件在语句缓冲区上就地切分；这里先复制以便重复运行
+    memcpy(buf, sentence, sizeof(buf));
+    if (strstr(buf, "$GNRMC") != NULL) {
+        return legacy_rmc(buf, d);
+    } else if (strstr(buf, "$GNGGA") != NULL) {
+        return legacy_gga(buf, d);
+    }
+    return 1;
+}
+
+/* ==================== 计时 ==================== */
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static volatile uint32_t sink;
+
+/**
+ * @brief 对一条语句计时
+ * @param method: 0: legacy, 1: parse, 2: dispatch
+ * @retval 每次纳秒数
+ */
+static double time_one(uint32_t i, int method, uint32_t rounds)
+{
+    double t0 = now_ns();
+    uint32_t r;
+
+    for (r = 0; r < rounds; r++) {
+        switch (method) {
+            case 0:
+                sink += legacy_parse(sentences[i], &data);
+                break;
+            case 1:
+                sink += GPS_Parse_NMEA(sentences[i], &data);
+                break;
+            default:
+                sink += GPS_Dispatch_Sentence(&parsed[i], &data);
+                break;
+        }
+    }
+    return (now_ns() - t0) / rounds;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t rounds = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : 100000U;
+    double total[3] = { 0, 0, 0 };
+    uint32_t handled[2] = { 0, 0 };
+    uint32_t failures = 0;
+    uint32_t i, k;
+    int m;
+
+    NMEA_Parser_Init(&gps_parser);
+    for (i = 0; i < BENCH_COUNT; i++) {
+        const char *b = bench_bodies[i];
+        const char *p;
+        const NMEA_Sentence_t *s = NULL;
+        uint8_t cs = 0;
+
+        for (p = b; *p; p++) {
+            cs ^= (uint8_t)*p;
+        }
+        snprintf(sentences[i], sizeof(sentences[i]), "$%s*%02X\r\n", b, cs);
+        for (p = sentences[i]; *p && s == NULL; p++) {
+            s = NMEA_Parser_Feed(&gps_parser, *p);
+        }
+        if (s == NULL) {
+            printf("FAIL: parser rejected %s", sentences[i]);
+            return 1;
+        }
+        parsed[i] = *s;
+    }
+
+    printf("%u rounds per sentence, best of 5\n", (unsigned)rounds);
+    printf("sentence  legacy ns  handled   parse ns  dispatch ns  handled\n");
+
+    for (i = 0; i < BENCH_COUNT; i++) {
+        double best[3] = { 1e30, 1e30, 1e30 };
+        uint8_t ok[2];
+
+        // 交替运行取最小值，减少主机调度噪声
+        for (k = 0; k < 5; k++) {
+            for (m = 0; m < 3; m++) {
+                double ns = time_one(i, m, rounds);
+
+                if (ns < best[m]) {
+                    best[m] = ns;
+                }
+            }
+        }
+        ok[0] = legacy_parse(sentences[i], &data) == 0;
+        ok[1] = GPS_Parse_NMEA(sentences[i], &data) == 0;
+        handled[0] += ok[0];
+        handled[1] += ok[1];
+        for (m = 0; m < 3; m++) {
+            total[m] += best[m];
+        }
+
+        printf("%.5s    %9.1f  %7s   %8.1f  %11.1f  %7s\n",
+               bench_bodies[i], best[0], ok[0] ? "yes" : "-", best[1], best[2], ok[1] ? "yes" : "-");
+    }
+
+    printf("mean      %9.1f  %4u/%-2u   %8.1f  %11.1f  %4u/%u\n",
+           total[0] / BENCH_COUNT, (unsigned)handled[0], (unsigned)BENCH_COUNT,
+           total[1] / BENCH_COUNT, total[2] / BENCH_COUNT, (unsigned)handled[1], (unsigned)BENCH_COUNT);
+
+    // 表中9条应全部由新分发处理，GLL/TXT两条落空
+    if (handled[1] != BENCH_COUNT - 2U || gps_parser.checksum_errors != 0) {
+        printf("FAIL: %u sentences handled, %u checksum errors\n",
+               (unsigned)handled[1], (unsigned)gps_parser.checksum_errors);
+        failures++;
+    }
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,367 @@
+/**
+  ******************************************************************************
+  * @file           : gps_dma_replay.c
+  * @brief          : NMEA数据流经循环DMA接收的回放测试（主机测试）
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-20
+  ******************************************************************************
+  * @attention
+  *
+  * 直接包含固件atgm336h.c，与固件scheduler.c、nmea.c和uart_rx_sim串口
+  * 循环DMA模型一起运行，把一段NMEA数据流按定位周期分组回放到USART2：
+  * - 默认数据按ATGM336H输出格式逐组生成（GGA/GSA/GSV/RMC/VTG/ZDA，时间和
+  *   坐标逐组递增，约1.3m/s步行），每次GEOFENCE_Update核对定点坐标与本组
+  *   RMC一致（误差不超过1e-7度）；
+  * - 给出文件参数时回放记录的NMEA日志（每行一句，遇到GGA开始新的一组，
+  *   每秒一组），只核对语句数。
+  * 主循环为scheduler_run + scheduler_idle，另有100ms周期、每次阻塞30ms的任务。
+  * 报告DMA半满/全满/空闲中断次数（逐字节中断接收为每字节一次）、丢失字节
+  * （DMA未运行时到达的字节 + 错误重启时缓冲区中未处理的字节）与语句统计。
+  * ore一行每隔ERROR_EVERY字节注入一次USART错误中断（GPS_UART_ErrorCallback
+  * 停止并重新启动DMA），检查错误之后的语句不被拼接（无校验失败）。
+  *
+  * 编译运行（仓库根目录）：
+  *   gcc -O2 -Itools/host -IAPP tools/host/gps_dma_replay.c tools/host/uart_rx_sim.c \
+  *       tools/host/hal_stub.c APP/scheduler.c APP/nmea.c -lm -o gps_dma_replay
+  *   ./gps_dma_replay [NMEA日志文件]
+  *
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+
+// 固件的每次定位打印与本测试无关，包含期间静默
+#define printf(...) ((void)0)
+#include "atgm336h.c"
+#undef printf
+#include "uart_rx_sim.h"
+#include <math.h>
+#include <stdlib.h>
+
+#define SIM_SECONDS     60U
+#define MAX_EPOCHS      (SIM_SECONDS * 10U)
+#define EPOCH_DELAY_MS  50U     // 定位时刻到第一句开始发送
+#define BUSY_PERIOD_MS  100U
+#define BUSY_BLOCK_MS   30U
+#define ERROR_EVERY     6007U   // ore：每隔多少字节注入一次错误（素数，落在语句内各处）
+
+static char stream[MAX_EPOCHS * 1024U];
+static uint32_t stream_len;
+static uint32_t epoch_off[MAX_EPOCHS + 1U];
+static uint32_t epoch_count;
+static uint32_t stream_sentences;   // 校验和正确的语句数
+static uint32_t stream_bad;         // 日志中校验和错误的语句数
+static int32_t expect_lat[MAX_EPOCHS];
+static int32_t expect_lon[MAX_EPOCHS];
+static int from_file;
+
+static uint32_t fence_calls;
+static uint32_t fence_epoch;         // 下一个期望的组
+static uint32_t position_errors;
+static uint32_t inject_errors;
+
+DR_State_t dr_state;
+DR_Output_t dr_output;
+
+void GEOFENCE_Update(const GPS_Data_t *data)
+{
+    uint32_t i;
+
+    fence_calls++;
+    if (from_file) {
+        return;
+    }
+    // 定位按组的顺序到达，错误可能跳过若干组：从上次匹配处向后查找
+    i = fence_epoch;
+    while (i < epoch_count && (expect_lat[i] != data->lat_e7 || expect_lon[i] != data->lon_e7)) {
+        i++;
+    }
+    if (i == epoch_count) {
+        position_errors++;
+    } else {
+        fence_epoch = i + 1U;
+    }
+}
+
+void TRACK_Add_Fix(const GPS_Data_t *data)
+{
+    (void)data;
+}
+
+void DR_Correct(DR_State_t *dr, const GPS_Data_t *gps)
+{
+    dr->fix_seq = gps->fix_seq;
+}
+
+void DR_Get_Output(const DR_State_t *dr, DR_Output_t *out)
+{
+    (void)dr;
+    (void)out;
+}
+
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
+{
+    GPS_UART_RxEventCallback(huart, Size);
+}
+
+static void error_isr(void)
+{
+    GPS_UART_ErrorCallback(&huart2);
+}
+
+static void on_byte(uint32_t index, uint8_t byte, uint64_t t)
+{
+    (void)byte;
+    (void)t;
+    if (inject_errors && index % ERROR_EVERY == ERROR_EVERY - 1U) {
+        host_raise_irq(error_isr);
+    }
+}
+
+static void busy_task(void)
+{
+    HAL_Delay(BUSY_BLOCK_MS);
+}
+
+/* ==================== 数据流 ==================== */
+
+static uint8_t checksum(const char *p, uint32_t n)
+{
+    uint8_t cs = 0;
+
+    while (n--) {
+        cs ^= (uint8_t)*p++;
+    }
+    return cs;
+}
+
+static void append(const char *body)
+{
+    stream_len += (uint32_t)snprintf(stream + stream_len, sizeof(stream) - stream_len, "$%s*%02X\r\n",
+                                     body, checksum(body, (uint32_t)strlen(body)));
+    stream_sentences++;
+}
+
+/**
+ * @brief 分(1e-5)换算为1e-7度，用double独立计算作为期望值
+ */
+static int32_t expect_e7(uint32_t deg, uint32_t minutes_e5)
+{
+    return (int32_t)lround((deg + minutes_e5 / 1e5 / 60.0) * 1e7);
+}
+
+static void generate(uint32_t rate)
+{
+    static const char *const fixed[] = {
+        "GNGSA,A,3,10,07,05,02,29,04,08,13,,,,,1.72,1.03,1.38,1",
+        "GNGSA,A,3,01,03,06,08,,,,,,,,,1.72,1.03,1.38,4",
+        "GPGSV,3,1,11,10,63,137,17,07,61,098,15,05,59,290,20,08,54,157,30",
+        "GPGSV,3,2,11,02,39,223,19,13,28,070,17,26,23,252,,04,14,186,14",
+        "GPGSV,3,3,11,29,09,301,24,16,09,020,,36,,,",
+        "BDGSV,2,1,06,01,45,125,33,03,51,199,35,06,60,216,31,08,64,002,29",
+        "BDGSV,2,2,06,13,22,310,27,16,35,080,30",
+    };
+    char body[128];
+    char hms[16];
+    char lat[16];
+    char lon[16];
+    uint32_t k, i;
+
+    stream_len = 0;
+    stream_sentences = 0;
+    epoch_count = SIM_SECONDS * rate;
+
+    for (k = 0; k < epoch_count; k++) {
+        uint32_t cs = k * (100U / rate);                // 百分之一秒
+        uint32_t lat_m5 = 5452200U + k * 7U * 10U / rate;   // 约1.3m/s向北
+        uint32_t lon_m5 = 2346150U + k * 5U * 10U / rate;   // 约1.2m/s向东
+
+        epoch_off[k] = stream_len;
+        snprintf(hms, sizeof(hms), "08%02u%02u.%02u",
+                 (unsigned)(cs / 6000U % 60U), (unsigned)(cs / 100U % 60U), (unsigned)(cs % 100U));
+        snprintf(lat, sizeof(lat), "39%02u.%05u", (unsigned)(lat_m5 / 100000U), (unsigned)(lat_m5 % 100000U));
+        snprintf(lon, sizeof(lon), "116%02u.%05u", (unsigned)(lon_m5 / 100000U), (unsigned)(lon_m5 % 100000U));
+        expect_lat[k] = expect_e7(39, lat_m5);
+        expect_lon[k] = expect_e7(116, lon_m5);
+
+        snprintf(body, sizeof(body), "GNGGA,%s,%s,N,%s,E,1,08,1.01,499.6,M,48.0,M,,", hms, lat, lon);
+        append(body);
+        for (i = 0; i < sizeof(fixed) / sizeof(fixed[0]); i++) {
+            append(fixed[i]);
+        }
+        snprintf(body, sizeof(body), "GNRMC,%s,A,%s,N,%s,E,2.520,35.20,091202,,,A", hms, lat, lon);
+        append(body);
+        append("GNVTG,35.20,T,,M,2.520,N,4.667,K,A");
+        snprintf(body, sizeof(body), "GNZDA,%s,09,12,2002,00,00", hms);
+        append(body);
+    }
+    epoch_off[epoch_count] = stream_len;
+}
+
+/**
+ * @brief 读入NMEA日志；行尾统一为CRLF，遇到GGA开始新的一组
+ */
+static int load_file(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    char line[256];
+
+    if (f == NULL) {
+        printf("cannot open %s\n", path);
+        return 1;
+    }
+
+    stream_len = 0;
+    stream_sentences = 0;
+    stream_bad = 0;
+    epoch_count = 0;
+    while (fgets(line, sizeof(line), f) != NULL && epoch_count <= MAX_EPOCHS) {
+        char *star;
+        uint32_t n = (uint32_t)strcspn(line, "\r\n");
+
+        line[n] = '\0';
+        if (line[0] != '$' || n < 6U || stream_len + n + 2U > sizeof(stream)) {
+            continue;
+        }
+        if (strncmp(line + 3, "GGA", 3) == 0 || epoch_count == 0) {
+            if (epoch_count == MAX_EPOCHS) {
+                break;
+            }
+            epoch_off[epoch_count++] = stream_len;
+        }
+        star = strchr(line, '*');
+        if (star != NULL && strtoul(star + 1, NULL, 16) == checksum(line + 1, (uint32_t)(star - line - 1))) {
+            stream_sentences++;
+        } else {
+            stream_bad++;
+        }
+        stream_len += (uint32_t)snprintf(stream + stream_len, sizeof(stream) - stream_len, "%s\r\n", line);
+    }
+    fclose(f);
+    epoch_off[epoch_count] = stream_len;
+    return epoch_count == 0;
+}
+
+/* ==================== 回放 ==================== */
+
+static uint32_t run(const char *name, uint32_t baud, uint32_t rate, int errors)
+{
+    uint64_t t0, t;
+    uint32_t k;
+    uint32_t parsed0, cserr0;
+    uint32_t irqs, lost, lost_sentences;
+    double seconds;
+    uint32_t failures = 0;
+
+    if (!from_file) {
+        generate(rate);
+    }
+
+    host_init();
+    scheduler_init();
+    memset(&gps_data, 0, sizeof(gps_data));
+    gps_slot_head = gps_slot_tail = 0;
+    gps_assembling = false;
+    gps_task_fix_seq = 0;
+    gps_task_fix_status = 0;
+    memset(&gps_rx_stats, 0, sizeof(gps_rx_stats));
+    NMEA_Parser_Init(&gps_parser);
+
+    huart2.Init.BaudRate = baud;
+    UART_Rx_Sim_Init(&huart2, baud);
+    uart_rx_sim.on_byte = on_byte;
+    inject_errors = (uint32_t)errors;
+    GPS_UART_Start_DMA();
+
+    scheduler_add_event_task(gps_task);
+    scheduler_add_task(busy_task, BUSY_PERIOD_MS);
+
+    t0 = host_cycles();
+    for (k = 0; k < epoch_count; k++) {
+        UART_Rx_Sim_Send_At((const uint8_t *)stream + epoch_off[k], epoch_off[k + 1U] - epoch_off[k],
+                            t0 + (uint64_t)k * HOST_CPU_HZ / rate + (uint64_t)EPOCH_DELAY_MS * (HOST_CPU_HZ / 1000U));
+    }
+
+    fence_calls = 0;
+    fence_epoch = 0;
+    position_errors = 0;
+    parsed0 = gps_parser.sentence_count;
+    cserr0 = gps_parser.checksum_errors;
+
+    t = t0 + (uint64_t)(epoch_count / rate + 1U) * HOST_CPU_HZ;
+    while (host_cycles() < t || !UART_Rx_Sim_Done()) {
+        scheduler_run();
+        scheduler_idle();
+    }
+
+    seconds = (double)(host_cycles() - t0) / HOST_CPU_HZ;
+    irqs = uart_rx_sim.irq_ht + uart_rx_sim.irq_tc + uart_rx_sim.irq_idle;
+    lost = uart_rx_sim.lost + (uart_rx_sim.written - gps_rx_stats.bytes);
+    lost_sentences = stream_sentences - (gps_parser.sentence_count - parsed0);
+
+    printf("%-5s %6u %3u  %8u %6u %5u %5u %5u  %7.1f %7.1f  %5u  %6u %5u %3u  %6u %5u\n",
+           name, (unsigned)baud, (unsigned)rate, (unsigned)uart_rx_sim.bytes,
+           (unsigned)uart_rx_sim.irq_ht, (unsigned)uart_rx_sim.irq_tc, (unsigned)uart_rx_sim.irq_idle,
+           (unsigned)irqs, irqs / seconds, uart_rx_sim.bytes / seconds, (unsigned)lost,
+           (unsigned)gps_rx_stats.errors, (unsigned)lost_sentences,
+           (unsigned)(gps_parser.checksum_errors - cserr0),
+           (unsigned)fence_calls, (unsigned)gps_rx_stats.dropped_full);
+
+    // 出错重启只会丢句，不能把前后两段拼成一句（拼接句的校验和几乎必然不符）
+    if (gps_parser.checksum_errors - cserr0 > stream_bad ||
+        (!errors && gps_parser.checksum_errors - cserr0 != stream_bad) || position_errors != 0) {
+        printf("FAIL: %u checksum errors (%u in the log), %u fixes with wrong coordinates\n",
+               (unsigned)(gps_parser.checksum_errors - cserr0), (unsigned)stream_bad,
+               (unsigned)position_errors);
+        failures++;
+    }
+    if (uart_rx_sim.written != uart_rx_sim.bytes - uart_rx_sim.lost) {
+        printf("FAIL: DMA wrote %u of %u bytes\n", (unsigned)uart_rx_sim.written, (unsigned)uart_rx_sim.bytes);
+        failures++;
+    }
+    if (!errors && (lost != 0 || lost_sentences != 0 || (!from_file && fence_calls != epoch_count))) {
+        printf("FAIL: %u bytes / %u sentences lost, %u fixes of %u\n",
+               (unsigned)lost, (unsigned)lost_sentences, (unsigned)fence_calls, (unsigned)epoch_count);
+        failures++;
+    }
+    if (errors && !from_file && fence_calls + gps_rx_stats.errors < epoch_count) {
+        printf("FAIL: %u fixes of %u with %u errors (at most one fix lost per error)\n",
+               (unsigned)fence_calls, (unsigned)epoch_count, (unsigned)gps_rx_stats.errors);
+        failures++;
+    }
+    return failures;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t failures = 0;
+
+    if (argc > 1) {
+        from_file = 1;
+        if (load_file(argv[1]) != 0) {
+            return 1;
+        }
+        printf("%s: %u epochs, %u sentences, %u bytes, replayed at 1 Hz\n",
+               argv[1], (unsigned)epoch_count, (unsigned)stream_sentences, (unsigned)stream_len);
+    } else {
+        printf("generated stream, %u s, 11 sentences per epoch, DMA buffer %u, busy task %u ms every %u ms\n",
+               (unsigned)SIM_SECONDS, (unsigned)GPS_UART_BUFFER_SIZE,
+               (unsigned)BUSY_BLOCK_MS, (unsigned)BUSY_PERIOD_MS);
+    }
+    printf("case    baud  Hz     bytes     HT    TC  IDLE  IRQs   IRQ/s  byte/s   lost  "
+           "errors  lost  cs    fixes  full\n");
+    printf("                                 DMA+USART interrupts    (per-byte IT)   bytes"
+           "         sent  err\n");
+
+    failures += run("1hz", 9600, 1, 0);
+    failures += run("1hz", 115200, 1, 0);
+    if (!from_file) {
+        failures += run("10hz", 115200, 10, 0);
+        failures += run("ore", 115200, 10, 1);
+    } else {
+        failures += run("ore", 115200, 1, 1);
+    }
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,225 @@
+/**
+  ******************************************************************************
+  * @file           : gps_latency_sim.c
+  * @brief          : GPS新定位从串口到达到围栏检测的事件延迟仿真（主机测试）
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-20
+  ******************************************************************************
+  * @attention
+  *
+  * 直接包含固件atgm336h.c，与固件scheduler.c、nmea.c和uart_rx_sim串口
+  * 循环DMA模型一起运行：模块每秒输出一组ATGM336H语句（GGA/GSA/GSV/RMC/VTG/ZDA，
+  * RMC在组内靠后），经DMA半满/全满/空闲事件进入GPS_UART_RxEventCallback，
+  * gps_task为事件任务，主循环为scheduler_run + scheduler_idle。
+  * 围栏/轨迹/航位推算用本文件的替身记录调用时刻，报告：
+  * - 每组语句中解析成功的语句数与GEOFENCE_Update调用次数（按fix_seq门控后应为1）；
+  * - RMC的'\n'写入DMA缓冲区到GEOFENCE_Update被调用的延迟（最小/平均/最大）；
+  * - 串口中断次数（半满/全满/空闲）。
+  * 负载：idle只有一个1秒周期的空任务；busy另有100ms周期、每次阻塞30ms的任务。
+  *
+  * 编译运行（仓库根目录）：
+  *   gcc -O2 -Itools/host -IAPP tools/host/gps_latency_sim.c tools/host/uart_rx_sim.c \
+  *       tools/host/hal_stub.c APP/scheduler.c APP/nmea.c -lm -o gps_latency_sim
+  *   ./gps_latency_sim [运行秒数]
+  *
+  ******************************************************************************
+  */
+
+#include "atgm336h.c"
+#include "uart_rx_sim.h"
+#include <stdlib.h>
+
+#define BUSY_PERIOD_MS  100
+#define BUSY_BLOCK_MS   30
+
+static const char *const epoch_bodies[] = {
+    "GNGGA,083559.00,3954.52200,N,11623.46150,E,1,08,1.01,499.6,M,48.0,M,,",
+    "GNGSA,A,3,10,07,05,02,29,04,08,13,,,,,1.72,1.03,1.38,1",
+    "GNGSA,A,3,01,03,06,08,,,,,,,,,1.72,1.03,1.38,4",
+    "GPGSV,3,1,11,10,63,137,17,07,61,098,15,05,59,290,20,08,54,157,30",
+    "GPGSV,3,2,11,02,39,223,19,13,28,070,17,26,23,252,,04,14,186,14",
+    "GPGSV,3,3,11,29,09,301,24,16,09,020,,36,,,",
+    "BDGSV,2,1,06,01,45,125,33,03,51,199,35,06,60,216,31,08,64,002,29",
+    "BDGSV,2,2,06,13,22,310,27,16,35,080,30",
+    "GNRMC,083559.00,A,3954.52200,N,11623.46150,E,0.004,77.52,091202,,,A",
+    "GNVTG,77.52,T,,M,0.004,N,0.008,K,A",
+    "GNZDA,083559.00,09,12,2002,00,00",
+};
+
+#define EPOCH_SENTENCES (sizeof(epoch_bodies) / sizeof(epoch_bodies[0]))
+
+static char epoch[1024];
+static uint32_t epoch_len;
+static uint32_t rmc_end;            // RMC语句'\n'在一组中的偏移
+
+static uint64_t rmc_time;           // 最近一次RMC '\n'写入时刻
+static uint32_t rmc_count;
+static uint32_t fence_calls;
+static uint32_t late_count;
+static double lat_min, lat_max, lat_sum;
+
+DR_State_t dr_state;
+DR_Output_t dr_output;
+
+void GEOFENCE_Update(const GPS_Data_t *data)
+{
+    double ms = (host_cycles() - rmc_time) * 1000.0 / HOST_CPU_HZ;
+
+    (void)data;
+    fence_calls++;
+    if (ms < lat_min) lat_min = ms;
+    if (ms > lat_max) lat_max = ms;
+    lat_sum += ms;
+    late_count++;
+}
+
+void TRACK_Add_Fix(const GPS_Data_t *data)
+{
+    (void)data;
+}
+
+void DR_Correct(DR_State_t *dr, const GPS_Data_t *gps)
+{
+    dr->fix_seq = gps->fix_seq;
+}
+
+void DR_Get_Output(const DR_State_t *dr, DR_Output_t *out)
+{
+    (void)dr;
+    (void)out;
+}
+
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
+{
+    GPS_UART_RxEventCallback(huart, Size);
+}
+
+static void on_byte(uint32_t index, uint8_t byte, uint64_t t)
+{
+    (void)byte;
+    if (index % epoch_len == rmc_end) {
+        rmc_time = t;
+        rmc_count++;
+    }
+}
+
+static void idle_task(void)
+{
+}
+
+static void busy_task(void)
+{
+    HAL_Delay(BUSY_BLOCK_MS);
+}
+
+static void build_epoch(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < EPOCH_SENTENCES; i++) {
+        const char *b = epoch_bodies[i];
+        uint8_t cs = 0;
+        const char *p;
+
+        for (p = b; *p; p++) {
+            cs ^= (uint8_t)*p;
+        }
+        epoch_len += (uint32_t)snprintf(epoch + epoch_len, sizeof(epoch) - epoch_len, "$%s*%02X\r\n", b, cs);
+        if (strncmp(b + 2, "RMC", 3) == 0) {
+            rmc_end = epoch_len - 1U;
+        }
+    }
+}
+
+static uint32_t run(uint32_t baud, int with_busy, uint32_t seconds)
+{
+    uint64_t t0, t;
+    uint32_t s;
+    uint32_t parsed0;
+    uint32_t failures = 0;
+
+    host_init();
+    scheduler_init();
+    memset(&gps_data, 0, sizeof(gps_data));
+    gps_slot_head = gps_slot_tail = 0;
+    gps_assembling = false;
+    gps_task_fix_seq = 0;
+    gps_task_fix_status = 0;
+    memset(&gps_rx_stats, 0, sizeof(gps_rx_stats));
+    NMEA_Parser_Init(&gps_parser);
+
+    huart2.Init.BaudRate = baud;
+    UART_Rx_Sim_Init(&huart2, baud);
+    uart_rx_sim.on_byte = on_byte;
+    GPS_UART_Start_DMA();
+
+    scheduler_add_event_task(gps_task);
+    scheduler_add_task(idle_task, 1000);
+    if (with_busy) {
+        scheduler_add_task(busy_task, BUSY_PERIOD_MS);
+    }
+
+    // 每秒一组；每组相对100ms负载周期的相位依次错开13ms，覆盖各种相位
+    t0 = host_cycles();
+    for (s = 0; s < seconds; s++) {
+        UART_Rx_Sim_Send_At((const uint8_t *)epoch, epoch_len,
+                            t0 + (uint64_t)s * HOST_CPU_HZ + HOST_CPU_HZ / 7U +
+                            (uint64_t)(s * 13U % BUSY_PERIOD_MS) * (HOST_CPU_HZ / 1000U));
+    }
+
+    rmc_count = 0;
+    fence_calls = 0;
+    late_count = 0;
+    lat_min = 1e9;
+    lat_max = 0;
+    lat_sum = 0;
+    parsed0 = gps_parser.sentence_count;
+
+    t = t0 + (uint64_t)(seconds + 1U) * HOST_CPU_HZ;
+    while (host_cycles() < t) {
+        scheduler_run();
+        scheduler_idle();
+    }
+
+    printf("%6u  %-4s  %5.1f  %9.2f   %4u   %6.2f %6.2f %6.2f   %4u %4u %5u   %u\n",
+           (unsigned)baud, with_busy ? "busy" : "idle",
+           (double)(gps_parser.sentence_count - parsed0) / rmc_count,
+           (double)fence_calls / rmc_count, (unsigned)rmc_count,
+           lat_min, late_count ? lat_sum / late_count : 0.0, lat_max,
+           (unsigned)uart_rx_sim.irq_ht, (unsigned)uart_rx_sim.irq_tc, (unsigned)uart_rx_sim.irq_idle,
+           (unsigned)(uart_rx_sim.lost + gps_rx_stats.dropped_full + gps_rx_stats.dropped_partial));
+
+    if (rmc_count != seconds || fence_calls != rmc_count) {
+        printf("FAIL: %u RMC sentences, %u GEOFENCE_Update calls (want one per fix)\n",
+               (unsigned)rmc_count, (unsigned)fence_calls);
+        failures++;
+    }
+    if (gps_parser.sentence_count - parsed0 != seconds * EPOCH_SENTENCES) {
+        printf("FAIL: %u sentences parsed, want %u\n",
+               (unsigned)(gps_parser.sentence_count - parsed0), (unsigned)(seconds * EPOCH_SENTENCES));
+        failures++;
+    }
+    return failures;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t seconds = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : 60U;
+    uint32_t failures = 0;
+
+    build_epoch();
+
+    printf("%u s, %u sentences / %u bytes per epoch, RMC ends at byte %u, DMA buffer %u\n",
+           (unsigned)seconds, (unsigned)EPOCH_SENTENCES, (unsigned)epoch_len, (unsigned)rmc_end + 1U,
+           (unsigned)GPS_UART_BUFFER_SIZE);
+    printf("  baud  load  parsed  fence     fixes  RMC->GEOFENCE_Update(ms)    HT   TC  IDLE   lost\n");
+    printf("                /fix  calls/fix          min    mean    max\n");
+
+    failures += run(9600, 0, seconds);
+    failures += run(9600, 1, seconds);
+    failures += run(115200, 0, seconds);
+    failures += run(115200, 1, seconds);
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,256 @@
+/**
+  ******************************************************************************
+  * @file           : gps_spsc_stress.c
+  * @brief          : GPS中断与gps_task之间语句槽位队列的交错压力测试（主机测试）
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-20
+  ******************************************************************************
+  * @attention
+  *
+  * 直接包含固件atgm336h.c。生产者为GPS_Process_Bytes（中断中的组装），每次
+  * 送入1~64字节的随机长度分块；消费者为GPS_Drain_Sentences。atgm336h.c中的
+  * NMEA_Parser_Feed被替换为包装函数：消费者每解析一个字符，按概率插入一次
+  * “中断”送入新字节，模拟中断在任务正在解析槽位时到达。
+  * 语句为带序号的$GNTXT，字段由序号决定（数值字段、可变长度字母字段），
+  * 另按概率发出没有换行的截断语句。检查：
+  * - 没有校验失败或格式错误（任务解析中的槽位从未被改写）；
+  * - 解析出的序号严格递增，字段与序号对应，截断语句从不被解析；
+  * - 解析数 + dropped_full + dropped_partial 等于发出的语句数。
+  * 三个阶段：fast每个分块后运行消费者；preempt消费者运行较少且解析中频繁
+  * 插入中断；slow消费者很少运行，槽位池经常满（dropped_full应大于0）。
+  *
+  * 编译运行（仓库根目录）：
+  *   gcc -O2 -Itools/host -IAPP tools/host/gps_spsc_stress.c tools/host/hal_stub.c \
+  *       APP/scheduler.c APP/nmea.c -lm -o gps_spsc_stress
+  *   ./gps_spsc_stress [每阶段语句数] [随机种子]
+  *
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+#include "nmea.h"
+
+const NMEA_Sentence_t *stress_feed(NMEA_Parser_t *parser, char c);
+
+// 固件打印与本测试无关；解析入口换成可插入“中断”的包装函数
+#define printf(...) ((void)0)
+#define NMEA_Parser_Feed stress_feed
+#include "atgm336h.c"
+#undef NMEA_Parser_Feed
+#undef printf
+#include <stdlib.h>
+
+#define TRUNCATE_ONE_IN 50U     // 截断语句比例
+
+DR_State_t dr_state;
+DR_Output_t dr_output;
+
+void GEOFENCE_Update(const GPS_Data_t *data) { (void)data; }
+void TRACK_Add_Fix(const GPS_Data_t *data) { (void)data; }
+void DR_Correct(DR_State_t *dr, const GPS_Data_t *gps) { (void)dr; (void)gps; }
+void DR_Get_Output(const DR_State_t *dr, DR_Output_t *out) { (void)dr; (void)out; }
+
+static uint32_t rng_state;
+
+static uint32_t rng(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+/* ==================== 生产者（中断） ==================== */
+
+static char pending[GPS_SENTENCE_MAX_LEN * 2];
+static uint32_t pending_len;
+static uint32_t pending_pos;
+static uint32_t next_seq;
+static uint32_t target;             // 本阶段要发出的语句数
+static uint32_t sent;
+static uint32_t truncated;
+
+// 语句总长不超过标准的82字符（$GNTXT,序号6位,数值9位,字母*XX<CR><LF>）
+static uint32_t payload_len(uint32_t seq)
+{
+    return seq * 37U % 54U;
+}
+
+static uint32_t payload_value(uint32_t seq)
+{
+    return seq * 2654435761U % 1000000000U;
+}
+
+/**
+ * @brief 生成下一条语句；按概率截断（去掉'*'之后的部分，不发换行）
+ */
+static void next_sentence(void)
+{
+    char body[GPS_SENTENCE_MAX_LEN];
+    uint32_t n, i;
+    uint8_t cs = 0;
+    uint32_t seq = next_seq++;
+
+    n = (uint32_t)snprintf(body, sizeof(body), "GNTXT,%u,%u,", (unsigned)seq, (unsigned)payload_value(seq));
+    for (i = 0; i < payload_len(seq); i++) {
+        body[n++] = (char)('A' + (seq + i) % 26U);
+    }
+    body[n] = '\0';
+    for (i = 0; i < n; i++) {
+        cs ^= (uint8_t)body[i];
+    }
+
+    pending_len = (uint32_t)snprintf(pending, sizeof(pending), "$%s*%02X\r\n", body, cs);
+    if (rng() % TRUNCATE_ONE_IN == 0) {
+        pending_len = 1U + rng() % (n + 1U);
+        truncated++;
+    }
+    pending_pos = 0;
+    sent++;
+}
+
+/**
+ * @brief 一次“中断”：送入1~64字节
+ * @retval 0: 本阶段已发完
+ */
+static int isr_chunk(void)
+{
+    uint8_t chunk[64];
+    uint32_t want = 1U + rng() % sizeof(chunk);
+    uint32_t n = 0;
+
+    while (n < want) {
+        if (pending_pos == pending_len) {
+            if (sent == target) {
+                break;
+            }
+            next_sentence();
+        }
+        chunk[n++] = (uint8_t)pending[pending_pos++];
+    }
+    if (n == 0) {
+        return 0;
+    }
+    GPS_Process_Bytes(chunk, (uint16_t)n);
+    return 1;
+}
+
+/* ==================== 消费者（任务） ==================== */
+
+static uint32_t preempt_one_in;     // 解析每个字符时插入中断的概率（0: 不插入）
+static int32_t last_seq;
+static uint32_t received;
+static uint32_t bad_fields;
+static uint32_t out_of_order;
+
+const NMEA_Sentence_t *stress_feed(NMEA_Parser_t *parser, char c)
+{
+    const NMEA_Sentence_t *s = NMEA_Parser_Feed(parser, c);
+
+    if (s != NULL && s->type == NMEA_TYPE('T', 'X', 'T')) {
+        int32_t seq = s->field[0].value;
+        uint32_t len = payload_len((uint32_t)seq);
+
+        received++;
+        if (seq <= last_seq) {
+            out_of_order++;
+        }
+        last_seq = seq;
+        if (s->field_count != 3 || s->field[1].value != (int32_t)payload_value((uint32_t)seq) ||
+            s->field[2].len != len || (len > 0 && s->field[2].first != (char)('A' + (uint32_t)seq % 26U))) {
+            bad_fields++;
+        }
+    }
+
+    // 任务正在解析槽位中的语句时中断到达
+    if (preempt_one_in != 0 && rng() % preempt_one_in == 0) {
+        isr_chunk();
+    }
+    return s;
+}
+
+/* ==================== 测试 ==================== */
+
+/**
+ * @brief 运行一个阶段
+ * @param drain_one_in: 每次中断后以1/drain_one_in的概率运行消费者
+ */
+static uint32_t run_phase(const char *name, uint32_t sentences, uint32_t drain_one_in, uint32_t preempt)
+{
+    uint32_t cs0 = gps_parser.checksum_errors;
+    uint32_t fmt0 = gps_parser.format_errors;
+    GPS_RX_Stats_t st0 = gps_rx_stats;
+    uint32_t full, partial;
+    uint32_t failures = 0;
+
+    target = sent + sentences;
+    preempt_one_in = preempt;
+    received = 0;
+    bad_fields = 0;
+    out_of_order = 0;
+    truncated = 0;
+
+    while (isr_chunk()) {
+        if (rng() % drain_one_in == 0) {
+            GPS_Drain_Sentences();
+        }
+    }
+    // 最后一条若被截断，由下一个'$'判定：补一个空语句头后排空
+    preempt_one_in = 0;
+    GPS_Process_Bytes((const uint8_t *)"$", 1);
+    GPS_Drain_Sentences();
+    gps_assembling = false;
+
+    full = gps_rx_stats.dropped_full - st0.dropped_full;
+    partial = gps_rx_stats.dropped_partial - st0.dropped_partial;
+    printf("%-8s %8u %8u %8u %8u %8u   %6u %6u %6u\n",
+           name, (unsigned)sentences, (unsigned)received, (unsigned)full, (unsigned)partial,
+           (unsigned)truncated, (unsigned)(gps_parser.checksum_errors - cs0),
+           (unsigned)(bad_fields + gps_parser.format_errors - fmt0), (unsigned)out_of_order);
+
+    if (gps_parser.checksum_errors != cs0 || gps_parser.format_errors != fmt0 || bad_fields || out_of_order) {
+        printf("FAIL: %s delivered corrupted or reordered sentences\n", name);
+        failures++;
+    }
+    if (received + full + partial != sentences) {
+        printf("FAIL: %s %u received + %u full + %u partial != %u sent\n", name,
+               (unsigned)received, (unsigned)full, (unsigned)partial, (unsigned)sentences);
+        failures++;
+    }
+    if (partial > truncated) {
+        printf("FAIL: %s %u partial drops but only %u truncated sentences\n", name,
+               (unsigned)partial, (unsigned)truncated);
+        failures++;
+    }
+    return failures;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t sentences = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : 200000U;
+    uint32_t failures = 0;
+
+    rng_state = argc > 2 ? (uint32_t)strtoul(argv[2], NULL, 0) : 0x2545F491U;
+    if (rng_state == 0) {
+        rng_state = 1;
+    }
+
+    NMEA_Parser_Init(&gps_parser);
+    last_seq = -1;
+
+    printf("%u slots of %u bytes, seed 0x%08X\n",
+           (unsigned)GPS_SENTENCE_SLOTS, (unsigned)GPS_SENTENCE_MAX_LEN, (unsigned)rng_state);
+    printf("phase        sent   parsed     full  partial truncated  cs err bad  reorder\n");
+
+    failures += run_phase("fast", sentences, 1, 0);
+    failures += run_phase("preempt", sentences, 8, 64);
+    failures += run_phase("slow", sentences, 64, 16);
+
+    if (gps_rx_stats.dropped_full == 0) {
+        printf("FAIL: slow consumer never filled the slot pool\n");
+        failures++;
+    }
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
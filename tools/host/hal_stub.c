@@ -0,0 +1,775 @@
+/**
+  ******************************************************************************
+  * @file           : hal_stub.c
+  * @brief          : 主机测试用HAL替身与仿真时钟
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-20
+  ******************************************************************************
+  * @attention
+  *
+  * 仿真时间以CPU周期计，只在host_advance中前进（HAL_GetTick、定时器计数
+  * 读取、HAL_Delay、WFI/STOP都经由它）。前进过程中按时间顺序处理：
+  * - SysTick：按LOAD/VAL/CTRL的写入重新装载，回绕时挂起SysTick中断
+  *   （uwTick加1），与硬件一样在PRIMASK置位时保持挂起；
+  * - TIM1：1MHz计数，使能更新中断后每ARR+1个计数调用
+  *   HAL_TIM_PeriodElapsedCallback；
+  * - 测试程序的外部事件：host_event_next/host_event_poll（弱定义，可重写），
+  *   用于产生传感器样本、串口字节、EXTI边沿等。
+  * 中断不嵌套，按挂起顺序依次执行；__enable_irq时执行挂起的中断。
+  *
+  * HAL外设函数均为弱定义的最小实现，测试程序按需重写。
+  *
+  ******************************************************************************
+  */
+
+#include "main.h"
+#include "usart.h"
+#include "tim.h"
+#include "adc.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/* ==================== 全局对象 ==================== */
+
+uint32_t SystemCoreClock = HOST_CPU_HZ;
+volatile uint32_t uwTick = 0;
+volatile uint32_t host_primask = 0;
+
+GPIO_TypeDef host_gpio[5];
+USART_TypeDef host_usart[3];
+TIM_TypeDef host_tim[2];
+ADC_TypeDef host_adc[1];
+CoreDebug_Type host_coredebug;
+
+DMA_HandleTypeDef hdma_usart2_rx;
+DMA_HandleTypeDef hdma_adc1;
+UART_HandleTypeDef huart1 = { .Instance = USART1 };
+UART_HandleTypeDef huart2 = { .Instance = USART2, .hdmarx = &hdma_usart2_rx };
+UART_HandleTypeDef huart3 = { .Instance = USART3 };
+TIM_HandleTypeDef htim1 = { .Instance = TIM1 };
+TIM_HandleTypeDef htim3 = { .Instance = TIM3 };
+ADC_HandleTypeDef hadc1 = { .Instance = ADC1, .DMA_Handle = &hdma_adc1 };
+I2C_HandleTypeDef hi2c1;
+
+/* ==================== 仿真状态 ==================== */
+
+#define HOST_MAX_IRQ        16
+#define HOST_TIM1_CYCLES    (HOST_CPU_HZ / 1000000U)  // TIM1每个计数的周期数
+
+static uint64_t now;                    // 当前仿真时刻（周期）
+static uint32_t in_isr;                 // 正在执行中断
+
+static host_isr_t pending[HOST_MAX_IRQ];
+static uint32_t pending_count;
+static struct {
+    host_isr_t isr;
+    uint32_t count;
+} isr_stats[HOST_MAX_IRQ];
+
+// SysTick：寄存器（程序可见）与影子值（用于识别写入）
+static SysTick_Type st_regs;
+static SysTick_Type st_shadow;
+static uint32_t st_enabled;
+static uint32_t st_div = 1;             // 1: HCLK, 8: HCLK/8
+static uint32_t st_reload;              // 本轮计数起点
+static uint64_t st_base;                // 本轮装载时刻
+static uint64_t st_next;                // 本轮回绕时刻
+static uint32_t st_frozen;              // 停止时的计数值
+
+static SCB_Type scb_regs;
+static DWT_Type dwt_regs;
+static uint32_t dwt_shadow;
+static uint64_t dwt_base;
+
+// TIM1
+static uint64_t tim1_base;              // 计数器写入时刻
+static uint32_t tim1_cnt0;              // 写入的计数值
+static uint64_t tim1_next;              // 下一次更新事件时刻
+
+// STOP模式
+static uint32_t stop_mode;
+
+/* ==================== 中断 ==================== */
+
+static void isr_count_inc(host_isr_t isr)
+{
+    uint32_t i;
+
+    for (i = 0; i < HOST_MAX_IRQ; i++) {
+        if (isr_stats[i].isr == isr || isr_stats[i].isr == NULL) {
+            isr_stats[i].isr = isr;
+            isr_stats[i].count++;
+            return;
+        }
+    }
+}
+
+static void service_pending(void)
+{
+    while (pending_count > 0 && !host_primask && !in_isr) {
+        host_isr_t isr = pending[0];
+        uint32_t i;
+
+        for (i = 1; i < pending_count; i++) {
+            pending[i - 1] = pending[i];
+        }
+        pending_count--;
+
+        in_isr = 1;
+        isr_count_inc(isr);
+        isr();
+        in_isr = 0;
+    }
+}
+
+static uint32_t is_pending(host_isr_t isr)
+{
+    uint32_t i;
+
+    for (i = 0; i < pending_count; i++) {
+        if (pending[i] == isr) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void clear_pending(host_isr_t isr)
+{
+    uint32_t i;
+    uint32_t j = 0;
+
+    for (i = 0; i < pending_count; i++) {
+        if (pending[i] != isr) {
+            pending[j++] = pending[i];
+        }
+    }
+    pending_count = j;
+}
+
+/**
+ * @brief 挂起一个中断；未屏蔽且不在中断中时立即执行
+ */
+void host_raise_irq(host_isr_t isr)
+{
+    if (!is_pending(isr)) {
+        if (pending_count >= HOST_MAX_IRQ) {
+            fprintf(stderr, "host: too many pending IRQs\n");
+            abort();
+        }
+        pending[pending_count++] = isr;
+    }
+    service_pending();
+}
+
+/**
+ * @brief 中断执行次数
+ */
+uint32_t host_isr_count(host_isr_t isr)
+{
+    uint32_t i;
+
+    for (i = 0; i < HOST_MAX_IRQ; i++) {
+        if (isr_stats[i].isr == isr) {
+            return isr_stats[i].count;
+        }
+    }
+    return 0;
+}
+
+/* ==================== SysTick / SCB / DWT ==================== */
+
+static void systick_isr(void)
+{
+    uwTick++;   // HAL_IncTick
+}
+
+static void tim1_isr(void)
+{
+    if (htim1.Instance->DIER & TIM_IT_UPDATE) {
+        HAL_TIM_PeriodElapsedCallback(&htim1);
+    }
+}
+
+static uint32_t systick_live(void)
+{
+    uint64_t elapsed;
+
+    if (!st_enabled) {
+        return st_frozen;
+    }
+    elapsed = (now - st_base) / st_div;
+    return (elapsed >= st_reload) ? 0U : st_reload - (uint32_t)elapsed;
+}
+
+static void systick_start(uint32_t from)
+{
+    st_base = now;
+    st_reload = from ? from : (st_regs.LOAD & SysTick_LOAD_RELOAD_Msk);
+    st_next = st_base + (uint64_t)(st_reload + 1U) * st_div;
+}
+
+/**
+ * @brief 识别上次访问后程序对SysTick/SCB/DWT的写入，并刷新只读值
+ */
+static void sync_core(void)
+{
+    // 写VAL：计数清零，下一个时钟重新装载LOAD
+    if (st_regs.VAL != st_shadow.VAL) {
+        st_frozen = 0;
+        if (st_enabled) {
+            systick_start(0);
+        }
+    }
+
+    if (st_regs.CTRL != st_shadow.CTRL) {
+        uint32_t enable = st_regs.CTRL & SysTick_CTRL_ENABLE_Msk;
+
+        if (st_enabled && !enable) {
+            st_frozen = systick_live();
+        }
+        st_div = (st_regs.CTRL & SysTick_CTRL_CLKSOURCE_Msk) ? 1U : 8U;
+        if (!st_enabled && enable) {
+            st_enabled = 1;
+            systick_start(st_frozen);
+        }
+        st_enabled = enable;
+    }
+
+    st_regs.VAL = systick_live();
+    st_shadow = st_regs;
+
+    // 写ICSR.PENDSTCLR：清除挂起的SysTick中断
+    if (scb_regs.ICSR & SCB_ICSR_PENDSTCLR_Msk) {
+        clear_pending(systick_isr);
+    }
+    scb_regs.ICSR = is_pending(systick_isr) ? SCB_ICSR_PENDSTSET_Msk : 0U;
+
+    if (dwt_regs.CYCCNT != dwt_shadow) {
+        dwt_base = now - dwt_regs.CYCCNT;
+    }
+    dwt_regs.CYCCNT = (uint32_t)(now - dwt_base);
+    dwt_shadow = dwt_regs.CYCCNT;
+}
+
+SysTick_Type *host_systick(void)
+{
+    sync_core();
+    return &st_regs;
+}
+
+SCB_Type *host_scb(void)
+{
+    sync_core();
+    return &scb_regs;
+}
+
+DWT_Type *host_dwt(void)
+{
+    sync_core();
+    return &dwt_regs;
+}
+
+/* ==================== 时间推进 ==================== */
+
+__weak uint64_t host_event_next(void)
+{
+    return UINT64_MAX;
+}
+
+__weak void host_event_poll(uint64_t t)
+{
+    (void)t;
+}
+
+static uint32_t tim1_running(void)
+{
+    return (htim1.Instance->DIER & TIM_IT_UPDATE) != 0;
+}
+
+static void tim1_schedule(void)
+{
+    uint64_t period = (uint64_t)(htim1.Instance->ARR + 1U);
+    uint64_t count = (now - tim1_base) / HOST_TIM1_CYCLES + tim1_cnt0;
+
+    // 下一次计数到达ARR+1的整数倍的时刻
+    tim1_next = tim1_base + ((count / period + 1U) * period - tim1_cnt0) * HOST_TIM1_CYCLES;
+}
+
+uint64_t host_cycles(void)
+{
+    return now;
+}
+
+/**
+ * @brief 仿真时间前进，按时间顺序处理SysTick回绕、TIM1更新和外部事件
+ * @param cycles: 前进的周期数（中断中调用时只累加时间）
+ */
+void host_advance(uint64_t cycles)
+{
+    uint64_t target = now + cycles;
+
+    if (in_isr) {
+        now = target;
+        return;
+    }
+
+    sync_core();
+
+    for (;;) {
+        uint64_t next = target;
+        uint64_t ev = host_event_next();
+
+        if (!stop_mode && st_enabled && st_next < next) next = st_next;
+        if (!stop_mode && tim1_running() && tim1_next < next) next = tim1_next;
+        if (ev < next) next = ev;
+        if (next > now) now = next;
+
+        if (!stop_mode && st_enabled && now >= st_next) {
+            st_base = st_next;
+            st_reload = st_regs.LOAD & SysTick_LOAD_RELOAD_Msk;
+            st_next = st_base + (uint64_t)(st_reload + 1U) * st_div;
+            st_shadow.VAL = st_regs.VAL = st_reload;
+            if (st_regs.CTRL & SysTick_CTRL_TICKINT_Msk) {
+                host_raise_irq(systick_isr);
+            }
+        }
+        if (!stop_mode && tim1_running() && now >= tim1_next) {
+            tim1_next += (uint64_t)(htim1.Instance->ARR + 1U) * HOST_TIM1_CYCLES;
+            host_raise_irq(tim1_isr);
+        }
+        if (ev <= now) {
+            host_event_poll(now);
+        }
+
+        sync_core();
+        if (now >= target) {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief __enable_irq/__set_PRIMASK(0)后执行挂起的中断
+ */
+void host_irq_unmasked(void)
+{
+    sync_core();
+    service_pending();
+}
+
+/**
+ * @brief 休眠直到有中断挂起（PRIMASK置位时同样唤醒，但中断不执行）
+ * @retval 休眠的周期数由调用方按host_cycles差值统计
+ */
+static void sleep_until_irq(void)
+{
+    uint32_t serviced = 0;
+    uint32_t i;
+
+    sync_core();
+
+    for (i = 0; i < HOST_MAX_IRQ; i++) {
+        serviced += isr_stats[i].count;
+    }
+
+    while (pending_count == 0) {
+        uint64_t next = host_event_next();
+        uint32_t total = 0;
+
+        if (!stop_mode && st_enabled && (st_regs.CTRL & SysTick_CTRL_TICKINT_Msk) && st_next < next) {
+            next = st_next;
+        }
+        if (!stop_mode && tim1_running() && tim1_next < next) {
+            next = tim1_next;
+        }
+        if (next == UINT64_MAX) {
+            fprintf(stderr, "host: WFI with no wake-up source\n");
+            abort();
+        }
+
+        host_advance(next > now ? next - now : 0);
+
+        for (i = 0; i < HOST_MAX_IRQ; i++) {
+            total += isr_stats[i].count;
+        }
+        if (total != serviced) {
+            break;  // 唤醒中断已执行
+        }
+    }
+}
+
+__weak void host_wfi(void)
+{
+    sleep_until_irq();
+}
+
+/* ==================== TIM ==================== */
+
+void host_tim_set_counter(TIM_HandleTypeDef *htim, uint32_t cnt)
+{
+    if (htim->Instance == TIM1) {
+        tim1_base = now;
+        tim1_cnt0 = cnt;
+        if (tim1_running()) {
+            tim1_schedule();
+        }
+    }
+    htim->Instance->CNT = cnt;
+}
+
+uint32_t host_tim_get_counter(TIM_HandleTypeDef *htim)
+{
+    host_advance(HOST_POLL_CYCLES);
+
+    if (htim->Instance == TIM1) {
+        uint64_t count = (now - tim1_base) / HOST_TIM1_CYCLES + tim1_cnt0;
+        htim->Instance->CNT = (uint32_t)(count % ((uint64_t)htim->Instance->ARR + 1U));
+    }
+    return htim->Instance->CNT;
+}
+
+void host_tim_set_autoreload(TIM_HandleTypeDef *htim, uint32_t arr)
+{
+    if (htim->Instance == TIM1) {
+        // 先把当前计数值固定下来，再按新周期计算
+        tim1_cnt0 = (uint32_t)(((now - tim1_base) / HOST_TIM1_CYCLES + tim1_cnt0) %
+                               ((uint64_t)htim->Instance->ARR + 1U));
+        tim1_base = now;
+    }
+    htim->Instance->ARR = arr;
+    if (htim->Instance == TIM1 && tim1_running()) {
+        tim1_schedule();
+    }
+}
+
+void host_tim_enable_it(TIM_HandleTypeDef *htim, uint32_t it)
+{
+    htim->Instance->DIER |= it;
+    if (htim->Instance == TIM1) {
+        tim1_schedule();
+    }
+}
+
+void host_tim_disable_it(TIM_HandleTypeDef *htim, uint32_t it)
+{
+    htim->Instance->DIER &= ~it;
+    if (htim->Instance == TIM1 && !tim1_running()) {
+        clear_pending(tim1_isr);
+    }
+}
+
+__weak HAL_StatusTypeDef HAL_TIM_Base_Start(TIM_HandleTypeDef *htim)
+{
+    (void)htim;
+    return HAL_OK;
+}
+
+__weak void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
+{
+    (void)htim;
+}
+
+/* ==================== 系统 ==================== */
+
+/**
+ * @brief 初始化仿真：SysTick 1ms节拍（同HAL_Init），TIM1自由计数（同MX_TIM1_Init）
+ */
+void host_init(void)
+{
+    SysTick->LOAD = HOST_CPU_HZ / 1000U - 1U;
+    SysTick->VAL = 0;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+    sync_core();
+
+    htim1.Instance->ARR = 0xFFFF;
+    tim1_base = now;
+    tim1_cnt0 = 0;
+}
+
+uint32_t HAL_GetTick(void)
+{
+    host_advance(HOST_POLL_CYCLES);
+    return uwTick;
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+    uint32_t start = HAL_GetTick();
+
+    // 与HAL一致：至少等待Delay+1个节拍边界
+    if (Delay < 0xFFFFFFFFU) {
+        Delay++;
+    }
+    while (HAL_GetTick() - start < Delay) {
+    }
+}
+
+void HAL_SuspendTick(void)
+{
+    SysTick->CTRL &= ~SysTick_CTRL_TICKINT_Msk;
+}
+
+void HAL_ResumeTick(void)
+{
+    SysTick->CTRL |= SysTick_CTRL_TICKINT_Msk;
+}
+
+/**
+ * @brief STOP模式：SysTick和TIM1停止计数，只有外部事件能唤醒
+ */
+void HAL_PWR_EnterSTOPMode(uint32_t Regulator, uint8_t STOPEntry)
+{
+    uint64_t start = now;
+    uint64_t slept;
+
+    (void)Regulator;
+    (void)STOPEntry;
+
+    sync_core();
+    stop_mode = 1;
+    sleep_until_irq();
+    stop_mode = 0;
+
+    // 时钟停止期间计数器不走：把SysTick和TIM1的时间基准后移
+    slept = now - start;
+    st_base += slept;
+    st_next += slept;
+    tim1_base += slept;
+    tim1_next += slept;
+}
+
+__weak void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority)
+{
+    (void)IRQn;
+    (void)PreemptPriority;
+    (void)SubPriority;
+}
+
+__weak void HAL_NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+    (void)IRQn;
+}
+
+__weak void HAL_NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+    (void)IRQn;
+}
+
+void Error_Handler(void)
+{
+    fprintf(stderr, "host: Error_Handler\n");
+    abort();
+}
+
+/* ==================== GPIO ==================== */
+
+__weak void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init)
+{
+    (void)GPIOx;
+    (void)GPIO_Init;
+}
+
+__weak void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+    if (PinState == GPIO_PIN_SET) {
+        GPIOx->ODR |= GPIO_Pin;
+    } else {
+        GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+    }
+}
+
+__weak GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+    return (GPIOx->IDR & GPIO_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+__weak void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+    GPIOx->ODR ^= GPIO_Pin;
+}
+
+__weak void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+    (void)GPIO_Pin;
+}
+
+/* ==================== UART ==================== */
+
+__weak HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef *huart)
+{
+    huart->gState = HAL_UART_STATE_READY;
+    huart->RxState = HAL_UART_STATE_READY;
+    return HAL_OK;
+}
+
+__weak HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+    (void)huart;
+    (void)pData;
+    (void)Size;
+    (void)Timeout;
+    return HAL_OK;
+}
+
+__weak HAL_StatusTypeDef HAL_UART_Transmit_IT(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size)
+{
+    (void)huart;
+    (void)pData;
+    (void)Size;
+    return HAL_OK;
+}
+
+__weak HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size)
+{
+    if (huart->RxState != HAL_UART_STATE_READY && huart->RxState != HAL_UART_STATE_RESET) {
+        return HAL_BUSY;
+    }
+    huart->pRxBuffPtr = pData;
+    huart->RxXferSize = Size;
+    huart->RxState = HAL_UART_STATE_BUSY_RX;
+    return HAL_OK;
+}
+
+__weak HAL_StatusTypeDef HAL_UART_AbortTransmit_IT(UART_HandleTypeDef *huart)
+{
+    huart->gState = HAL_UART_STATE_READY;
+    return HAL_OK;
+}
+
+__weak HAL_StatusTypeDef HAL_UART_DMAStop(UART_HandleTypeDef *huart)
+{
+    huart->RxState = HAL_UART_STATE_READY;
+    return HAL_OK;
+}
+
+__weak HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size)
+{
+    huart->pRxBuffPtr = pData;
+    huart->RxXferSize = Size;
+    huart->RxState = HAL_UART_STATE_BUSY_RX;
+    return HAL_OK;
+}
+
+__weak void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
+{
+    (void)huart;
+}
+
+__weak void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+    (void)huart;
+}
+
+__weak void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+    (void)huart;
+}
+
+__weak void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
+{
+    (void)huart;
+    (void)Size;
+}
+
+/* ==================== ADC ==================== */
+
+__weak HAL_StatusTypeDef HAL_ADC_Init(ADC_HandleTypeDef *hadc)
+{
+    (void)hadc;
+    return HAL_OK;
+}
+
+__weak HAL_StatusTypeDef HAL_ADC_ConfigChannel(ADC_HandleTypeDef *hadc, ADC_ChannelConfTypeDef *sConfig)
+{
+    (void)hadc;
+    (void)sConfig;
+    return HAL_OK;
+}
+
+__weak HAL_StatusTypeDef HAL_ADC_AnalogWDGConfig(ADC_HandleTypeDef *hadc, ADC_AnalogWDGConfTypeDef *AnalogWDGConfig)
+{
+    hadc->Instance->HTR = AnalogWDGConfig->HighThreshold;
+    hadc->Instance->LTR = AnalogWDGConfig->LowThreshold;
+    return HAL_OK;
+}
+
+__weak HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef *hadc, uint32_t *pData, uint32_t Length)
+{
+    (void)hadc;
+    (void)pData;
+    (void)Length;
+    return HAL_OK;
+}
+
+__weak HAL_StatusTypeDef HAL_ADC_Stop_DMA(ADC_HandleTypeDef *hadc)
+{
+    (void)hadc;
+    return HAL_OK;
+}
+
+__weak void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc)
+{
+    (void)hadc;
+}
+
+__weak void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc)
+{
+    (void)hadc;
+}
+
+__weak void HAL_ADC_LevelOutOfWindowCallback(ADC_HandleTypeDef *hadc)
+{
+    (void)hadc;
+}
+
+__weak void HAL_ADC_ErrorCallback(ADC_HandleTypeDef *hadc)
+{
+    (void)hadc;
+}
+
+/* ==================== I2C ==================== */
+
+__weak HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+    (void)hi2c;
+    (void)DevAddress;
+    (void)pData;
+    (void)Size;
+    (void)Timeout;
+    return HAL_ERROR;
+}
+
+__weak HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+    (void)hi2c;
+    (void)DevAddress;
+    (void)pData;
+    (void)Size;
+    (void)Timeout;
+    return HAL_ERROR;
+}
+
+__weak HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+    (void)hi2c;
+    (void)DevAddress;
+    (void)MemAddress;
+    (void)MemAddSize;
+    (void)pData;
+    (void)Size;
+    (void)Timeout;
+    return HAL_ERROR;
+}
+
+__weak HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+    (void)hi2c;
+    (void)DevAddress;
+    (void)MemAddress;
+    (void)MemAddSize;
+    (void)pData;
+    (void)Size;
+    (void)Timeout;
+    return HAL_ERROR;
+}
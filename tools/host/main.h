@@ -0,0 +1,367 @@
+/**
+  ******************************************************************************
+  * @file           : main.h
+  * @brief          : 主机测试用main.h替身（在PC上编译APP模块时使用）
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-08
+  ******************************************************************************
+  * @attention
+  *
+  * 纯算法模块（如nmea.c）只用到标准整数类型；驱动模块还需要的HAL句柄、
+  * GPIO/定时器宏、内核寄存器（SysTick/SCB/DWT）和内建函数在这里给出
+  * 最小替身，由hal_stub.c按仿真时钟实现。编译时把本目录放在APP目录之前，
+  * 且不要加入Core/Inc（usart.h/tim.h/adc.h同样由本目录提供）：
+  *   gcc -Itools/host -IAPP ... tools/host/hal_stub.c
+  *
+  * 仿真时间以CPU周期计（SystemCoreClock = 168MHz），HAL_GetTick和定时器
+  * 计数读取各消耗HOST_POLL_CYCLES，使忙等循环能推进时间。
+  *
+  ******************************************************************************
+  */
+
+#ifndef __MAIN_H
+#define __MAIN_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* ==================== 通用定义 ==================== */
+
+#define __weak              __attribute__((weak))
+
+typedef enum {
+    HAL_OK = 0x00U,
+    HAL_ERROR = 0x01U,
+    HAL_BUSY = 0x02U,
+    HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+typedef enum { DISABLE = 0U, ENABLE = !DISABLE } FunctionalState;
+
+typedef enum {
+    ADC_IRQn, DMA1_Stream5_IRQn, DMA2_Stream0_IRQn, USART2_IRQn, USART3_IRQn,
+    TIM1_UP_TIM10_IRQn, EXTI15_10_IRQn
+} IRQn_Type;
+
+/* ==================== 内核 ==================== */
+
+#define HOST_CPU_HZ         168000000U  // 仿真CPU主频
+#define HOST_POLL_CYCLES    16U         // 一次HAL_GetTick/计数器读取消耗的周期
+
+extern uint32_t SystemCoreClock;
+extern volatile uint32_t uwTick;
+
+typedef struct {
+    volatile uint32_t CTRL;
+    volatile uint32_t LOAD;
+    volatile uint32_t VAL;
+    volatile uint32_t CALIB;
+} SysTick_Type;
+
+typedef struct {
+    volatile uint32_t ICSR;
+} SCB_Type;
+
+typedef struct {
+    volatile uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct {
+    volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+// 每次访问先按仿真时间同步寄存器值（并识别上次访问后的写入）
+SysTick_Type *host_systick(void);
+SCB_Type *host_scb(void);
+DWT_Type *host_dwt(void);
+extern CoreDebug_Type host_coredebug;
+
+#define SysTick             (host_systick())
+#define SCB                 (host_scb())
+#define DWT                 (host_dwt())
+#define CoreDebug           (&host_coredebug)
+
+#define SysTick_CTRL_ENABLE_Msk         (1UL << 0)
+#define SysTick_CTRL_TICKINT_Msk        (1UL << 1)
+#define SysTick_CTRL_CLKSOURCE_Msk      (1UL << 2)
+#define SysTick_CTRL_COUNTFLAG_Msk      (1UL << 16)
+#define SysTick_LOAD_RELOAD_Msk         (0xFFFFFFUL)
+#define SCB_ICSR_PENDSTSET_Msk          (1UL << 26)
+#define SCB_ICSR_PENDSTCLR_Msk          (1UL << 25)
+#define DWT_CTRL_CYCCNTENA_Msk          (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk      (1UL << 24)
+
+extern volatile uint32_t host_primask;
+
+void host_irq_unmasked(void);
+void host_wfi(void);
+
+#define __disable_irq()     (host_primask = 1U)
+#define __enable_irq()      do { host_primask = 0U; host_irq_unmasked(); } while (0)
+#define __get_PRIMASK()     (host_primask)
+#define __set_PRIMASK(v)    do { host_primask = (v); if (!host_primask) host_irq_unmasked(); } while (0)
+#define __DMB()             __sync_synchronize()
+#define __DSB()             __sync_synchronize()
+#define __ISB()             __sync_synchronize()
+#define __WFI()             host_wfi()
+#define __NOP()             ((void)0)
+
+static inline uint8_t __CLZ(uint32_t x)
+{
+    return x ? (uint8_t)__builtin_clz(x) : 32U;
+}
+
+/* ==================== GPIO ==================== */
+
+typedef struct {
+    volatile uint32_t IDR;
+    volatile uint32_t ODR;
+} GPIO_TypeDef;
+
+extern GPIO_TypeDef host_gpio[5];
+
+#define GPIOA               (&host_gpio[0])
+#define GPIOB               (&host_gpio[1])
+#define GPIOC               (&host_gpio[2])
+#define GPIOD               (&host_gpio[3])
+#define GPIOE               (&host_gpio[4])
+
+typedef enum { GPIO_PIN_RESET = 0, GPIO_PIN_SET } GPIO_PinState;
+
+#define GPIO_PIN_0          ((uint16_t)0x0001)
+#define GPIO_PIN_1          ((uint16_t)0x0002)
+#define GPIO_PIN_2          ((uint16_t)0x0004)
+#define GPIO_PIN_3          ((uint16_t)0x0008)
+#define GPIO_PIN_10         ((uint16_t)0x0400)
+#define GPIO_PIN_11         ((uint16_t)0x0800)
+#define GPIO_PIN_12         ((uint16_t)0x1000)
+#define GPIO_PIN_13         ((uint16_t)0x2000)
+#define GPIO_PIN_14         ((uint16_t)0x4000)
+#define GPIO_PIN_15         ((uint16_t)0x8000)
+
+#define GPIO_MODE_INPUT         0x00000000U
+#define GPIO_MODE_OUTPUT_PP     0x00000001U
+#define GPIO_MODE_OUTPUT_OD     0x00000011U
+#define GPIO_MODE_IT_FALLING    0x10210000U
+#define GPIO_NOPULL             0x00000000U
+#define GPIO_PULLUP             0x00000001U
+#define GPIO_SPEED_FREQ_HIGH    0x00000002U
+
+typedef struct {
+    uint32_t Pin;
+    uint32_t Mode;
+    uint32_t Pull;
+    uint32_t Speed;
+    uint32_t Alternate;
+} GPIO_InitTypeDef;
+
+// 板级引脚（与Core/Inc/main.h一致）
+#define ICM_INT_Pin         GPIO_PIN_12
+#define ICM_INT_GPIO_Port   GPIOB
+#define ADC_IN1_Pin         GPIO_PIN_1
+#define ADC_IN1_GPIO_Port   GPIOA
+
+/* ==================== 外设实例 ==================== */
+
+typedef struct { volatile uint32_t SR, DR, BRR; } USART_TypeDef;
+typedef struct { volatile uint32_t CNT, ARR, DIER, SR; } TIM_TypeDef;
+typedef struct { volatile uint32_t SR, HTR, LTR, DR; } ADC_TypeDef;
+typedef struct { volatile uint32_t NDTR; } DMA_Stream_TypeDef;
+typedef struct { volatile uint32_t SR1; } I2C_TypeDef;
+
+extern USART_TypeDef host_usart[3];
+extern TIM_TypeDef host_tim[2];
+extern ADC_TypeDef host_adc[1];
+
+#define USART1              (&host_usart[0])
+#define USART2              (&host_usart[1])
+#define USART3              (&host_usart[2])
+#define TIM1                (&host_tim[0])
+#define TIM3                (&host_tim[1])
+#define ADC1                (&host_adc[0])
+
+/* ==================== DMA ==================== */
+
+typedef struct {
+    DMA_Stream_TypeDef *Instance;
+} DMA_HandleTypeDef;
+
+/* ==================== UART ==================== */
+
+typedef enum {
+    HAL_UART_STATE_RESET = 0x00U,
+    HAL_UART_STATE_READY = 0x20U,
+    HAL_UART_STATE_BUSY_TX = 0x21U,
+    HAL_UART_STATE_BUSY_RX = 0x22U
+} HAL_UART_StateTypeDef;
+
+typedef struct {
+    uint32_t BaudRate;
+    uint32_t WordLength;
+    uint32_t StopBits;
+    uint32_t Parity;
+    uint32_t Mode;
+    uint32_t HwFlowCtl;
+    uint32_t OverSampling;
+} UART_InitTypeDef;
+
+typedef struct {
+    USART_TypeDef *Instance;
+    UART_InitTypeDef Init;
+    uint8_t *pRxBuffPtr;
+    uint16_t RxXferSize;
+    volatile HAL_UART_StateTypeDef gState;
+    volatile HAL_UART_StateTypeDef RxState;
+    volatile uint32_t ErrorCode;
+    DMA_HandleTypeDef *hdmarx;
+} UART_HandleTypeDef;
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef *huart);
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_UART_Transmit_IT(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_AbortTransmit_IT(UART_HandleTypeDef *huart);
+HAL_StatusTypeDef HAL_UART_DMAStop(UART_HandleTypeDef *huart);
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart);
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart);
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart);
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size);
+
+/* ==================== 定时器 ==================== */
+
+#define TIM_IT_UPDATE       (1UL << 0)
+#define TIM_FLAG_UPDATE     (1UL << 0)
+
+typedef struct {
+    uint32_t Prescaler;
+    uint32_t CounterMode;
+    uint32_t Period;
+    uint32_t ClockDivision;
+    uint32_t RepetitionCounter;
+    uint32_t AutoReloadPreload;
+} TIM_Base_InitTypeDef;
+
+typedef struct {
+    TIM_TypeDef *Instance;
+    TIM_Base_InitTypeDef Init;
+} TIM_HandleTypeDef;
+
+// TIM1为1MHz计数（预分频168），CNT按仿真时间计算；使能更新中断后每ARR+1个计数触发一次
+void host_tim_set_counter(TIM_HandleTypeDef *htim, uint32_t cnt);
+uint32_t host_tim_get_counter(TIM_HandleTypeDef *htim);
+void host_tim_set_autoreload(TIM_HandleTypeDef *htim, uint32_t arr);
+void host_tim_enable_it(TIM_HandleTypeDef *htim, uint32_t it);
+void host_tim_disable_it(TIM_HandleTypeDef *htim, uint32_t it);
+
+#define __HAL_TIM_SET_COUNTER(h, v)     host_tim_set_counter((h), (v))
+#define __HAL_TIM_GET_COUNTER(h)        host_tim_get_counter(h)
+#define __HAL_TIM_SET_AUTORELOAD(h, v)  host_tim_set_autoreload((h), (v))
+#define __HAL_TIM_CLEAR_FLAG(h, f)      ((h)->Instance->SR &= ~(f))
+#define __HAL_TIM_ENABLE_IT(h, i)       host_tim_enable_it((h), (i))
+#define __HAL_TIM_DISABLE_IT(h, i)      host_tim_disable_it((h), (i))
+
+HAL_StatusTypeDef HAL_TIM_Base_Start(TIM_HandleTypeDef *htim);
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim);
+
+/* ==================== ADC ==================== */
+
+#define ADC_CHANNEL_0               0x00000000U
+#define ADC_CHANNEL_1               0x00000001U
+#define ADC_CHANNEL_2               0x00000002U
+#define ADC_CHANNEL_TEMPSENSOR      0x00000010U
+#define ADC_CHANNEL_VREFINT         0x00000011U
+#define ADC_SAMPLETIME_480CYCLES    0x00000007U
+#define ADC_EOC_SEQ_CONV            0x00000000U
+#define ADC_ANALOGWATCHDOG_SINGLE_REG 0x00800200U
+
+typedef struct {
+    uint32_t ScanConvMode;
+    uint32_t NbrOfConversion;
+    uint32_t EOCSelection;
+    uint32_t ExternalTrigConv;
+    uint32_t ExternalTrigConvEdge;
+    uint32_t DMAContinuousRequests;
+} ADC_InitTypeDef;
+
+typedef struct {
+    ADC_TypeDef *Instance;
+    ADC_InitTypeDef Init;
+    DMA_HandleTypeDef *DMA_Handle;
+} ADC_HandleTypeDef;
+
+typedef struct {
+    uint32_t Channel;
+    uint32_t Rank;
+    uint32_t SamplingTime;
+    uint32_t Offset;
+} ADC_ChannelConfTypeDef;
+
+typedef struct {
+    uint32_t WatchdogMode;
+    uint32_t HighThreshold;
+    uint32_t LowThreshold;
+    uint32_t Channel;
+    FunctionalState ITMode;
+    uint32_t WatchdogNumber;
+} ADC_AnalogWDGConfTypeDef;
+
+HAL_StatusTypeDef HAL_ADC_Init(ADC_HandleTypeDef *hadc);
+HAL_StatusTypeDef HAL_ADC_ConfigChannel(ADC_HandleTypeDef *hadc, ADC_ChannelConfTypeDef *sConfig);
+HAL_StatusTypeDef HAL_ADC_AnalogWDGConfig(ADC_HandleTypeDef *hadc, ADC_AnalogWDGConfTypeDef *AnalogWDGConfig);
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef *hadc, uint32_t *pData, uint32_t Length);
+HAL_StatusTypeDef HAL_ADC_Stop_DMA(ADC_HandleTypeDef *hadc);
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc);
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc);
+void HAL_ADC_LevelOutOfWindowCallback(ADC_HandleTypeDef *hadc);
+void HAL_ADC_ErrorCallback(ADC_HandleTypeDef *hadc);
+
+/* ==================== I2C ==================== */
+
+#define I2C_MEMADD_SIZE_8BIT        0x00000001U
+
+typedef struct {
+    I2C_TypeDef *Instance;
+} I2C_HandleTypeDef;
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+
+/* ==================== 系统 ==================== */
+
+#define PWR_LOWPOWERREGULATOR_ON    0x00000001U
+#define PWR_STOPENTRY_WFI           ((uint8_t)0x01)
+
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t Delay);
+void HAL_SuspendTick(void);
+void HAL_ResumeTick(void);
+void HAL_PWR_EnterSTOPMode(uint32_t Regulator, uint8_t STOPEntry);
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority);
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn);
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn);
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init);
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin);
+void Error_Handler(void);
+
+/* ==================== 仿真控制（hal_stub.c） ==================== */
+
+typedef void (*host_isr_t)(void);
+
+void host_init(void);
+uint64_t host_cycles(void);
+void host_advance(uint64_t cycles);
+void host_raise_irq(host_isr_t isr);
+uint32_t host_isr_count(host_isr_t isr);
+
+// 测试程序可重写（弱定义）：下一个外部事件时刻、到期事件处理、STOP模式唤醒判断
+uint64_t host_event_next(void);
+void host_event_poll(uint64_t now);
+
+#endif /* __MAIN_H */
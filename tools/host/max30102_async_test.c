@@ -0,0 +1,214 @@
+/**
+  ******************************************************************************
+  * @file           : max30102_async_test.c
+  * @brief          : MAX30102异步I2C引擎的超时恢复与CPU占用测试（主机测试）
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-20
+  ******************************************************************************
+  * @attention
+  *
+  * 直接包含固件max30102.c以检查引擎内部状态，对接引脚级从机模型：
+  * 1. 排空一次17个样本的FIFO（INT_STATUS 2字节 + 指针3字节 + 数据102字节），
+  *    对比阻塞位操作（MAX30102_I2C_Start/Send_Byte/Recv_Byte/Stop，全程占用CPU）
+  *    与TIM1节拍引擎（只在节拍中断中占用CPU）的耗时和CPU占用。
+  *    节拍中断的周期数无法在主机上测得，按参数估算（默认150周期：
+  *    异常进出约24周期 + HAL_TIM_IRQHandler标志检查 + 引擎状态机）；
+  * 2. 排空事务进行到字节中途时停住TIM1中断，再发起阻塞寄存器读：
+  *    等待超时后排队事务须全部以失败状态回调（fifo_async_busy释放），
+  *    总线恢复后寄存器读写和FIFO排空继续正常进行。
+  * 全程（阻塞基准除外）检查快速模式时序。
+  *
+  * 编译运行（仓库根目录）：
+  *   gcc -O2 -Itools/host -IAPP tools/host/max30102_async_test.c tools/host/max30102_sim.c \
+  *       tools/host/hal_stub.c APP/scheduler.c APP/ppg_filter.c -lm -o max30102_async_test
+  *   ./max30102_async_test [每次节拍中断周期数]
+  *
+  ******************************************************************************
+  */
+
+#include "max30102.c"
+#include "max30102_sim.h"
+#include <stdlib.h>
+
+static const uint32_t stall_us[] = { 40, 330 };
+
+static uint32_t tick_count;
+static uint32_t failures;
+
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
+{
+    tick_count++;
+    MAX30102_TIM_PeriodElapsedCallback(htim);
+}
+
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+    MAX30102_EXTI_Callback(GPIO_Pin);
+}
+
+static void expect(int cond, const char *what)
+{
+    if (!cond) {
+        printf("FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+static void wait_pending(uint32_t n)
+{
+    while (MAX30102_Sim_Pending() < n) {
+        host_advance(HOST_CPU_HZ / 10000U);
+    }
+}
+
+/**
+ * @brief 阻塞位操作读寄存器（基准）
+ */
+static uint8_t blocking_read(uint8_t reg, uint8_t *buf, uint32_t len)
+{
+    uint32_t i;
+
+    MAX30102_I2C_Start();
+    if (MAX30102_I2C_Send_Byte(MAX30102_I2C_ADDR) || MAX30102_I2C_Send_Byte(reg)) {
+        MAX30102_I2C_Stop();
+        return 1;
+    }
+    MAX30102_I2C_Start();
+    if (MAX30102_I2C_Send_Byte(MAX30102_I2C_ADDR | 0x01)) {
+        MAX30102_I2C_Stop();
+        return 1;
+    }
+    for (i = 0; i < len; i++) {
+        buf[i] = MAX30102_I2C_Recv_Byte(i + 1 == len);
+    }
+    MAX30102_I2C_Stop();
+
+    return 0;
+}
+
+/**
+ * @brief 阻塞方式排空FIFO
+ * @retval 样本数
+ */
+static uint32_t drain_blocking(void)
+{
+    uint32_t pending;
+
+    blocking_read(MAX30102_INT_STATUS_1, int_status_raw, 2);
+    blocking_read(MAX30102_FIFO_WR_PTR, fifo_ptr_raw, 3);
+    pending = MAX30102_FIFO_Pending(fifo_ptr_raw);
+    if (pending > 0) {
+        blocking_read(MAX30102_FIFO_DATA, fifo_raw, pending * MAX30102_FIFO_SAMPLE_BYTES);
+    }
+    return pending;
+}
+
+/**
+ * @brief 按max30102_task的方式启动异步排空（中断状态 -> 指针 -> 数据）
+ */
+static void drain_async_start(void)
+{
+    fifo_async_busy = true;
+    fifo_raw_count = 0;
+    if (MAX30102_I2C_Async_Read(MAX30102_INT_STATUS_1, int_status_raw, 2,
+                                MAX30102_Int_Status_Callback, NULL)) {
+        fifo_async_busy = false;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t isr_cycles = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : 150U;
+    uint64_t t0, block_cycles, async_cycles;
+    uint32_t ticks, block_n, async_n, errors;
+    uint32_t popped;
+    uint8_t id = 0;
+    uint8_t ret;
+    uint32_t i;
+
+    host_init();
+    MAX30102_Sim_Init(100);
+    expect(MAX30102_Init() == 0, "MAX30102_Init");
+
+    /* ---------- 1. CPU占用 ---------- */
+
+    wait_pending(17);
+    errors = max30102_sim.timing_errors;
+    t0 = host_cycles();
+    block_n = drain_blocking();
+    block_cycles = host_cycles() - t0;
+    max30102_sim.timing_errors = errors;    // 阻塞基准只作耗时参考
+    max30102_sim.first_error[0] = '\0';
+    max30102_sim.min_tlow_us = 0;
+    max30102_sim.min_thigh_us = 0;
+
+    wait_pending(17);
+    t0 = host_cycles();
+    ticks = tick_count;
+    drain_async_start();
+    while (fifo_async_busy) {
+        host_advance(HOST_POLL_CYCLES);     // 主循环可做其他工作
+    }
+    async_cycles = host_cycles() - t0;
+    ticks = tick_count - ticks;
+    async_n = fifo_raw_count;
+    fifo_raw_ready = false;
+
+    expect(block_n == 17 && async_n == 17, "both drains read the 17 pending samples");
+
+    printf("drain of %u samples        wall(us)   CPU(us)  CPU(%%)\n", (unsigned)async_n);
+    printf("  blocking bit-bang      %8.1f  %8.1f   %5.1f\n",
+           block_cycles / 168.0, block_cycles / 168.0, 100.0);
+    printf("  TIM1 tick engine       %8.1f  %8.1f   %5.1f   (%u ticks x %u cycles)\n",
+           async_cycles / 168.0, (double)ticks * isr_cycles / 168.0,
+           100.0 * ticks * isr_cycles / (double)async_cycles, (unsigned)ticks, (unsigned)isr_cycles);
+    printf("  CPU reclaimed vs blocking: %.1f%%\n",
+           100.0 * (1.0 - (double)ticks * isr_cycles / (double)block_cycles));
+
+    /* ---------- 2. 超时恢复 ---------- */
+
+    // 分别停在地址字节（主机发送）和INT_STATUS数据字节（从机发送）中途
+    for (i = 0; i < sizeof(stall_us) / sizeof(stall_us[0]); i++) {
+        wait_pending(1);
+        drain_async_start();
+        host_advance((uint64_t)HOST_CPU_HZ / 1000000U * stall_us[i]);
+        htim1.Instance->DIER &= ~TIM_IT_UPDATE;         // TIM1中断停住
+
+        t0 = host_cycles();
+        ret = MAX30102_Read_Reg(MAX30102_PART_ID, &id);
+        printf("stall at %3uus: ret=%u after %.1f ms, queue=%u, fifo_async_busy=%d",
+               (unsigned)stall_us[i], ret, (host_cycles() - t0) * 1000.0 / HOST_CPU_HZ,
+               i2c_queue_count, fifo_async_busy);
+        expect(ret == 1, "stalled read times out");
+        expect(i2c_queue_count == 0, "queue emptied");
+        expect(!fifo_async_busy, "drain in flight completed with failure (fifo_async_busy released)");
+
+        id = 0;
+        ret = MAX30102_Read_Reg(MAX30102_PART_ID, &id);
+        printf(", next read ret=%u id=0x%02X\n", ret, id);
+        expect(ret == 0 && id == 0x15, "bus usable after timeout");
+    }
+
+    // 1秒正常采集（任务20ms轮询）
+    popped = max30102_sim.popped;
+    for (i = 0; i < 50; i++) {
+        max30102_task();
+        HAL_Delay(20);
+    }
+    popped = max30102_sim.popped - popped;
+    printf("acquisition after recovery: %u samples in 1 s, %u lost\n",
+           (unsigned)popped, (unsigned)max30102_sim.lost);
+    expect(popped >= 90, "acquisition resumes");
+
+    // 字节中途的STOP来自停住后的总线恢复
+    printf("bus: %u transactions, min tLOW %.2fus, min tHIGH %.2fus, %u timing errors, %u mid-byte STOP/START\n",
+           (unsigned)max30102_sim.transactions, max30102_sim.min_tlow_us, max30102_sim.min_thigh_us,
+           (unsigned)max30102_sim.timing_errors, (unsigned)max30102_sim.glitches);
+    if (max30102_sim.first_error[0] != '\0') {
+        printf("first error: %s\n", max30102_sim.first_error);
+    }
+    expect(max30102_sim.timing_errors == 0, "bus timing");
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
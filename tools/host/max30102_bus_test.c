@@ -0,0 +1,155 @@
+/**
+  ******************************************************************************
+  * @file           : max30102_bus_test.c
+  * @brief          : MAX30102逐样本读取与突发读取的总线字节数对比（主机测试）
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-20
+  ******************************************************************************
+  * @attention
+  *
+  * 固件max30102.c（异步软件I2C引擎 + 阻塞封装）驱动引脚级从机模型，
+  * 模型按100Hz产生样本。对比两种读法取走FIFO中同一批样本的代价：
+  * - MAX30102_Read_FIFO_Multi(100)：每样本一次6字节事务，不看读写指针，
+  *   FIFO读空后继续读到的是旧数据（模型计为stale）；
+  * - MAX30102_Read_FIFO_Burst：先读3个指针寄存器，再一次读出全部待读样本。
+  * 同时核对模型解码出的字节数与驱动计数一致、读出样本序号连续、
+  * 全程无快速模式时序违例。
+  *
+  * 编译运行（仓库根目录）：
+  *   gcc -O2 -Itools/host -IAPP tools/host/max30102_bus_test.c tools/host/max30102_sim.c \
+  *       tools/host/hal_stub.c APP/max30102.c APP/scheduler.c APP/ppg_filter.c -lm \
+  *       -o max30102_bus_test
+  *   ./max30102_bus_test
+  *
+  ******************************************************************************
+  */
+
+#include "max30102.h"
+#include "max30102_sim.h"
+#include "tim.h"
+#include <stdio.h>
+#include <string.h>
+
+static MAX30102_Data_t data;
+static uint32_t failures;
+
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
+{
+    MAX30102_TIM_PeriodElapsedCallback(htim);
+}
+
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+    MAX30102_EXTI_Callback(GPIO_Pin);
+}
+
+static void expect(int cond, const char *what)
+{
+    if (!cond) {
+        printf("FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+/**
+ * @brief 检查缓冲区内样本为模型连续序号
+ */
+static uint32_t check_sequence(const MAX30102_Data_t *d, uint32_t count)
+{
+    uint32_t first = d->red_buffer[0];
+    uint32_t i;
+
+    for (i = 0; i < count; i++) {
+        if (d->red_buffer[i] != MAX30102_Sim_Red(first + i) ||
+            d->ir_buffer[i] != MAX30102_Sim_IR(first + i)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+typedef struct {
+    uint32_t bus_bytes;     // 驱动计数
+    uint32_t wire_bytes;    // 模型解码
+    uint32_t popped;        // 弹出的新样本
+    uint32_t stale;         // 读到的旧样本
+    uint32_t returned;      // 函数返回样本数
+    double ms;              // 耗时
+} Run_t;
+
+static void run_begin(Run_t *r)
+{
+    r->bus_bytes = MAX30102_Get_Bus_Bytes();
+    r->wire_bytes = max30102_sim.bytes;
+    r->popped = max30102_sim.popped;
+    r->stale = max30102_sim.stale_reads;
+    r->ms = (double)host_cycles();
+}
+
+static void run_end(Run_t *r, uint32_t returned)
+{
+    r->bus_bytes = MAX30102_Get_Bus_Bytes() - r->bus_bytes;
+    r->wire_bytes = max30102_sim.bytes - r->wire_bytes;
+    r->popped = max30102_sim.popped - r->popped;
+    r->stale = max30102_sim.stale_reads - r->stale;
+    r->returned = returned;
+    r->ms = ((double)host_cycles() - r->ms) * 1000.0 / HOST_CPU_HZ;
+}
+
+static void run_print(const char *name, const Run_t *r)
+{
+    printf("%-22s %9u %9u %9u %9u %11.2f %9.1f\n", name,
+           (unsigned)r->returned, (unsigned)r->popped, (unsigned)r->stale,
+           (unsigned)r->bus_bytes, r->popped ? (double)r->bus_bytes / r->popped : 0.0, r->ms);
+}
+
+int main(void)
+{
+    Run_t multi, burst;
+    uint32_t pending;
+
+    host_init();
+    MAX30102_Sim_Init(100);
+
+    expect(MAX30102_Init() == 0, "MAX30102_Init");
+    expect(max30102_sim.regs[MAX30102_FIFO_CONFIG] == MAX30102_FIFO_A_FULL, "FIFO_CONFIG");
+    expect(max30102_sim.regs[MAX30102_MODE_CONFIG] == MAX30102_MODE_SPO2, "MODE_CONFIG");
+    expect(max30102_sim.regs[MAX30102_SPO2_CONFIG] == 0x27, "SPO2_CONFIG");
+    expect(max30102_sim.regs[MAX30102_LED1_PA] == 0x3F && max30102_sim.regs[MAX30102_LED2_PA] == 0x3F, "LED_PA");
+
+    // 逐样本读取：先积累约200ms样本
+    HAL_Delay(200);
+    pending = MAX30102_Sim_Pending();
+    memset(&data, 0, sizeof(data));
+    run_begin(&multi);
+    run_end(&multi, MAX30102_Read_FIFO_Multi(&data, MAX30102_BUFFER_SIZE));
+    expect(multi.bus_bytes == multi.wire_bytes, "multi: driver byte count matches the wire");
+    expect(multi.popped >= pending, "multi: every pending sample read");
+
+    // 突发读取：积累到A_FULL门限附近
+    HAL_Delay(170);
+    pending = MAX30102_Sim_Pending();
+    memset(&data, 0, sizeof(data));
+    run_begin(&burst);
+    run_end(&burst, MAX30102_Read_FIFO_Burst(&data));
+    expect(burst.bus_bytes == burst.wire_bytes, "burst: driver byte count matches the wire");
+    expect(burst.returned == pending && burst.popped == pending, "burst: exactly the pending samples");
+    expect(burst.stale == 0, "burst: no stale reads");
+    expect(check_sequence(&data, burst.returned), "burst: consecutive sample sequence");
+    expect(burst.bus_bytes == (3 + 3) + (3 + 6 * pending), "burst: (3 + 3) + (3 + 6N) bytes");
+
+    printf("%-22s %9s %9s %9s %9s %11s %9s\n", "", "returned", "new", "stale", "bytes", "bytes/new", "ms");
+    run_print("Read_FIFO_Multi(100)", &multi);
+    run_print("Read_FIFO_Burst", &burst);
+    printf("bus: %u transactions, min tLOW %.2fus, min tHIGH %.2fus, %u timing errors, %u glitches\n",
+           (unsigned)max30102_sim.transactions, max30102_sim.min_tlow_us, max30102_sim.min_thigh_us,
+           (unsigned)max30102_sim.timing_errors, (unsigned)max30102_sim.glitches);
+    if (max30102_sim.first_error[0] != '\0') {
+        printf("first error: %s\n", max30102_sim.first_error);
+    }
+
+    expect(max30102_sim.timing_errors == 0 && max30102_sim.glitches == 0, "bus timing");
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,147 @@
+/**
+  ******************************************************************************
+  * @file           : max30102_irq_test.c
+  * @brief          : INT中断唤醒的max30102_task在100/200/400Hz下的无丢样测试（主机测试）
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-20
+  ******************************************************************************
+  * @attention
+  *
+  * 直接包含固件max30102.c，与固件scheduler.c和引脚级从机模型一起运行：
+  * max30102_task按main.c登记为事件任务，只由INT下降沿（MAX30102_EXTI_Callback）
+  * 和异步排空完成（MAX30102_Drain_Done）唤醒，主循环为scheduler_run + scheduler_idle。
+  * 模型按100/200/400Hz产生样本（与固件SR配置无关，考察排空能力），两种负载：
+  * - idle：只有本任务，没有周期任务时调度器进入STOP，由INT唤醒；
+  * - busy：另有100ms周期任务每次阻塞若干毫秒（模拟ESP01S同步收发等）。
+  * 每种组合运行10秒，要求：模型FIFO不溢出（FIFO_OVF_CNT为0）、不读空、
+  * 读出样本全部送入流式估计器、总线时序无违例。
+  * 另报告INT边沿数和FIFO最高占用。
+  *
+  * 编译运行（仓库根目录）：
+  *   gcc -O2 -Itools/host -IAPP tools/host/max30102_irq_test.c tools/host/max30102_sim.c \
+  *       tools/host/hal_stub.c APP/scheduler.c APP/ppg_filter.c -lm -o max30102_irq_test
+  *   ./max30102_irq_test [busy负载每次阻塞毫秒数]
+  *
+  ******************************************************************************
+  */
+
+#include "max30102.c"
+#include "max30102_sim.h"
+#include <stdlib.h>
+
+#define RUN_SECONDS     10
+#define BUSY_PERIOD_MS  100
+
+static const uint32_t rates[] = { 100, 200, 400 };
+
+static uint32_t busy_ms;
+static uint32_t max_fill;
+static uint32_t failures;
+
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
+{
+    MAX30102_TIM_PeriodElapsedCallback(htim);
+}
+
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+    uint32_t fill = MAX30102_Sim_Pending();
+
+    if (fill > max_fill) {
+        max_fill = fill;
+    }
+    MAX30102_EXTI_Callback(GPIO_Pin);
+}
+
+// 同main.c
+uint8_t scheduler_stop_allowed(void)
+{
+    return !MAX30102_I2C_Async_Busy();
+}
+
+static void busy_task(void)
+{
+    HAL_Delay(busy_ms);
+}
+
+static void expect(int cond, const char *what)
+{
+    if (!cond) {
+        printf("FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+/**
+ * @brief 按main.c的方式运行一种组合
+ * @param with_busy: 是否加入阻塞型周期任务
+ */
+static void run(uint32_t rate, int with_busy)
+{
+    uint64_t start, end;
+    uint32_t processed;
+
+    host_init();
+    MAX30102_Sim_Init(rate);
+    scheduler_init();
+    max_fill = 0;
+
+    expect(MAX30102_Init() == 0, "MAX30102_Init");
+    fifo_async_busy = false;
+    fifo_raw_ready = false;
+    scheduler_add_event_task(max30102_task);
+    scheduler_notify(max30102_task);
+    if (with_busy) {
+        scheduler_add_task(busy_task, BUSY_PERIOD_MS);
+    }
+
+    start = host_cycles();
+    end = start + (uint64_t)RUN_SECONDS * HOST_CPU_HZ;
+    while (host_cycles() < end) {
+        scheduler_run();
+        scheduler_idle();
+    }
+
+    // 收尾：处理完在途的排空
+    while (fifo_async_busy || fifo_raw_ready) {
+        scheduler_run();
+        host_advance(HOST_POLL_CYCLES);
+    }
+
+    processed = max30102_stream.sample_index;
+
+    printf("%4uHz %-5s %6u %6u %6u %5u %4u %6u    %2u/32\n",
+           (unsigned)rate, with_busy ? "busy" : "idle",
+           (unsigned)max30102_sim.generated, (unsigned)max30102_sim.popped, (unsigned)processed,
+           (unsigned)(max30102_sim.lost + MAX30102_Get_Overflow_Count()),
+           (unsigned)max30102_sim.stale_reads, (unsigned)max30102_sim.int_edges,
+           (unsigned)max_fill);
+
+    expect(max30102_sim.lost == 0 && MAX30102_Get_Overflow_Count() == 0, "no FIFO overflow");
+    expect(max30102_sim.stale_reads == 0, "no reads from an empty FIFO");
+    expect(processed == max30102_sim.popped, "every popped sample reaches the stream estimator");
+    expect(max30102_sim.popped + MAX30102_Sim_Pending() == max30102_sim.generated, "sample accounting");
+    expect(max30102_sim.timing_errors == 0, "bus timing");
+    if (max30102_sim.first_error[0] != '\0') {
+        printf("  first error: %s\n", max30102_sim.first_error);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t i;
+
+    busy_ms = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : 30U;
+
+    printf("max30102_task as event task, %u s per run, busy = %u ms blocking every %u ms\n",
+           (unsigned)RUN_SECONDS, (unsigned)busy_ms, (unsigned)BUSY_PERIOD_MS);
+    printf(" rate  load   gen  popped  proc  lost stale  edges  max fill\n");
+
+    for (i = 0; i < sizeof(rates) / sizeof(rates[0]); i++) {
+        run(rates[i], 0);
+        run(rates[i], 1);
+    }
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
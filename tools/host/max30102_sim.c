@@ -0,0 +1,546 @@
+/**
+  ******************************************************************************
+  * @file           : max30102_sim.c
+  * @brief          : MAX30102引脚级从机模型（主机测试用）
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-20
+  ******************************************************************************
+  * @attention
+  *
+  * 重写HAL_GPIO_WritePin/ReadPin/Init和host_event_next/poll，
+  * 与hal_stub.c及固件max30102.c一起链接，见max30102_sim.h。
+  * 时序限值取MAX30102数据手册的快速模式（400kHz）参数。
+  *
+  ******************************************************************************
+  */
+
+#include "max30102_sim.h"
+#include "max30102.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+
+/* ==================== 参数 ==================== */
+
+#define SIM_ADDR            0x57
+#define SIM_CYC_PER_US      (HOST_CPU_HZ / 1000000U)
+
+// 快速模式时序限值（ns）
+#define SIM_T_LOW_NS        1300
+#define SIM_T_HIGH_NS       600
+#define SIM_T_SU_STA_NS     600
+#define SIM_T_HD_STA_NS     600
+#define SIM_T_SU_STO_NS     600
+#define SIM_T_BUF_NS        1300
+#define SIM_T_SU_DAT_NS     100
+
+#define NS_TO_CYC(ns)       ((uint64_t)(ns) * HOST_CPU_HZ / 1000000000U)
+
+typedef enum {
+    SIM_IDLE = 0,   // 等待START
+    SIM_RX,         // 接收主机字节
+    SIM_ACK_TX,     // 从机应答
+    SIM_TX,         // 发送字节
+    SIM_ACK_RX,     // 等待主机应答
+    SIM_WAIT        // 地址不匹配或主机NACK，等待STOP/START
+} Sim_State_t;
+
+/* ==================== 模型状态 ==================== */
+
+MAX30102_Sim_t max30102_sim;
+
+static uint8_t m_sda = 1, m_scl = 1;    // 主机输出（1=释放）
+static uint8_t s_sda = 1;               // 从机输出
+static uint8_t line_sda = 1, line_scl = 1;
+static uint8_t int_low;
+static uint8_t exti_enabled;
+
+static Sim_State_t state;
+static uint8_t bits;
+static uint8_t shift;
+static uint8_t byte_index;              // 事务内字节序号（0: 地址）
+static uint8_t reg_ptr;
+static uint8_t master_ack;
+static uint8_t fifo_byte;               // 当前样本已读字节数
+
+static uint64_t t_scl_rise, t_scl_fall, t_sda_change, t_start, t_stop;
+static uint8_t start_since_rise;
+static uint8_t bus_started;
+
+static uint32_t fifo_red[MAX30102_FIFO_DEPTH];
+static uint32_t fifo_ir[MAX30102_FIFO_DEPTH];
+static uint32_t fifo_count;
+static uint32_t seq;
+static uint64_t next_sample;
+
+/* ==================== 工具 ==================== */
+
+static void sim_error(uint32_t *counter, const char *fmt, ...)
+{
+    (*counter)++;
+    if (max30102_sim.first_error[0] == '\0') {
+        va_list ap;
+
+        va_start(ap, fmt);
+        vsnprintf(max30102_sim.first_error, sizeof(max30102_sim.first_error), fmt, ap);
+        va_end(ap);
+    }
+}
+
+static void check_min(uint64_t dt, uint32_t min_ns, const char *name)
+{
+    if (dt < NS_TO_CYC(min_ns)) {
+        sim_error(&max30102_sim.timing_errors, "%s %.2fus < %.2fus @%.1fus", name,
+                  (double)dt / SIM_CYC_PER_US, min_ns / 1000.0,
+                  (double)host_cycles() / SIM_CYC_PER_US);
+    }
+}
+
+uint32_t MAX30102_Sim_Red(uint32_t n)
+{
+    return n & 0x3FFFF;
+}
+
+uint32_t MAX30102_Sim_IR(uint32_t n)
+{
+    return (n * 3U + 1U) & 0x3FFFF;
+}
+
+uint32_t MAX30102_Sim_Pending(void)
+{
+    return fifo_count;
+}
+
+/* ==================== INT引脚 ==================== */
+
+static void exti_isr(void)
+{
+    HAL_GPIO_EXTI_Callback(MAX30102_INT_PIN);
+}
+
+static void update_int(void)
+{
+    uint8_t *r = max30102_sim.regs;
+    uint8_t low = ((r[MAX30102_INT_STATUS_1] & (r[MAX30102_INT_ENABLE_1] | MAX30102_INT_PWR_RDY)) != 0) ||
+                  ((r[MAX30102_INT_STATUS_2] & r[MAX30102_INT_ENABLE_2]) != 0);
+
+    if (low) {
+        MAX30102_INT_GPIO_PORT->IDR &= ~(uint32_t)MAX30102_INT_PIN;
+    } else {
+        MAX30102_INT_GPIO_PORT->IDR |= MAX30102_INT_PIN;
+    }
+
+    if (low && !int_low) {
+        max30102_sim.int_edges++;
+        if (exti_enabled) {
+            host_raise_irq(exti_isr);
+        }
+    }
+    int_low = low;
+}
+
+/* ==================== 寄存器与FIFO ==================== */
+
+static void fifo_sync_ptr(void)
+{
+    fifo_count = (uint32_t)(max30102_sim.regs[MAX30102_FIFO_WR_PTR] -
+                            max30102_sim.regs[MAX30102_FIFO_RD_PTR]) & (MAX30102_FIFO_DEPTH - 1);
+}
+
+static void reg_reset(void)
+{
+    memset(max30102_sim.regs, 0, sizeof(max30102_sim.regs));
+    max30102_sim.regs[MAX30102_INT_STATUS_1] = MAX30102_INT_PWR_RDY;
+    max30102_sim.regs[MAX30102_REV_ID] = 0x03;
+    max30102_sim.regs[MAX30102_PART_ID] = 0x15;
+    fifo_count = 0;
+    update_int();
+}
+
+static uint8_t sampling(void)
+{
+    uint8_t mode = max30102_sim.regs[MAX30102_MODE_CONFIG];
+
+    return !(mode & 0x80) && ((mode & 0x07) == MAX30102_MODE_HR_ONLY ||
+                              (mode & 0x07) == MAX30102_MODE_SPO2);
+}
+
+static void reg_write(uint8_t reg, uint8_t val)
+{
+    uint8_t *r = max30102_sim.regs;
+
+    switch (reg) {
+        case MAX30102_INT_STATUS_1:
+        case MAX30102_INT_STATUS_2:
+        case MAX30102_REV_ID:
+        case MAX30102_PART_ID:
+            return;     // 只读
+
+        case MAX30102_MODE_CONFIG:
+            if (val & 0x40) {
+                reg_reset();    // 复位位自动清零
+                return;
+            }
+            if (!sampling() && ((val & 0x07) == MAX30102_MODE_HR_ONLY || (val & 0x07) == MAX30102_MODE_SPO2)) {
+                next_sample = host_cycles() + HOST_CPU_HZ / max30102_sim.rate_hz;
+            }
+            r[reg] = val;
+            return;
+
+        case MAX30102_FIFO_WR_PTR:
+        case MAX30102_FIFO_OVF_CNT:
+        case MAX30102_FIFO_RD_PTR:
+            r[reg] = val & 0x1F;
+            fifo_sync_ptr();
+            return;
+
+        default:
+            r[reg] = val;
+            if (reg == MAX30102_INT_ENABLE_1 || reg == MAX30102_INT_ENABLE_2) {
+                update_int();
+            }
+            return;
+    }
+}
+
+static uint8_t reg_read(uint8_t reg)
+{
+    uint8_t *r = max30102_sim.regs;
+    uint8_t val;
+
+    if (reg == MAX30102_FIFO_DATA) {
+        uint32_t rd = r[MAX30102_FIFO_RD_PTR];
+        uint32_t word = (fifo_byte < 3) ? fifo_red[rd] : fifo_ir[rd];
+        uint32_t sh = (2U - (fifo_byte % 3U)) * 8U;
+
+        // 读FIFO_DATA清除A_FULL/PPG_RDY
+        if (r[MAX30102_INT_STATUS_1] & (MAX30102_INT_A_FULL | MAX30102_INT_PPG_RDY)) {
+            r[MAX30102_INT_STATUS_1] &= ~(MAX30102_INT_A_FULL | MAX30102_INT_PPG_RDY);
+            update_int();
+        }
+
+        val = (uint8_t)(word >> sh);
+
+        if (++fifo_byte == MAX30102_FIFO_SAMPLE_BYTES) {
+            fifo_byte = 0;
+            if (fifo_count > 0) {
+                // 弹出一个完整样本，溢出计数清零
+                r[MAX30102_FIFO_RD_PTR] = (uint8_t)((rd + 1U) & (MAX30102_FIFO_DEPTH - 1));
+                r[MAX30102_FIFO_OVF_CNT] = 0;
+                fifo_count--;
+                max30102_sim.popped++;
+            } else {
+                max30102_sim.stale_reads++;
+            }
+        }
+        return val;
+    }
+
+    val = r[reg];
+
+    if (reg == MAX30102_INT_STATUS_1 || reg == MAX30102_INT_STATUS_2) {
+        r[reg] = 0;     // 读清除
+        update_int();
+    }
+
+    return val;
+}
+
+static void sample_push(void)
+{
+    uint8_t *r = max30102_sim.regs;
+    uint32_t threshold = MAX30102_FIFO_DEPTH - (r[MAX30102_FIFO_CONFIG] & 0x0F);
+    uint32_t before = fifo_count;
+
+    max30102_sim.generated++;
+
+    if (fifo_count >= MAX30102_FIFO_DEPTH && !(r[MAX30102_FIFO_CONFIG] & 0x10)) {
+        // 不覆盖：新样本丢弃
+        if (r[MAX30102_FIFO_OVF_CNT] < 0x1F) {
+            r[MAX30102_FIFO_OVF_CNT]++;
+        }
+        max30102_sim.lost++;
+    } else {
+        uint32_t wr = r[MAX30102_FIFO_WR_PTR];
+
+        fifo_red[wr] = MAX30102_Sim_Red(seq);
+        fifo_ir[wr] = MAX30102_Sim_IR(seq);
+        r[MAX30102_FIFO_WR_PTR] = (uint8_t)((wr + 1U) & (MAX30102_FIFO_DEPTH - 1));
+        if (fifo_count < MAX30102_FIFO_DEPTH) {
+            fifo_count++;
+        } else {
+            // 覆盖模式：丢弃最旧样本
+            r[MAX30102_FIFO_RD_PTR] = r[MAX30102_FIFO_WR_PTR];
+            max30102_sim.lost++;
+        }
+    }
+    seq++;
+
+    r[MAX30102_INT_STATUS_1] |= MAX30102_INT_PPG_RDY;
+    if (before < threshold && fifo_count >= threshold) {
+        r[MAX30102_INT_STATUS_1] |= MAX30102_INT_A_FULL;
+    }
+    update_int();
+}
+
+/* ==================== 协议状态机 ==================== */
+
+static void byte_received(uint8_t b)
+{
+    max30102_sim.bytes++;
+
+    if (byte_index == 0) {
+        if ((b >> 1) != SIM_ADDR) {
+            state = SIM_WAIT;
+            return;
+        }
+        fifo_byte = 0;
+    } else if (byte_index == 1) {
+        reg_ptr = b;
+    } else {
+        reg_write(reg_ptr, b);
+        if (reg_ptr != MAX30102_FIFO_DATA) {
+            reg_ptr++;
+        }
+    }
+
+    byte_index++;
+    state = SIM_ACK_TX;
+    s_sda = 0;
+}
+
+static void load_tx_byte(void)
+{
+    shift = reg_read(reg_ptr);
+    if (reg_ptr != MAX30102_FIFO_DATA) {
+        reg_ptr++;
+    }
+    bits = 0;
+    state = SIM_TX;
+    s_sda = (shift >> 7) & 1U;
+}
+
+static void on_scl_rise(void)
+{
+    uint64_t now = host_cycles();
+
+    if (bus_started) {
+        check_min(now - t_scl_fall, SIM_T_LOW_NS, "tLOW");
+        if (t_sda_change > t_scl_fall) {
+            check_min(now - t_sda_change, SIM_T_SU_DAT_NS, "tSU;DAT");
+        }
+        if (max30102_sim.min_tlow_us == 0 || (double)(now - t_scl_fall) / SIM_CYC_PER_US < max30102_sim.min_tlow_us) {
+            max30102_sim.min_tlow_us = (double)(now - t_scl_fall) / SIM_CYC_PER_US;
+        }
+    }
+    t_scl_rise = now;
+    start_since_rise = 0;
+
+    switch (state) {
+        case SIM_RX:
+            shift = (uint8_t)((shift << 1) | line_sda);
+            bits++;
+            break;
+
+        case SIM_ACK_RX:
+            master_ack = line_sda;
+            break;
+
+        default:
+            break;
+    }
+}
+
+static void on_scl_fall(void)
+{
+    uint64_t now = host_cycles();
+
+    if (bus_started) {
+        check_min(now - t_scl_rise, SIM_T_HIGH_NS, "tHIGH");
+        if (start_since_rise) {
+            check_min(now - t_start, SIM_T_HD_STA_NS, "tHD;STA");
+        }
+        if (max30102_sim.min_thigh_us == 0 || (double)(now - t_scl_rise) / SIM_CYC_PER_US < max30102_sim.min_thigh_us) {
+            max30102_sim.min_thigh_us = (double)(now - t_scl_rise) / SIM_CYC_PER_US;
+        }
+    }
+    t_scl_fall = now;
+
+    switch (state) {
+        case SIM_RX:
+            if (bits == 8) {
+                byte_received(shift);
+                bits = 0;
+            }
+            break;
+
+        case SIM_ACK_TX:
+            s_sda = 1;
+            if (byte_index == 1 && (shift & 0x01)) {
+                load_tx_byte();     // 读地址之后由从机发送
+            } else {
+                state = SIM_RX;
+                bits = 0;
+            }
+            break;
+
+        case SIM_TX:
+            if (++bits < 8) {
+                s_sda = (shift >> (7 - bits)) & 1U;
+            } else {
+                s_sda = 1;
+                state = SIM_ACK_RX;
+            }
+            break;
+
+        case SIM_ACK_RX:
+            max30102_sim.bytes++;
+            if (master_ack == 0) {
+                load_tx_byte();
+            } else {
+                state = SIM_WAIT;
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+static void on_start(void)
+{
+    uint64_t now = host_cycles();
+
+    // 字节第一位的SCL高电平期间出现START/STOP属正常（此时bits为1）
+    if ((state == SIM_RX && bits > 1) || state == SIM_TX || state == SIM_ACK_TX) {
+        sim_error(&max30102_sim.glitches, "START inside a byte @%.1fus", (double)now / SIM_CYC_PER_US);
+    }
+    if (bus_started) {
+        check_min(now - t_scl_rise, SIM_T_SU_STA_NS, "tSU;STA");
+    }
+    if (state == SIM_IDLE && t_stop != 0) {
+        check_min(now - t_stop, SIM_T_BUF_NS, "tBUF");
+    }
+
+    bus_started = 1;
+    max30102_sim.starts++;
+    t_start = now;
+    start_since_rise = 1;
+    state = SIM_RX;
+    bits = 0;
+    byte_index = 0;
+}
+
+static void on_stop(void)
+{
+    uint64_t now = host_cycles();
+
+    if ((state == SIM_RX && bits > 1) || state == SIM_TX || state == SIM_ACK_TX) {
+        sim_error(&max30102_sim.glitches, "STOP inside a byte @%.1fus", (double)now / SIM_CYC_PER_US);
+    }
+    check_min(now - t_scl_rise, SIM_T_SU_STO_NS, "tSU;STO");
+
+    max30102_sim.transactions++;
+    t_stop = now;
+    bus_started = 0;
+    state = SIM_IDLE;
+    s_sda = 1;
+}
+
+/**
+ * @brief 主机改变引脚后重新计算线电平并处理边沿
+ */
+static void bus_update(void)
+{
+    uint8_t scl = m_scl;
+    uint8_t sda;
+
+    if (scl != line_scl) {
+        line_scl = scl;
+        if (scl) {
+            on_scl_rise();
+        } else {
+            on_scl_fall();  // 从机可能在此改变SDA
+        }
+    }
+
+    sda = m_sda & s_sda;
+    if (sda != line_sda) {
+        line_sda = sda;
+        t_sda_change = host_cycles();
+        if (line_scl) {
+            if (sda) {
+                on_stop();
+            } else {
+                on_start();
+            }
+        }
+    }
+
+    if (line_sda) {
+        GPIOB->IDR |= GPIO_PIN_14;
+    } else {
+        GPIOB->IDR &= ~(uint32_t)GPIO_PIN_14;
+    }
+}
+
+/* ==================== HAL重写 ==================== */
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init)
+{
+    if (GPIOx == MAX30102_INT_GPIO_PORT && (GPIO_Init->Pin & MAX30102_INT_PIN) &&
+        GPIO_Init->Mode == GPIO_MODE_IT_FALLING) {
+        exti_enabled = 1;
+    }
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+    if (PinState == GPIO_PIN_SET) {
+        GPIOx->ODR |= GPIO_Pin;
+    } else {
+        GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+    }
+
+    if (GPIOx == GPIOB && (GPIO_Pin & (GPIO_PIN_14 | GPIO_PIN_15))) {
+        m_sda = (GPIOB->ODR & GPIO_PIN_14) ? 1 : 0;
+        m_scl = (GPIOB->ODR & GPIO_PIN_15) ? 1 : 0;
+        bus_update();
+    }
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+    return (GPIOx->IDR & GPIO_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+uint64_t host_event_next(void)
+{
+    return sampling() ? next_sample : UINT64_MAX;
+}
+
+void host_event_poll(uint64_t t)
+{
+    while (sampling() && next_sample <= t) {
+        sample_push();
+        next_sample += HOST_CPU_HZ / max30102_sim.rate_hz;
+    }
+}
+
+void MAX30102_Sim_Init(uint32_t rate_hz)
+{
+    memset(&max30102_sim, 0, sizeof(max30102_sim));
+    max30102_sim.rate_hz = rate_hz;
+
+    m_sda = m_scl = s_sda = 1;
+    line_sda = line_scl = 1;
+    int_low = 0;
+    exti_enabled = 0;
+    state = SIM_IDLE;
+    bus_started = 0;
+    t_stop = 0;
+    seq = 0;
+    GPIOB->IDR |= GPIO_PIN_14 | GPIO_PIN_15 | MAX30102_INT_PIN;
+    GPIOB->ODR |= GPIO_PIN_14 | GPIO_PIN_15;
+    reg_reset();
+}
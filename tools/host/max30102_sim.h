@@ -0,0 +1,65 @@
+/**
+  ******************************************************************************
+  * @file           : max30102_sim.h
+  * @brief          : MAX30102引脚级从机模型（主机测试用）
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-20
+  ******************************************************************************
+  * @attention
+  *
+  * 接管PB13(INT)/PB14(SDA)/PB15(SCL)三个引脚：
+  * - SDA为线与，按SCL/SDA边沿解码START/STOP、地址、寄存器和数据字节，
+  *   寄存器写入自动递增（FIFO_DATA除外），读FIFO_DATA每6字节弹出一个样本；
+  * - 按快速模式（400kHz）时序检查tLOW/tHIGH/tSU;STA/tHD;STA/tSU;STO/tBUF/tSU;DAT，
+  *   字节中途出现START/STOP（SCL高电平期间SDA变化）记为毛刺；
+  * - MODE_CONFIG进入SpO2模式后按设定速率产生样本：红光=序号，红外=序号x3+1
+  *   （18位截断），FIFO满时按FIFO_ROLLOVER_EN=0丢弃并累加OVF_CNT；
+  * - INT_STATUS_1的A_FULL/PPG_RDY按INT_ENABLE_1驱动INT引脚，
+  *   读INT_STATUS_1或FIFO_DATA清除，下降沿经HAL_GPIO_EXTI_Callback通知。
+  *
+  ******************************************************************************
+  */
+
+#ifndef __MAX30102_SIM_H
+#define __MAX30102_SIM_H
+
+#include "main.h"
+
+typedef struct {
+    uint32_t rate_hz;           // 样本产生速率
+    uint32_t generated;         // 已产生样本数
+    uint32_t lost;              // FIFO满丢弃的样本数
+    uint32_t popped;            // 主机读出的完整样本数
+    uint32_t stale_reads;       // FIFO为空时读FIFO_DATA的样本数（读到旧数据）
+    uint32_t bytes;             // 总线上传输的字节数（含地址/寄存器字节）
+    uint32_t starts;            // START与重复START次数
+    uint32_t transactions;      // STOP次数
+    uint32_t int_edges;         // INT下降沿次数
+    uint32_t timing_errors;     // 时序违例次数
+    uint32_t glitches;          // 字节中途的START/STOP
+    char first_error[96];       // 第一条时序/协议错误描述
+    double min_tlow_us;         // 实测最小SCL低电平时间
+    double min_thigh_us;        // 实测最小SCL高电平时间
+    uint8_t regs[256];          // 寄存器
+} MAX30102_Sim_t;
+
+extern MAX30102_Sim_t max30102_sim;
+
+/**
+ * @brief 复位模型
+ * @param rate_hz: 样本产生速率（与固件SR配置无关，用于考察排空能力）
+ */
+void MAX30102_Sim_Init(uint32_t rate_hz);
+
+/**
+ * @brief FIFO中待读样本数
+ */
+uint32_t MAX30102_Sim_Pending(void);
+
+/**
+ * @brief 由样本序号得到红光/红外值（与模型产生的数据一致）
+ */
+uint32_t MAX30102_Sim_Red(uint32_t seq);
+uint32_t MAX30102_Sim_IR(uint32_t seq);
+
+#endif /* __MAX30102_SIM_H */
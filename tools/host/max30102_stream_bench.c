@@ -0,0 +1,199 @@
+/**
+  ******************************************************************************
+  * @file           : max30102_stream_bench.c
+  * @brief          : 流式心率血氧估计的精度与每样本耗时（主机测试）
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-20
+  ******************************************************************************
+  * @attention
+  *
+  * 用ppg_synth.h的合成信号（没有实录数据）按100Hz产生5段各30秒的
+  * 心率/血氧组合，经PPG_Filter_Process带通后分别送入：
+  * - 流式估计：MAX30102_Stream_Update逐样本更新，每次心跳输出；
+  * - 批量计算：每17个样本（A_FULL一批）对100样本窗口调用MAX30102_Calculate。
+  * 报告每段后20秒的心率/血氧平均绝对误差和主机上每样本耗时。
+  * 主机耗时只用于比较两种方法的相对开销；Cortex-M4上的周期数
+  * 需在目标板上以SCHEDULER_PROFILE（DWT）测量。
+  *
+  * 编译运行（仓库根目录）：
+  *   gcc -O2 -Itools/host -IAPP tools/host/max30102_stream_bench.c APP/max30102.c \
+  *       APP/scheduler.c APP/ppg_filter.c tools/host/hal_stub.c -lm -o max30102_stream_bench
+  *   ./max30102_stream_bench [耗时测试重复轮数]
+  *
+  ******************************************************************************
+  */
+
+#include "max30102.h"
+#include "ppg_synth.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define FS              MAX30102_SAMPLE_RATE
+#define SEG_SECONDS     30
+#define SEG_SAMPLES     (SEG_SECONDS * FS)
+#define SETTLE_SAMPLES  (10 * FS)       // 每段前10秒不计误差
+#define BATCH           17              // A_FULL一批样本数
+
+static const struct {
+    double bpm;
+    double spo2;
+} segments[] = {
+    { 60.0, 98.0 },
+    { 75.0, 95.0 },
+    { 90.0, 92.0 },
+    { 120.0, 90.0 },
+    { 150.0, 97.0 },
+};
+
+#define SEG_COUNT       (sizeof(segments) / sizeof(segments[0]))
+#define TOTAL_SAMPLES   (SEG_COUNT * SEG_SAMPLES)
+
+static uint32_t red_trace[TOTAL_SAMPLES];
+static uint32_t ir_trace[TOTAL_SAMPLES];
+static int16_t red_ac_trace[TOTAL_SAMPLES];
+static int16_t ir_ac_trace[TOTAL_SAMPLES];
+static uint32_t red_dc_trace[TOTAL_SAMPLES];
+static uint32_t ir_dc_trace[TOTAL_SAMPLES];
+static MAX30102_Data_t data;
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * @brief 追加一个样本到100样本滑动窗口（同MAX30102_FIFO_Append）
+ */
+static void window_push(PPG_Filter_t *filter, uint32_t red, uint32_t ir)
+{
+    if (data.buffer_index == MAX30102_BUFFER_SIZE) {
+        memmove(data.red_ac_buffer, &data.red_ac_buffer[1], (MAX30102_BUFFER_SIZE - 1) * sizeof(int16_t));
+        memmove(data.ir_ac_buffer, &data.ir_ac_buffer[1], (MAX30102_BUFFER_SIZE - 1) * sizeof(int16_t));
+        data.buffer_index--;
+    }
+    PPG_Filter_Process(filter, red, ir, &data.red_ac_buffer[data.buffer_index], &data.ir_ac_buffer[data.buffer_index]);
+    data.red_dc = filter->red.dc;
+    data.ir_dc = filter->ir.dc;
+    data.buffer_index++;
+    data.sample_count = data.buffer_index;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t rounds = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : 20U;
+    static MAX30102_Stream_t stream;
+    PPG_Filter_t filter;
+    PPG_Synth_t synth;
+    uint32_t seg, i, r;
+    double t0, stream_ns, filter_ns, calc_ns;
+    uint32_t calc_calls = 0;
+    volatile uint32_t sink = 0;
+
+    // 生成轨迹
+    PPG_Synth_Init(&synth, segments[0].bpm, segments[0].spo2, 12345U);
+    for (i = 0; i < TOTAL_SAMPLES; i++) {
+        seg = i / SEG_SAMPLES;
+        synth.bpm = segments[seg].bpm;
+        synth.spo2 = segments[seg].spo2;
+        PPG_Synth_Next(&synth, FS, &red_trace[i], &ir_trace[i]);
+    }
+
+    // 带通前端（两种方法共用）
+    PPG_Filter_Init(&filter);
+    for (i = 0; i < TOTAL_SAMPLES; i++) {
+        PPG_Filter_Process(&filter, red_trace[i], ir_trace[i], &red_ac_trace[i], &ir_ac_trace[i]);
+        red_dc_trace[i] = filter.red.dc;
+        ir_dc_trace[i] = filter.ir.dc;
+    }
+
+    /* ---------- 精度 ---------- */
+
+    printf("segment       stream: beats  HR err  SpO2 err   batch: calls  HR err  SpO2 err\n");
+
+    MAX30102_Stream_Init(&stream);
+    PPG_Filter_Init(&filter);
+    memset(&data, 0, sizeof(data));
+
+    for (seg = 0; seg < SEG_COUNT; seg++) {
+        double s_hr = 0, s_spo2 = 0, b_hr = 0, b_spo2 = 0;
+        uint32_t s_n = 0, s_spo2_n = 0, b_n = 0, b_spo2_n = 0;
+
+        for (i = seg * SEG_SAMPLES; i < (seg + 1) * SEG_SAMPLES; i++) {
+            uint32_t k = i - seg * SEG_SAMPLES;
+
+            if (MAX30102_Stream_Update(&stream, red_ac_trace[i], ir_ac_trace[i], red_dc_trace[i], ir_dc_trace[i]) &&
+                k >= SETTLE_SAMPLES) {
+                if (stream.hr_valid) {
+                    s_hr += fabs(stream.heart_rate - segments[seg].bpm);
+                    s_n++;
+                }
+                if (stream.spo2_valid) {
+                    s_spo2 += fabs(stream.spo2 - segments[seg].spo2);
+                    s_spo2_n++;
+                }
+            }
+
+            window_push(&filter, red_trace[i], ir_trace[i]);
+            if ((i + 1) % BATCH == 0 && k >= SETTLE_SAMPLES) {
+                MAX30102_Calculate(&data);
+                if (data.hr_valid) {
+                    b_hr += fabs(data.heart_rate - segments[seg].bpm);
+                    b_n++;
+                }
+                if (data.spo2_valid) {
+                    b_spo2 += fabs(data.spo2 - segments[seg].spo2);
+                    b_spo2_n++;
+                }
+            }
+        }
+
+        printf("%3.0fbpm %2.0f%%         %6u  %6.2f  %8.2f          %5u  %6.2f  %8.2f\n",
+               segments[seg].bpm, segments[seg].spo2,
+               (unsigned)s_n, s_n ? s_hr / s_n : -1.0, s_spo2_n ? s_spo2 / s_spo2_n : -1.0,
+               (unsigned)b_n, b_n ? b_hr / b_n : -1.0, b_spo2_n ? b_spo2 / b_spo2_n : -1.0);
+    }
+
+    /* ---------- 耗时 ---------- */
+
+    t0 = now_ns();
+    for (r = 0; r < rounds; r++) {
+        MAX30102_Stream_Init(&stream);
+        for (i = 0; i < TOTAL_SAMPLES; i++) {
+            sink += MAX30102_Stream_Update(&stream, red_ac_trace[i], ir_ac_trace[i], red_dc_trace[i], ir_dc_trace[i]);
+        }
+    }
+    stream_ns = (now_ns() - t0) / ((double)rounds * TOTAL_SAMPLES);
+
+    t0 = now_ns();
+    for (r = 0; r < rounds; r++) {
+        PPG_Filter_Init(&filter);
+        memset(&data, 0, sizeof(data));
+        for (i = 0; i < TOTAL_SAMPLES; i++) {
+            window_push(&filter, red_trace[i], ir_trace[i]);
+        }
+    }
+    filter_ns = (now_ns() - t0) / ((double)rounds * TOTAL_SAMPLES);
+
+    t0 = now_ns();
+    for (r = 0; r < rounds; r++) {
+        for (i = 0; i < TOTAL_SAMPLES; i += BATCH) {
+            sink += MAX30102_Calculate(&data);
+            calc_calls++;
+        }
+    }
+    calc_ns = (now_ns() - t0) / calc_calls;
+
+    printf("\nhost cost per sample (%u rounds x %u samples):\n", (unsigned)rounds, (unsigned)TOTAL_SAMPLES);
+    printf("  Stream_Update                    %7.1f ns\n", stream_ns);
+    printf("  PPG_Filter_Process + window      %7.1f ns\n", filter_ns);
+    printf("  Calculate (100-sample window)    %7.1f ns per call, %.1f ns per sample at %u samples/call\n",
+           calc_ns, calc_ns / BATCH, BATCH);
+    (void)sink;
+
+    return 0;
+}
@@ -0,0 +1,372 @@
+/**
+  ******************************************************************************
+  * @file           : mq2_alarm_latency_sim.c
+  * @brief          : MQ2看门狗报警的确认延迟与误报仿真（主机测试）
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-20
+  ******************************************************************************
+  * @attention
+  *
+  * 直接包含固件mq2.c和adc_scan.c，与固件scheduler.c和adc_scan_sim
+  * （TIM3 1kHz触发扫描 + 循环DMA + 模拟看门狗）一起运行；主循环为
+  * scheduler_run + scheduler_idle，mq2_task为500ms周期任务，mq2_alarm_task
+  * 为事件任务，与main.c相同。跳过3分钟预热，R0为默认值，AHT20无效（k=1）。
+  * MQ2通道输入为原始ADC码的均值（场景给定）+ 高斯噪声 + 可选的尖峰：
+  * - clean：清洁空气，噪声σ4LSB，不应有看门狗越界；
+  * - spikes：清洁空气，平均每300ms一个满量程尖峰（干扰），不应报警；
+  * - near：均值比报警码低15LSB，噪声σ8LSB，单次转换频繁越界，平均值不越界，
+  *   不应报警；
+  * - step：清洁空气与报警码+100LSB之间阶跃（各保持3~4秒，相位随机），
+  *   每次上升恰好报警一次、下降恰好解除一次；
+  * - ramp：均值以每秒20LSB在清洁空气与报警码+60LSB之间往返（σ8LSB），
+  *   每个周期恰好报警、解除各一次（滞回不抖动），切换时均值与阈值相差
+  *   不超过4LSB（平均值可能略早于均值越过阈值，报告有符号偏差）。
+  * 报警延迟（step）为均值越过报警码（解除：回落到解除码以下）到
+  * mq2_alarm_task切换报警状态的时间，按主循环中scheduler_run返回时刻计。
+  * 同时报告看门狗越界次数（即只按单次转换切换时的报警次数）与被平均值
+  * 否决的次数。
+  *
+  * 编译运行（仓库根目录）：
+  *   gcc -O2 -Itools/host -IAPP tools/host/mq2_alarm_latency_sim.c tools/host/adc_scan_sim.c \
+  *       tools/host/hal_stub.c APP/scheduler.c -lm -o mq2_alarm_latency_sim
+  *   ./mq2_alarm_latency_sim [随机种子]
+  *
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+
+// 出厂校准值在主机上没有对应地址，替换为常数（VREFINT采样取同一值，VDDA = 3.3V）
+#define ADC_SCAN_VREFINT_CAL    1500U
+#define ADC_SCAN_TS_CAL1        940U
+#define ADC_SCAN_TS_CAL2        1200U
+
+// 固件打印与本测试无关，包含期间静默
+#define printf(...) ((void)0)
+#include "adc_scan.c"
+#include "mq2.c"
+#undef printf
+#include "adc_scan_sim.h"
+#include <math.h>
+#include <stdlib.h>
+
+#define MS_CYCLES       (HOST_CPU_HZ / 1000U)
+#define LATENCY_LIMIT_MS 150.0  // 平均值周期64ms + DMA批处理16ms + 查询间隔16ms，留余量
+#define RAMP_RATE       20.0    // 斜坡速率(LSB/s)
+#define RAMP_LIMIT_LSB  4.0     // 斜坡上切换时均值偏离阈值的上限（平均值σ1LSB，滞后约1.3LSB）
+
+AHT20_Data_t aht20_data;
+
+typedef enum {
+    SCENE_CLEAN = 0,
+    SCENE_SPIKES,
+    SCENE_NEAR,
+    SCENE_STEP,
+    SCENE_RAMP
+} Scene_t;
+
+static const char *const scene_name[] = { "clean", "spikes", "near", "step", "ramp" };
+
+static Scene_t scene;
+static double noise_lsb;
+static double clean_code;
+static double mean_code;            // 当前输入均值（原始ADC码）
+static uint64_t spike_next;
+
+static uint32_t rng_state;
+
+static double uniform(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return (rng_state + 0.5) / 4294967296.0;
+}
+
+static double gaussian(void)
+{
+    return sqrt(-2.0 * log(uniform())) * cos(2.0 * M_PI * uniform());
+}
+
+/* ==================== 模拟输入与中断转发 ==================== */
+
+static int32_t sample(uint32_t channel, uint64_t t)
+{
+    if (channel == ADC_CHANNEL_VREFINT) {
+        return ADC_SCAN_VREFINT_CAL;
+    }
+    if (channel != MQ2_ADC_CHANNEL) {
+        return 1000;
+    }
+
+    if (scene == SCENE_SPIKES && t >= spike_next) {
+        spike_next = t + (uint64_t)(-300.0 * log(uniform()) * MS_CYCLES);
+        return MQ2_ADC_MAX;
+    }
+    return (int32_t)lround(mean_code + noise_lsb * gaussian());
+}
+
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc)
+{
+    ADC_SCAN_ConvHalfCpltCallback(hadc);
+}
+
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc)
+{
+    ADC_SCAN_ConvCpltCallback(hadc);
+}
+
+void HAL_ADC_LevelOutOfWindowCallback(ADC_HandleTypeDef *hadc)
+{
+    ADC_SCAN_LevelOutOfWindowCallback(hadc);
+}
+
+/* ==================== 统计 ==================== */
+
+typedef struct {
+    uint32_t on;                    // 报警置位次数
+    uint32_t off;                   // 报警解除次数
+    uint32_t late;                  // 超过LATENCY_LIMIT_MS（斜坡：RAMP_LIMIT_LSB）的次数
+    uint32_t missed;                // 均值越过阈值后没有切换的次数
+    uint32_t on_n, off_n;           // 计入延迟的切换次数
+    double on_min, on_sum, on_max;  // 报警延迟(ms)；斜坡：切换时均值 - 阈值(LSB)
+    double off_min, off_sum, off_max;
+} Stats_t;
+
+static Stats_t st;
+static uint64_t cross_on_time;      // 均值越过报警码的时刻（0: 未越过）
+static uint64_t cross_off_time;
+static bool last_alarm;
+
+static void record(uint32_t *n, double *min, double *sum, double *max, double v)
+{
+    (*n)++;
+    if (v < *min) *min = v;
+    if (v > *max) *max = v;
+    *sum += v;
+    if (scene == SCENE_RAMP ? fabs(v) > RAMP_LIMIT_LSB : v > LATENCY_LIMIT_MS) {
+        st.late++;
+    }
+}
+
+/**
+ * @brief 设置输入均值，记录越过阈值的时刻（均值只在主循环中改变；斜坡不计时）
+ */
+static void set_mean(double code)
+{
+    double alarm = mq2_awd_alarm_raw;
+    double release = mq2_awd_release_raw;
+
+    if (scene == SCENE_RAMP) {
+        mean_code = code;
+        return;
+    }
+    if (mean_code < alarm && code >= alarm) {
+        if (cross_on_time != 0) {
+            st.missed++;
+        }
+        cross_on_time = host_cycles();
+    }
+    if (mean_code >= release && code < release && last_alarm) {
+        if (cross_off_time != 0) {
+            st.missed++;
+        }
+        cross_off_time = host_cycles();
+    }
+    mean_code = code;
+}
+
+/**
+ * @brief 主循环：运行调度器，直到指定时刻；记录报警状态切换
+ */
+static void run_until(uint64_t t)
+{
+    while (host_cycles() < t) {
+        scheduler_run();
+        if (mq2_alarm_active != last_alarm) {
+            double ms;
+
+            last_alarm = mq2_alarm_active;
+            if (scene == SCENE_RAMP) {
+                // 缓慢斜坡上平均值可能略早于均值越过阈值，记录切换时均值相对阈值的偏差
+                if (last_alarm) {
+                    st.on++;
+                    record(&st.on_n, &st.on_min, &st.on_sum, &st.on_max, mean_code - mq2_awd_alarm_raw);
+                } else {
+                    st.off++;
+                    record(&st.off_n, &st.off_min, &st.off_sum, &st.off_max, mean_code - mq2_awd_release_raw);
+                }
+            } else if (last_alarm) {
+                st.on++;
+                if (cross_on_time != 0) {
+                    ms = (host_cycles() - cross_on_time) * 1000.0 / HOST_CPU_HZ;
+                    record(&st.on_n, &st.on_min, &st.on_sum, &st.on_max, ms);
+                    cross_on_time = 0;
+                }
+            } else {
+                st.off++;
+                if (cross_off_time != 0) {
+                    ms = (host_cycles() - cross_off_time) * 1000.0 / HOST_CPU_HZ;
+                    record(&st.off_n, &st.off_min, &st.off_sum, &st.off_max, ms);
+                    cross_off_time = 0;
+                }
+            }
+        }
+        scheduler_idle();
+    }
+}
+
+/* ==================== 场景 ==================== */
+
+/**
+ * @brief 复位并启动固件（跳过预热），运行1秒使VDDA与看门狗阈值就绪
+ */
+static void start(Scene_t s, double noise)
+{
+    scene = s;
+    noise_lsb = noise;
+
+    host_init();
+    scheduler_init();
+    ADC_Scan_Sim_Init(1000U, sample);
+
+    memset(&mq2_status, 0, sizeof(mq2_status));
+    mq2_alarm_active = false;
+    mq2_awd_pending = false;
+    mq2_awd_alarm_raw = mq2_awd_release_raw = MQ2_ADC_MAX + 1;
+    ADC_SCAN_Init();
+    MQ2_Init();
+    mq2_preheat_start = HAL_GetTick() - MQ2_PREHEAT_MS;
+    ADC_SCAN_Start();
+
+    scheduler_add_task(mq2_task, MQ2_TASK_PERIOD_MS);
+    scheduler_add_event_task(mq2_alarm_task);
+
+    // 清洁空气：Rs/R0 = 9.9
+    clean_code = MQ2_Rs_To_ADC(R0 * MQ2_CLEAN_AIR_RATIO);
+    mean_code = clean_code;
+    spike_next = host_cycles() + 500U * MS_CYCLES;
+
+    memset(&st, 0, sizeof(st));
+    st.on_min = st.off_min = 1e9;
+    cross_on_time = cross_off_time = 0;
+    last_alarm = false;
+
+    run_until(host_cycles() + (uint64_t)HOST_CPU_HZ);
+    if (s == SCENE_NEAR) {
+        set_mean(mq2_awd_alarm_raw - 15.0);
+    }
+}
+
+static void print_range(double min, double sum, double max, uint32_t n)
+{
+    if (n == 0) {
+        printf("    -     -     -");
+    } else {
+        printf("%5.1f %5.1f %5.1f", min, sum / n, max);
+    }
+}
+
+static uint32_t report(uint32_t cycles)
+{
+    uint32_t failures = 0;
+    bool expect_alarm = (scene == SCENE_STEP || scene == SCENE_RAMP);
+
+    printf("%-7s %5.1f  %4u %4u   %6u %6u   ", scene_name[scene], noise_lsb, (unsigned)st.on, (unsigned)st.off,
+           (unsigned)mq2_status.awd_trips, (unsigned)mq2_status.awd_rejected);
+    print_range(st.on_min, st.on_sum, st.on_max, st.on_n);
+    printf("   ");
+    print_range(st.off_min, st.off_sum, st.off_max, st.off_n);
+    printf("\n");
+
+    if (!expect_alarm && st.on != 0) {
+        printf("FAIL: %s raised %u false alarms\n", scene_name[scene], (unsigned)st.on);
+        failures++;
+    }
+    if (expect_alarm && (st.on != cycles || st.off != cycles || st.missed != 0)) {
+        printf("FAIL: %s %u alarms / %u releases for %u cycles (%u missed)\n", scene_name[scene],
+               (unsigned)st.on, (unsigned)st.off, (unsigned)cycles, (unsigned)st.missed);
+        failures++;
+    }
+    if (st.late != 0) {
+        printf("FAIL: %s %u transitions later than %.0f ms (ramp: off by more than %.0f LSB)\n",
+               scene_name[scene], (unsigned)st.late, LATENCY_LIMIT_MS, RAMP_LIMIT_LSB);
+        failures++;
+    }
+    if (mq2_status.alarm_unreachable) {
+        printf("FAIL: alarm threshold unreachable\n");
+        failures++;
+    }
+    return failures;
+}
+
+static uint32_t run_idle(Scene_t s, double noise, uint32_t seconds)
+{
+    start(s, noise);
+    run_until(host_cycles() + (uint64_t)seconds * HOST_CPU_HZ);
+    return report(0);
+}
+
+static uint32_t run_step(uint32_t cycles)
+{
+    uint32_t c;
+
+    start(SCENE_STEP, 4.0);
+    for (c = 0; c < cycles; c++) {
+        // 相位在1ms内也随机，避免与触发和DMA批处理对齐
+        run_until(host_cycles() + (uint64_t)((3.0 + uniform()) * HOST_CPU_HZ));
+        set_mean(mq2_awd_alarm_raw + 100.0);
+        run_until(host_cycles() + (uint64_t)((3.0 + uniform()) * HOST_CPU_HZ));
+        set_mean(clean_code);
+    }
+    run_until(host_cycles() + 2U * (uint64_t)HOST_CPU_HZ);
+    return report(cycles);
+}
+
+static uint32_t run_ramp(uint32_t cycles)
+{
+    double top;
+    uint32_t c;
+
+    start(SCENE_RAMP, 8.0);
+    top = mq2_awd_alarm_raw + 60.0;
+    for (c = 0; c < cycles; c++) {
+        while (mean_code < top) {
+            run_until(host_cycles() + MS_CYCLES);
+            set_mean(mean_code + RAMP_RATE / 1000.0);
+        }
+        while (mean_code > clean_code) {
+            run_until(host_cycles() + MS_CYCLES);
+            set_mean(mean_code - RAMP_RATE / 1000.0);
+        }
+    }
+    run_until(host_cycles() + 2U * (uint64_t)HOST_CPU_HZ);
+    return report(cycles);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t failures = 0;
+
+    rng_state = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : 0x9E3779B9U;
+    if (rng_state == 0) {
+        rng_state = 1;
+    }
+
+    start(SCENE_CLEAN, 4.0);
+    printf("1 kHz trigger, %u-sample averages, R0 %.1f kOhm, clean air %.0f, alarm raw %u, release raw %u\n",
+           1U << MQ2_OVERSAMPLE_SHIFT, R0, clean_code, (unsigned)mq2_awd_alarm_raw,
+           (unsigned)mq2_awd_release_raw);
+    printf("scene   noise    on  off    trips rejected   alarm latency (ms)  release latency (ms)\n");
+    printf("        (LSB)                               min  mean   max     min  mean   max\n");
+    printf("                                            (ramp: input mean - threshold, LSB)\n");
+
+    failures += run_idle(SCENE_CLEAN, 4.0, 120);
+    failures += run_idle(SCENE_SPIKES, 4.0, 120);
+    failures += run_idle(SCENE_NEAR, 8.0, 120);
+    failures += run_step(50);
+    failures += run_ramp(5);
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,398 @@
+/**
+  ******************************************************************************
+  * @file           : mq2_climate_sweep.c
+  * @brief          : MQ2温湿度补偿在合成气候扫描上的误差、回退与耗时（主机测试）
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-20
+  ******************************************************************************
+  * @attention
+  *
+  * 直接包含固件mq2.c，ADC扫描服务由本文件替身提供（平均值由测试设定，
+  * VDDA = 3.3V），aht20_data由测试设定。
+  * 传感器模型：Rs = R0 x k(T,RH) x (ppm/A)^(1/B)，k为光滑解析式
+  *   k = (0.896 + 0.204 x exp(-(T-20)/22.5)) x (1 - 0.00205 x (RH-20))
+  * （按数据手册温湿度特性拟合，与补偿表独立，参考条件20℃/65%RH下约1），
+  * 由Rs按分压和3.3V参考换算成带小数位的ADC平均值交给MQ2_Read_Data。
+  * - 扫描：-10~50℃每2.5℃、20~100%RH每5%（多数点不在表格节点上），
+  *   真实浓度100/300/1000/3000ppm，分别读取未补偿（AHT20无效）与补偿
+  *   读数，报告相对真实浓度的平均/最大误差。补偿后的误差分为两部分检查：
+  *   表中k相对模型的偏差（表的取点精度，不超过2.5%，经幂律放大|B|倍）与
+  *   读数相对ppm x (k模型/k表)^B的偏差（固件实现，不超过1%）；
+  * - 表外：-20℃、60℃、0%RH等按边界取值，仅报告；
+  * - 回退：AHT20无效时k必须为1，读数与从未有效时逐位相同（包括从有效
+  *   切回无效之后）；
+  * - 耗时：MQ2_Compensation_Factor（一次双线性插值）和MQ2_Read_Data在
+  *   温湿度固定、每次读数都变化（k变化时重算powf）和AHT20无效时的主机
+  *   纳秒数（Cortex-M4周期数需在目标板上用DWT测量）。
+  *
+  * 编译运行（仓库根目录）：
+  *   gcc -O2 -Itools/host -IAPP tools/host/mq2_climate_sweep.c tools/host/hal_stub.c \
+  *       APP/scheduler.c -lm -o mq2_climate_sweep
+  *   ./mq2_climate_sweep [耗时测试重复轮数]
+  *
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+
+// 固件打印与本测试无关，包含期间静默
+#define printf(...) ((void)0)
+#include "mq2.c"
+#undef printf
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define VREFINT_CAL     1500U   // 替身出厂校准值（3.3V下的VREFINT码）
+#define APPLY_LIMIT     0.01    // 读数相对按表中k的幂律预期值的误差上限（查表精度，报警范围）
+#define K_LIMIT         0.025   // 表格范围内补偿系数相对模型的误差上限
+
+AHT20_Data_t aht20_data;
+
+/* ==================== ADC扫描服务替身 ==================== */
+
+static uint16_t bench_code;                                 // 通道平均值（带小数位）
+static volatile uint16_t bench_vrefint = VREFINT_CAL << ADC_SCAN_FRAC_BITS;
+
+int8_t ADC_SCAN_Add_Channel(uint32_t channel, uint32_t sampling_time, uint8_t oversample_shift)
+{
+    (void)channel;
+    (void)sampling_time;
+    (void)oversample_shift;
+    return 2;
+}
+
+uint8_t ADC_SCAN_Set_Watchdog(int8_t index, ADC_SCAN_Watchdog_Handler_t handler)
+{
+    (void)index;
+    (void)handler;
+    return 0;
+}
+
+void ADC_SCAN_Set_Watchdog_Window(uint16_t low, uint16_t high)
+{
+    (void)low;
+    (void)high;
+}
+
+bool ADC_SCAN_Read(int8_t index, uint16_t *code)
+{
+    (void)index;
+    *code = bench_code;
+    return true;
+}
+
+uint32_t ADC_SCAN_Get_Count(int8_t index)
+{
+    (void)index;
+    return 0;
+}
+
+float ADC_SCAN_Get_VDDA(void)
+{
+    return 3.3f * (float)((uint32_t)VREFINT_CAL << ADC_SCAN_FRAC_BITS) / (float)bench_vrefint;
+}
+
+float ADC_SCAN_Get_Voltage(int8_t index)
+{
+    (void)index;
+    return (float)bench_code * ADC_SCAN_Get_VDDA() *
+           (1.0f / ((float)ADC_SCAN_CODE_MAX * (float)(1U << ADC_SCAN_FRAC_BITS)));
+}
+
+/* ==================== 传感器模型 ==================== */
+
+/**
+ * @brief 清洁空气Rs相对参考条件的比值（解析模型，与补偿表独立）
+ */
+static double model_k(double t, double rh)
+{
+    return (0.896 + 0.204 * exp(-(t - 20.0) / 22.5)) * (1.0 - 0.00205 * (rh - 20.0));
+}
+
+/**
+ * @brief 真实浓度和气候下的ADC平均值（带小数位）
+ * @retval 平均值，超出量程返回0
+ */
+static uint16_t model_code(double ppm, double t, double rh)
+{
+    double rs = (double)R0 * model_k(t, rh) * pow(ppm / (double)MQ2_CURVE_A, 1.0 / (double)MQ2_CURVE_B);
+    double v = (double)MQ2_VCC * (double)MQ2_LOAD_RESISTANCE / (rs + (double)MQ2_LOAD_RESISTANCE);
+    double code = v / (double)MQ2_VREF * MQ2_ADC_MAX * (1U << ADC_SCAN_FRAC_BITS);
+
+    if (code > (double)((uint32_t)MQ2_ADC_MAX << ADC_SCAN_FRAC_BITS) ||
+        code < (double)((uint32_t)MQ2_ADC_VALID_MIN << ADC_SCAN_FRAC_BITS)) {
+        return 0;
+    }
+    return (uint16_t)lround(code);
+}
+
+static void set_climate(bool valid, float t, float rh)
+{
+    aht20_data.is_valid = valid;
+    aht20_data.temperature = t;
+    aht20_data.humidity = rh;
+}
+
+/* ==================== 扫描 ==================== */
+
+static const double gas_ppm[] = { 100.0, 300.0, 1000.0, 3000.0 };
+
+#define GAS_COUNT       (sizeof(gas_ppm) / sizeof(gas_ppm[0]))
+#define T_POINTS        25U     // -10~50℃，步长2.5℃
+#define RH_POINTS       17U     // 20~100%RH，步长5%
+
+typedef struct {
+    uint32_t points;
+    uint32_t saturated;
+    double raw_sum, raw_max;    // 未补偿相对误差
+    double comp_sum, comp_max;  // 补偿后相对误差
+    double k_max;               // 补偿系数与模型的最大相对偏差
+    double apply_max;           // 读数相对ppm x (k模型/k表)^B的最大相对偏差
+} Sweep_t;
+
+static void sweep_point(Sweep_t *s, double ppm, double t, double rh)
+{
+    MQ2_Data_t data;
+    uint16_t code = model_code(ppm, t, rh);
+    double e;
+
+    if (code == 0) {
+        s->saturated++;
+        return;
+    }
+    bench_code = code;
+    s->points++;
+
+    set_climate(false, 0.0f, 0.0f);
+    MQ2_Read_Data(&data);
+    e = fabs(data.ppm - ppm) / ppm;
+    s->raw_sum += e;
+    if (e > s->raw_max) s->raw_max = e;
+
+    set_climate(true, (float)t, (float)rh);
+    MQ2_Read_Data(&data);
+    e = fabs(data.ppm - ppm) / ppm;
+    s->comp_sum += e;
+    if (e > s->comp_max) s->comp_max = e;
+
+    e = fabs(data.comp / model_k(t, rh) - 1.0);
+    if (e > s->k_max) s->k_max = e;
+
+    // 读数 = A x (Rs/R0/k表)^B = ppm x (k模型/k表)^B：剩余偏差来自固件实现
+    e = fabs(data.ppm / (ppm * pow(model_k(t, rh) / data.comp, (double)MQ2_CURVE_B)) - 1.0);
+    if (e > s->apply_max) s->apply_max = e;
+}
+
+static void print_sweep(const char *name, const Sweep_t *s)
+{
+    printf("%-10s %5u %4u    %6.2f%% %6.2f%%    %6.2f%% %6.2f%%    %5.2f%%    %5.2f%%\n", name,
+           (unsigned)s->points, (unsigned)s->saturated, s->points ? s->raw_sum / s->points * 100.0 : 0.0,
+           s->raw_max * 100.0, s->points ? s->comp_sum / s->points * 100.0 : 0.0, s->comp_max * 100.0,
+           s->k_max * 100.0, s->apply_max * 100.0);
+}
+
+static uint32_t sweep_table_range(void)
+{
+    Sweep_t all;
+    uint32_t failures = 0;
+    uint32_t g, i, j;
+
+    memset(&all, 0, sizeof(all));
+    for (g = 0; g < GAS_COUNT; g++) {
+        Sweep_t s;
+        char name[16];
+
+        memset(&s, 0, sizeof(s));
+        for (i = 0; i < T_POINTS; i++) {
+            for (j = 0; j < RH_POINTS; j++) {
+                sweep_point(&s, gas_ppm[g], -10.0 + 2.5 * i, 20.0 + 5.0 * j);
+            }
+        }
+        snprintf(name, sizeof(name), "%.0f ppm", gas_ppm[g]);
+        print_sweep(name, &s);
+
+        all.points += s.points;
+        all.saturated += s.saturated;
+        all.raw_sum += s.raw_sum;
+        all.comp_sum += s.comp_sum;
+        if (s.raw_max > all.raw_max) all.raw_max = s.raw_max;
+        if (s.comp_max > all.comp_max) all.comp_max = s.comp_max;
+        if (s.k_max > all.k_max) all.k_max = s.k_max;
+        if (s.apply_max > all.apply_max) all.apply_max = s.apply_max;
+    }
+    print_sweep("all", &all);
+
+    if (all.apply_max > APPLY_LIMIT) {
+        printf("FAIL: reading deviates %.2f%% from the power law at the table's k (limit %.0f%%)\n",
+               all.apply_max * 100.0, APPLY_LIMIT * 100.0);
+        failures++;
+    }
+    if (all.k_max > K_LIMIT) {
+        printf("FAIL: table k deviates %.2f%% from the sensor model (limit %.1f%%)\n", all.k_max * 100.0,
+               K_LIMIT * 100.0);
+        failures++;
+    }
+    if (all.comp_sum >= all.raw_sum) {
+        printf("FAIL: compensation does not reduce the mean error\n");
+        failures++;
+    }
+    return failures;
+}
+
+static void sweep_outside(void)
+{
+    static const double outside[][2] = {
+        { -20.0, 50.0 }, { 60.0, 50.0 }, { 20.0, 0.0 }, { 20.0, 10.0 }, { -20.0, 0.0 }, { 60.0, 100.0 },
+    };
+    Sweep_t s;
+    uint32_t g, i;
+
+    memset(&s, 0, sizeof(s));
+    for (g = 0; g < GAS_COUNT; g++) {
+        for (i = 0; i < sizeof(outside) / sizeof(outside[0]); i++) {
+            sweep_point(&s, gas_ppm[g], outside[i][0], outside[i][1]);
+        }
+    }
+    print_sweep("outside", &s);
+}
+
+/* ==================== 回退 ==================== */
+
+/**
+ * @brief AHT20无效时k = 1，读数与从未有效时逐位相同
+ */
+static uint32_t check_fallback(void)
+{
+    static const float climates[][2] = { { -10.0f, 20.0f }, { 50.0f, 100.0f }, { 27.5f, 45.0f } };
+    uint32_t failures = 0;
+    uint32_t g, c;
+
+    for (g = 0; g < GAS_COUNT; g++) {
+        MQ2_Data_t before, hot, after;
+
+        bench_code = model_code(gas_ppm[g], 20.0, 65.0);
+        set_climate(false, 0.0f, 0.0f);
+        MQ2_Read_Data(&before);
+
+        for (c = 0; c < sizeof(climates) / sizeof(climates[0]); c++) {
+            set_climate(true, climates[c][0], climates[c][1]);
+            MQ2_Read_Data(&hot);
+            // 无效数据的温湿度字段可能是任意值，不应参与
+            set_climate(false, climates[c][0], climates[c][1]);
+            MQ2_Read_Data(&after);
+
+            if (after.comp != 1.0f || after.ppm != before.ppm || before.comp != 1.0f) {
+                printf("FAIL: fallback at %.0f ppm after %.1fC/%.0f%%: k %.4f, ppm %.3f vs %.3f\n",
+                       gas_ppm[g], (double)climates[c][0], (double)climates[c][1], (double)after.comp,
+                       (double)after.ppm, (double)before.ppm);
+                failures++;
+            }
+        }
+    }
+    printf("fallback (AHT20 invalid -> k = 1, bit-identical reading): %s\n", failures ? "FAILED" : "ok");
+    return failures;
+}
+
+/* ==================== 耗时 ==================== */
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+#define CODE_SEQUENCE   1024U
+
+static uint16_t codes[CODE_SEQUENCE];
+static float temps[CODE_SEQUENCE];
+static volatile float sink;
+
+/**
+ * @brief 每次调用纳秒数
+ * @param method: 0: MQ2_Compensation_Factor, 1: 读数（温湿度固定）,
+ *                2: 读数（温湿度每次变化）, 3: 读数（AHT20无效）
+ */
+static double time_method(int method, uint32_t rounds)
+{
+    MQ2_Data_t data;
+    double t0;
+    uint32_t r, i;
+
+    set_climate(method != 3, 28.0f, 55.0f);
+    t0 = now_ns();
+    for (r = 0; r < rounds; r++) {
+        for (i = 0; i < CODE_SEQUENCE; i++) {
+            if (method == 0) {
+                sink += MQ2_Compensation_Factor(temps[i], 55.0f);
+                continue;
+            }
+            bench_code = codes[i];
+            if (method == 2) {
+                aht20_data.temperature = temps[i];
+            }
+            MQ2_Read_Data(&data);
+            sink += data.ppm;
+        }
+    }
+    return (now_ns() - t0) / ((double)rounds * CODE_SEQUENCE);
+}
+
+static void measure_cost(uint32_t rounds)
+{
+    static const char *const names[] = { "bilinear k", "read, fixed climate", "read, climate per read",
+                                         "read, AHT20 invalid" };
+    double best[4] = { 1e30, 1e30, 1e30, 1e30 };
+    uint32_t rng = 0x9E3779B9U;
+    uint32_t i;
+    int m;
+
+    for (i = 0; i < CODE_SEQUENCE; i++) {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        codes[i] = (uint16_t)(((uint32_t)MQ2_ADC_VALID_MIN << ADC_SCAN_FRAC_BITS) +
+                              rng % ((uint32_t)(MQ2_ADC_MAX - MQ2_ADC_VALID_MIN) << ADC_SCAN_FRAC_BITS));
+        temps[i] = -10.0f + (float)(rng >> 8) * (60.0f / 16777216.0f);
+    }
+    for (i = 0; i < 5; i++) {
+        for (m = 0; m < 4; m++) {
+            double ns = time_method(m, rounds);
+
+            if (ns < best[m]) {
+                best[m] = ns;
+            }
+        }
+    }
+
+    printf("\nhost ns per call (best of 5, %u calls):\n", (unsigned)(rounds * CODE_SEQUENCE));
+    for (m = 0; m < 4; m++) {
+        printf("  %-24s %6.1f\n", names[m], best[m]);
+    }
+    printf("(AHT20 updates every 2 s, so powf runs once per climate change; measure Cortex-M4 cycles with DWT on target)\n");
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t rounds = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : 2000U;
+    uint32_t failures = 0;
+
+    MQ2_Init();
+
+    printf("R0 %.1f kOhm, sensor k(T,RH) from an analytic model, table %ux%u over %.0f..%.0fC / %.0f..%.0f%%RH\n",
+           (double)R0, (unsigned)MQ2_COMP_T_POINTS, (unsigned)MQ2_COMP_RH_POINTS, (double)MQ2_COMP_T_MIN,
+           (double)(MQ2_COMP_T_MIN + MQ2_COMP_T_STEP * (MQ2_COMP_T_POINTS - 1)), (double)MQ2_COMP_RH_MIN,
+           (double)(MQ2_COMP_RH_MIN + MQ2_COMP_RH_STEP * (MQ2_COMP_RH_POINTS - 1)));
+    printf("gas        points  sat    uncompensated      compensated        k vs      reading vs\n");
+    printf("                          mean    max        mean    max        model     power law\n");
+
+    failures += sweep_table_range();
+    sweep_outside();
+    failures += check_fallback();
+    measure_cost(rounds);
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
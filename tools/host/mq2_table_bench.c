@@ -0,0 +1,350 @@
+/**
+  ******************************************************************************
+  * @file           : mq2_table_bench.c
+  * @brief          : MQ2查表读数与逐样本powf的精度对比及每次读数耗时（主机测试）
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-20
+  ******************************************************************************
+  * @attention
+  *
+  * 直接包含固件mq2.c，ADC扫描服务由本文件替身提供（平均值由测试设定，
+  * VDDA与固件一样由VREFINT码除法换算）。三种读数方式：
+  * - powf：最初做法，每次读数Rs = f(adc)，再MQ2_Calculate_PPM(Rs/k, R0)；
+  * - legacy：上一版查表，Rs/k折算回ADC码再查表（每次三次除法，用同一张表）；
+  * - table：MQ2_Read_Data，查表插值后乘补偿增益k^(-B)（读数路径无除法）。
+  * 精度：对每个R0和温湿度，逐一扫过MQ2_ADC_VALID_MIN~4095的全部小数码
+  * （ADC_SCAN_FRAC_BITS位小数），与双精度曲线A*(Rs/R0/k)^B（限幅10000）
+  * 比较，按参考ppm分段报告最大绝对误差和最大相对误差。
+  * 耗时：随机码序列上每次读数的主机纳秒数，Cortex-M4周期数需在目标板上
+  * 用DWT测量（SCHEDULER_PROFILE）。
+  *
+  * 编译运行（仓库根目录）：
+  *   gcc -O2 -Itools/host -IAPP tools/host/mq2_table_bench.c tools/host/hal_stub.c \
+  *       APP/scheduler.c -lm -o mq2_table_bench
+  *   ./mq2_table_bench [耗时测试重复轮数]
+  *
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+
+// 固件打印与本测试无关，包含期间静默
+#define printf(...) ((void)0)
+#include "mq2.c"
+#undef printf
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define VREFINT_CAL     1500U   // 替身出厂校准值（3.3V下的VREFINT码）
+
+AHT20_Data_t aht20_data;
+
+/* ==================== ADC扫描服务替身 ==================== */
+
+static uint16_t bench_code;                                 // 通道平均值（带小数位）
+static volatile uint16_t bench_vrefint = VREFINT_CAL << ADC_SCAN_FRAC_BITS;
+
+int8_t ADC_SCAN_Add_Channel(uint32_t channel, uint32_t sampling_time, uint8_t oversample_shift)
+{
+    (void)channel;
+    (void)sampling_time;
+    (void)oversample_shift;
+    return 2;
+}
+
+uint8_t ADC_SCAN_Set_Watchdog(int8_t index, ADC_SCAN_Watchdog_Handler_t handler)
+{
+    (void)index;
+    (void)handler;
+    return 0;
+}
+
+void ADC_SCAN_Set_Watchdog_Window(uint16_t low, uint16_t high)
+{
+    (void)low;
+    (void)high;
+}
+
+bool ADC_SCAN_Read(int8_t index, uint16_t *code)
+{
+    (void)index;
+    *code = bench_code;
+    return true;
+}
+
+uint32_t ADC_SCAN_Get_Count(int8_t index)
+{
+    (void)index;
+    return 0;
+}
+
+float ADC_SCAN_Get_VDDA(void)
+{
+    return 3.3f * (float)((uint32_t)VREFINT_CAL << ADC_SCAN_FRAC_BITS) / (float)bench_vrefint;
+}
+
+float ADC_SCAN_Get_Voltage(int8_t index)
+{
+    (void)index;
+    return (float)bench_code * ADC_SCAN_Get_VDDA() *
+           (1.0f / ((float)ADC_SCAN_CODE_MAX * (float)(1U << ADC_SCAN_FRAC_BITS)));
+}
+
+/* ==================== 对照读数方式 ==================== */
+
+/**
+ * @brief 最初做法：每次读数调用powf
+ */
+static float powf_read(void)
+{
+    float v = ADC_SCAN_Get_Voltage(mq2_scan_index);
+    float adc = v * ((float)MQ2_ADC_MAX / MQ2_VREF);
+    float comp = aht20_data.is_valid ? MQ2_Compensation_Factor(aht20_data.temperature, aht20_data.humidity) : 1.0f;
+
+    if (adc > (float)MQ2_ADC_MAX) adc = (float)MQ2_ADC_MAX;
+    if (adc < (float)MQ2_ADC_VALID_MIN) {
+        return 0.0f;
+    }
+    return MQ2_Calculate_PPM(MQ2_ADC_To_Rs(adc) / comp, R0);
+}
+
+/**
+ * @brief 上一版查表：Rs/k折算回ADC码再查表
+ */
+static float legacy_read(void)
+{
+    float v = ADC_SCAN_Get_Voltage(mq2_scan_index);
+    float adc = v * ((float)MQ2_ADC_MAX / MQ2_VREF);
+    float comp = aht20_data.is_valid ? MQ2_Compensation_Factor(aht20_data.temperature, aht20_data.humidity) : 1.0f;
+    float Rs, adc_comp, ppm;
+    uint32_t avg, code, frac, next;
+    int32_t step;
+
+    if (adc > (float)MQ2_ADC_MAX) adc = (float)MQ2_ADC_MAX;
+    if (adc < (float)MQ2_ADC_VALID_MIN) {
+        return 0.0f;
+    }
+    Rs = MQ2_ADC_To_Rs(adc);
+    adc_comp = (comp == 1.0f) ? adc : MQ2_Rs_To_ADC(Rs / comp);
+    if (adc_comp > (float)MQ2_ADC_MAX) adc_comp = (float)MQ2_ADC_MAX;
+    avg = (uint32_t)(adc_comp * (float)(1U << ADC_SCAN_FRAC_BITS) + 0.5f);
+    code = avg >> ADC_SCAN_FRAC_BITS;
+    frac = avg & ((1U << ADC_SCAN_FRAC_BITS) - 1);
+    next = (code < MQ2_ADC_MAX) ? code + 1 : code;
+    step = (int32_t)mq2_ppm_table[next] - (int32_t)mq2_ppm_table[code];
+    ppm = ((float)mq2_ppm_table[code] + (float)(step * (int32_t)frac) * (1.0f / (float)(1U << ADC_SCAN_FRAC_BITS))) *
+          (1.0f / (float)MQ2_PPM_TABLE_SCALE);
+    return (ppm > MQ2_PPM_MAX) ? MQ2_PPM_MAX : ppm;
+}
+
+/**
+ * @brief 双精度参考：A*(Rs/R0/k)^B，限幅与固件一致
+ */
+static double reference_ppm(uint32_t adc_ref, double r0, double k)
+{
+    double adc = adc_ref / (double)(1U << ADC_SCAN_FRAC_BITS);
+    double c = (double)MQ2_VCC / (double)MQ2_VREF * MQ2_ADC_MAX;
+    double rs = (c - adc) / adc * (double)MQ2_LOAD_RESISTANCE;
+    double ppm = (double)MQ2_CURVE_A * pow(rs / r0 / k, (double)MQ2_CURVE_B);
+
+    return (ppm > (double)MQ2_PPM_MAX) ? (double)MQ2_PPM_MAX : ppm;
+}
+
+/* ==================== 精度 ==================== */
+
+#define BANDS           4U
+
+static const double band_low[BANDS] = { 0.0, 10.0, 100.0, 1000.0 };
+static const char *const band_name[BANDS] = { "<10", "10-100", "100-1k", "1k-10k" };
+
+typedef struct {
+    double abs_err[BANDS];
+    double rel_err[BANDS];
+    uint32_t samples[BANDS];
+} Error_t;
+
+static void account(Error_t *e, double ref, double got)
+{
+    uint32_t b = BANDS - 1U;
+    double err = fabs(got - ref);
+
+    while (b > 0 && ref < band_low[b]) {
+        b--;
+    }
+    e->samples[b]++;
+    if (err > e->abs_err[b]) e->abs_err[b] = err;
+    if (ref >= 1.0 && err / ref > e->rel_err[b]) e->rel_err[b] = err / ref;
+}
+
+typedef struct {
+    const char *name;
+    bool valid;
+    float temperature;
+    float humidity;
+} Climate_t;
+
+static const Climate_t climates[] = {
+    { "no AHT20", false, 0, 0 },
+    { "-10C/20%", true, -10.0f, 20.0f },
+    { "20C/65%", true, 20.0f, 65.0f },
+    { "35C/50%", true, 35.0f, 50.0f },
+    { "50C/100%", true, 50.0f, 100.0f },
+};
+
+static const float r0_values[] = { 5.0f, 10.0f, 20.0f };
+
+#define CLIMATE_COUNT   (sizeof(climates) / sizeof(climates[0]))
+#define R0_COUNT        (sizeof(r0_values) / sizeof(r0_values[0]))
+
+/**
+ * @brief 扫过全部小数码，返回table方式在报警范围（参考ppm不小于100）的最大相对误差
+ */
+static double sweep(float r0, const Climate_t *cl)
+{
+    Error_t et, el, ep;
+    MQ2_Data_t data;
+    uint32_t code;
+    uint32_t b;
+    double worst = 0;
+
+    memset(&et, 0, sizeof(et));
+    memset(&el, 0, sizeof(el));
+    memset(&ep, 0, sizeof(ep));
+    MQ2_Set_R0(r0);
+    aht20_data.is_valid = cl->valid;
+    aht20_data.temperature = cl->temperature;
+    aht20_data.humidity = cl->humidity;
+
+    for (code = (uint32_t)MQ2_ADC_VALID_MIN << ADC_SCAN_FRAC_BITS;
+         code <= (uint32_t)MQ2_ADC_MAX << ADC_SCAN_FRAC_BITS; code++) {
+        double ref;
+
+        bench_code = (uint16_t)code;
+        MQ2_Read_Data(&data);
+        ref = reference_ppm(data.adc_ref, r0, data.comp);
+        account(&et, ref, data.ppm);
+        account(&el, ref, legacy_read());
+        account(&ep, ref, powf_read());
+    }
+
+    for (b = 0; b < BANDS; b++) {
+        if (et.samples[b] == 0) {
+            continue;
+        }
+        printf("%4.1f  %-9s %5.3f  %-7s %6u   %7.3f %6.3f%%  %7.3f %6.3f%%  %7.3f %6.3f%%\n",
+               (double)r0, cl->name, (double)data.comp, band_name[b], (unsigned)et.samples[b],
+               ep.abs_err[b], ep.rel_err[b] * 100.0, el.abs_err[b], el.rel_err[b] * 100.0,
+               et.abs_err[b], et.rel_err[b] * 100.0);
+        if (b >= 2U && et.rel_err[b] > worst) {
+            worst = et.rel_err[b];
+        }
+    }
+    return worst;
+}
+
+/* ==================== 耗时 ==================== */
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+#define CODE_SEQUENCE   1024U
+
+static uint16_t codes[CODE_SEQUENCE];
+static volatile float sink;
+
+/**
+ * @brief 每次读数纳秒数
+ * @param method: 0: powf, 1: legacy, 2: table
+ */
+static double time_reads(int method, uint32_t rounds)
+{
+    MQ2_Data_t data;
+    double t0 = now_ns();
+    uint32_t r, i;
+
+    for (r = 0; r < rounds; r++) {
+        for (i = 0; i < CODE_SEQUENCE; i++) {
+            bench_code = codes[i];
+            switch (method) {
+                case 0:
+                    sink += powf_read();
+                    break;
+                case 1:
+                    sink += legacy_read();
+                    break;
+                default:
+                    MQ2_Read_Data(&data);
+                    sink += data.ppm;
+                    break;
+            }
+        }
+    }
+    return (now_ns() - t0) / ((double)rounds * CODE_SEQUENCE);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t rounds = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : 2000U;
+    uint32_t rng = 0x9E3779B9U;
+    uint32_t failures = 0;
+    double worst = 0;
+    double best[3] = { 1e30, 1e30, 1e30 };
+    uint32_t i, j;
+    int m;
+
+    MQ2_Init();
+
+    printf("error vs double-precision curve over every code %u..%u (1/%u LSB steps)\n",
+           (unsigned)MQ2_ADC_VALID_MIN, (unsigned)MQ2_ADC_MAX, 1U << ADC_SCAN_FRAC_BITS);
+    printf("R0    climate   k      ppm     codes     powf abs / rel    legacy abs / rel   table abs / rel\n");
+    for (i = 0; i < R0_COUNT; i++) {
+        for (j = 0; j < CLIMATE_COUNT; j++) {
+            double w = sweep(r0_values[i], &climates[j]);
+
+            if (w > worst) {
+                worst = w;
+            }
+        }
+    }
+
+    // 耗时：温湿度固定（AHT20约2秒才更新一次），码随机
+    MQ2_Set_R0(MQ2_R0_CLEAN_AIR);
+    aht20_data.is_valid = true;
+    aht20_data.temperature = 28.0f;
+    aht20_data.humidity = 55.0f;
+    for (i = 0; i < CODE_SEQUENCE; i++) {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        codes[i] = (uint16_t)(((uint32_t)MQ2_ADC_VALID_MIN << ADC_SCAN_FRAC_BITS) +
+                              rng % ((uint32_t)(MQ2_ADC_MAX - MQ2_ADC_VALID_MIN) << ADC_SCAN_FRAC_BITS));
+    }
+    for (i = 0; i < 5; i++) {
+        for (m = 0; m < 3; m++) {
+            double ns = time_reads(m, rounds);
+
+            if (ns < best[m]) {
+                best[m] = ns;
+            }
+        }
+    }
+    printf("\nhost ns per read (best of 5, %u reads): powf %.1f  legacy %.1f  table %.1f\n",
+           (unsigned)(rounds * CODE_SEQUENCE), best[0], best[1], best[2]);
+    printf("(all three include the VDDA divide in ADC_SCAN_Get_Voltage; measure Cortex-M4 cycles with DWT on target)\n");
+
+    // 误差主要来自表项取整（乘补偿增益后放大），报警范围内应远小于传感器本身的精度
+    printf("worst table relative error at >= 100 ppm: %.3f%%\n", worst * 100.0);
+    if (worst > 0.01) {
+        printf("FAIL: table read deviates more than 1%% from the curve in the alarm range\n");
+        failures++;
+    }
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
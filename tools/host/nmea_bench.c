@@ -0,0 +1,94 @@
+/**
+  ******************************************************************************
+  * @file           : nmea_bench.c
+  * @brief          : NMEA解析器主机吞吐量测试
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-08
+  ******************************************************************************
+  * @attention
+  *
+  * 按ATGM336H 1Hz输出的典型组合（RMC/GGA/GSA/GSV/VTG）生成带校验的语句流，
+  * 逐字节送入解析器并对数字字段做换算，报告每秒语句数和每秒字节数。
+  *
+  * 编译运行（仓库根目录）：
+  *   gcc -O2 -Itools/host -IAPP tools/host/nmea_bench.c APP/nmea.c -o nmea_bench
+  *   ./nmea_bench [重复轮数]
+  *
+  ******************************************************************************
+  */
+
+#include "nmea.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static const char *const bench_bodies[] = {
+    "GNRMC,083559.00,A,3954.52200,N,11623.46150,E,0.004,77.52,091202,,,A",
+    "GNVTG,77.52,T,,M,0.004,N,0.008,K,A",
+    "GNGGA,083559.00,3954.52200,N,11623.46150,E,1,08,1.01,499.6,M,48.0,M,,",
+    "GNGSA,A,3,10,07,05,02,29,04,08,13,,,,,1.72,1.03,1.38",
+    "GPGSV,3,1,11,10,63,137,17,07,61,098,15,05,59,290,20,08,54,157,30",
+    "GPGSV,3,2,11,02,39,223,19,13,28,070,17,26,23,252,,04,14,186,14",
+    "GPGSV,3,3,11,29,09,301,24,16,09,020,,36,,,",
+    "BDGSV,1,1,04,01,45,125,33,03,51,199,35,06,60,216,31,08,64,002,29",
+};
+
+int main(int argc, char **argv)
+{
+    NMEA_Parser_t parser;
+    uint32_t rounds = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : 200000U;
+    static char stream[2048];
+    size_t stream_len = 0;
+    uint32_t sentences = 0;
+    volatile uint32_t sink = 0;
+    struct timespec t0, t1;
+    double seconds;
+    uint32_t r;
+    size_t i;
+
+    // 拼接一轮语句流
+    for (i = 0; i < sizeof(bench_bodies) / sizeof(bench_bodies[0]); i++) {
+        const char *b = bench_bodies[i];
+        uint8_t cs = 0;
+        const char *p;
+
+        for (p = b; *p; p++) {
+            cs ^= (uint8_t)*p;
+        }
+        stream_len += (size_t)snprintf(stream + stream_len, sizeof(stream) - stream_len,
+                                       "$%s*%02X\r\n", b, cs);
+    }
+
+    NMEA_Parser_Init(&parser);
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    for (r = 0; r < rounds; r++) {
+        for (i = 0; i < stream_len; i++) {
+            const NMEA_Sentence_t *s = NMEA_Parser_Feed(&parser, stream[i]);
+
+            if (s != NULL) {
+                uint8_t k;
+                for (k = 0; k < s->field_count; k++) {
+                    sink += (uint32_t)NMEA_Field_To_Fixed(&s->field[k], 5);
+                }
+                sentences++;
+            }
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    seconds = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) * 1e-9;
+    (void)sink;
+
+    if (sentences != rounds * (sizeof(bench_bodies) / sizeof(bench_bodies[0]))) {
+        fprintf(stderr, "nmea_bench: expected %u sentences, got %u\n",
+                (unsigned)(rounds * (sizeof(bench_bodies) / sizeof(bench_bodies[0]))), sentences);
+        return 1;
+    }
+
+    printf("nmea_bench: %u sentences, %.3f s, %.0f sentences/s, %.1f MB/s\n",
+           sentences, seconds, sentences / seconds,
+           (double)stream_len * rounds / seconds / 1e6);
+    return 0;
+}
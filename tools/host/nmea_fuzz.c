@@ -0,0 +1,255 @@
+/**
+  ******************************************************************************
+  * @file           : nmea_fuzz.c
+  * @brief          : NMEA解析器主机模糊测试
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-08
+  ******************************************************************************
+  * @attention
+  *
+  * 先跑回归用例，再对合法语句做随机变异（翻转、插入分隔符/数字、截断、
+  * 拼接），一半变异后重算校验和，使畸形字段能通过校验进入数字换算。
+  * 每条输出语句检查字段数和小数位数，并对所有字段调用定点/浮点换算。
+  *
+  * 编译运行（仓库根目录）：
+  *   gcc -O1 -g -fsanitize=address,undefined -fno-sanitize-recover=all \
+  *       -Itools/host -IAPP tools/host/nmea_fuzz.c APP/nmea.c -o nmea_fuzz
+  *   ./nmea_fuzz [迭代次数] [随机种子]
+  *
+  * 用libFuzzer时加 -DNMEA_LIBFUZZER -fsanitize=fuzzer（clang）。
+  *
+  ******************************************************************************
+  */
+
+#include "nmea.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ==================== 种子语句 ==================== */
+
+static const char *const seed_bodies[] = {
+    "GNRMC,083559.00,A,3954.52200,N,11623.46150,E,0.004,77.52,091202,,,A",
+    "GNGGA,083559.00,3954.52200,N,11623.46150,E,1,08,1.01,499.6,M,48.0,M,,",
+    "GNGSA,A,3,10,07,05,02,29,04,08,13,,,,,1.72,1.03,1.38",
+    "GPGSV,3,1,11,10,63,137,17,07,61,098,15,05,59,290,20,08,54,157,30",
+    "GNVTG,77.52,T,,M,0.004,N,0.008,K,A",
+    "PCAS01,5",
+    "GNRMC,,V,,,,,,,,,,N",
+    "GPGGA,,,,,,0,00,99.99,,,,,,",
+};
+
+// 回归用例：曾触发越界或溢出的输入（完整语句，校验和在运行时补齐）
+static const char *const regression_bodies[] = {
+    "GPGGA,0.00000000000,1",                    // 值为0的小数位超过9位，nmea_pow10越界
+    "GPGGA,0.000000000000000000000000000000,1",
+    "GPGGA,-0.0000000000001,1",
+    "GNRMC,1,A,99999999.9,N,-99999999.9,E",     // 定点换算补小数位时int32溢出
+    "GNRMC,1,A,2147483647,N,-2147483648,E",
+    "GPGGA,1.2.3,--1,-,.,-.,.-,1-",
+    "GPGSV,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,",  // 字段数超过NMEA_MAX_FIELDS
+};
+
+/* ==================== 内部函数 ==================== */
+
+static uint32_t fuzz_rng_state = 1;
+
+/**
+ * @brief xorshift32伪随机数
+ */
+static uint32_t Fuzz_Rand(void)
+{
+    fuzz_rng_state ^= fuzz_rng_state << 13;
+    fuzz_rng_state ^= fuzz_rng_state >> 17;
+    fuzz_rng_state ^= fuzz_rng_state << 5;
+    return fuzz_rng_state;
+}
+
+/**
+ * @brief 由语句主体生成"$主体*hh\r\n"
+ * @retval 写入长度
+ */
+static size_t Fuzz_Frame(char *out, size_t size, const char *body, size_t body_len)
+{
+    uint8_t cs = 0;
+    size_t i;
+
+    for (i = 0; i < body_len; i++) {
+        cs ^= (uint8_t)body[i];
+    }
+    return (size_t)snprintf(out, size, "$%.*s*%02X\r\n", (int)body_len, body, cs);
+}
+
+/**
+ * @brief 检查输出语句并对所有字段做换算
+ */
+static void Fuzz_Check(const NMEA_Sentence_t *s)
+{
+    volatile uint32_t sink_i = 0;
+    volatile float sink_f = 0.0f;
+    uint8_t i;
+    uint8_t d;
+
+    if (s->field_count > NMEA_MAX_FIELDS) {
+        fprintf(stderr, "field_count %u > %u\n", s->field_count, NMEA_MAX_FIELDS);
+        abort();
+    }
+
+    for (i = 0; i < s->field_count; i++) {
+        const NMEA_Field_t *f = &s->field[i];
+
+        if (f->frac_digits > 9) {
+            fprintf(stderr, "field %u frac_digits %u > 9\n", i, f->frac_digits);
+            abort();
+        }
+        for (d = 0; d <= 10; d++) {
+            sink_i += (uint32_t)NMEA_Field_To_Fixed(f, d);
+        }
+        sink_f += NMEA_Field_To_Float(f);
+        (void)NMEA_Field_Is_Number(f);
+    }
+    (void)sink_i;
+    (void)sink_f;
+}
+
+/**
+ * @brief 把一段字节流逐字节送入解析器
+ * @retval 输出的语句数
+ */
+static uint32_t Fuzz_Feed(NMEA_Parser_t *parser, const char *data, size_t len)
+{
+    uint32_t count = 0;
+    size_t i;
+
+    for (i = 0; i < len; i++) {
+        const NMEA_Sentence_t *s = NMEA_Parser_Feed(parser, data[i]);
+
+        if (s != NULL) {
+            Fuzz_Check(s);
+            count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief 对语句主体做一次随机变异
+ * @retval 变异后长度
+ */
+static size_t Fuzz_Mutate(char *buf, size_t len, size_t cap)
+{
+    static const char alphabet[] = "0123456789.,-*$\r\nAVNSEWM";
+    uint32_t n = 1 + Fuzz_Rand() % 8;
+
+    while (n--) {
+        size_t pos = len ? Fuzz_Rand() % len : 0;
+
+        switch (Fuzz_Rand() % 6) {
+            case 0:     // 翻转一个比特
+                if (len) buf[pos] ^= (char)(1U << (Fuzz_Rand() % 8));
+                break;
+            case 1:     // 替换为特殊字符
+                if (len) buf[pos] = alphabet[Fuzz_Rand() % (sizeof(alphabet) - 1)];
+                break;
+            case 2:     // 插入一串数字（制造超长数字和超长小数）
+            {
+                size_t k = 1 + Fuzz_Rand() % 24;
+                if (len + k >= cap) break;
+                memmove(buf + pos + k, buf + pos, len - pos);
+                while (k--) {
+                    buf[pos + k] = (Fuzz_Rand() & 1) ? '0' : (char)('0' + Fuzz_Rand() % 10);
+                    len++;
+                }
+                break;
+            }
+            case 3:     // 插入分隔符
+                if (len + 1 >= cap) break;
+                memmove(buf + pos + 1, buf + pos, len - pos);
+                buf[pos] = (Fuzz_Rand() & 1) ? ',' : '.';
+                len++;
+                break;
+            case 4:     // 删除一个字符
+                if (len) {
+                    memmove(buf + pos, buf + pos + 1, len - pos - 1);
+                    len--;
+                }
+                break;
+            default:    // 截断
+                len = pos;
+                break;
+        }
+    }
+    return len;
+}
+
+#ifdef NMEA_LIBFUZZER
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    static NMEA_Parser_t parser;
+
+    NMEA_Parser_Init(&parser);
+    Fuzz_Feed(&parser, (const char *)data, size);
+    return 0;
+}
+
+#else
+
+int main(int argc, char **argv)
+{
+    NMEA_Parser_t parser;
+    uint32_t iterations = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : 1000000U;
+    uint32_t accepted = 0;
+    uint32_t i;
+    char body[256];
+    char frame[300];
+    size_t len;
+
+    fuzz_rng_state = argc > 2 ? (uint32_t)strtoul(argv[2], NULL, 0) : 0x12345678U;
+    if (fuzz_rng_state == 0) {
+        fuzz_rng_state = 1;
+    }
+
+    NMEA_Parser_Init(&parser);
+
+    // 回归用例必须通过校验并经过换算检查
+    for (i = 0; i < sizeof(regression_bodies) / sizeof(regression_bodies[0]); i++) {
+        len = Fuzz_Frame(frame, sizeof(frame), regression_bodies[i], strlen(regression_bodies[i]));
+        if (Fuzz_Feed(&parser, frame, len) != 1) {
+            fprintf(stderr, "regression %u not accepted: %s", i, frame);
+            return 1;
+        }
+    }
+
+    for (i = 0; i < iterations; i++) {
+        const char *seed = seed_bodies[Fuzz_Rand() % (sizeof(seed_bodies) / sizeof(seed_bodies[0]))];
+
+        len = strlen(seed);
+        memcpy(body, seed, len);
+        len = Fuzz_Mutate(body, len, sizeof(body));
+
+        if (Fuzz_Rand() & 1) {
+            // 重算校验和，让畸形字段通过校验
+            len = Fuzz_Frame(frame, sizeof(frame), body, len);
+        } else {
+            // 原样送入（校验错误、缺'$'或'*'等）
+            memcpy(frame, body, len);
+        }
+        accepted += Fuzz_Feed(&parser, frame, len);
+
+        // 偶尔送入纯随机字节
+        if ((Fuzz_Rand() & 0xFF) == 0) {
+            uint32_t k;
+            for (k = 0; k < sizeof(frame); k++) {
+                frame[k] = (char)Fuzz_Rand();
+            }
+            accepted += Fuzz_Feed(&parser, frame, sizeof(frame));
+        }
+    }
+
+    printf("nmea_fuzz: %u iterations, %u sentences accepted, %u checksum errors, %u format errors\n",
+           iterations, accepted, parser.checksum_errors, parser.format_errors);
+    return 0;
+}
+
+#endif
@@ -0,0 +1,91 @@
+/**
+  ******************************************************************************
+  * @file           : ppg_synth.h
+  * @brief          : 合成PPG信号（主机测试用）
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-20
+  ******************************************************************************
+  * @attention
+  *
+  * 没有实录的MAX30102数据，心率/血氧类测试使用合成信号：
+  * - 每搏波形：收缩峰（相位0.15）+ 重搏波（相位0.45，幅度0.35），按心率逐搏推进相位；
+  * - 红外直流120000、交流峰峰约1.2%；红光直流100000，交流按
+  *   R=(110-SpO2)/25 取 (AC_red/DC_red)/(AC_ir/DC_ir)=R；
+  * - 叠加0.25Hz呼吸基线漂移和均匀噪声（固定种子，结果可复现）。
+  *
+  ******************************************************************************
+  */
+
+#ifndef __PPG_SYNTH_H
+#define __PPG_SYNTH_H
+
+#include <stdint.h>
+#include <math.h>
+
+#define PPG_SYNTH_IR_DC         120000.0
+#define PPG_SYNTH_RED_DC        100000.0
+#define PPG_SYNTH_IR_AC         0.012       // 红外交流/直流
+#define PPG_SYNTH_WANDER        300.0       // 呼吸基线漂移幅度（计数）
+#define PPG_SYNTH_NOISE         20.0        // 噪声幅度（计数，均匀分布±）
+
+typedef struct {
+    double phase;       // 心动周期相位 [0,1)
+    double t;           // 时间(s)
+    double bpm;         // 心率
+    double spo2;        // 血氧
+    uint32_t rng;       // 噪声种子
+} PPG_Synth_t;
+
+static inline void PPG_Synth_Init(PPG_Synth_t *s, double bpm, double spo2, uint32_t seed)
+{
+    s->phase = 0.0;
+    s->t = 0.0;
+    s->bpm = bpm;
+    s->spo2 = spo2;
+    s->rng = seed ? seed : 1U;
+}
+
+static inline double PPG_Synth_Noise(PPG_Synth_t *s)
+{
+    s->rng = s->rng * 1664525U + 1013904223U;
+    return ((double)(s->rng >> 8) / (double)(1U << 24) * 2.0 - 1.0) * PPG_SYNTH_NOISE;
+}
+
+/**
+ * @brief 归一化脉搏波形（峰峰约1）
+ */
+static inline double PPG_Synth_Pulse(double phase)
+{
+    double a = (phase - 0.15) / 0.06;
+    double b = (phase - 0.45) / 0.08;
+
+    return exp(-a * a) + 0.35 * exp(-b * b);
+}
+
+/**
+ * @brief 产生下一个样本
+ * @param fs: 采样率(Hz)
+ * @retval 1: 本样本跨入新的心动周期
+ */
+static inline int PPG_Synth_Next(PPG_Synth_t *s, uint32_t fs, uint32_t *red, uint32_t *ir)
+{
+    double r = (110.0 - s->spo2) / 25.0;
+    double pulse = PPG_Synth_Pulse(s->phase);
+    double wander = PPG_SYNTH_WANDER * sin(2.0 * 3.14159265358979 * 0.25 * s->t);
+    double ir_v = PPG_SYNTH_IR_DC * (1.0 + PPG_SYNTH_IR_AC * pulse) + wander + PPG_Synth_Noise(s);
+    double red_v = PPG_SYNTH_RED_DC * (1.0 + r * PPG_SYNTH_IR_AC * pulse) + wander + PPG_Synth_Noise(s);
+    int wrapped;
+
+    *red = (uint32_t)red_v & 0x3FFFF;
+    *ir = (uint32_t)ir_v & 0x3FFFF;
+
+    s->t += 1.0 / fs;
+    s->phase += s->bpm / 60.0 / fs;
+    wrapped = s->phase >= 1.0;
+    if (wrapped) {
+        s->phase -= 1.0;
+    }
+    return wrapped;
+}
+
+#endif /* __PPG_SYNTH_H */
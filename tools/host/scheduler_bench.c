@@ -0,0 +1,227 @@
+/**
+  ******************************************************************************
+  * @file           : scheduler_bench.c
+  * @brief          : 截止时间堆调度与线性扫描调度的主机对比测试
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-20
+  ******************************************************************************
+  * @attention
+  *
+  * 固件scheduler.c以MAX_TASKS=256、SCHEDULER_PROFILE=0编译（只比较分派结构），
+  * 与本文件中原轮询式调度器（每轮扫描全部任务，按last_run判断到期）对比。
+  * 16/64/256个空任务，两组周期轮流分配：dense为5/10/20/50/100/200/500/1000ms，
+  * sparse为100/200/500/1000/2000/5000ms。模拟10秒：每个1ms节拍调用一次scheduler_run和一次scheduler_next_due
+  * （休眠路径），时钟由本文件直接给出，不链接hal_stub.c。
+  * 检查两种实现的分派次数都等于各任务 节拍数/周期 之和，并报告主机上
+  * 每节拍耗时和每次分派耗时（Cortex-M4周期数需在目标板上用DWT测量）。
+  *
+  * 编译运行（仓库根目录）：
+  *   gcc -O2 -DMAX_TASKS=256 -DSCHEDULER_PROFILE=0 -Itools/host -IAPP \
+  *       tools/host/scheduler_bench.c APP/scheduler.c -o scheduler_bench
+  *   ./scheduler_bench [重复轮数]
+  *
+  ******************************************************************************
+  */
+
+#include "scheduler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#if MAX_TASKS < 256
+#error "build with -DMAX_TASKS=256"
+#endif
+
+#define SIM_MS  10000U
+
+// dense: 约一半任务周期在100ms以内，每节拍都有分派；sparse: 周期0.1~5秒，多数节拍无任务到期
+static const uint32_t dense_periods[] = { 5, 10, 20, 50, 100, 200, 500, 1000 };
+static const uint32_t sparse_periods[] = { 100, 200, 500, 1000, 2000, 5000 };
+static const uint32_t task_counts[] = { 16, 64, 256 };
+
+static const uint32_t *periods;
+static uint32_t period_count;
+
+/* ==================== 时钟与内核替身 ==================== */
+
+uint32_t SystemCoreClock = HOST_CPU_HZ;
+volatile uint32_t uwTick;
+volatile uint32_t host_primask;
+CoreDebug_Type host_coredebug;
+
+static SysTick_Type systick_regs;
+static SCB_Type scb_regs;
+static DWT_Type dwt_regs;
+
+SysTick_Type *host_systick(void) { return &systick_regs; }
+SCB_Type *host_scb(void) { return &scb_regs; }
+DWT_Type *host_dwt(void) { return &dwt_regs; }
+void host_irq_unmasked(void) { }
+void host_wfi(void) { }
+uint32_t HAL_GetTick(void) { return uwTick; }
+void HAL_SuspendTick(void) { }
+void HAL_ResumeTick(void) { }
+void HAL_PWR_EnterSTOPMode(uint32_t Regulator, uint8_t STOPEntry) { (void)Regulator; (void)STOPEntry; }
+
+/* ==================== 原轮询式调度器 ==================== */
+
+typedef struct {
+    void (*task_func)(void);
+    uint32_t period_ms;
+    uint32_t last_run;
+} linear_task_t;
+
+static linear_task_t linear_list[MAX_TASKS];
+static uint32_t linear_count;
+
+static void linear_run(void)
+{
+    uint32_t current_time = HAL_GetTick();
+
+    for (uint32_t i = 0; i < linear_count; i++) {
+        if (current_time - linear_list[i].last_run >= linear_list[i].period_ms) {
+            linear_list[i].last_run = current_time;
+            linear_list[i].task_func();
+        }
+    }
+}
+
+static uint32_t linear_next_due(void)
+{
+    uint32_t now = HAL_GetTick();
+    uint32_t best = SCHEDULER_NO_DEADLINE;
+
+    for (uint32_t i = 0; i < linear_count; i++) {
+        uint32_t elapsed = now - linear_list[i].last_run;
+        uint32_t remain = elapsed >= linear_list[i].period_ms ? 0 : linear_list[i].period_ms - elapsed;
+
+        if (remain < best) {
+            best = remain;
+        }
+    }
+    return best;
+}
+
+/* ==================== 测试 ==================== */
+
+static volatile uint32_t dispatched;
+static volatile uint32_t sink;
+
+static void dummy_task(void)
+{
+    dispatched++;
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * @brief 模拟SIM_MS个节拍
+ * @param heap: 1: 固件调度器, 0: 线性扫描
+ * @retval 耗时（纳秒）
+ */
+static double simulate(uint32_t n, int heap)
+{
+    double t0;
+    uint32_t i;
+
+    uwTick = 0;
+    if (heap) {
+        scheduler_init();
+        for (i = 0; i < n; i++) {
+            scheduler_add_task(dummy_task, periods[i % period_count]);
+        }
+    } else {
+        linear_count = n;
+        for (i = 0; i < n; i++) {
+            linear_list[i].task_func = dummy_task;
+            linear_list[i].period_ms = periods[i % period_count];
+            linear_list[i].last_run = 0;
+        }
+    }
+
+    t0 = now_ns();
+    for (uwTick = 1; uwTick <= SIM_MS; uwTick++) {
+        if (heap) {
+            scheduler_run();
+            sink += scheduler_next_due();
+        } else {
+            linear_run();
+            sink += linear_next_due();
+        }
+    }
+    return now_ns() - t0;
+}
+
+/**
+ * @brief 对一组周期运行16/64/256个任务
+ * @retval 失败数
+ */
+static uint32_t run_mix(const char *name, const uint32_t *p, uint32_t count, uint32_t rounds)
+{
+    uint32_t failures = 0;
+    uint32_t c, k, i;
+
+    periods = p;
+    period_count = count;
+
+    for (c = 0; c < sizeof(task_counts) / sizeof(task_counts[0]); c++) {
+        uint32_t n = task_counts[c];
+        uint32_t expect = 0;
+        double best[2] = { 1e30, 1e30 };
+        uint32_t counted[2] = { 0, 0 };
+
+        for (i = 0; i < n; i++) {
+            expect += SIM_MS / periods[i % period_count];
+        }
+
+        // 交替运行取最小值，减少主机调度噪声
+        for (k = 0; k < rounds; k++) {
+            for (i = 0; i < 2; i++) {
+                double ns;
+
+                dispatched = 0;
+                ns = simulate(n, (int)i);
+                counted[i] = dispatched;
+                if (ns < best[i]) {
+                    best[i] = ns;
+                }
+            }
+        }
+
+        printf("%-6s %5u  %10u   %14.1f  %12.1f   %14.2f  %12.2f  %6.2fx\n",
+               name, (unsigned)n, (unsigned)expect,
+               best[0] / SIM_MS, best[1] / SIM_MS,
+               best[0] / expect, best[1] / expect, best[0] / best[1]);
+
+        if (counted[0] != expect || counted[1] != expect) {
+            printf("FAIL: %u tasks dispatched linear %u, heap %u, want %u\n",
+                   (unsigned)n, (unsigned)counted[0], (unsigned)counted[1], (unsigned)expect);
+            failures++;
+        }
+    }
+
+    return failures;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t rounds = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : 20U;
+    uint32_t failures = 0;
+
+    printf("%u ms simulated, scheduler_run + scheduler_next_due every 1 ms tick, best of %u rounds\n",
+           (unsigned)SIM_MS, (unsigned)rounds);
+    printf("mix    tasks  dispatches   linear ns/tick  heap ns/tick   linear ns/disp  heap ns/disp  speedup\n");
+
+    failures += run_mix("dense", dense_periods, sizeof(dense_periods) / sizeof(dense_periods[0]), rounds);
+    failures += run_mix("sparse", sparse_periods, sizeof(sparse_periods) / sizeof(sparse_periods[0]), rounds);
+
+    (void)sink;
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,140 @@
+/**
+  ******************************************************************************
+  * @file           : scheduler_stop_test.c
+  * @brief          : scheduler_idle进入STOP前关中断复查的主机测试
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-20
+  ******************************************************************************
+  * @attention
+  *
+  * 只有一个事件任务、没有周期任务时scheduler_idle进入STOP。三种情形：
+  * - race：scheduler_stop_allowed被调用时挂起一次EXTI中断（中断中scheduler_notify），
+  *   模拟通知恰好落在“决定进入STOP”与进入STOP之间。任务须在1ms内运行；
+  *   若进入STOP前不关中断复查，通知会被搁置到下一个唤醒源（本测试在1秒后
+  *   安排一次兜底EXTI）；
+  * - stop：100ms后EXTI唤醒，任务须在1ms内运行，且STOP期间SysTick停止
+  *   （uwTick几乎不增加）；
+  * - busy：scheduler_stop_allowed返回0，改为单次定时休眠，uwTick照常增加。
+  *
+  * 编译运行（仓库根目录）：
+  *   gcc -O2 -Itools/host -IAPP tools/host/scheduler_stop_test.c tools/host/hal_stub.c \
+  *       APP/scheduler.c -o scheduler_stop_test
+  *   ./scheduler_stop_test
+  *
+  ******************************************************************************
+  */
+
+#include "scheduler.h"
+#include <stdio.h>
+
+#define RESCUE_MS   1000U   // 兜底EXTI
+
+static uint64_t exti_at[2];         // 已安排的EXTI时刻（UINT64_MAX: 无）
+static uint64_t notify_time;        // 首次通知时刻（0: 尚未通知）
+static uint64_t run_time;           // 任务最近一次运行时刻
+static uint32_t task_runs;
+static int race_armed;
+static int stop_allowed;
+static uint32_t failures;
+
+static void event_task(void)
+{
+    run_time = host_cycles();
+    task_runs++;
+}
+
+static void exti_isr(void)
+{
+    if (notify_time == 0) {
+        notify_time = host_cycles();
+    }
+    scheduler_notify(event_task);
+}
+
+uint8_t scheduler_stop_allowed(void)
+{
+    if (race_armed) {
+        race_armed = 0;
+        host_raise_irq(exti_isr);
+    }
+    return (uint8_t)stop_allowed;
+}
+
+uint64_t host_event_next(void)
+{
+    return exti_at[0] < exti_at[1] ? exti_at[0] : exti_at[1];
+}
+
+void host_event_poll(uint64_t now)
+{
+    uint32_t i;
+
+    for (i = 0; i < 2; i++) {
+        if (exti_at[i] <= now) {
+            exti_at[i] = UINT64_MAX;
+            host_raise_irq(exti_isr);
+        }
+    }
+}
+
+static void expect(int cond, const char *what)
+{
+    if (!cond) {
+        printf("FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+/**
+ * @brief 运行主循环直到任务运行一次
+ * @param first_ms: 首次EXTI在多少毫秒后（0: 无）
+ */
+static void run_case(const char *name, int race, int allowed, uint32_t first_ms)
+{
+    uint64_t t0;
+    uint32_t tick0;
+    double latency_ms, elapsed_ms;
+
+    host_init();
+    scheduler_init();
+    scheduler_add_event_task(event_task);
+
+    t0 = host_cycles();
+    exti_at[0] = first_ms ? t0 + (uint64_t)first_ms * (HOST_CPU_HZ / 1000U) : UINT64_MAX;
+    exti_at[1] = t0 + (uint64_t)RESCUE_MS * (HOST_CPU_HZ / 1000U);
+    race_armed = race;
+    stop_allowed = allowed;
+    task_runs = 0;
+    notify_time = 0;
+    tick0 = uwTick;
+
+    while (task_runs == 0) {
+        scheduler_run();
+        if (task_runs == 0) {
+            scheduler_idle();
+        }
+    }
+
+    latency_ms = (double)(run_time - notify_time) * 1000.0 / HOST_CPU_HZ;
+    elapsed_ms = (double)(run_time - t0) * 1000.0 / HOST_CPU_HZ;
+    printf("%-5s notify->run %7.3f ms, woke after %7.2f ms, uwTick +%u\n",
+           name, latency_ms, elapsed_ms, (unsigned)(uwTick - tick0));
+
+    expect(latency_ms < 1.0, "task runs within 1 ms of its notification");
+    expect(elapsed_ms < RESCUE_MS - 1.0, "woken by its own EXTI, not the rescue one");
+    if (allowed) {
+        expect(uwTick - tick0 <= 1U, "SysTick halted in STOP");
+    } else {
+        expect(uwTick - tick0 + 1U >= first_ms, "uwTick keeps counting in tickless sleep");
+    }
+}
+
+int main(void)
+{
+    run_case("race", 1, 1, 0);
+    run_case("stop", 0, 1, 100);
+    run_case("busy", 0, 0, 100);
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
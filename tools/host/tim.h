@@ -0,0 +1,16 @@
+/**
+  ******************************************************************************
+  * @file           : tim.h
+  * @brief          : 主机测试用tim.h替身（句柄由hal_stub.c定义）
+  ******************************************************************************
+  */
+
+#ifndef __TIM_H__
+#define __TIM_H__
+
+#include "main.h"
+
+extern TIM_HandleTypeDef htim1;
+extern TIM_HandleTypeDef htim3;
+
+#endif /* __TIM_H__ */
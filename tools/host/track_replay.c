@@ -0,0 +1,255 @@
+/**
+  ******************************************************************************
+  * @file           : track_replay.c
+  * @brief          : 轨迹抽稀在步行/驾车轨迹上的压缩比与重建误差（主机测试）
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-20
+  ******************************************************************************
+  * @attention
+  *
+  * 直接包含固件track.c，按1Hz逐个定位调用TRACK_Add_Fix，每个定位后用
+  * TRACK_Peek/TRACK_Consume取走输出点（模拟上传总是成功）。轨迹均为30分钟：
+  * - walk：约1.3m/s步行，直行、直角转弯、沿弧线走、原地停留交替；
+  * - drive：8~17m/s驾车，直路、弯道（3度/秒）、路口停车交替，从23:45开始，
+  *   跨过UTC零点；
+  * 每种轨迹各有无噪声（clean）和带定位噪声（白噪声σ1.5m/1.0m + 缓慢漂移）两种。
+  * 重建误差由本文件独立计算：每个被省略的定位到其前后两个输出点连线的
+  * 距离（double，以前一输出点为原点的局部平面），与模块自身统计
+  * max_error_m对照，并检查不超过TRACK_TOLERANCE_M。
+  * 结尾仍在窗口中、尚未输出的定位不计入误差。
+  *
+  * 编译运行（仓库根目录；容差可用-DTRACK_TOLERANCE_M=2.0f等覆盖）：
+  *   gcc -O2 -Itools/host -IAPP tools/host/track_replay.c -lm -o track_replay
+  *   ./track_replay
+  *
+  ******************************************************************************
+  */
+
+#include "track.c"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TRACE_SECONDS   1800U
+#define BASE_LAT_E7     399087000L
+#define BASE_LON_E7     1163910000L
+#define M_PER_E7_LAT    0.011119493
+
+typedef struct {
+    uint8_t kind;       // 0: 直行, 1: 转弯（匀角速度）, 2: 停留
+    uint32_t seconds;
+    double speed;       // m/s
+    double turn;        // 度/秒
+} Leg_t;
+
+static const Leg_t walk_legs[] = {
+    { 0, 120, 1.3, 0 }, { 1, 3, 1.0, 30 }, { 0, 90, 1.3, 0 }, { 2, 60, 0, 0 },
+    { 0, 60, 1.4, 0 }, { 1, 3, 1.0, -30 }, { 1, 120, 1.2, 1.5 }, { 0, 45, 1.3, 0 },
+    { 2, 180, 0, 0 }, { 1, 3, 1.0, 60 }, { 0, 150, 1.3, 0 },
+};
+
+static const Leg_t drive_legs[] = {
+    { 0, 60, 14, 0 }, { 1, 30, 10, 3 }, { 0, 45, 17, 0 }, { 2, 40, 0, 0 },
+    { 0, 20, 8, 0 }, { 1, 10, 6, -9 }, { 0, 90, 15, 0 }, { 1, 60, 12, -1.5 },
+    { 0, 30, 16, 0 }, { 2, 25, 0, 0 },
+};
+
+typedef struct {
+    int32_t lat_e7;
+    int32_t lon_e7;
+    uint32_t time;
+} Fix_t;
+
+static Fix_t fixes[TRACE_SECONDS];
+static uint32_t emitted_index[TRACE_SECONDS];
+static uint32_t emitted_count;
+static uint32_t failures;
+
+static uint32_t rng_state = 0x1234567U;
+
+static double uniform(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return (rng_state + 0.5) / 4294967296.0;
+}
+
+static double gaussian(void)
+{
+    return sqrt(-2.0 * log(uniform())) * cos(2.0 * M_PI * uniform());
+}
+
+/**
+ * @brief 按分段运动生成1Hz定位；noise为白噪声标准差（m），0表示无噪声
+ */
+static void generate(const Leg_t *legs, uint32_t leg_count, double noise, uint32_t start_time)
+{
+    double east = 0, north = 0, heading = 30.0;
+    double drift_e = 0, drift_n = 0;
+    double m_per_e7_lon = M_PER_E7_LAT * cos(BASE_LAT_E7 / 1e7 * M_PI / 180.0);
+    uint32_t t = 0, leg = 0, in_leg = 0;
+
+    while (t < TRACE_SECONDS) {
+        const Leg_t *l = &legs[leg];
+        double e = east, n = north;
+
+        if (l->kind == 1) {
+            heading += l->turn;
+        }
+        if (l->kind != 2) {
+            east += l->speed * sin(heading * M_PI / 180.0);
+            north += l->speed * cos(heading * M_PI / 180.0);
+        }
+        if (noise > 0) {
+            // 漂移为缓慢随机游走，叠加白噪声
+            drift_e += 0.05 * gaussian();
+            drift_n += 0.05 * gaussian();
+            e = east + drift_e + noise * gaussian();
+            n = north + drift_n + noise * gaussian();
+        } else {
+            e = east;
+            n = north;
+        }
+
+        fixes[t].lat_e7 = BASE_LAT_E7 + (int32_t)lround(n / M_PER_E7_LAT);
+        fixes[t].lon_e7 = BASE_LON_E7 + (int32_t)lround(e / m_per_e7_lon);
+        fixes[t].time = (start_time + t) % 86400U;
+        t++;
+
+        if (++in_leg >= l->seconds) {
+            in_leg = 0;
+            leg = (leg + 1U) % leg_count;
+        }
+    }
+}
+
+/**
+ * @brief 点p到线段a-b的距离（米，double，以a为原点的局部平面）
+ */
+static double segment_distance(const Fix_t *a, const Fix_t *b, const Fix_t *p)
+{
+    double m_lon = M_PER_E7_LAT * cos(a->lat_e7 / 1e7 * M_PI / 180.0);
+    double bx = ((double)b->lon_e7 - a->lon_e7) * m_lon;
+    double by = ((double)b->lat_e7 - a->lat_e7) * M_PER_E7_LAT;
+    double px = ((double)p->lon_e7 - a->lon_e7) * m_lon;
+    double py = ((double)p->lat_e7 - a->lat_e7) * M_PER_E7_LAT;
+    double len2 = bx * bx + by * by;
+    double u = len2 > 0 ? (px * bx + py * by) / len2 : 0;
+
+    if (u < 0) u = 0;
+    if (u > 1) u = 1;
+    return hypot(px - u * bx, py - u * by);
+}
+
+/**
+ * @brief 取走上传队列中的点，按顺序对应回定位序号
+ */
+static void drain(uint32_t *cursor)
+{
+    TRACK_Point_t pts[TRACK_UPLOAD_MAX];
+    uint32_t next;
+    uint8_t n, i;
+
+    while ((n = TRACK_Peek(pts, TRACK_UPLOAD_MAX, &next)) > 0) {
+        for (i = 0; i < n; i++) {
+            while (*cursor < TRACE_SECONDS &&
+                   (fixes[*cursor].lat_e7 != pts[i].lat_e7 || fixes[*cursor].lon_e7 != pts[i].lon_e7 ||
+                    fixes[*cursor].time != pts[i].time)) {
+                (*cursor)++;
+            }
+            if (*cursor == TRACE_SECONDS) {
+                printf("FAIL: emitted point not found in the trace\n");
+                failures++;
+                return;
+            }
+            emitted_index[emitted_count++] = (*cursor)++;
+        }
+        TRACK_Consume(next);
+    }
+}
+
+static void replay(const char *name)
+{
+    GPS_Data_t data;
+    uint32_t cursor = 0;
+    uint32_t t, k, j;
+    uint32_t max_gap = 0;
+    double max_err = 0, sum_err = 0;
+    uint32_t omitted = 0;
+    const TRACK_Stats_t *st;
+
+    TRACK_Init();
+    emitted_count = 0;
+    memset(&data, 0, sizeof(data));
+    data.fix_valid = true;
+
+    for (t = 0; t < TRACE_SECONDS; t++) {
+        data.lat_e7 = fixes[t].lat_e7;
+        data.lon_e7 = fixes[t].lon_e7;
+        data.hour = (uint8_t)(fixes[t].time / 3600U);
+        data.minute = (uint8_t)(fixes[t].time / 60U % 60U);
+        data.second = (uint8_t)(fixes[t].time % 60U);
+        data.fix_seq++;
+        TRACK_Add_Fix(&data);
+        drain(&cursor);
+    }
+
+    // 相邻输出点之间被省略的定位到连线的距离
+    for (k = 0; k + 1U < emitted_count; k++) {
+        const Fix_t *a = &fixes[emitted_index[k]];
+        const Fix_t *b = &fixes[emitted_index[k + 1U]];
+
+        if (emitted_index[k + 1U] - emitted_index[k] > max_gap) {
+            max_gap = emitted_index[k + 1U] - emitted_index[k];
+        }
+        for (j = emitted_index[k] + 1U; j < emitted_index[k + 1U]; j++) {
+            double d = segment_distance(a, b, &fixes[j]);
+
+            if (d > max_err) max_err = d;
+            sum_err += d;
+            omitted++;
+        }
+    }
+
+    st = TRACK_Get_Stats();
+    printf("%-11s %6u %7u  %6.1f:1  %7u   %7.2f  %6.2f  %9.2f\n",
+           name, (unsigned)st->fixes, (unsigned)emitted_count,
+           (double)st->fixes / emitted_count, (unsigned)max_gap,
+           max_err, omitted ? sum_err / omitted : 0.0, (double)st->max_error_m);
+
+    // 独立计算与模块统计可有少量差异（float与double、平面近似原点不同），留1%余量
+    if (max_err > TRACK_TOLERANCE_M * 1.01) {
+        printf("FAIL: %s reconstruction error %.2f m exceeds %.1f m\n", name, max_err, (double)TRACK_TOLERANCE_M);
+        failures++;
+    }
+    if (max_gap > TRACK_MAX_INTERVAL) {
+        printf("FAIL: %s %u s between emitted points, limit %u s\n", name, (unsigned)max_gap,
+               (unsigned)TRACK_MAX_INTERVAL);
+        failures++;
+    }
+    if (st->dropped != 0) {
+        printf("FAIL: %s dropped %u points with uploads always succeeding\n", name, (unsigned)st->dropped);
+        failures++;
+    }
+}
+
+int main(void)
+{
+    printf("%u s at 1 Hz, tolerance %.1f m, window %u, max interval %u s\n",
+           (unsigned)TRACE_SECONDS, (double)TRACK_TOLERANCE_M, (unsigned)TRACK_WINDOW_SIZE,
+           (unsigned)TRACK_MAX_INTERVAL);
+    printf("trace        fixes emitted    ratio  max gap   max err  mean    module max\n");
+    printf("                                       (s)       (m)    (m)        (m)\n");
+
+    generate(walk_legs, sizeof(walk_legs) / sizeof(walk_legs[0]), 0, 8U * 3600U);
+    replay("walk-clean");
+    generate(walk_legs, sizeof(walk_legs) / sizeof(walk_legs[0]), 1.5, 8U * 3600U);
+    replay("walk-noisy");
+    generate(drive_legs, sizeof(drive_legs) / sizeof(drive_legs[0]), 0, 23U * 3600U + 45U * 60U);
+    replay("drive-clean");
+    generate(drive_legs, sizeof(drive_legs) / sizeof(drive_legs[0]), 1.0, 23U * 3600U + 45U * 60U);
+    replay("drive-noisy");
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,230 @@
+/**
+  ******************************************************************************
+  * @file           : uart_rx_sim.c
+  * @brief          : 串口循环DMA接收模型（主机测试用）
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-20
+  ******************************************************************************
+  */
+
+#include "uart_rx_sim.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+UART_Rx_Sim_t uart_rx_sim;
+
+static struct {
+    const uint8_t *data;
+    uint32_t len;
+    uint64_t at;
+} bursts[UART_RX_SIM_MAX_BURSTS];
+
+static uint32_t burst_count;
+static uint32_t burst_index;        // 正在发送的突发
+static uint32_t byte_index;         // 突发内下一个字节
+static uint64_t burst_start;        // 当前突发实际开始时刻
+static uint64_t next_byte_end;      // 下一个字节停止位结束时刻
+static uint64_t idle_at;            // 空闲中断时刻（UINT64_MAX: 无）
+
+static DMA_Stream_TypeDef dma_stream;
+static uint32_t dma_pos;            // DMA写入位置
+static uint32_t ht_flag;
+static uint32_t tc_flag;
+static uint32_t idle_flag;
+
+static uint64_t byte_end(uint64_t start, uint32_t i)
+{
+    return start + (uint64_t)(i + 1U) * 10U * HOST_CPU_HZ / uart_rx_sim.baud;
+}
+
+uint64_t UART_Rx_Sim_Frame_Cycles(void)
+{
+    return 10ULL * HOST_CPU_HZ / uart_rx_sim.baud;
+}
+
+/**
+ * @brief 定位下一个要发送的字节，更新next_byte_end
+ */
+static void schedule_next(uint64_t line_free)
+{
+    while (burst_index < burst_count && byte_index >= bursts[burst_index].len) {
+        burst_index++;
+        byte_index = 0;
+        if (burst_index < burst_count) {
+            burst_start = bursts[burst_index].at > line_free ? bursts[burst_index].at : line_free;
+        }
+    }
+    next_byte_end = burst_index < burst_count ? byte_end(burst_start, byte_index) : UINT64_MAX;
+}
+
+void UART_Rx_Sim_Init(UART_HandleTypeDef *huart, uint32_t baud)
+{
+    memset(&uart_rx_sim, 0, sizeof(uart_rx_sim));
+    uart_rx_sim.huart = huart;
+    uart_rx_sim.baud = baud;
+    if (huart->hdmarx != NULL) {
+        huart->hdmarx->Instance = &dma_stream;
+    }
+    burst_count = 0;
+    burst_index = 0;
+    byte_index = 0;
+    next_byte_end = UINT64_MAX;
+    idle_at = UINT64_MAX;
+    dma_pos = 0;
+    ht_flag = tc_flag = idle_flag = 0;
+}
+
+void UART_Rx_Sim_Send_At(const uint8_t *data, uint32_t len, uint64_t at)
+{
+    if (burst_count >= UART_RX_SIM_MAX_BURSTS) {
+        fprintf(stderr, "uart_rx_sim: too many bursts\n");
+        abort();
+    }
+    bursts[burst_count].data = data;
+    bursts[burst_count].len = len;
+    bursts[burst_count].at = at;
+    burst_count++;
+
+    if (next_byte_end == UINT64_MAX && burst_index == burst_count - 1U) {
+        byte_index = 0;
+        burst_start = at;
+        schedule_next(at);
+    }
+}
+
+int UART_Rx_Sim_Done(void)
+{
+    return next_byte_end == UINT64_MAX;
+}
+
+/* ==================== 中断 ==================== */
+
+static uint32_t dma_running(void)
+{
+    return uart_rx_sim.huart->RxState == HAL_UART_STATE_BUSY_RX;
+}
+
+static void rx_event(uint16_t size)
+{
+    uart_rx_sim.callbacks++;
+    HAL_UARTEx_RxEventCallback(uart_rx_sim.huart, size);
+}
+
+/**
+ * @brief DMA流中断（HAL_DMA_IRQHandler：先半满后全满）
+ */
+static void dma_isr(void)
+{
+    uint16_t size = uart_rx_sim.huart->RxXferSize;
+
+    if (ht_flag) {
+        ht_flag = 0;
+        if (dma_running()) {
+            rx_event(size / 2U);
+        }
+    }
+    if (tc_flag) {
+        tc_flag = 0;
+        if (dma_running()) {
+            rx_event(size);
+        }
+    }
+}
+
+/**
+ * @brief USART中断（空闲线：剩余计数不为0且不为满时回调）
+ */
+static void usart_isr(void)
+{
+    uint16_t size = uart_rx_sim.huart->RxXferSize;
+    uint32_t ndtr = dma_stream.NDTR;
+
+    if (idle_flag) {
+        idle_flag = 0;
+        if (dma_running() && ndtr > 0U && ndtr < size) {
+            rx_event((uint16_t)(size - ndtr));
+        }
+    }
+}
+
+/* ==================== 字节传输 ==================== */
+
+static void deliver_byte(uint64_t t)
+{
+    UART_HandleTypeDef *huart = uart_rx_sim.huart;
+    uint8_t b = bursts[burst_index].data[byte_index];
+    uint64_t next_start;
+
+    uart_rx_sim.bytes++;
+
+    if (dma_running() && huart->RxXferSize > 0U) {
+        huart->pRxBuffPtr[dma_pos++] = b;
+        uart_rx_sim.written++;
+        if (uart_rx_sim.on_byte != NULL) {
+            uart_rx_sim.on_byte(uart_rx_sim.written - 1U, b, t);
+        }
+        if (dma_pos == huart->RxXferSize / 2U) {
+            ht_flag = 1;
+            uart_rx_sim.irq_ht++;
+            host_raise_irq(dma_isr);
+        } else if (dma_pos == huart->RxXferSize) {
+            dma_pos = 0;
+            tc_flag = 1;
+            uart_rx_sim.irq_tc++;
+            host_raise_irq(dma_isr);
+        }
+        dma_stream.NDTR = huart->RxXferSize - dma_pos;
+    } else {
+        uart_rx_sim.lost++;
+    }
+
+    byte_index++;
+    schedule_next(t);
+
+    // 下一个字节的起始位不早于一帧之后：线路空闲，一帧后产生空闲中断
+    next_start = next_byte_end == UINT64_MAX ? UINT64_MAX : next_byte_end - UART_Rx_Sim_Frame_Cycles();
+    idle_at = next_start >= t + UART_Rx_Sim_Frame_Cycles() ? t + UART_Rx_Sim_Frame_Cycles() : UINT64_MAX;
+}
+
+uint64_t host_event_next(void)
+{
+    return next_byte_end < idle_at ? next_byte_end : idle_at;
+}
+
+void host_event_poll(uint64_t now)
+{
+    while (next_byte_end <= now || idle_at <= now) {
+        if (next_byte_end <= idle_at) {
+            deliver_byte(next_byte_end);
+        } else {
+            idle_at = UINT64_MAX;
+            if (dma_running()) {
+                idle_flag = 1;
+                uart_rx_sim.irq_idle++;
+                host_raise_irq(usart_isr);
+            }
+        }
+    }
+}
+
+/* ==================== HAL接口 ==================== */
+
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size)
+{
+    huart->pRxBuffPtr = pData;
+    huart->RxXferSize = Size;
+    huart->RxState = HAL_UART_STATE_BUSY_RX;
+    if (huart == uart_rx_sim.huart) {
+        dma_pos = 0;
+        dma_stream.NDTR = Size;
+        ht_flag = tc_flag = idle_flag = 0;
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_DMAStop(UART_HandleTypeDef *huart)
+{
+    huart->RxState = HAL_UART_STATE_READY;
+    return HAL_OK;
+}
@@ -0,0 +1,68 @@
+/**
+  ******************************************************************************
+  * @file           : uart_rx_sim.h
+  * @brief          : 串口循环DMA接收模型（主机测试用）
+  * @author         : STM32智能安全帽项目组
+  * @date           : 2025-12-20
+  ******************************************************************************
+  * @attention
+  *
+  * 模拟一路USART + 循环DMA接收（HAL_UARTEx_ReceiveToIdle_DMA）：
+  * - 测试程序预先登记若干突发（起始时刻 + 字节），字节按10位帧在线路上
+  *   背靠背传输，每个字节的停止位结束时写入DMA缓冲区；
+  * - 写到一半/写满时挂起DMA半满/全满中断，线路空闲一帧时挂起USART
+  *   空闲中断，中断执行时按HAL的规则以Size调用HAL_UARTEx_RxEventCallback
+  *   （半满为RxXferSize/2，全满为RxXferSize，空闲为RxXferSize-NDTR且不为0或满）；
+  * - DMA未运行（RxState不是BUSY_RX，如错误后尚未重启）时到达的字节计为丢失。
+  * 与max30102_sim一样定义host_event_next/host_event_poll，不能与其同时链接。
+  *
+  ******************************************************************************
+  */
+
+#ifndef __UART_RX_SIM_H
+#define __UART_RX_SIM_H
+
+#include "main.h"
+
+#define UART_RX_SIM_MAX_BURSTS  1024
+
+typedef struct {
+    UART_HandleTypeDef *huart;  // 接收句柄
+    uint32_t baud;              // 线路波特率
+    uint32_t bytes;             // 线路上已传输的字节数
+    uint32_t written;           // 写入DMA缓冲区的字节数
+    uint32_t lost;              // DMA未运行时到达的字节数
+    uint32_t irq_ht;            // DMA半满中断次数
+    uint32_t irq_tc;            // DMA全满中断次数
+    uint32_t irq_idle;          // USART空闲中断次数
+    uint32_t callbacks;         // HAL_UARTEx_RxEventCallback调用次数
+    // 每个字节写入时调用（可为NULL）：序号、字节、时刻（周期）
+    void (*on_byte)(uint32_t index, uint8_t byte, uint64_t t);
+} UART_Rx_Sim_t;
+
+extern UART_Rx_Sim_t uart_rx_sim;
+
+/**
+ * @brief 复位模型
+ * @param huart: 接收句柄（须已设置hdmarx）
+ * @param baud: 线路波特率
+ */
+void UART_Rx_Sim_Init(UART_HandleTypeDef *huart, uint32_t baud);
+
+/**
+ * @brief 登记一次突发，在at时刻（周期）开始发送；前一突发未发完时接在其后
+ * @note  data须在发送完之前保持有效
+ */
+void UART_Rx_Sim_Send_At(const uint8_t *data, uint32_t len, uint64_t at);
+
+/**
+ * @brief 一帧（10位）的周期数
+ */
+uint64_t UART_Rx_Sim_Frame_Cycles(void);
+
+/**
+ * @brief 所有登记的字节是否已发送完
+ */
+int UART_Rx_Sim_Done(void);
+
+#endif /* __UART_RX_SIM_H */
@@ -0,0 +1,18 @@
+/**
+  ******************************************************************************
+  * @file           : usart.h
+  * @brief          : 主机测试用usart.h替身（句柄由hal_stub.c定义）
+  ******************************************************************************
+  */
+
+#ifndef __USART_H__
+#define __USART_H__
+
+#include "main.h"
+
+extern UART_HandleTypeDef huart1;
+extern UART_HandleTypeDef huart2;
+extern UART_HandleTypeDef huart3;
+extern DMA_HandleTypeDef hdma_usart2_rx;
+
+#endif /* __USART_H__ */